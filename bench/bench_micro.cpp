@@ -0,0 +1,263 @@
+#include "micro_harness.h"
+#include "database/database.h"
+#include "concurrency/occ_manager.h"
+#include "concurrency/twopl_manager.h"
+#include "concurrency/timestamp_oracle.h"
+#include "workload/key_selector.h"
+#include "workload/record.h"
+#include <filesystem>
+#include <memory>
+#include <random>
+
+using namespace txn;
+using txn::bench::MicroHarness;
+
+// Sink so the optimizer cannot drop benchmark bodies whose results are unused.
+static std::atomic<uint64_t> g_sink{0};
+
+static std::string Params(std::initializer_list<std::pair<const char*, std::string>> kv) {
+    std::string out;
+    for (const auto& [k, v] : kv) {
+        if (!out.empty()) out += ';';
+        out += std::string(k) + '=' + v;
+    }
+    return out;
+}
+
+// ============================================================
+// LockManager::TryAcquireAll
+// ============================================================
+
+static void BenchLockManager(MicroHarness& h) {
+    for (int set_size : {2, 4, 8, 16}) {
+        for (int threads : h.ThreadCounts()) {
+            // Disjoint: every thread locks its own keys, so only the table
+            // mutex is contended.
+            {
+                LockManager lm;
+                std::vector<std::vector<std::string>> keys(threads);
+                for (int t = 0; t < threads; t++) {
+                    for (int k = 0; k < set_size; k++) {
+                        keys[t].push_back("key_" + std::to_string(t) + "_" + std::to_string(k));
+                    }
+                }
+                h.Run("lock_manager/try_acquire_all",
+                      Params({{"set_size", std::to_string(set_size)}, {"keys", "disjoint"}}),
+                      threads, [&](int t, uint64_t n) {
+                    uint64_t id = t + 1;
+                    for (uint64_t i = 0; i < n; i++) {
+                        lm.TryAcquireAll(id, keys[t]);
+                        lm.ReleaseAll(id, keys[t]);
+                    }
+                });
+            }
+            // Shared: all threads race for one key set; failed attempts count as ops.
+            {
+                LockManager lm;
+                std::vector<std::string> keys;
+                for (int k = 0; k < set_size; k++) keys.push_back("key_" + std::to_string(k));
+                h.Run("lock_manager/try_acquire_all",
+                      Params({{"set_size", std::to_string(set_size)}, {"keys", "shared"}}),
+                      threads, [&](int t, uint64_t n) {
+                    uint64_t id = t + 1;
+                    uint64_t granted = 0;
+                    for (uint64_t i = 0; i < n; i++) {
+                        if (lm.TryAcquireAll(id, keys)) {
+                            granted++;
+                            lm.ReleaseAll(id, keys);
+                        }
+                    }
+                    g_sink += granted;
+                });
+            }
+        }
+    }
+}
+
+// ============================================================
+// OCCManager::Validate
+// ============================================================
+
+static void BenchOCCValidate(MicroHarness& h, Database& db) {
+    if (!h.Enabled("occ/validate")) return;
+
+    for (int history : {0, 100, 1000, 10000}) {
+        // Build a committed history of single-key blind writes. The pinned
+        // transaction stays active so history GC keeps every record.
+        OCCManager mgr(db);
+        auto pin = mgr.Begin("pin");
+        for (int i = 0; i < history; i++) {
+            auto txn = mgr.Begin("fill");
+            mgr.Write(txn, "hist_" + std::to_string(i), "0");
+            mgr.Commit(txn);
+        }
+
+        for (int read_set : {2, 8}) {
+            // Read keys never appear in the history, so every record is scanned
+            Transaction probe;
+            probe.txn_id = 0;
+            probe.start_ts = 0;
+            for (int k = 0; k < read_set; k++) {
+                probe.read_set["read_" + std::to_string(k)] = "0";
+            }
+
+            for (int threads : h.ThreadCounts()) {
+                std::vector<Transaction> probes(threads, probe);
+                h.Run("occ/validate",
+                      Params({{"history", std::to_string(history)},
+                              {"read_set", std::to_string(read_set)}}),
+                      threads, [&](int t, uint64_t n) {
+                    uint64_t ok = 0;
+                    for (uint64_t i = 0; i < n; i++) ok += mgr.Validate(probes[t]);
+                    g_sink += ok;
+                });
+            }
+        }
+    }
+}
+
+// ============================================================
+// SerializeRecord / DeserializeRecord
+// ============================================================
+
+static void BenchRecord(MicroHarness& h) {
+    for (int fields : {2, 5, 10}) {
+        Record rec;
+        for (int f = 0; f < fields; f++) {
+            rec["field_" + std::to_string(f)] = std::to_string(100000 + f);
+        }
+        std::string encoded = SerializeRecord(rec);
+
+        for (int threads : h.ThreadCounts()) {
+            h.Run("record/serialize", Params({{"fields", std::to_string(fields)}}), threads,
+                  [&](int, uint64_t n) {
+                uint64_t bytes = 0;
+                for (uint64_t i = 0; i < n; i++) bytes += SerializeRecord(rec).size();
+                g_sink += bytes;
+            });
+            h.Run("record/deserialize", Params({{"fields", std::to_string(fields)}}), threads,
+                  [&](int, uint64_t n) {
+                uint64_t count = 0;
+                for (uint64_t i = 0; i < n; i++) count += DeserializeRecord(encoded).size();
+                g_sink += count;
+            });
+        }
+    }
+}
+
+// ============================================================
+// KeySelector::SelectDistinctKeys
+// ============================================================
+
+static void BenchKeySelector(MicroHarness& h) {
+    for (double hot_prob : {0.1, 0.9}) {
+        for (int n_keys : {2, 4, 8}) {
+            for (int threads : h.ThreadCounts()) {
+                ContentionConfig config{1000, 10, hot_prob};
+                h.Run("key_selector/select_distinct_keys",
+                      Params({{"n", std::to_string(n_keys)},
+                              {"hotset_prob", std::to_string(hot_prob).substr(0, 3)}}),
+                      threads, [&](int t, uint64_t n) {
+                    std::mt19937 rng(t + 1);
+                    KeySelector selector(config, rng);
+                    uint64_t count = 0;
+                    for (uint64_t i = 0; i < n; i++) count += selector.SelectDistinctKeys(n_keys).size();
+                    g_sink += count;
+                });
+            }
+        }
+    }
+}
+
+// ============================================================
+// TimestampOracle::Next / Horizon
+// ============================================================
+
+static void BenchTimestampOracle(MicroHarness& h) {
+    if (!h.Enabled("timestamp_oracle/next") && !h.Enabled("timestamp_oracle/horizon")) return;
+    for (const std::string name : {"central", "batched", "epoch", "clock"}) {
+        for (int threads : h.ThreadCounts()) {
+            auto oracle = MakeTimestampOracle(name);
+            h.Run("timestamp_oracle/next", Params({{"oracle", name}}), threads,
+                  [&](int, uint64_t n) {
+                uint64_t last = 0;
+                for (uint64_t i = 0; i < n; i++) last = oracle->Next();
+                g_sink += last;
+            });
+            // One thread per sample takes horizons while the others take timestamps
+            h.Run("timestamp_oracle/horizon", Params({{"oracle", name}}), threads,
+                  [&](int t, uint64_t n) {
+                uint64_t last = 0;
+                for (uint64_t i = 0; i < n; i++) last = t == 0 ? oracle->Horizon() : oracle->Next();
+                g_sink += last;
+            });
+        }
+    }
+}
+
+// ============================================================
+// Database::Get
+// ============================================================
+
+static void BenchDatabaseGet(MicroHarness& h, Database& db) {
+    if (!h.Enabled("database/get")) return;
+
+    const int NUM_KEYS = 10000;
+    for (int i = 0; i < NUM_KEYS; i++) {
+        db.Put("get_" + std::to_string(i), "balance=1000|name=Account-" + std::to_string(i));
+    }
+
+    for (int threads : h.ThreadCounts()) {
+        h.Run("database/get", Params({{"keys", std::to_string(NUM_KEYS)}}), threads,
+              [&](int t, uint64_t n) {
+            std::mt19937 rng(t + 1);
+            std::uniform_int_distribution<int> dist(0, NUM_KEYS - 1);
+            uint64_t found = 0;
+            for (uint64_t i = 0; i < n; i++) {
+                found += db.Get("get_" + std::to_string(dist(rng))).has_value();
+            }
+            g_sink += found;
+        });
+    }
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main(int argc, char* argv[]) {
+    std::string db_path = "bench_micro_db";
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--db-path") db_path = argv[i + 1];
+    }
+
+    MicroHarness harness(argc, argv);
+
+    BenchLockManager(harness);
+    BenchRecord(harness);
+    BenchKeySelector(harness);
+    BenchTimestampOracle(harness);
+
+    if (harness.Enabled("occ/validate") || harness.Enabled("database/get")) {
+        // Database status lines go to stdout; keep them out of the results
+        std::filesystem::remove_all(db_path);
+        auto* saved = std::cout.rdbuf(nullptr);
+        Database db;
+        bool opened = db.Open(db_path);
+        std::cout.rdbuf(saved);
+        if (!opened) {
+            std::cerr << "Failed to open database: " << db_path << "\n";
+            return 1;
+        }
+
+        BenchOCCValidate(harness, db);
+        BenchDatabaseGet(harness, db);
+
+        std::cout.rdbuf(nullptr);
+        db.Close();
+        std::cout.rdbuf(saved);
+        std::filesystem::remove_all(db_path);
+    }
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+// Load generator for server mode (transaction_system --serve PATH or
+// --shm NAME). Opens one connection per thread and keeps up to --pipeline requests in
+// flight on each, sending them in batches of --batch per write. Reports
+// client-observed throughput and latency.
+#include "server/txn_client.h"
+#include "server/shm_client.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace txn;
+using Clock = std::chrono::steady_clock;
+
+struct LoadConfig {
+    std::string socket_path;
+    std::string shm_name;            // set: use the shared-memory transport instead
+    int connections   = 4;
+    int requests      = 10000;       // per connection
+    int pipeline      = 1;           // max in-flight requests per connection
+    int batch         = 1;           // requests per write
+    uint16_t template_id = kAnyTemplate;
+    int ops_keys      = 0;           // > 0: explicit read+write ops over lg_key_0..N-1
+    int ops_per_txn   = 2;           // keys read and rewritten per ops request
+};
+
+struct LoadTotals {
+    std::mutex mutex;
+    std::vector<double> latencies_us;
+    uint64_t committed = 0;
+    uint64_t aborted = 0;
+    uint64_t bad = 0;
+    uint64_t retries = 0;
+    double server_latency_us = 0.0;
+    bool failed = false;
+};
+
+static std::vector<TxnOp> MakeOps(const LoadConfig& config, std::mt19937& rng) {
+    std::uniform_int_distribution<int> key_dist(0, config.ops_keys - 1);
+    std::vector<int> picked;
+    while (static_cast<int>(picked.size()) < std::min(config.ops_per_txn, config.ops_keys)) {
+        int k = key_dist(rng);
+        if (std::find(picked.begin(), picked.end(), k) == picked.end()) picked.push_back(k);
+    }
+    std::vector<TxnOp> ops;
+    for (int k : picked) {
+        std::string key = "lg_key_" + std::to_string(k);
+        ops.push_back({OpType::kRead, key, ""});
+        ops.push_back({OpType::kWrite, key, std::to_string(rng())});
+    }
+    return ops;
+}
+
+// Client is TxnClient or ShmTxnClient; both expose the same interface.
+template <typename Client>
+static void RunConnection(const LoadConfig& config, int thread_id, LoadTotals& totals) {
+    Client client;
+    if (!client.Connect(config.shm_name.empty() ? config.socket_path : config.shm_name)) {
+        std::lock_guard<std::mutex> lock(totals.mutex);
+        totals.failed = true;
+        return;
+    }
+    std::mt19937 rng(thread_id + Clock::now().time_since_epoch().count());
+    std::unordered_map<uint64_t, Clock::time_point> sent_at;
+    std::vector<double> latencies;
+    latencies.reserve(config.requests);
+    uint64_t committed = 0, aborted = 0, bad = 0, retries = 0;
+    double server_latency_us = 0.0;
+
+    int sent = 0, done = 0;
+    bool ok = true;
+    while (ok && done < config.requests) {
+        int queued = 0;
+        while (sent < config.requests && client.InFlight() < static_cast<size_t>(config.pipeline)
+               && queued < config.batch) {
+            uint64_t id = config.ops_keys > 0 ? client.SubmitOps(MakeOps(config, rng))
+                                              : client.SubmitTemplate(config.template_id);
+            if (id == 0) {
+                ok = false;  // shared memory: engine stopped
+                break;
+            }
+            sent_at[id] = Clock::now();
+            sent++;
+            queued++;
+        }
+        if (!ok || (queued > 0 && !client.Flush())) {
+            ok = false;
+            break;
+        }
+
+        TxnResponse response;
+        if (!client.Receive(response)) {
+            ok = false;
+            break;
+        }
+        auto it = sent_at.find(response.id);
+        if (it != sent_at.end()) {
+            latencies.push_back(std::chrono::duration<double, std::micro>(
+                Clock::now() - it->second).count());
+            sent_at.erase(it);
+        }
+        switch (response.status) {
+            case ResponseStatus::kCommitted:  committed++; break;
+            case ResponseStatus::kAborted:    aborted++;   break;
+            case ResponseStatus::kBadRequest:
+                if (bad++ == 0) std::cerr << "Bad request: " << response.error << "\n";
+                break;
+        }
+        retries += response.retries;
+        server_latency_us += response.latency_us;
+        done++;
+    }
+
+    std::lock_guard<std::mutex> lock(totals.mutex);
+    if (!ok) {
+        std::cerr << "Connection " << thread_id << " lost after " << done << " responses\n";
+        totals.failed = true;
+    }
+    totals.latencies_us.insert(totals.latencies_us.end(), latencies.begin(), latencies.end());
+    totals.committed += committed;
+    totals.aborted += aborted;
+    totals.bad += bad;
+    totals.retries += retries;
+    totals.server_latency_us += server_latency_us;
+}
+
+static double PercentileOf(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1));
+    return sorted[idx];
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            config.socket_path = argv[++i];
+        } else if (arg == "--shm" && i + 1 < argc) {
+            config.shm_name = argv[++i];
+        } else if (arg == "--connections" && i + 1 < argc) {
+            config.connections = std::stoi(argv[++i]);
+        } else if (arg == "--requests" && i + 1 < argc) {
+            config.requests = std::stoi(argv[++i]);
+        } else if (arg == "--pipeline" && i + 1 < argc) {
+            config.pipeline = std::stoi(argv[++i]);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            config.batch = std::stoi(argv[++i]);
+        } else if (arg == "--template" && i + 1 < argc) {
+            config.template_id = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--ops-keys" && i + 1 < argc) {
+            config.ops_keys = std::stoi(argv[++i]);
+        } else if (arg == "--ops-per-txn" && i + 1 < argc) {
+            config.ops_per_txn = std::stoi(argv[++i]);
+        } else if (arg == "--help") {
+            std::cout
+                << "Usage: load_client --socket PATH | --shm NAME [options]\n"
+                << "  --socket PATH        Server socket (transaction_system --serve PATH)\n"
+                << "  --shm NAME           Shared-memory region (transaction_system --shm NAME)\n"
+                << "  --connections N      Client connections, one thread each (default: 4)\n"
+                << "  --requests N         Requests per connection (default: 10000)\n"
+                << "  --pipeline D         Max in-flight requests per connection (default: 1)\n"
+                << "  --batch B            Requests sent per write (default: 1)\n"
+                << "  --template ID        Template index to run (default: server's weighted mix)\n"
+                << "  --ops-keys N         Send explicit read/write ops over N keys instead\n"
+                << "  --ops-per-txn K      Keys read and rewritten per ops request (default: 2)\n";
+            return 0;
+        }
+    }
+    if (config.socket_path.empty() == config.shm_name.empty()) {
+        std::cerr << "Give exactly one of --socket and --shm\n";
+        return 1;
+    }
+    if (config.connections < 1 || config.requests < 1 || config.pipeline < 1
+        || config.batch < 1 || config.ops_keys < 0 || config.ops_per_txn < 1) {
+        std::cerr << "connections, requests, pipeline, batch and ops-per-txn must be >= 1\n";
+        return 1;
+    }
+    config.batch = std::min(config.batch, config.pipeline);
+
+    LoadTotals totals;
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < config.connections; t++) {
+        threads.emplace_back(config.shm_name.empty() ? RunConnection<TxnClient>
+                                                     : RunConnection<ShmTxnClient>,
+                             std::cref(config), t, std::ref(totals));
+    }
+    for (auto& t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    auto& lat = totals.latencies_us;
+    std::sort(lat.begin(), lat.end());
+    uint64_t responses = totals.committed + totals.aborted + totals.bad;
+    double mean = 0.0;
+    for (double v : lat) mean += v;
+    if (!lat.empty()) mean /= lat.size();
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Transport:          " << (config.shm_name.empty() ? "socket" : "shared memory")
+              << "\n"
+              << "Connections:        " << config.connections << " (pipeline " << config.pipeline
+              << ", batch " << config.batch << ")\n"
+              << "Responses:          " << responses << " (" << totals.committed << " committed, "
+              << totals.aborted << " aborted, " << totals.bad << " bad)\n"
+              << "Elapsed:            " << elapsed << " s\n"
+              << "Throughput:         " << (elapsed > 0 ? totals.committed / elapsed : 0.0)
+              << " txn/s\n"
+              << "Client latency:     mean " << mean << " us, p50 " << PercentileOf(lat, 50)
+              << " us, p99 " << PercentileOf(lat, 99) << " us, p99.9 "
+              << PercentileOf(lat, 99.9) << " us\n"
+              << "Server latency:     mean "
+              << (responses > 0 ? totals.server_latency_us / responses : 0.0) << " us\n"
+              << "Retries/response:   "
+              << (responses > 0 ? static_cast<double>(totals.retries) / responses : 0.0) << "\n";
+    return totals.failed ? 1 : 0;
+}
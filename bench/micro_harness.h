@@ -0,0 +1,149 @@
+#ifndef MICRO_HARNESS_H
+#define MICRO_HARNESS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace txn {
+namespace bench {
+
+// Body of a benchmark: run `iterations` operations on behalf of thread `thread_idx`.
+using BenchBody = std::function<void(int thread_idx, uint64_t iterations)>;
+
+struct BenchResult {
+    std::string name;
+    std::string params;   // "key=value;key=value"
+    int threads;
+    uint64_t iterations;  // per thread
+    double ns_per_op;     // wall time * threads / total ops
+    double ops_per_s;     // total ops / wall time
+};
+
+// Minimal microbenchmark harness. Each case is calibrated by doubling the
+// per-thread iteration count until one timed run lasts at least min_time_ms,
+// then reported as one CSV row or JSON line on stdout.
+class MicroHarness {
+public:
+    MicroHarness(int argc, char* argv[]) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) {
+                filter_ = argv[++i];
+            } else if (arg == "--format" && i + 1 < argc) {
+                json_ = std::string(argv[++i]) == "json";
+            } else if (arg == "--min-time-ms" && i + 1 < argc) {
+                min_time_ms_ = std::stod(argv[++i]);
+            } else if (arg == "--threads" && i + 1 < argc) {
+                threads_ = ParseIntList(argv[++i]);
+            } else if (arg == "--help") {
+                std::cout
+                    << "Usage: bench_micro [options]\n"
+                    << "  --filter SUBSTR     Only run benchmarks whose name contains SUBSTR\n"
+                    << "  --format csv|json   Output format (default: csv)\n"
+                    << "  --min-time-ms MS    Minimum timed duration per case (default: 200)\n"
+                    << "  --threads LIST      Comma-separated thread counts (default: 1,2,4,8)\n";
+                std::exit(0);
+            }
+        }
+        if (!json_) {
+            std::cout << "benchmark,params,threads,iterations,ns_per_op,ops_per_s\n";
+        }
+    }
+
+    const std::vector<int>& ThreadCounts() const { return threads_; }
+
+    bool Enabled(const std::string& name) const {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    void Run(const std::string& name, const std::string& params, int threads,
+             const BenchBody& body) {
+        if (!Enabled(name)) return;
+
+        uint64_t iterations = 1;
+        double elapsed_s = 0.0;
+        while (true) {
+            elapsed_s = TimeOnce(threads, iterations, body);
+            if (elapsed_s * 1000.0 >= min_time_ms_ || iterations >= (1ULL << 40)) break;
+            // Jump close to the target once the timing is meaningful
+            double scale = elapsed_s > 1e-4 ? (min_time_ms_ / 1000.0) / elapsed_s * 1.2 : 10.0;
+            iterations = std::max(iterations * 2,
+                                  static_cast<uint64_t>(iterations * std::min(scale, 100.0)));
+        }
+
+        double total_ops = static_cast<double>(iterations) * threads;
+        Emit({name, params, threads, iterations,
+              elapsed_s * 1e9 * threads / total_ops, total_ops / elapsed_s});
+    }
+
+private:
+    static std::vector<int> ParseIntList(const std::string& s) {
+        std::vector<int> out;
+        size_t pos = 0;
+        while (pos < s.size()) {
+            size_t comma = s.find(',', pos);
+            if (comma == std::string::npos) comma = s.size();
+            out.push_back(std::stoi(s.substr(pos, comma - pos)));
+            pos = comma + 1;
+        }
+        return out;
+    }
+
+    static double TimeOnce(int threads, uint64_t iterations, const BenchBody& body) {
+        if (threads == 1) {
+            auto start = std::chrono::steady_clock::now();
+            body(0, iterations);
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Start all threads together so the timed region covers only the work
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back([&, t]() {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                body(t, iterations);
+            });
+        }
+        while (ready.load() < threads) std::this_thread::yield();
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& th : pool) th.join();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Emit(const BenchResult& r) const {
+        std::cout << std::fixed << std::setprecision(2);
+        if (json_) {
+            std::cout << "{\"benchmark\":\"" << r.name << "\",\"params\":\"" << r.params
+                      << "\",\"threads\":" << r.threads << ",\"iterations\":" << r.iterations
+                      << ",\"ns_per_op\":" << r.ns_per_op << ",\"ops_per_s\":" << r.ops_per_s
+                      << "}\n";
+        } else {
+            std::cout << r.name << "," << r.params << "," << r.threads << ","
+                      << r.iterations << "," << r.ns_per_op << "," << r.ops_per_s << "\n";
+        }
+        std::cout.flush();
+    }
+
+    std::string filter_;
+    bool json_ = false;
+    double min_time_ms_ = 200.0;
+    std::vector<int> threads_ = {1, 2, 4, 8};
+};
+
+} // namespace bench
+} // namespace txn
+
+#endif // MICRO_HARNESS_H
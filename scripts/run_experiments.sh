@@ -19,6 +19,7 @@ BIN="${BUILD_DIR}/transaction_system"
 RESULTS_DIR="results"
 CSV="${RESULTS_DIR}/results.csv"
 LATENCY_CSV="${RESULTS_DIR}/latency_samples.csv"
+RUNS_JSONL="${RESULTS_DIR}/runs.jsonl"
 
 # Sanity check
 if [[ ! -x "${BIN}" ]]; then
@@ -29,7 +30,7 @@ fi
 
 mkdir -p "${RESULTS_DIR}"
 # Remove stale CSV so headers are written fresh
-rm -f "${CSV}" "${LATENCY_CSV}"
+rm -f "${CSV}" "${LATENCY_CSV}" "${RUNS_JSONL}"
 
 WORKLOADS=(1 2)
 PROTOCOLS=(occ 2pl)
@@ -69,6 +70,7 @@ for W in "${WORKLOADS[@]}"; do
             --hotset-prob      "${H}"
             --db-path          "${DB_PATH}"
             --csv-output       "${CSV}"
+            --record           "${RUNS_JSONL}"
         )
 
         # Add latency dump for the representative run
@@ -92,3 +94,4 @@ echo ""
 echo "All ${total_runs} runs complete."
 echo "Results:          ${CSV}"
 echo "Latency samples:  ${LATENCY_CSV}"
+echo "Run records:      ${RUNS_JSONL}"
@@ -0,0 +1,308 @@
+#include "cluster/cluster_manager.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <thread>
+
+namespace txn {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Result of one call to a partition. Local calls have already run; remote
+// ones complete when the reply arrives, one latency after the handler ran.
+template <typename R>
+class PendingCall {
+public:
+    explicit PendingCall(R value) : value_(std::move(value)) {}
+    PendingCall(std::future<std::pair<R, Clock::time_point>> reply, Clock::duration latency)
+        : reply_(std::move(reply)), latency_(latency) {}
+
+    R Get() {
+        if (reply_.valid()) {
+            auto [value, done] = reply_.get();
+            std::this_thread::sleep_until(done + latency_);
+            value_ = std::move(value);
+        }
+        return value_;
+    }
+
+private:
+    R value_{};
+    std::future<std::pair<R, Clock::time_point>> reply_;
+    Clock::duration latency_{};
+};
+
+// Runs fn on target: directly if it is the coordinator's home partition,
+// otherwise as a message delivered after the latency.
+template <typename R>
+PendingCall<R> Call(Partition& target, const Transaction& txn, Clock::duration latency,
+                    bool may_block, std::atomic<uint64_t>& messages, std::function<R()> fn) {
+    if (target.Id() == txn.home_partition) return PendingCall<R>(fn());
+
+    auto promise = std::make_shared<std::promise<std::pair<R, Clock::time_point>>>();
+    auto reply = promise->get_future();
+    ClusterMessage message;
+    message.deliver_at = Clock::now() + latency;
+    message.may_block = may_block;
+    message.run = [promise, fn = std::move(fn)]() {
+        R value = fn();
+        promise->set_value({std::move(value), Clock::now()});
+    };
+    messages += 2;
+    target.Post(std::move(message));
+    return PendingCall<R>(std::move(reply), latency);
+}
+
+} // anonymous namespace
+
+ClusterManager::ClusterManager(const ClusterConfig& config)
+    : config_(config), partitioner_(config.placement) {}
+
+ClusterManager::~ClusterManager() {
+    Close();
+}
+
+bool ClusterManager::Open() {
+    if (config_.placement.num_partitions < 1 || config_.handlers_per_partition < 2
+        || config_.latency_us < 0) {
+        std::cerr << "A cluster needs >= 1 partition, >= 2 handlers each and latency >= 0\n";
+        return false;
+    }
+    for (int i = 0; i < config_.placement.num_partitions; i++) {
+        auto partition = std::make_unique<Partition>(i, config_.handlers_per_partition);
+        if (!partition->Open(config_.db_path + "_p" + std::to_string(i), config_.protocol)) {
+            partitions_.clear();
+            return false;
+        }
+        partitions_.push_back(std::move(partition));
+    }
+    for (auto& partition : partitions_) partition->Start();
+    return true;
+}
+
+void ClusterManager::Close() {
+    for (auto& partition : partitions_) partition->Stop();
+    for (auto& partition : partitions_) partition->Close();
+}
+
+bool ClusterManager::Load(const std::map<std::string, std::string>& data) {
+    std::vector<std::map<std::string, std::string>> per_partition(partitions_.size());
+    for (const auto& [key, value] : data) {
+        per_partition[PartitionOf(key)].emplace(key, value);
+    }
+    bool ok = true;
+    for (size_t i = 0; i < partitions_.size(); i++) {
+        ok = partitions_[i]->Db().InitializeWithData(per_partition[i]) && ok;
+    }
+    return ok;
+}
+
+std::optional<std::string> ClusterManager::Get(const std::string& key) {
+    return partitions_[PartitionOf(key)]->Db().Get(key);
+}
+
+void ClusterManager::Join(Transaction& txn, int p) {
+    if (txn.home_partition < 0) txn.home_partition = p;
+    if (std::find(txn.partitions.begin(), txn.partitions.end(), p) == txn.partitions.end()) {
+        txn.partitions.push_back(p);
+    }
+}
+
+WriteList ClusterManager::WritesFor(const Transaction& txn, int p) const {
+    WriteList writes;
+    for (const auto& [key, value] : txn.write_set) {
+        if (PartitionOf(key) == p) writes.emplace_back(key, value);
+    }
+    return writes;
+}
+
+void ClusterManager::Finish(Transaction& txn, TxnStatus status) {
+    txn.status = status;
+    if (status == TxnStatus::ABORTED) {
+        txn.read_set.clear();
+        txn.write_set.clear();
+    }
+}
+
+Transaction ClusterManager::Begin(const std::string& type_name,
+                                  const std::vector<std::string>& keys) {
+    Transaction txn;
+    txn.txn_id = ++gid_counter_;
+    txn.type_name = type_name;
+    txn.start_ts = 0;
+    txn.status = TxnStatus::ACTIVE;
+    txn.wall_start = Clock::now();
+    if (!keys.empty()) txn.home_partition = PartitionOf(keys[0]);
+
+    // Ascending partition order, so lock waits cannot form a cycle
+    std::map<int, std::vector<std::string>> by_partition;
+    for (const auto& key : keys) by_partition[PartitionOf(key)].push_back(key);
+    auto latency = std::chrono::microseconds(config_.latency_us);
+    for (const auto& [p, partition_keys] : by_partition) {
+        Join(txn, p);
+        Partition& target = *partitions_[p];
+        uint64_t gid = txn.txn_id;
+        txn.retry_count += Call<int>(target, txn, latency, true, messages_,
+            [&target, gid, type_name, partition_keys]() {
+                return target.BeginBranch(gid, type_name, partition_keys);
+            }).Get();
+    }
+    return txn;
+}
+
+std::optional<std::string> ClusterManager::Read(Transaction& txn, const std::string& key) {
+    // Read-your-writes: buffered writes are not shipped until commit
+    auto it = txn.write_set.find(key);
+    if (it != txn.write_set.end()) return it->second;
+
+    int p = PartitionOf(key);
+    Join(txn, p);
+    Partition& target = *partitions_[p];
+    uint64_t gid = txn.txn_id;
+    std::string type_name = txn.type_name;
+    return Call<std::optional<std::string>>(target, txn, std::chrono::microseconds(config_.latency_us),
+                                            false, messages_,
+        [&target, gid, type_name, key]() { return target.Read(gid, type_name, key); }).Get();
+}
+
+void ClusterManager::Write(Transaction& txn, const std::string& key, const std::string& value) {
+    Join(txn, PartitionOf(key));
+    txn.write_set[key] = value;
+}
+
+CommitResult ClusterManager::Commit(Transaction& txn) {
+    auto latency = std::chrono::microseconds(config_.latency_us);
+    uint64_t gid = txn.txn_id;
+    std::string type_name = txn.type_name;
+
+    if (txn.partitions.size() <= 1) {
+        bool ok = true;
+        if (!txn.partitions.empty()) {
+            Partition& target = *partitions_[txn.partitions[0]];
+            WriteList writes = WritesFor(txn, target.Id());
+            ok = Call<bool>(target, txn, latency, false, messages_,
+                [&target, gid, type_name, writes]() {
+                    return target.Commit(gid, type_name, writes);
+                }).Get();
+        }
+        if (ok) single_partition_commits_++;
+        Finish(txn, ok ? TxnStatus::COMMITTED : TxnStatus::ABORTED);
+        return {ok, gid, txn.retry_count, txn.conflict_key};
+    }
+
+    // Remote participants first so their messages are in flight while the
+    // home partition runs its part directly
+    std::vector<int> order = txn.partitions;
+    std::stable_partition(order.begin(), order.end(),
+                          [&txn](int p) { return p != txn.home_partition; });
+
+    // Phase 1: prepare everywhere at once
+    std::vector<PendingCall<bool>> votes;
+    for (int p : order) {
+        Partition& target = *partitions_[p];
+        WriteList writes = WritesFor(txn, p);
+        votes.push_back(Call<bool>(target, txn, latency, false, messages_,
+            [&target, gid, type_name, writes]() {
+                return target.Prepare(gid, type_name, writes);
+            }));
+    }
+    std::vector<int> prepared;
+    for (size_t i = 0; i < votes.size(); i++) {
+        if (votes[i].Get()) prepared.push_back(order[i]);
+    }
+    bool commit = prepared.size() == order.size();
+
+    // Phase 2: the decision goes to every participant that voted yes
+    std::vector<PendingCall<bool>> acks;
+    for (int p : prepared) {
+        Partition& target = *partitions_[p];
+        acks.push_back(Call<bool>(target, txn, latency, false, messages_,
+            [&target, gid, type_name, commit]() {
+                if (commit) return target.Commit(gid, type_name, {});
+                target.Abort(gid);
+                return true;
+            }));
+    }
+    for (auto& ack : acks) ack.Get();
+
+    if (commit) {
+        distributed_commits_++;
+    } else {
+        distributed_aborts_++;
+    }
+    Finish(txn, commit ? TxnStatus::COMMITTED : TxnStatus::ABORTED);
+    return {commit, gid, txn.retry_count, txn.conflict_key};
+}
+
+void ClusterManager::Abort(Transaction& txn) {
+    auto latency = std::chrono::microseconds(config_.latency_us);
+    uint64_t gid = txn.txn_id;
+    std::vector<PendingCall<bool>> acks;
+    for (int p : txn.partitions) {
+        Partition& target = *partitions_[p];
+        acks.push_back(Call<bool>(target, txn, latency, false, messages_,
+            [&target, gid]() {
+                target.Abort(gid);
+                return true;
+            }));
+    }
+    for (auto& ack : acks) ack.Get();
+    Finish(txn, TxnStatus::ABORTED);
+}
+
+bool ClusterManager::Prepare(Transaction& txn) {
+    Abort(txn);
+    return false;
+}
+
+std::string ClusterManager::ProtocolName() const {
+    std::string name = config_.protocol;
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return std::toupper(c); });
+    return name + " x" + std::to_string(partitions_.size()) + " partitions";
+}
+
+std::vector<std::pair<std::string, size_t>> ClusterManager::StructureSizes() {
+    std::vector<std::pair<std::string, size_t>> totals;
+    size_t branches = 0;
+    for (auto& partition : partitions_) {
+        for (const auto& [name, size] : partition->Manager().StructureSizes()) {
+            auto it = std::find_if(totals.begin(), totals.end(),
+                                   [&name](const auto& entry) { return entry.first == name; });
+            if (it == totals.end()) {
+                totals.emplace_back(name, size);
+            } else {
+                it->second += size;
+            }
+        }
+        branches += partition->OpenBranches();
+    }
+    totals.emplace_back("open_branches", branches);
+    return totals;
+}
+
+void ClusterManager::Declare(const std::string& type_name, const AccessSet& access) {
+    TransactionManager::Declare(type_name, access);
+    for (auto& partition : partitions_) partition->Manager().Declare(type_name, access);
+}
+
+void ClusterManager::SetIsolation(const std::string& type_name, IsolationLevel level) {
+    TransactionManager::SetIsolation(type_name, level);
+    for (auto& partition : partitions_) partition->Manager().SetIsolation(type_name, level);
+}
+
+ClusterStats ClusterManager::Stats() const {
+    ClusterStats stats;
+    stats.single_partition_commits = single_partition_commits_.load();
+    stats.distributed_commits      = distributed_commits_.load();
+    stats.distributed_aborts       = distributed_aborts_.load();
+    stats.messages                 = messages_.load();
+    return stats;
+}
+
+} // namespace txn
@@ -0,0 +1,96 @@
+#ifndef CLUSTER_MANAGER_H
+#define CLUSTER_MANAGER_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "cluster/partition.h"
+#include "cluster/partitioner.h"
+#include "concurrency/transaction_manager.h"
+
+namespace txn {
+
+struct ClusterConfig {
+    PartitionConfig placement;
+    std::string protocol        = "occ";
+    int handlers_per_partition  = 4;     // >= 2
+    int latency_us              = 100;   // injected one-way delay per message
+    std::string db_path         = "db_cluster";  // partition i uses db_path + "_p<i>"
+};
+
+struct ClusterStats {
+    uint64_t single_partition_commits = 0;
+    uint64_t distributed_commits      = 0;  // committed through 2PC
+    uint64_t distributed_aborts       = 0;  // a participant voted no
+    uint64_t messages                 = 0;  // one per request and one per reply
+};
+
+// Runs N partitions in one process behind the TransactionManager interface,
+// so the executor and templates work unchanged. The calling thread acts as
+// coordinator at the partition of the transaction's first key: calls to that
+// partition are direct, all others are messages delayed by latency_us each
+// way.
+//
+// Begin starts a branch on every partition owning a declared key, in
+// partition order so that 2PL lock waits cannot form a cycle across
+// partitions. Undeclared keys add branches as they are touched. Writes are
+// buffered at the coordinator and shipped at commit: a transaction with one
+// branch commits in one round trip, otherwise through two-phase commit
+// (parallel prepares, then commits or aborts).
+class ClusterManager : public TransactionManager {
+public:
+    explicit ClusterManager(const ClusterConfig& config);
+    ~ClusterManager() override;
+
+    // Opens every partition's database and starts its handlers.
+    bool Open();
+    void Close();
+
+    // Stores each record on its partition.
+    bool Load(const std::map<std::string, std::string>& data);
+    // Direct read outside any transaction, e.g. for invariant checks.
+    std::optional<std::string> Get(const std::string& key);
+
+    Transaction Begin(const std::string& type_name,
+                      const std::vector<std::string>& keys = {}) override;
+    std::optional<std::string> Read(Transaction& txn, const std::string& key) override;
+    void Write(Transaction& txn, const std::string& key, const std::string& value) override;
+    CommitResult Commit(Transaction& txn) override;
+    void Abort(Transaction& txn) override;
+    // Cluster transactions are not nested in a larger two-phase commit
+    bool Prepare(Transaction& txn) override;
+    std::string ProtocolName() const override;
+    std::vector<std::pair<std::string, size_t>> StructureSizes() override;
+    // Also declared to every partition's manager, for the branches; call after Open
+    void Declare(const std::string& type_name, const AccessSet& access) override;
+    // Also set on every partition's manager, whose branches run at the level; call after Open
+    void SetIsolation(const std::string& type_name, IsolationLevel level) override;
+
+    int PartitionOf(const std::string& key) const { return partitioner_.PartitionOf(key); }
+    int NumPartitions() const { return partitioner_.NumPartitions(); }
+    Partition& PartitionAt(int idx) { return *partitions_[idx]; }
+    ClusterStats Stats() const;
+
+private:
+    // Adds p to txn's participants; the first one becomes the home partition
+    void Join(Transaction& txn, int p);
+    WriteList WritesFor(const Transaction& txn, int p) const;
+    void Finish(Transaction& txn, TxnStatus status);
+
+    ClusterConfig config_;
+    Partitioner partitioner_;
+    std::vector<std::unique_ptr<Partition>> partitions_;
+    std::atomic<uint64_t> gid_counter_{0};
+
+    std::atomic<uint64_t> single_partition_commits_{0};
+    std::atomic<uint64_t> distributed_commits_{0};
+    std::atomic<uint64_t> distributed_aborts_{0};
+    std::atomic<uint64_t> messages_{0};
+};
+
+} // namespace txn
+
+#endif // CLUSTER_MANAGER_H
@@ -0,0 +1,94 @@
+#include "cluster/cluster_runner.h"
+#include "workload/input_parser.h"
+#include "workload/record.h"
+#include "workload/workload_executor.h"
+#include "metrics/metrics.h"
+#include <iomanip>
+#include <iostream>
+
+namespace txn {
+
+int RunCluster(const ClusterRunConfig& config) {
+    ParseResult parsed = config.input_file.empty()
+                       ? LoadWorkloadInput(config.workload, config.workload_options)
+                       : ParseInputFile(config.input_file);
+    auto templates = BuildWorkloadTemplates(config.workload, parsed, config.hotset_size,
+                                            config.hotset_prob, config.workload_options);
+    if (templates.empty()) {
+        std::cerr << "Unknown workload: " << config.workload << "\n";
+        return 1;
+    }
+
+    ClusterManager cluster(config.cluster);
+    if (!cluster.Open()) return 1;
+    cluster.Load(parsed.initial_data);
+
+    const PartitionConfig& placement = config.cluster.placement;
+    std::cout << "Cluster:         " << placement.num_partitions << " partitions ("
+              << (placement.scheme == PartitionScheme::kHash ? "hash" : "warehouse")
+              << " placement";
+    if (placement.scheme == PartitionScheme::kWarehouse && placement.customer_offset != 0) {
+        std::cout << ", customers " << placement.customer_offset << " partition(s) over";
+    }
+    std::cout << "), " << config.cluster.handlers_per_partition << " handlers each, "
+              << config.cluster.latency_us << " us one-way latency\n";
+    for (int p = 0; p < cluster.NumPartitions(); p++) {
+        std::cout << "  Partition " << p << ":     "
+                  << cluster.PartitionAt(p).Db().GetKeyCount() << " records\n";
+    }
+    std::cout << "Loaded " << parsed.initial_data.size() << " records\n";
+
+    ExecutorConfig exec_config;
+    exec_config.num_threads     = config.threads;
+    exec_config.txns_per_thread = config.txns_per_thread;
+    exec_config.contention      = {static_cast<int>(parsed.initial_data.size()),
+                                   config.hotset_size, config.hotset_prob};
+    exec_config.templates       = templates;
+
+    MetricsCollector metrics;
+    WorkloadExecutor executor(cluster, metrics, exec_config);
+    std::cout << "Running workload...\n";
+    executor.Run();
+    double elapsed = executor.ElapsedSeconds();
+    metrics.PrintReport(elapsed);
+
+    ClusterStats stats = cluster.Stats();
+    uint64_t commits = stats.single_partition_commits + stats.distributed_commits;
+    uint64_t attempts = stats.distributed_commits + stats.distributed_aborts;
+    std::cout << std::fixed << std::setprecision(1)
+              << "\nCluster:\n"
+              << "  Single-partition:  " << stats.single_partition_commits << " commits\n"
+              << "  Distributed (2PC): " << stats.distributed_commits << " commits ("
+              << (commits > 0 ? 100.0 * stats.distributed_commits / commits : 0.0)
+              << "% of commits), " << stats.distributed_aborts << " aborted at prepare ("
+              << (attempts > 0 ? 100.0 * stats.distributed_aborts / attempts : 0.0) << "%)\n"
+              << "  Messages:          " << stats.messages << " ("
+              << (commits > 0 ? static_cast<double>(stats.messages) / commits : 0.0)
+              << " per commit)\n";
+
+    // Workload 1: verify zero-sum balance conservation across partitions
+    if (config.workload == "1") {
+        long long initial_total = 0;
+        long long final_total   = 0;
+        for (const auto& key : parsed.account_keys) {
+            auto it = parsed.initial_data.find(key);
+            if (it != parsed.initial_data.end()) {
+                initial_total += GetIntField(DeserializeRecord(it->second), "balance");
+            }
+            auto val = cluster.Get(key);
+            if (val.has_value()) {
+                final_total += GetIntField(DeserializeRecord(val.value()), "balance");
+            }
+        }
+        std::cout << "\nBalance conservation check:\n"
+                  << "  Initial total:  " << initial_total << "\n"
+                  << "  Final total:    " << final_total   << "\n"
+                  << "  Difference:     " << (final_total - initial_total)
+                  << " (should be 0)\n";
+    }
+
+    cluster.Close();
+    return 0;
+}
+
+} // namespace txn
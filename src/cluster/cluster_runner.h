@@ -0,0 +1,29 @@
+#ifndef CLUSTER_RUNNER_H
+#define CLUSTER_RUNNER_H
+
+#include <string>
+#include "cluster/cluster_manager.h"
+#include "workload/workload_builder.h"
+
+namespace txn {
+
+struct ClusterRunConfig {
+    std::string workload   = "1";
+    std::string input_file = "";    // empty: the workload's default or generated data
+    int threads            = 4;     // coordinator threads, shared by all partitions
+    int txns_per_thread    = 100;
+    int hotset_size        = 10;
+    double hotset_prob     = 0.5;
+    WorkloadOptions workload_options;
+    ClusterConfig cluster;
+};
+
+// Loads the workload into a ClusterManager, runs the executor over it and
+// reports the usual metrics plus the single-partition / 2PC split and the
+// message count. Workload 1 also gets the balance conservation check.
+// Returns 0 on success, 1 on setup errors.
+int RunCluster(const ClusterRunConfig& config);
+
+} // namespace txn
+
+#endif // CLUSTER_RUNNER_H
@@ -0,0 +1,153 @@
+#include "cluster/partition.h"
+#include "concurrency/manager_factory.h"
+#include <filesystem>
+#include <iostream>
+
+namespace txn {
+
+Partition::Partition(int id, int num_handlers) : id_(id), num_handlers_(num_handlers) {}
+
+Partition::~Partition() {
+    Stop();
+    Close();
+}
+
+bool Partition::Open(const std::string& db_path, const std::string& protocol) {
+    std::filesystem::remove_all(db_path);
+    if (!db_.Open(db_path)) {
+        std::cerr << "Failed to open partition " << id_ << " database: " << db_path << "\n";
+        return false;
+    }
+    mgr_ = MakeTransactionManager(protocol, db_);
+    if (!mgr_) {
+        std::cerr << "Unknown protocol: " << protocol << "\n";
+        db_.Close();
+        return false;
+    }
+    return true;
+}
+
+void Partition::Close() {
+    mgr_.reset();
+    if (db_.IsOpen()) db_.Close();
+}
+
+void Partition::Start() {
+    stopping_ = false;
+    for (int i = 0; i < num_handlers_; i++) {
+        handlers_.emplace_back(&Partition::HandlerLoop, this);
+    }
+}
+
+void Partition::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        stopping_ = true;
+    }
+    inbox_cv_.notify_all();
+    for (auto& t : handlers_) t.join();
+    handlers_.clear();
+}
+
+void Partition::Post(ClusterMessage&& message) {
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        inbox_.push_back(std::move(message));
+    }
+    inbox_cv_.notify_one();
+}
+
+void Partition::HandlerLoop() {
+    std::unique_lock<std::mutex> lock(inbox_mutex_);
+    while (true) {
+        // First message this handler may take; blocking ones only while
+        // another handler stays free for the rest
+        auto it = inbox_.begin();
+        while (it != inbox_.end() && it->may_block && blocking_ + 1 >= num_handlers_) ++it;
+        if (it == inbox_.end()) {
+            if (stopping_ && inbox_.empty()) return;
+            inbox_cv_.wait(lock);
+            continue;
+        }
+        // Latency is the same for every message, so the inbox is in delivery order
+        auto deliver_at = it->deliver_at;
+        if (deliver_at > std::chrono::steady_clock::now()) {
+            inbox_cv_.wait_until(lock, deliver_at);
+            continue;
+        }
+
+        ClusterMessage message = std::move(*it);
+        inbox_.erase(it);
+        if (message.may_block) blocking_++;
+        lock.unlock();
+        message.run();
+        lock.lock();
+        if (message.may_block) {
+            blocking_--;
+            inbox_cv_.notify_all();
+        }
+    }
+}
+
+Transaction& Partition::Branch(uint64_t gid, const std::string& type_name) {
+    {
+        std::lock_guard<std::mutex> lock(branches_mutex_);
+        auto it = branches_.find(gid);
+        if (it != branches_.end()) return it->second;
+    }
+    Transaction branch = mgr_->Begin(type_name);
+    std::lock_guard<std::mutex> lock(branches_mutex_);
+    return branches_.emplace(gid, std::move(branch)).first->second;
+}
+
+std::optional<Transaction> Partition::TakeBranch(uint64_t gid) {
+    std::lock_guard<std::mutex> lock(branches_mutex_);
+    auto it = branches_.find(gid);
+    if (it == branches_.end()) return std::nullopt;
+    Transaction branch = std::move(it->second);
+    branches_.erase(it);
+    return branch;
+}
+
+int Partition::BeginBranch(uint64_t gid, const std::string& type_name,
+                           const std::vector<std::string>& keys) {
+    Transaction branch = mgr_->Begin(type_name, keys);
+    int retries = branch.retry_count;
+    std::lock_guard<std::mutex> lock(branches_mutex_);
+    branches_.emplace(gid, std::move(branch));
+    return retries;
+}
+
+std::optional<std::string> Partition::Read(uint64_t gid, const std::string& type_name,
+                                           const std::string& key) {
+    return mgr_->Read(Branch(gid, type_name), key);
+}
+
+bool Partition::Prepare(uint64_t gid, const std::string& type_name, const WriteList& writes) {
+    Transaction& branch = Branch(gid, type_name);
+    for (const auto& [key, value] : writes) mgr_->Write(branch, key, value);
+    if (mgr_->Prepare(branch)) return true;
+    TakeBranch(gid);  // aborted by the manager
+    return false;
+}
+
+bool Partition::Commit(uint64_t gid, const std::string& type_name, const WriteList& writes) {
+    Branch(gid, type_name);
+    Transaction branch = std::move(*TakeBranch(gid));
+    if (branch.status != TxnStatus::PREPARED) {
+        for (const auto& [key, value] : writes) mgr_->Write(branch, key, value);
+    }
+    return mgr_->Commit(branch).success;
+}
+
+void Partition::Abort(uint64_t gid) {
+    auto branch = TakeBranch(gid);
+    if (branch) mgr_->Abort(*branch);
+}
+
+size_t Partition::OpenBranches() {
+    std::lock_guard<std::mutex> lock(branches_mutex_);
+    return branches_.size();
+}
+
+} // namespace txn
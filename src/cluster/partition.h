@@ -0,0 +1,97 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "concurrency/transaction_manager.h"
+#include "database/database.h"
+
+namespace txn {
+
+using WriteList = std::vector<std::pair<std::string, std::string>>;
+
+// A request from another partition's coordinator. Handlers run it once
+// deliver_at has passed.
+struct ClusterMessage {
+    std::chrono::steady_clock::time_point deliver_at;
+    bool may_block = false;  // may wait for locks (2PL Begin with keys)
+    std::function<void()> run;
+};
+
+// One engine partition: its own database, transaction manager and handler
+// threads draining an inbox of messages. Each global transaction has at most
+// one branch here, keyed by its global id. The branch operations are called
+// directly by coordinators at this partition and from messages otherwise.
+//
+// Handlers never all wait for locks at once: one is always left for
+// non-blocking messages (reads, prepares, commits, aborts), so the
+// transactions holding those locks can finish.
+class Partition {
+public:
+    Partition(int id, int num_handlers);
+    ~Partition();
+    Partition(const Partition&) = delete;
+    Partition& operator=(const Partition&) = delete;
+
+    // Opens a fresh database at db_path with a manager for protocol.
+    bool Open(const std::string& db_path, const std::string& protocol);
+    void Close();
+
+    void Start();
+    // Runs every queued message, then joins the handlers.
+    void Stop();
+    void Post(ClusterMessage&& message);
+
+    // Begins the branch, declaring keys (2PL locks them, possibly waiting).
+    // Returns the lock retries.
+    int BeginBranch(uint64_t gid, const std::string& type_name,
+                    const std::vector<std::string>& keys);
+    // Reads and Prepare/Commit begin the branch without keys if needed.
+    std::optional<std::string> Read(uint64_t gid, const std::string& type_name,
+                                    const std::string& key);
+    // Applies writes, then votes; a no vote ends the branch.
+    bool Prepare(uint64_t gid, const std::string& type_name, const WriteList& writes);
+    // Commits a prepared branch, or applies writes and commits in one phase.
+    bool Commit(uint64_t gid, const std::string& type_name, const WriteList& writes);
+    void Abort(uint64_t gid);
+
+    int Id() const { return id_; }
+    Database& Db() { return db_; }
+    TransactionManager& Manager() { return *mgr_; }
+    size_t OpenBranches();
+
+private:
+    void HandlerLoop();
+    // Returns the branch, beginning it without keys if absent
+    Transaction& Branch(uint64_t gid, const std::string& type_name);
+    std::optional<Transaction> TakeBranch(uint64_t gid);
+
+    int id_;
+    int num_handlers_;
+    Database db_;
+    std::unique_ptr<TransactionManager> mgr_;
+
+    std::mutex branches_mutex_;
+    std::unordered_map<uint64_t, Transaction> branches_;  // references stay valid
+
+    std::mutex inbox_mutex_;
+    std::condition_variable inbox_cv_;
+    std::deque<ClusterMessage> inbox_;
+    int blocking_ = 0;  // handlers inside a may_block message
+    bool stopping_ = false;
+    std::vector<std::thread> handlers_;
+};
+
+} // namespace txn
+
+#endif // PARTITION_H
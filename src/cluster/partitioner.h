@@ -0,0 +1,61 @@
+#ifndef PARTITIONER_H
+#define PARTITIONER_H
+
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+namespace txn {
+
+enum class PartitionScheme {
+    kHash,       // every key by hash
+    kWarehouse,  // TPC-C style keys by warehouse id, everything else by hash
+};
+
+struct PartitionConfig {
+    int num_partitions     = 1;
+    PartitionScheme scheme = PartitionScheme::kWarehouse;
+    // kWarehouse: customer records (C_, CL_, CO_) of warehouse w are placed
+    // with warehouse w + customer_offset, so payments cross partitions
+    int customer_offset    = 0;
+};
+
+// Maps keys to partitions 0..num_partitions-1.
+class Partitioner {
+public:
+    explicit Partitioner(const PartitionConfig& config) : config_(config) {}
+
+    int PartitionOf(const std::string& key) const {
+        if (config_.num_partitions <= 1) return 0;
+        if (config_.scheme == PartitionScheme::kWarehouse) {
+            int offset = 0;
+            int warehouse = WarehouseOf(key, offset);
+            if (warehouse > 0) return (warehouse - 1 + offset) % config_.num_partitions;
+        }
+        return static_cast<int>(std::hash<std::string>{}(key) % config_.num_partitions);
+    }
+
+    int NumPartitions() const { return config_.num_partitions; }
+
+private:
+    // Warehouse id of a workload-2 / TPC-C key ("<table>_<w>_..."), or 0 for
+    // tables without one (items, accounts, YCSB and SmallBank keys).
+    int WarehouseOf(const std::string& key, int& offset) const {
+        size_t sep = key.find('_');
+        if (sep == std::string::npos) return 0;
+        std::string table = key.substr(0, sep);
+        if (table == "C" || table == "CL" || table == "CO") {
+            offset = config_.customer_offset;
+        } else if (table != "W" && table != "D" && table != "S" && table != "O"
+                   && table != "NO" && table != "OL" && table != "DP") {
+            return 0;
+        }
+        return std::atoi(key.c_str() + sep + 1);
+    }
+
+    PartitionConfig config_;
+};
+
+} // namespace txn
+
+#endif // PARTITIONER_H
@@ -0,0 +1,86 @@
+#include "concurrency/commit_history.h"
+#include <algorithm>
+
+namespace txn {
+
+uint64_t CommitHistory::Start(uint64_t first_id, size_t count) {
+    // start_ts is read under active_mutex_ so a concurrent GC either sees
+    // these transactions or computes its horizon from a later one
+    std::lock_guard<std::mutex> lock(active_mutex_);
+    uint64_t start_ts = oracle_.Horizon();
+    for (size_t i = 0; i < count; i++) {
+        active_txns_.emplace(first_id + i, start_ts);
+        active_start_ts_.insert(start_ts);
+    }
+    return start_ts;
+}
+
+void CommitHistory::Finish(uint64_t txn_id) {
+    std::lock_guard<std::mutex> lock(active_mutex_);
+    auto it = active_txns_.find(txn_id);
+    if (it == active_txns_.end()) return;  // already finished, or never started
+    active_start_ts_.erase(active_start_ts_.find(it->second));
+    active_txns_.erase(it);
+}
+
+bool CommitHistory::Validate(Transaction& txn) {
+    const auto& checked = txn.ConflictKeys();
+    if (checked.empty()) return true;
+
+    std::lock_guard<std::mutex> lock(committed_mutex_);
+    for (const auto& record : committed_) {
+        if (record.finish_ts <= txn.start_ts) continue;
+        for (const auto& write_key : record.write_keys) {
+            if (checked.count(write_key)) {
+                txn.conflict_key = write_key;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void CommitHistory::Record(const Transaction& txn) {
+    CommittedTxnRecord record;
+    record.txn_id = txn.txn_id;
+    record.finish_ts = txn.finish_ts;
+    for (const auto& [key, _] : txn.write_set) record.write_keys.insert(key);
+
+    bool collect;
+    {
+        std::lock_guard<std::mutex> lock(committed_mutex_);
+        committed_.push_back(std::move(record));
+        collect = ++records_since_gc_ >= kGcInterval;
+        if (collect) records_since_gc_ = 0;
+    }
+    if (collect) GarbageCollect(MinActiveStartTs());
+}
+
+size_t CommitHistory::HistorySize() {
+    std::lock_guard<std::mutex> lock(committed_mutex_);
+    return committed_.size();
+}
+
+size_t CommitHistory::ActiveCount() {
+    std::lock_guard<std::mutex> lock(active_mutex_);
+    return active_txns_.size();
+}
+
+uint64_t CommitHistory::MinActiveStartTs() {
+    std::lock_guard<std::mutex> lock(active_mutex_);
+    if (active_start_ts_.empty()) return oracle_.Horizon();
+    return *active_start_ts_.begin();
+}
+
+void CommitHistory::GarbageCollect(uint64_t min_active_start_ts) {
+    std::lock_guard<std::mutex> lock(committed_mutex_);
+    committed_.erase(
+        std::remove_if(committed_.begin(), committed_.end(),
+            [min_active_start_ts](const CommittedTxnRecord& r) {
+                return r.finish_ts <= min_active_start_ts;
+            }),
+        committed_.end()
+    );
+}
+
+} // namespace txn
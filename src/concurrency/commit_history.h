@@ -0,0 +1,70 @@
+#ifndef COMMIT_HISTORY_H
+#define COMMIT_HISTORY_H
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "concurrency/timestamp_oracle.h"
+#include "transaction/transaction.h"
+
+namespace txn {
+
+struct CommittedTxnRecord {
+    uint64_t txn_id;
+    uint64_t finish_ts;
+    std::set<std::string> write_keys;
+};
+
+// Backward-validation state of a timestamp-based optimistic protocol: the
+// write keys of recent commits, and the start_ts of every transaction that
+// has begun but not finished. History no active transaction started before
+// can no longer cause a conflict and is pruned every kGcInterval records.
+//
+// Validate only sees records already added, so callers that must not miss a
+// commit (OCCManager, HybridManager) validate and record under a lock of
+// their own.
+class CommitHistory {
+public:
+    explicit CommitHistory(TimestampOracle& oracle) : oracle_(oracle) {}
+
+    // Adds count transactions with consecutive ids from first_id to the
+    // active set and returns their start_ts
+    uint64_t Start(uint64_t first_id, size_t count = 1);
+    // Drops txn_id from the active set; no-op if it is not there
+    void Finish(uint64_t txn_id);
+
+    // False, setting txn.conflict_key, if a commit recorded after txn.start_ts
+    // wrote one of txn's conflict keys (its read set, or below repeatable
+    // read its write set)
+    bool Validate(Transaction& txn);
+    // Records txn's write set at txn.finish_ts
+    void Record(const Transaction& txn);
+
+    size_t HistorySize();
+    size_t ActiveCount();
+
+private:
+    // Committed history is pruned every this many records
+    static constexpr int kGcInterval = 256;
+
+    uint64_t MinActiveStartTs();
+    void GarbageCollect(uint64_t min_active_start_ts);
+
+    TimestampOracle& oracle_;
+
+    std::mutex committed_mutex_;
+    std::vector<CommittedTxnRecord> committed_;
+    int records_since_gc_ = 0;  // guarded by committed_mutex_
+
+    std::mutex active_mutex_;
+    std::unordered_map<uint64_t, uint64_t> active_txns_;  // txn_id -> start_ts
+    std::multiset<uint64_t> active_start_ts_;
+};
+
+} // namespace txn
+
+#endif // COMMIT_HISTORY_H
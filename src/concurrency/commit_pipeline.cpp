@@ -0,0 +1,62 @@
+#include "concurrency/commit_pipeline.h"
+#include <algorithm>
+
+namespace txn {
+
+CommitPipeline::CommitPipeline(GroupCommit commit_group, size_t max_group)
+    : commit_group_(std::move(commit_group)), max_group_(std::max<size_t>(max_group, 1)) {}
+
+CommitPipeline::~CommitPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (committer_.joinable()) committer_.join();
+}
+
+void CommitPipeline::Submit(Transaction txn, CommitCallback done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!committer_.joinable()) committer_ = std::thread(&CommitPipeline::Run, this);
+        queue_.push_back({std::move(txn), std::move(done)});
+    }
+    cv_.notify_one();
+}
+
+uint64_t CommitPipeline::Groups() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return groups_;
+}
+
+uint64_t CommitPipeline::Commits() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return commits_;
+}
+
+void CommitPipeline::Run() {
+    std::vector<Transaction> group;
+    std::vector<CommitCallback> callbacks;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;  // stopping and drained
+            size_t take = std::min(queue_.size(), max_group_);
+            for (size_t i = 0; i < take; i++) {
+                group.push_back(std::move(queue_[i].txn));
+                callbacks.push_back(std::move(queue_[i].done));
+            }
+            queue_.erase(queue_.begin(), queue_.begin() + take);
+            groups_++;
+            commits_ += take;
+        }
+
+        std::vector<CommitResult> results = commit_group_(group);
+        for (size_t i = 0; i < callbacks.size(); i++) callbacks[i](results[i]);
+        group.clear();
+        callbacks.clear();
+    }
+}
+
+} // namespace txn
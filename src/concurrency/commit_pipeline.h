@@ -0,0 +1,62 @@
+#ifndef COMMIT_PIPELINE_H
+#define COMMIT_PIPELINE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "concurrency/transaction_manager.h"
+
+namespace txn {
+
+// One transaction handed to CommitAsync, with its completion callback
+struct PendingCommit {
+    Transaction txn;
+    CommitCallback done;
+};
+
+// Commit stage behind a manager's CommitAsync. Submit only queues the
+// transaction, so the caller moves on to its next one. A committer thread
+// (started on the first Submit) takes everything queued so far as one group
+// and passes it to the manager's CommitBatch, which decides each member in
+// order and applies the survivors' writes in one WriteBatch; the callbacks
+// then run on the committer thread. While one group is validated, written
+// and synced, the next one fills up behind it.
+class CommitPipeline {
+public:
+    // Commits a group; returns one outcome per transaction, in order
+    using GroupCommit = std::function<std::vector<CommitResult>(std::vector<Transaction>& group)>;
+
+    explicit CommitPipeline(GroupCommit commit_group, size_t max_group = 64);
+    // Commits everything still queued, then stops the committer thread
+    ~CommitPipeline();
+
+    CommitPipeline(const CommitPipeline&) = delete;
+    CommitPipeline& operator=(const CommitPipeline&) = delete;
+
+    void Submit(Transaction txn, CommitCallback done);
+
+    // Groups committed and transactions in them, since construction
+    uint64_t Groups();
+    uint64_t Commits();
+
+private:
+    void Run();
+
+    GroupCommit commit_group_;
+    size_t max_group_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<PendingCommit> queue_;  // guarded by mutex_
+    bool stopping_ = false;             // guarded by mutex_
+    uint64_t groups_ = 0;               // guarded by mutex_
+    uint64_t commits_ = 0;              // guarded by mutex_
+    std::thread committer_;
+};
+
+} // namespace txn
+
+#endif // COMMIT_PIPELINE_H
@@ -0,0 +1,177 @@
+#include "concurrency/hybrid_manager.h"
+#include <algorithm>
+#include <chrono>
+
+namespace txn {
+
+HybridManager::HybridManager(Database& db, std::unordered_set<std::string> locking_types,
+                             std::unique_ptr<TimestampOracle> oracle, LockInheritance inheritance)
+    : db_(db),
+      locking_types_(std::move(locking_types)),
+      oracle_(oracle ? std::move(oracle) : std::make_unique<CentralOracle>()),
+      locks_(inheritance),
+      history_(*oracle_) {}
+
+Transaction HybridManager::Begin(const std::string& type_name,
+                                 const std::vector<std::string>& keys) {
+    Transaction txn;
+    txn.txn_id = ++txn_id_counter_;
+    txn.type_name = type_name;
+    txn.access = Declared(type_name);
+    txn.isolation = IsolationOf(type_name);
+    txn.status = TxnStatus::ACTIVE;
+    txn.wall_start = std::chrono::steady_clock::now();
+
+    if (Locking(type_name)) {
+        // Conservative 2PL: every declared lock before execution
+        txn.start_ts = 0;
+        LockManager::AssignKeys(txn, keys);
+        txn.retry_count = locks_.Acquire(txn);
+    } else {
+        txn.start_ts = history_.Start(txn.txn_id);
+    }
+    // After the locks or start_ts, as in TwoPLManager and OCCManager
+    if (txn.isolation == IsolationLevel::kSnapshot) txn.snapshot = db_.GetSnapshot();
+    return txn;
+}
+
+std::optional<Transaction> HybridManager::TryBegin(const std::string& type_name,
+                                                   const std::vector<std::string>& keys) {
+    if (!Locking(type_name)) return Begin(type_name, keys);
+    Transaction txn;
+    txn.txn_id = ++txn_id_counter_;
+    txn.type_name = type_name;
+    txn.access = Declared(type_name);
+    txn.isolation = IsolationOf(type_name);
+    txn.start_ts = 0;
+    LockManager::AssignKeys(txn, keys);
+    if (!locks_.TryAcquireAll(txn.txn_id, txn.lock_keys, txn.shared_keys)) return std::nullopt;
+    if (txn.isolation == IsolationLevel::kSnapshot) txn.snapshot = db_.GetSnapshot();
+    txn.status = TxnStatus::ACTIVE;
+    txn.wall_start = std::chrono::steady_clock::now();
+    return txn;
+}
+
+std::optional<std::string> HybridManager::Read(Transaction& txn, const std::string& key) {
+    if (Locking(txn.type_name) && !locks_.LockOnTouch(txn, key, false)) return std::nullopt;
+    return txn.Read(key, db_);
+}
+
+void HybridManager::Write(Transaction& txn, const std::string& key, const std::string& value) {
+    if (Locking(txn.type_name)) {
+        // Snapshot: first committer wins, as in TwoPLManager::Write
+        bool fresh = txn.snapshot
+                  && std::find(txn.lock_keys.begin(), txn.lock_keys.end(), key) == txn.lock_keys.end();
+        if (!locks_.LockOnTouch(txn, key, true)) return;
+        if (fresh && !txn.SnapshotCurrent(key, db_)) {
+            txn.conflict_key = key;
+            txn.status = TxnStatus::ABORTED;
+            return;
+        }
+    }
+    txn.Write(key, value);
+}
+
+CommitResult HybridManager::Commit(Transaction& txn) {
+    if (txn.status == TxnStatus::ABORTED) {
+        Abort(txn);
+        return {false, txn.txn_id, txn.retry_count, txn.conflict_key};
+    }
+
+    if (Locking(txn.type_name) || txn.status == TxnStatus::PREPARED) {
+        // Every key is locked already: nothing to validate
+        CommitResult result;
+        {
+            std::lock_guard<std::mutex> val_lock(validation_mutex_);
+            result = Apply(txn);
+        }
+        ReleaseLocks(txn);
+        return result;
+    }
+
+    // OCC: validate, then lock the write keys for the apply. A held lock
+    // means a locking transaction may have read or be about to read the key,
+    // so the OCC transaction yields rather than wait.
+    std::unique_lock<std::mutex> val_lock(validation_mutex_);
+    txn.validation_ts = oracle_->Next();
+    for (const auto& [key, _] : txn.write_set) txn.lock_keys.push_back(key);
+    if (!history_.Validate(txn)
+            || (!txn.lock_keys.empty()
+                && !locks_.TryAcquireAll(txn.txn_id, txn.lock_keys, {}, &txn.conflict_key))) {
+        txn.lock_keys.clear();
+        txn.status = TxnStatus::ABORTED;
+        FinishActive(txn);
+        return {false, txn.txn_id, txn.retry_count, txn.conflict_key};
+    }
+    CommitResult result = Apply(txn);
+    val_lock.unlock();
+    ReleaseLocks(txn);
+    return result;
+}
+
+CommitResult HybridManager::Apply(Transaction& txn) {
+    // A transaction that wrote nothing leaves no history: later validations
+    // have nothing to check against it
+    if (!txn.write_set.empty()) {
+        db_.CommitWrites(txn.write_set);
+        txn.finish_ts = oracle_->Next();
+        history_.Record(txn);
+    }
+    txn.status = TxnStatus::COMMITTED;
+    FinishActive(txn);
+    return {true, txn.txn_id, txn.retry_count, txn.conflict_key};
+}
+
+bool HybridManager::Prepare(Transaction& txn) {
+    if (txn.status == TxnStatus::ABORTED) {
+        Abort(txn);
+        return false;
+    }
+    if (Locking(txn.type_name)) {
+        txn.status = TxnStatus::PREPARED;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> val_lock(validation_mutex_);
+    txn.validation_ts = oracle_->Next();
+    for (const auto& [key, _] : txn.write_set) txn.lock_keys.push_back(key);
+    for (const auto& [key, _] : txn.read_set) {
+        if (ProtectsReads(txn.isolation) && !txn.write_set.count(key)) txn.shared_keys.push_back(key);
+    }
+    if (!history_.Validate(txn)
+            || !locks_.TryAcquireAll(txn.txn_id, txn.lock_keys, txn.shared_keys, &txn.conflict_key)) {
+        txn.lock_keys.clear();
+        txn.shared_keys.clear();
+        txn.status = TxnStatus::ABORTED;
+        FinishActive(txn);
+        return false;
+    }
+    txn.status = TxnStatus::PREPARED;
+    return true;
+}
+
+void HybridManager::Abort(Transaction& txn) {
+    txn.status = TxnStatus::ABORTED;
+    txn.read_set.clear();
+    txn.write_set.clear();
+    ReleaseLocks(txn);
+    FinishActive(txn);
+}
+
+void HybridManager::ReleaseLocks(const Transaction& txn) {
+    if (txn.lock_keys.empty() && txn.shared_keys.empty()) return;
+    locks_.ReleaseAll(txn.txn_id, txn.lock_keys, txn.shared_keys);
+}
+
+void HybridManager::FinishActive(Transaction& txn) {
+    txn.snapshot.reset();
+    history_.Finish(txn.txn_id);  // no-op for locking transactions
+}
+
+std::vector<std::pair<std::string, size_t>> HybridManager::StructureSizes() {
+    return {{"lock_table", locks_.Size()},
+            {"committed_history", history_.HistorySize()},
+            {"active_txns", history_.ActiveCount()}};
+}
+
+} // namespace txn
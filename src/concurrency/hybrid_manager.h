@@ -0,0 +1,82 @@
+#ifndef HYBRID_MANAGER_H
+#define HYBRID_MANAGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "concurrency/commit_history.h"
+#include "concurrency/timestamp_oracle.h"
+#include "concurrency/transaction_manager.h"
+#include "concurrency/twopl_manager.h"
+#include "database/database.h"
+
+namespace txn {
+
+// Runs each transaction type under its own protocol: the types in
+// locking_types under Conservative 2PL, every other type under OCC.
+//
+// Both classes share one lock table and one committed history. Locking
+// transactions hold their locks from Begin to Commit, and their commits are
+// recorded in the history like OCC commits, so OCC validation sees them.
+// An OCC transaction validates its reads against the history, then takes
+// exclusive locks on its write keys without waiting while it applies them;
+// if a locking transaction holds one, it aborts. Its writes therefore never
+// land under a locking transaction, and every commit of either class applies
+// and records its writes under the validation lock, so a validation never
+// misses a commit it could have read from.
+class HybridManager : public TransactionManager {
+public:
+    // Timestamps come from oracle; a CentralOracle when none is given.
+    // inheritance as for TwoPLManager.
+    HybridManager(Database& db, std::unordered_set<std::string> locking_types,
+                  std::unique_ptr<TimestampOracle> oracle = nullptr,
+                  LockInheritance inheritance = LockInheritance::kOff);
+
+    Transaction Begin(const std::string& type_name,
+                      const std::vector<std::string>& keys = {}) override;
+    std::optional<std::string> Read(Transaction& txn, const std::string& key) override;
+    void Write(Transaction& txn, const std::string& key, const std::string& value) override;
+    CommitResult Commit(Transaction& txn) override;
+    void Abort(Transaction& txn) override;
+    // Locking transactions already hold their locks. OCC transactions
+    // validate now and lock their write keys exclusive and, from repeatable
+    // read up, their other read keys shared until Commit or Abort.
+    bool Prepare(Transaction& txn) override;
+    std::string ProtocolName() const override { return "Hybrid"; }
+    // One attempt at a locking transaction's up-front locks
+    std::optional<Transaction> TryBegin(const std::string& type_name,
+                                        const std::vector<std::string>& keys) override;
+    std::vector<std::pair<std::string, size_t>> StructureSizes() override;
+
+    // Whether type_name runs under 2PL
+    bool Locking(const std::string& type_name) const { return locking_types_.count(type_name) > 0; }
+    const LockManager& Locks() const { return locks_; }
+
+private:
+    // Requires validation_mutex_. Applies txn's writes and records them in
+    // the history; txn's locks are left for the caller to release.
+    CommitResult Apply(Transaction& txn);
+    void ReleaseLocks(const Transaction& txn);
+    // Drops txn from the active set and releases its snapshot, which would
+    // otherwise keep old versions pinned in storage
+    void FinishActive(Transaction& txn);
+
+    Database& db_;
+    const std::unordered_set<std::string> locking_types_;
+    std::unique_ptr<TimestampOracle> oracle_;
+    LockManager locks_;
+    // Commits of both classes; only OCC transactions are in its active set.
+    // Validated and recorded into under validation_mutex_.
+    CommitHistory history_;
+    std::atomic<uint64_t> txn_id_counter_{0};
+
+    std::mutex validation_mutex_;
+};
+
+} // namespace txn
+
+#endif // HYBRID_MANAGER_H
@@ -0,0 +1,57 @@
+#include "concurrency/manager_factory.h"
+#include "concurrency/hybrid_manager.h"
+#include "concurrency/occ_manager.h"
+#include "concurrency/timestamp_oracle.h"
+#include "concurrency/twopl_manager.h"
+#include "concurrency/versioned_occ_manager.h"
+
+namespace txn {
+
+namespace {
+
+std::unique_ptr<TransactionManager> MakeProtocolManager(const std::string& protocol,
+                                                        Database& db,
+                                                        const ManagerOptions& options) {
+    LockInheritance inheritance = options.inherit_locks ? LockInheritance::kOn
+                                                        : LockInheritance::kOff;
+    if (protocol == "occ") {
+        auto oracle = MakeTimestampOracle(options.timestamps);
+        if (!oracle) return nullptr;
+        return std::make_unique<OCCManager>(db, std::move(oracle));
+    } else if (protocol == "2pl") {
+        return std::make_unique<TwoPLManager>(db, inheritance);
+    } else if (protocol == "hybrid") {
+        std::unordered_set<std::string> locking_types;
+        for (const auto& [type_name, assigned] : options.template_protocols) {
+            if (assigned == "2pl") {
+                locking_types.insert(type_name);
+            } else if (assigned != "occ") {
+                return nullptr;
+            }
+        }
+        auto oracle = MakeTimestampOracle(options.timestamps);
+        if (!oracle) return nullptr;
+        return std::make_unique<HybridManager>(db, std::move(locking_types), std::move(oracle),
+                                               inheritance);
+    } else if (protocol == "occ-versioned") {
+        return std::make_unique<VersionedOCCManager>(db);
+    }
+    return nullptr;
+}
+
+} // anonymous namespace
+
+std::unique_ptr<TransactionManager> MakeTransactionManager(const std::string& protocol,
+                                                           Database& db,
+                                                           const ManagerOptions& options) {
+    auto mgr = MakeProtocolManager(protocol, db, options);
+    if (!mgr) return nullptr;
+    for (const auto& [type_name, name] : options.isolation) {
+        IsolationLevel level;
+        if (!ParseIsolationLevel(name, level)) return nullptr;
+        mgr->SetIsolation(type_name, level);
+    }
+    return mgr;
+}
+
+} // namespace txn
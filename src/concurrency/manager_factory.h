@@ -0,0 +1,34 @@
+#ifndef MANAGER_FACTORY_H
+#define MANAGER_FACTORY_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include "concurrency/transaction_manager.h"
+#include "database/database.h"
+
+namespace txn {
+
+// Protocol-specific manager settings
+struct ManagerOptions {
+    std::string timestamps = "central";  // OCC: --timestamps oracle
+    bool inherit_locks     = false;      // 2PL: --inherit-locks
+    // hybrid: --template-protocols, template name -> "occ" or "2pl";
+    // templates not listed run under OCC
+    std::map<std::string, std::string> template_protocols;
+    // Any protocol: --isolation, template name -> isolation level name; ""
+    // for every template not listed (see TransactionManager::SetIsolation)
+    std::map<std::string, std::string> isolation;
+};
+
+// Creates the manager for a --protocol name ("occ", "2pl", "hybrid" or
+// "occ-versioned").
+// Returns nullptr for an unknown protocol, timestamp oracle, template
+// protocol or isolation level.
+std::unique_ptr<TransactionManager> MakeTransactionManager(const std::string& protocol,
+                                                           Database& db,
+                                                           const ManagerOptions& options = {});
+
+} // namespace txn
+
+#endif // MANAGER_FACTORY_H
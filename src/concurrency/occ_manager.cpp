@@ -1,98 +1,248 @@
 #include "concurrency/occ_manager.h"
-#include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 namespace txn {
 
-OCCManager::OCCManager(Database& db) : db_(db) {}
+OCCManager::OCCManager(Database& db, std::unique_ptr<TimestampOracle> oracle)
+    : db_(db), oracle_(oracle ? std::move(oracle) : std::make_unique<CentralOracle>()) {}
 
 Transaction OCCManager::Begin(const std::string& type_name,
                               const std::vector<std::string>& /*keys*/) {
     Transaction txn;
     txn.txn_id = ++txn_id_counter_;
     txn.type_name = type_name;
-    txn.start_ts = timestamp_counter_.load();
+    txn.access = Declared(type_name);
+    txn.isolation = IsolationOf(type_name);
+    txn.start_ts = history_.Start(txn.txn_id);
+    // Taken after start_ts: every commit missing from the snapshot has a
+    // larger finish_ts, so validation still checks it
+    if (txn.isolation == IsolationLevel::kSnapshot) txn.snapshot = db_.GetSnapshot();
     txn.status = TxnStatus::ACTIVE;
     txn.wall_start = std::chrono::steady_clock::now();
     return txn;
 }
 
+std::vector<std::optional<Transaction>> OCCManager::BeginBatch(
+        const std::vector<BeginRequest>& requests) {
+    std::vector<std::optional<Transaction>> txns(requests.size());
+    uint64_t first_id = txn_id_counter_.fetch_add(requests.size()) + 1;
+    auto now = std::chrono::steady_clock::now();
+
+    uint64_t start_ts = history_.Start(first_id, requests.size());
+    std::shared_ptr<const rocksdb::Snapshot> snapshot;
+    for (size_t i = 0; i < requests.size(); i++) {
+        Transaction txn;
+        txn.txn_id = first_id + i;
+        txn.type_name = requests[i].type_name;
+        txn.access = Declared(txn.type_name);
+        txn.isolation = IsolationOf(txn.type_name);
+        if (txn.isolation == IsolationLevel::kSnapshot) {
+            if (!snapshot) snapshot = db_.GetSnapshot();
+            txn.snapshot = snapshot;
+        }
+        txn.start_ts = start_ts;
+        txn.status = TxnStatus::ACTIVE;
+        txn.wall_start = now;
+        txns[i] = std::move(txn);
+    }
+    return txns;
+}
+
 std::optional<std::string> OCCManager::Read(Transaction& txn, const std::string& key) {
     return txn.Read(key, db_);
 }
 
+bool OCCManager::StartRead(Transaction& txn, const std::string& key,
+                           std::optional<std::string>& value) {
+    // Batched fetches read the latest values; snapshot reads go one by one
+    if (txn.snapshot) {
+        value = txn.Read(key, db_);
+        return false;
+    }
+    return !txn.ReadLocal(key, value);
+}
+
+std::optional<std::string> OCCManager::FinishRead(Transaction& txn, const std::string& key,
+                                                  std::optional<std::string> fetched) {
+    txn.RecordRead(key, fetched);
+    return fetched;
+}
+
 void OCCManager::Write(Transaction& txn, const std::string& key, const std::string& value) {
     txn.Write(key, value);
 }
 
 bool OCCManager::Validate(Transaction& txn) {
-    // Check for conflicts with committed transactions
-    std::lock_guard<std::mutex> lock(committed_mutex_);
-    for (const auto& record : committed_history_) {
-        if (record.finish_ts > txn.start_ts) {
-            // Check if any of the committed txn's write keys overlap with our read set
-            for (const auto& write_key : record.write_keys) {
-                if (txn.read_set.find(write_key) != txn.read_set.end()) {
-                    return false;
-                }
+    return history_.Validate(txn);
+}
+
+bool OCCManager::TouchesPrepared(Transaction& txn) const {
+    if (prepared_keys_.empty()) return false;
+    // Below repeatable read, reading a pinned key sees its committed value
+    // and does not conflict
+    for (const auto* set : {&txn.read_set, &txn.write_set}) {
+        if (set == &txn.read_set && !ProtectsReads(txn.isolation)) continue;
+        for (const auto& [key, _] : *set) {
+            if (prepared_keys_.count(key)) {
+                txn.conflict_key = key;
+                return true;
             }
         }
     }
-    return true;
+    return false;
 }
 
-CommitResult OCCManager::Commit(Transaction& txn) {
+void OCCManager::ReleasePrepared(const Transaction& txn) {
+    for (const auto* set : {&txn.read_set, &txn.write_set}) {
+        for (const auto& [key, _] : *set) {
+            auto it = prepared_keys_.find(key);
+            if (it != prepared_keys_.end() && --it->second == 0) prepared_keys_.erase(it);
+        }
+    }
+}
+
+bool OCCManager::Prepare(Transaction& txn) {
     std::lock_guard<std::mutex> val_lock(validation_mutex_);
+    txn.validation_ts = oracle_->Next();
+    if (TouchesPrepared(txn) || !Validate(txn)) {
+        txn.status = TxnStatus::ABORTED;
+        FinishActive(txn);
+        return false;
+    }
+    // A key both read and written is counted twice and released twice
+    for (const auto* set : {&txn.read_set, &txn.write_set}) {
+        for (const auto& [key, _] : *set) prepared_keys_[key]++;
+    }
+    txn.status = TxnStatus::PREPARED;
+    return true;
+}
+
+bool OCCManager::AdmitCommit(Transaction& txn) {
+    if (txn.status == TxnStatus::PREPARED) {
+        // Validated in Prepare; pinned keys kept conflicting commits out since
+        ReleasePrepared(txn);
+        return true;
+    }
 
     // Assign validation timestamp
-    txn.validation_ts = ++timestamp_counter_;
+    txn.validation_ts = oracle_->Next();
 
-    // Validate
-    if (!Validate(txn)) {
+    // Validate, treating keys pinned by prepared transactions as conflicts
+    if (TouchesPrepared(txn) || !Validate(txn)) {
         txn.status = TxnStatus::ABORTED;
-        return {false, txn.txn_id, txn.retry_count};
+        FinishActive(txn);
+        return false;
     }
+    return true;
+}
 
-    // Apply writes to database
-    for (const auto& [key, value] : txn.write_set) {
-        db_.Put(key, value);
-    }
+CommitResult OCCManager::Commit(Transaction& txn) {
+    if (txn.status == TxnStatus::ACTIVE && txn.write_set.empty()) return CommitReadOnly(txn);
 
-    // Assign finish timestamp
-    txn.finish_ts = ++timestamp_counter_;
-    txn.status = TxnStatus::COMMITTED;
+    std::lock_guard<std::mutex> val_lock(validation_mutex_);
+    if (!AdmitCommit(txn)) return {false, txn.txn_id, txn.retry_count, txn.conflict_key};
+
+    // Apply writes to database as one batch
+    db_.CommitWrites(txn.write_set);
+    return RecordCommit(txn);
+}
 
-    // Record committed transaction
-    CommittedTxnRecord record;
-    record.txn_id = txn.txn_id;
-    record.finish_ts = txn.finish_ts;
-    for (const auto& [key, _] : txn.write_set) {
-        record.write_keys.insert(key);
+CommitResult OCCManager::CommitReadOnly(Transaction& txn) {
+    // A single read is consistent on its own. Several are validated, under
+    // validation_mutex_ so that every writer whose batch is visible also has
+    // its history record in place.
+    // Below repeatable read only writes are checked: it always commits.
+    bool valid = true;
+    if (txn.read_set.size() > 1 && ProtectsReads(txn.isolation)) {
+        std::lock_guard<std::mutex> val_lock(validation_mutex_);
+        valid = Validate(txn);
     }
+    FinishActive(txn);
+    txn.status = valid ? TxnStatus::COMMITTED : TxnStatus::ABORTED;
+    return {valid, txn.txn_id, txn.retry_count, txn.conflict_key};
+}
 
-    {
-        std::lock_guard<std::mutex> lock(committed_mutex_);
-        committed_history_.push_back(std::move(record));
+void OCCManager::CommitAsync(Transaction txn, CommitCallback done) {
+    pipeline_.Submit(std::move(txn), std::move(done));
+}
+
+std::vector<CommitResult> OCCManager::CommitBatch(std::vector<Transaction>& txns) {
+    std::vector<CommitResult> results(txns.size());
+    std::lock_guard<std::mutex> val_lock(validation_mutex_);
+
+    // Earlier members have no history record until the batch is applied, so
+    // a member that read a key they write is checked here: it read the
+    // value from before their writes (below repeatable read, one that
+    // writes a key they write)
+    std::unordered_set<std::string> batch_writes;
+    std::vector<const std::unordered_map<std::string, std::string>*> write_sets;
+    std::vector<size_t> admitted;
+    for (size_t i = 0; i < txns.size(); i++) {
+        Transaction& txn = txns[i];
+        bool stale = false;
+        if (txn.status != TxnStatus::PREPARED) {
+            for (const auto& [key, _] : txn.ConflictKeys()) {
+                if (batch_writes.count(key)) {
+                    txn.conflict_key = key;
+                    stale = true;
+                    break;
+                }
+            }
+        }
+        if (stale) {
+            txn.status = TxnStatus::ABORTED;
+            FinishActive(txn);
+        }
+        if (stale || !AdmitCommit(txn)) {
+            results[i] = {false, txn.txn_id, txn.retry_count, txn.conflict_key};
+            continue;
+        }
+        for (const auto& [key, _] : txn.write_set) batch_writes.insert(key);
+        write_sets.push_back(&txn.write_set);
+        admitted.push_back(i);
     }
 
-    return {true, txn.txn_id, txn.retry_count};
+    // Apply every admitted write set as one batch
+    db_.CommitWriteGroup(write_sets);
+    for (size_t i : admitted) results[i] = RecordCommit(txns[i]);
+    return results;
+}
+
+CommitResult OCCManager::RecordCommit(Transaction& txn) {
+    // Assign finish timestamp
+    txn.finish_ts = oracle_->Next();
+    txn.status = TxnStatus::COMMITTED;
+    history_.Record(txn);
+    FinishActive(txn);
+    return {true, txn.txn_id, txn.retry_count, txn.conflict_key};
 }
 
 void OCCManager::Abort(Transaction& txn) {
+    if (txn.status == TxnStatus::PREPARED) {
+        std::lock_guard<std::mutex> val_lock(validation_mutex_);
+        ReleasePrepared(txn);
+    }
     txn.status = TxnStatus::ABORTED;
     txn.read_set.clear();
     txn.write_set.clear();
+    FinishActive(txn);
+}
+
+void OCCManager::FinishActive(Transaction& txn) {
+    txn.snapshot.reset();
+    history_.Finish(txn.txn_id);
 }
 
-void OCCManager::GarbageCollect(uint64_t min_active_start_ts) {
-    std::lock_guard<std::mutex> lock(committed_mutex_);
-    committed_history_.erase(
-        std::remove_if(committed_history_.begin(), committed_history_.end(),
-            [min_active_start_ts](const CommittedTxnRecord& r) {
-                return r.finish_ts <= min_active_start_ts;
-            }),
-        committed_history_.end()
-    );
+std::vector<std::pair<std::string, size_t>> OCCManager::StructureSizes() {
+    size_t prepared;
+    {
+        std::lock_guard<std::mutex> lock(validation_mutex_);
+        prepared = prepared_keys_.size();
+    }
+    return {{"committed_history", history_.HistorySize()},
+            {"active_txns", history_.ActiveCount()},
+            {"prepared_keys", prepared}};
 }
 
 } // namespace txn
@@ -4,42 +4,86 @@
 #include <atomic>
 #include <vector>
 #include <mutex>
-#include <set>
+#include <string>
+#include <unordered_map>
 #include <cstdint>
+#include <memory>
+#include "concurrency/commit_history.h"
+#include "concurrency/commit_pipeline.h"
+#include "concurrency/timestamp_oracle.h"
 #include "concurrency/transaction_manager.h"
 #include "database/database.h"
 
 namespace txn {
 
-struct CommittedTxnRecord {
-    uint64_t txn_id;
-    uint64_t finish_ts;
-    std::set<std::string> write_keys;
-};
-
 class OCCManager : public TransactionManager {
 public:
-    explicit OCCManager(Database& db);
+    // Timestamps come from oracle; a CentralOracle when none is given
+    explicit OCCManager(Database& db, std::unique_ptr<TimestampOracle> oracle = nullptr);
 
     Transaction Begin(const std::string& type_name,
                       const std::vector<std::string>& keys = {}) override;
     std::optional<std::string> Read(Transaction& txn, const std::string& key) override;
     void Write(Transaction& txn, const std::string& key, const std::string& value) override;
     CommitResult Commit(Transaction& txn) override;
+    // Queued for the commit pipeline, which validates a whole group under
+    // one hold of the validation lock and applies it as one batch
+    void CommitAsync(Transaction txn, CommitCallback done) override;
+    using TransactionManager::CommitAsync;
+    // One start timestamp and one active-set update for the whole batch
+    std::vector<std::optional<Transaction>> BeginBatch(const std::vector<BeginRequest>& requests) override;
+    // Validates the batch in order under one hold of the validation lock and
+    // applies it as one WriteBatch
+    std::vector<CommitResult> CommitBatch(std::vector<Transaction>& txns) override;
     void Abort(Transaction& txn) override;
+    // Validates now and pins txn's read and write keys until Commit or
+    // Abort: any other transaction touching them fails validation meanwhile.
+    bool Prepare(Transaction& txn) override;
     std::string ProtocolName() const override { return "OCC"; }
+    std::string OracleName() const { return oracle_->Name(); }
+    bool StartRead(Transaction& txn, const std::string& key,
+                   std::optional<std::string>& value) override;
+    std::vector<std::optional<std::string>> Fetch(const std::vector<std::string>& keys) override {
+        return db_.MultiGet(keys);
+    }
+    std::optional<std::string> FinishRead(Transaction& txn, const std::string& key,
+                                          std::optional<std::string> fetched) override;
+    std::vector<std::pair<std::string, size_t>> StructureSizes() override;
 
-private:
+    // Backward validation of txn's read set against the committed history.
+    // Read-only; public so it can be benchmarked in isolation.
     bool Validate(Transaction& txn);
-    void GarbageCollect(uint64_t min_active_start_ts);
+
+private:
+    // All require validation_mutex_
+    bool TouchesPrepared(Transaction& txn) const;
+    void ReleasePrepared(const Transaction& txn);
+    // Validates txn for commit (a prepared txn already was); aborts it on failure
+    bool AdmitCommit(Transaction& txn);
+    // Finishes txn once its writes are applied: history record
+    CommitResult RecordCommit(Transaction& txn);
+    // Commit of a transaction that wrote nothing: later validations have
+    // nothing to check against it, so it takes no timestamps, history record
+    // or storage write
+    CommitResult CommitReadOnly(Transaction& txn);
+    // Drops txn from the active set and releases its snapshot, which would
+    // otherwise keep old versions pinned in storage
+    void FinishActive(Transaction& txn);
 
     Database& db_;
-    std::atomic<uint64_t> timestamp_counter_{0};
+    std::unique_ptr<TimestampOracle> oracle_;
     std::atomic<uint64_t> txn_id_counter_{0};
+    // Validated and recorded into under validation_mutex_
+    CommitHistory history_{*oracle_};
 
     std::mutex validation_mutex_;
-    std::mutex committed_mutex_;
-    std::vector<CommittedTxnRecord> committed_history_;
+    // Keys read or written by prepared transactions, with a count of each
+    std::unordered_map<std::string, int> prepared_keys_;  // guarded by validation_mutex_
+
+    // Last member: drained before the state it commits into is destroyed
+    CommitPipeline pipeline_{[this](std::vector<Transaction>& group) {
+        return CommitBatch(group);
+    }};
 };
 
 } // namespace txn
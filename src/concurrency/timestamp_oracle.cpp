@@ -0,0 +1,184 @@
+#include "concurrency/timestamp_oracle.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace txn {
+
+namespace {
+
+// Thread slot registry shared by all oracles. A slot's registration is odd
+// while a thread holds it and is bumped again when the thread exits, so an
+// oracle can tell a live owner from a previous one.
+struct ThreadSlots {
+    std::mutex mutex;
+    std::array<std::atomic<uint64_t>, SlottedOracle::kMaxThreads> registration{};
+    std::atomic<int> used{0};  // slots [0, used) have been handed out at least once
+};
+
+ThreadSlots& Registry() {
+    static ThreadSlots slots;
+    return slots;
+}
+
+// The calling thread's slot; registration does not change while it lives
+struct SlotHolder {
+    int index = -1;
+    uint64_t registration = 0;
+
+    ~SlotHolder() {
+        if (index >= 0) Registry().registration[index]++;
+    }
+};
+
+void AcquireSlot(SlotHolder& holder) {
+    ThreadSlots& slots = Registry();
+    std::lock_guard<std::mutex> lock(slots.mutex);
+    for (int i = 0; i < SlottedOracle::kMaxThreads; i++) {
+        if (slots.registration[i].load() % 2 == 0) {
+            holder.registration = ++slots.registration[i];
+            holder.index = i;
+            if (i >= slots.used.load()) slots.used = i + 1;
+            return;
+        }
+    }
+    throw std::runtime_error("timestamp oracle: more than 256 threads at once");
+}
+
+const SlotHolder& ThreadSlot() {
+    thread_local SlotHolder holder;
+    if (holder.index < 0) AcquireSlot(holder);
+    return holder;
+}
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// SlottedOracle
+// ---------------------------------------------------------------------------
+
+SlottedOracle::Slot& SlottedOracle::Mine(int& index) {
+    const SlotHolder& holder = ThreadSlot();
+    index = holder.index;
+    Slot& slot = slots_[index];
+    if (slot.owner.load(std::memory_order_relaxed) != holder.registration) {
+        slot.floor = kNoFloor;
+        slot.next = slot.end = 0;
+        slot.owner = holder.registration;
+    }
+    return slot;
+}
+
+uint64_t SlottedOracle::FloorHorizon(uint64_t bound) {
+    // bound is read first: a thread whose floor the scan misses announces it
+    // later, and then computes from at least bound
+    uint64_t horizon = bound;
+    ThreadSlots& slots = Registry();
+    int used = slots.used.load();
+    for (int i = 0; i < used; i++) {
+        uint64_t registration = slots.registration[i].load();
+        if (registration % 2 == 0 || slots_[i].owner.load() != registration) continue;
+        horizon = std::min(horizon, slots_[i].floor.load());
+    }
+    return horizon - 1;
+}
+
+// ---------------------------------------------------------------------------
+// BatchedOracle
+// ---------------------------------------------------------------------------
+
+uint64_t BatchedOracle::Next() {
+    int index;
+    Slot& slot = Mine(index);
+    if (slot.next == slot.end || slot.next <= retired_.load()) {
+        slot.next = counter_.fetch_add(block_size_);
+        slot.end = slot.next + block_size_;
+    }
+    return slot.next++;
+}
+
+uint64_t BatchedOracle::Horizon() {
+    uint64_t horizon = counter_.load() - 1;
+    uint64_t retired = retired_.load();
+    while (horizon > retired && !retired_.compare_exchange_weak(retired, horizon)) {}
+    return horizon;
+}
+
+// ---------------------------------------------------------------------------
+// EpochOracle
+// ---------------------------------------------------------------------------
+
+EpochOracle::EpochOracle(int epoch_us) : epoch_us_(epoch_us) {
+    advancer_ = std::thread(&EpochOracle::Advance, this);
+}
+
+EpochOracle::~EpochOracle() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stopping_ = true;
+    }
+    stop_cv_.notify_all();
+    advancer_.join();
+}
+
+void EpochOracle::Advance() {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    while (!stop_cv_.wait_for(lock, std::chrono::microseconds(epoch_us_),
+                              [this] { return stopping_; })) {
+        epoch_++;
+    }
+}
+
+uint64_t EpochOracle::Next() {
+    int index;
+    Slot& slot = Mine(index);
+    slot.floor = slot.last + 1;
+    // Next sequence number in the epoch; one that runs out continues in the
+    // following epoch, ahead of the global one
+    uint64_t base = std::max(epoch_.load() << kEpochShift, slot.last + (1 << kSlotBits));
+    uint64_t ts = (base & ~((uint64_t{1} << kSlotBits) - 1)) | static_cast<uint64_t>(index);
+    slot.last = ts;
+    slot.floor.store(kNoFloor, std::memory_order_release);
+    return ts;
+}
+
+// ---------------------------------------------------------------------------
+// ClockOracle
+// ---------------------------------------------------------------------------
+
+uint64_t ClockOracle::Ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    // Fenced so the read is ordered with the floor store before it and the
+    // slot scan after it
+    _mm_lfence();
+    uint64_t tsc = __rdtsc();
+    _mm_lfence();
+    return tsc;
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+uint64_t ClockOracle::Next() {
+    int index;
+    Slot& slot = Mine(index);
+    slot.floor = slot.last + 1;
+    uint64_t base = std::max(Now() << kSlotBits, slot.last + (1 << kSlotBits));
+    uint64_t ts = (base & ~((uint64_t{1} << kSlotBits) - 1)) | static_cast<uint64_t>(index);
+    slot.last = ts;
+    slot.floor.store(kNoFloor, std::memory_order_release);
+    return ts;
+}
+
+std::unique_ptr<TimestampOracle> MakeTimestampOracle(const std::string& name) {
+    if (name == "central") return std::make_unique<CentralOracle>();
+    if (name == "batched") return std::make_unique<BatchedOracle>();
+    if (name == "epoch") return std::make_unique<EpochOracle>();
+    if (name == "clock") return std::make_unique<ClockOracle>();
+    return nullptr;
+}
+
+} // namespace txn
@@ -0,0 +1,148 @@
+#ifndef TIMESTAMP_ORACLE_H
+#define TIMESTAMP_ORACLE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace txn {
+
+// Source of transaction timestamps. Next returns timestamps that are unique
+// and increase on each thread. Horizon returns a value below every timestamp
+// that a Next call starting after it returns, on any thread: OCC takes
+// start_ts from it, so a commit that finishes after a transaction began has
+// a larger finish_ts. Horizon may lag behind the timestamps already issued;
+// that only makes OCC validation more conservative.
+class TimestampOracle {
+public:
+    virtual ~TimestampOracle() = default;
+
+    virtual uint64_t Next() = 0;
+    virtual uint64_t Horizon() = 0;
+    virtual std::string Name() const = 0;
+};
+
+// One shared counter, incremented by every Next. Horizon is exact.
+class CentralOracle : public TimestampOracle {
+public:
+    uint64_t Next() override { return ++counter_; }
+    uint64_t Horizon() override { return counter_.load(); }
+    std::string Name() const override { return "central"; }
+
+private:
+    std::atomic<uint64_t> counter_{0};
+};
+
+// Base of the oracles that issue timestamps without touching shared state
+// on every call; each thread using the oracle has a slot of its own.
+class SlottedOracle : public TimestampOracle {
+public:
+    // Threads that can use oracles at once; slots of exited threads are reused
+    static constexpr int kMaxThreads = 256;
+
+protected:
+    static constexpr uint64_t kNoFloor = UINT64_MAX;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> owner{0};  // registration of the thread using the slot
+        // A value no larger than anything the owner may still return, set
+        // while it computes a timestamp
+        std::atomic<uint64_t> floor{kNoFloor};
+        // Owner only. last is kept across owners, so timestamps built from
+        // the slot index stay unique
+        uint64_t last = 0;
+        uint64_t next = 0;
+        uint64_t end = 0;
+    };
+
+    // The calling thread's slot and its index; a slot last used by an exited
+    // thread is handed over without its floor or range
+    Slot& Mine(int& index);
+    // Horizon for oracles whose threads announce a floor before computing a
+    // timestamp: below every floor and below bound, the least timestamp a
+    // thread without a floor can compute from now on. Scans every slot.
+    uint64_t FloorHorizon(uint64_t bound);
+
+private:
+    std::array<Slot, kMaxThreads> slots_;
+};
+
+// Each thread takes ranges of block_size timestamps from a shared counter
+// and hands them out locally. Horizon is the counter; a thread whose range
+// lies at or below the latest horizon drops it and takes a new one, so
+// frequent horizons shorten the ranges actually used.
+class BatchedOracle : public SlottedOracle {
+public:
+    explicit BatchedOracle(uint64_t block_size = 64) : block_size_(block_size) {}
+
+    uint64_t Next() override;
+    uint64_t Horizon() override;
+    std::string Name() const override { return "batched"; }
+
+private:
+    uint64_t block_size_;
+    std::atomic<uint64_t> counter_{1};
+    std::atomic<uint64_t> retired_{0};  // largest horizon returned
+};
+
+// Silo-style composite timestamps: a global epoch advanced every epoch_us by
+// a background thread, then a per-thread sequence within the epoch, then the
+// thread's slot. Next reads the epoch and writes only its own slot. Horizon
+// is at the start of the current epoch, so OCC counts every commit of the
+// current epoch as concurrent.
+class EpochOracle : public SlottedOracle {
+public:
+    explicit EpochOracle(int epoch_us = 100);
+    ~EpochOracle() override;
+
+    uint64_t Next() override;
+    uint64_t Horizon() override { return FloorHorizon(epoch_.load() << kEpochShift); }
+    std::string Name() const override { return "epoch"; }
+
+private:
+    static constexpr int kSlotBits = 8;
+    static constexpr int kEpochShift = 24;  // 16 bits of sequence per thread and epoch
+
+    void Advance();
+
+    int epoch_us_;
+    std::atomic<uint64_t> epoch_{1};
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    bool stopping_ = false;
+    std::thread advancer_;
+};
+
+// Synchronized-clock timestamps: the CPU timestamp counter (steady_clock
+// where there is none) shifted left, with the thread's slot in the low bits.
+// Assumes the counter is synchronized across cores (invariant TSC).
+class ClockOracle : public SlottedOracle {
+public:
+    ClockOracle() : origin_(Ticks()) {}
+
+    uint64_t Next() override;
+    uint64_t Horizon() override { return FloorHorizon(Now() << kSlotBits); }
+    std::string Name() const override { return "clock"; }
+
+private:
+    static constexpr int kSlotBits = 8;
+
+    static uint64_t Ticks();
+    // Ticks since construction, from 1, so the shifted value cannot overflow
+    uint64_t Now() { return Ticks() - origin_ + 1; }
+
+    uint64_t origin_;
+};
+
+// Oracle for a --timestamps name ("central", "batched", "epoch" or "clock").
+// Returns nullptr for an unknown name.
+std::unique_ptr<TimestampOracle> MakeTimestampOracle(const std::string& name);
+
+} // namespace txn
+
+#endif // TIMESTAMP_ORACLE_H
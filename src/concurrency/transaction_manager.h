@@ -4,6 +4,11 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <utility>
+#include <functional>
+#include <future>
+#include <memory>
+#include <unordered_map>
 #include "transaction/transaction.h"
 
 namespace txn {
@@ -12,6 +17,17 @@ struct CommitResult {
     bool success;
     uint64_t txn_id;
     int retries;
+    // Key whose conflict aborted the transaction or made it wait for a
+    // lock; empty if there was none or the manager cannot tell
+    std::string conflict_key;
+};
+
+using CommitCallback = std::function<void(const CommitResult&)>;
+
+// One transaction to start through BeginBatch
+struct BeginRequest {
+    std::string type_name;
+    std::vector<std::string> keys;
 };
 
 class TransactionManager {
@@ -24,7 +40,110 @@ public:
     virtual void Write(Transaction& txn, const std::string& key, const std::string& value) = 0;
     virtual CommitResult Commit(Transaction& txn) = 0;
     virtual void Abort(Transaction& txn) = 0;
+    // Two-phase commit vote. true: txn is PREPARED, its keys stay protected
+    // and a later Commit is guaranteed to succeed. false: txn was aborted.
+    virtual bool Prepare(Transaction& txn) = 0;
     virtual std::string ProtocolName() const = 0;
+
+    // Asynchronous commit: the manager takes txn over and calls done once
+    // the outcome is final, possibly on another thread and after this call
+    // returns. By default it commits synchronously and calls done inline.
+    virtual void CommitAsync(Transaction txn, CommitCallback done) {
+        CommitResult result = Commit(txn);
+        done(result);
+    }
+    // CommitAsync with the outcome delivered through a future
+    std::future<CommitResult> CommitAsync(Transaction txn) {
+        auto promise = std::make_shared<std::promise<CommitResult>>();
+        std::future<CommitResult> outcome = promise->get_future();
+        CommitAsync(std::move(txn), [promise](const CommitResult& result) {
+            promise->set_value(result);
+        });
+        return outcome;
+    }
+
+    // For callers running several transactions per thread (AsyncIo), which
+    // must not block: nullopt means the keys are busy, try again later.
+    // Managers whose Begin never waits just Begin.
+    virtual std::optional<Transaction> TryBegin(const std::string& type_name,
+                                                const std::vector<std::string>& keys) {
+        return Begin(type_name, keys);
+    }
+
+    // Batch forms of TryBegin and Commit for callers that run many
+    // independent transactions at once (ExecuteBatch), so a manager can
+    // share one id allocation, one lock-table or validation critical section
+    // and one storage write across them. BeginBatch returns nullopt where a
+    // request's keys are busy; CommitBatch returns one outcome per
+    // transaction, in order. By default each one is handled on its own.
+    virtual std::vector<std::optional<Transaction>> BeginBatch(const std::vector<BeginRequest>& requests) {
+        std::vector<std::optional<Transaction>> txns;
+        txns.reserve(requests.size());
+        for (const auto& request : requests) txns.push_back(TryBegin(request.type_name, request.keys));
+        return txns;
+    }
+    virtual std::vector<CommitResult> CommitBatch(std::vector<Transaction>& txns) {
+        std::vector<CommitResult> results;
+        results.reserve(txns.size());
+        for (auto& txn : txns) results.push_back(Commit(txn));
+        return results;
+    }
+
+    // Read split around a storage fetch, so reads of many transactions can be
+    // fetched in one batch. StartRead returns true if key must come from
+    // storage; otherwise value already holds the read's result. Fetch reads
+    // the storage keys of any number of StartReads at once; FinishRead takes
+    // each fetched value and returns the read's result. By default the whole
+    // Read runs synchronously in StartRead and nothing is fetched.
+    virtual bool StartRead(Transaction& txn, const std::string& key,
+                           std::optional<std::string>& value) {
+        value = Read(txn, key);
+        return false;
+    }
+    virtual std::vector<std::optional<std::string>> Fetch(const std::vector<std::string>& keys) {
+        return std::vector<std::optional<std::string>>(keys.size());
+    }
+    virtual std::optional<std::string> FinishRead(Transaction& /*txn*/, const std::string& /*key*/,
+                                                  std::optional<std::string> fetched) {
+        return fetched;
+    }
+
+    // Element counts of internal bookkeeping structures, by name. Used to
+    // spot unbounded growth in long runs; managers without any return none.
+    virtual std::vector<std::pair<std::string, size_t>> StructureSizes() { return {}; }
+
+    // Registers the accesses of a transaction type, before any transaction
+    // of that type begins. Begin attaches them to the transaction, so the
+    // manager can pick lock modes from them; callers can look them up to
+    // prefetch or route. Empty sets are ignored.
+    virtual void Declare(const std::string& type_name, const AccessSet& access) {
+        if (!access.Empty()) declared_[type_name] = access;
+    }
+    // nullptr if type_name declared nothing
+    const AccessSet* Declared(const std::string& type_name) const {
+        auto it = declared_.find(type_name);
+        return it == declared_.end() ? nullptr : &it->second;
+    }
+
+    // Sets the isolation level transactions of type_name begin at; an empty
+    // type_name sets it for every type without a level of its own. Call
+    // before any transaction of the type begins. Begin attaches the level,
+    // and the manager relaxes validation or locking to match it.
+    virtual void SetIsolation(const std::string& type_name, IsolationLevel level) {
+        isolation_[type_name] = level;
+    }
+    // Serializable unless a level was set
+    IsolationLevel IsolationOf(const std::string& type_name) const {
+        if (isolation_.empty()) return IsolationLevel::kSerializable;
+        auto it = isolation_.find(type_name);
+        if (it == isolation_.end()) it = isolation_.find("");
+        return it == isolation_.end() ? IsolationLevel::kSerializable : it->second;
+    }
+    bool HasIsolationLevels() const { return !isolation_.empty(); }
+
+protected:
+    std::unordered_map<std::string, AccessSet> declared_;
+    std::unordered_map<std::string, IsolationLevel> isolation_;
 };
 
 } // namespace txn
@@ -1,8 +1,7 @@
 #include "concurrency/twopl_manager.h"
 #include <algorithm>
 #include <chrono>
-#include <random>
-#include <thread>
+#include <string_view>
 
 namespace txn {
 
@@ -10,101 +9,519 @@ namespace txn {
 // LockManager
 // ---------------------------------------------------------------------------
 
+namespace {
+
+std::atomic<uint64_t> g_lock_managers{0};
+std::atomic<uint64_t> g_thread_serials{0};
+
+uint64_t ThreadSerial() {
+    thread_local uint64_t serial = ++g_thread_serials;
+    return serial;
+}
+
+} // anonymous namespace
+
+LockManager::LockManager(LockInheritance inheritance)
+    : inherit_(inheritance == LockInheritance::kOn), instance_(++g_lock_managers) {}
+
 bool LockManager::TryAcquireAll(uint64_t txn_id,
-                                 const std::vector<std::string>& keys) {
+                                 const std::vector<std::string>& keys,
+                                 const std::vector<std::string>& shared_keys,
+                                 std::string* blocked) {
+    std::lock_guard<std::mutex> guard(table_mutex_);
+    return TryAcquireLocked(txn_id, keys, shared_keys, blocked);
+}
+
+void LockManager::ReleaseAll(uint64_t txn_id,
+                              const std::vector<std::string>& keys,
+                              const std::vector<std::string>& shared_keys) {
+    std::lock_guard<std::mutex> guard(table_mutex_);
+    ReleaseLocked(txn_id, keys, shared_keys, inherit_);
+    GrantWaiting();
+}
+
+int LockManager::Acquire(Transaction& txn) {
+    if (inherit_ && TryReclaim(txn)) return 0;
+    queued_requests_++;
+    LockRequest request;
+    request.txn = &txn;
+    bool grant;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_.push_back(&request);
+        grant = !granting_;
+        granting_ = true;
+    }
+
+    while (true) {
+        if (grant) RunGrantPasses(request);
+        std::unique_lock<std::mutex> lock(request.mutex);
+        request.cv.wait(lock, [&request] { return request.granted || request.grant; });
+        if (request.granted) {
+            // Granted under table_mutex_, which the grant pass has released
+            if (request.passes > 0) txn.conflict_key = std::move(request.blocked);
+            return request.passes;
+        }
+        request.grant = false;
+        grant = true;
+    }
+}
+
+void LockManager::RunGrantPasses(LockRequest& self) {
+    while (true) {
+        std::vector<LockRequest*> arrived;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            if (pending_.empty()) {
+                granting_ = false;
+                return;
+            }
+            std::lock_guard<std::mutex> self_lock(self.mutex);
+            if (self.granted) {
+                // Hand the passes to a queued request rather than serve
+                // arrivals indefinitely
+                LockRequest* next = pending_.front();
+                std::lock_guard<std::mutex> next_lock(next->mutex);
+                next->grant = true;
+                next->cv.notify_one();
+                return;
+            }
+            arrived.swap(pending_);
+        }
+        std::lock_guard<std::mutex> guard(table_mutex_);
+        grant_passes_++;
+        waiting_.insert(waiting_.end(), arrived.begin(), arrived.end());
+        GrantWaiting();
+    }
+}
+
+void LockManager::GrantWaiting() {
+    // Keys of earlier requests still waiting, and whether one wants it
+    // exclusive. A later request conflicting with one of them is not granted
+    // past it, so an exclusive request is not starved by a stream of shared
+    // ones and a large request by a stream of small ones.
+    std::unordered_map<std::string_view, bool> queued;
+    auto overtakes = [&queued](const Transaction& txn, std::string& blocked) {
+        for (const auto& key : txn.lock_keys) {
+            if (queued.count(key)) {
+                blocked = key;
+                return true;
+            }
+        }
+        for (const auto& key : txn.shared_keys) {
+            auto it = queued.find(key);
+            if (it != queued.end() && it->second) {
+                blocked = key;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    size_t kept = 0;
+    for (LockRequest* request : waiting_) {
+        const Transaction& txn = *request->txn;
+        if (overtakes(txn, request->blocked) ||
+            !TryAcquireLocked(txn.txn_id, txn.lock_keys, txn.shared_keys, &request->blocked)) {
+            request->passes++;
+            waiting_[kept++] = request;
+            for (const auto& key : txn.lock_keys) queued[key] = true;
+            for (const auto& key : txn.shared_keys) queued.emplace(key, false);
+            continue;
+        }
+        // Notified under its mutex: the waiter cannot return and destroy the
+        // request before this unlocks
+        std::lock_guard<std::mutex> lock(request->mutex);
+        request->granted = true;
+        request->cv.notify_one();
+    }
+    waiting_.resize(kept);
+}
+
+LockManager::Inherited& LockManager::Mine() {
+    // Entries of destroyed managers stay behind but are never looked up
+    thread_local std::unordered_map<uint64_t, Inherited> inherited;
+    return inherited[instance_];
+}
+
+bool LockManager::TryReclaim(const Transaction& txn) {
+    Inherited& mine = Mine();
+    if (mine.parked.empty()) return false;
+
+    const uint64_t parked = kParked | ThreadSerial();
+    std::vector<std::pair<std::string, LockState*>> claimed;
+    for (const auto& key : txn.lock_keys) {
+        auto it = mine.parked.find(key);
+        if (it == mine.parked.end()) continue;
+        uint64_t expected = parked;
+        if (it->second->owner.compare_exchange_strong(expected, txn.txn_id)) {
+            claimed.emplace_back(key, it->second);
+        }
+        mine.parked.erase(it);  // held by txn now, or taken over
+    }
+    if (claimed.empty()) return false;
+    if (claimed.size() == txn.lock_keys.size() && txn.shared_keys.empty()) {
+        inherited_locks_ += claimed.size();
+        return true;
+    }
+
+    // The other keys in one attempt. Waiting while holding the claimed locks
+    // could deadlock, so on failure they are parked again and txn queues
+    // holding nothing; requests that found them held meanwhile get them.
     std::lock_guard<std::mutex> guard(table_mutex_);
+    if (TryAcquireLocked(txn.txn_id, txn.lock_keys, txn.shared_keys)) {
+        inherited_locks_ += claimed.size();
+        return true;
+    }
+    for (const auto& [key, state] : claimed) {
+        state->owner = parked;
+        mine.parked[key] = state;
+    }
+    GrantWaiting();
+    return false;
+}
+
+bool LockManager::FreeOrParked(LockState& state, uint64_t txn_id) {
+    uint64_t owner = state.owner.load();
+    if (owner == txn_id) return true;
+    if (owner & kParked) {
+        // Fails only if the parking thread takes it back first
+        if (!state.owner.compare_exchange_strong(owner, 0)) return false;
+        hand_overs_++;
+        return true;
+    }
+    return owner == 0;
+}
 
-    // Phase 1: check all keys are free (all-or-nothing)
+bool LockManager::TryUpgrade(uint64_t txn_id, const std::string& key) {
+    std::lock_guard<std::mutex> guard(table_mutex_);
+    auto it = lock_table_.find(key);
+    if (it == lock_table_.end() || it->second.owner != 0 || it->second.readers != 1) {
+        return false;
+    }
+    it->second.readers = 0;
+    it->second.owner = txn_id;
+    return true;
+}
+
+void LockManager::AssignKeys(Transaction& txn, const std::vector<std::string>& keys) {
+    for (const auto& key : keys) {
+        if (txn.access && txn.access->ModeOf(key) == AccessMode::kRead) {
+            if (ProtectsReads(txn.isolation)) txn.shared_keys.push_back(key);
+        } else {
+            txn.lock_keys.push_back(key);
+        }
+    }
+}
+
+bool LockManager::LockOnTouch(Transaction& txn, const std::string& key, bool write) {
+    if (txn.status == TxnStatus::ABORTED) return false;
+    if (!write && !ProtectsReads(txn.isolation)) return true;
+    auto held = [&key](const std::vector<std::string>& keys) {
+        return std::find(keys.begin(), keys.end(), key) != keys.end();
+    };
+    if (held(txn.lock_keys)) return true;
+    if (held(txn.shared_keys)) {
+        if (!write) return true;
+        if (!TryUpgrade(txn.txn_id, key)) {
+            txn.conflict_key = key;
+            txn.status = TxnStatus::ABORTED;
+            return false;
+        }
+        txn.shared_keys.erase(std::find(txn.shared_keys.begin(), txn.shared_keys.end(), key));
+        txn.lock_keys.push_back(key);
+        return true;
+    }
+
+    std::vector<std::string> one = {key};
+    bool shared = !write && txn.access && txn.access->ModeOf(key) == AccessMode::kRead;
+    bool acquired = shared ? TryAcquireAll(txn.txn_id, {}, one)
+                           : TryAcquireAll(txn.txn_id, one);
+    if (!acquired) {
+        txn.conflict_key = key;
+        txn.status = TxnStatus::ABORTED;
+        return false;
+    }
+    (shared ? txn.shared_keys : txn.lock_keys).push_back(key);
+    return true;
+}
+
+std::vector<bool> LockManager::TryAcquireEach(const std::vector<Transaction*>& txns) {
+    std::vector<bool> acquired(txns.size());
+    std::lock_guard<std::mutex> guard(table_mutex_);
+    for (size_t i = 0; i < txns.size(); i++) {
+        acquired[i] = TryAcquireLocked(txns[i]->txn_id, txns[i]->lock_keys,
+                                       txns[i]->shared_keys);
+    }
+    return acquired;
+}
+
+void LockManager::ReleaseEach(const std::vector<Transaction*>& txns) {
+    std::lock_guard<std::mutex> guard(table_mutex_);
+    // Usually called off the transactions' own threads: nothing is parked
+    for (const Transaction* txn : txns) {
+        ReleaseLocked(txn->txn_id, txn->lock_keys, txn->shared_keys);
+    }
+    GrantWaiting();
+}
+
+bool LockManager::TryAcquireLocked(uint64_t txn_id,
+                                   const std::vector<std::string>& keys,
+                                   const std::vector<std::string>& shared_keys,
+                                   std::string* blocked) {
+    // Phase 1: check all keys are free or already txn_id's (all-or-nothing);
+    // shared locks only conflict with an exclusive holder. Parked locks are
+    // taken over, and stay free if the check fails.
     for (const auto& key : keys) {
         auto it = lock_table_.find(key);
-        if (it != lock_table_.end() && it->second != 0) {
+        if (it != lock_table_.end() && (!FreeOrParked(it->second, txn_id) || it->second.readers > 0)) {
+            if (blocked) *blocked = key;
+            return false;
+        }
+    }
+    for (const auto& key : shared_keys) {
+        auto it = lock_table_.find(key);
+        if (it != lock_table_.end() && !FreeOrParked(it->second, txn_id)) {
+            if (blocked) *blocked = key;
             return false;
         }
     }
 
     // Phase 2: acquire all
     for (const auto& key : keys) {
-        lock_table_[key] = txn_id;
+        lock_table_[key].owner = txn_id;
+    }
+    for (const auto& key : shared_keys) {
+        lock_table_[key].readers++;
     }
     return true;
 }
 
-void LockManager::ReleaseAll(uint64_t txn_id,
-                              const std::vector<std::string>& keys) {
-    std::lock_guard<std::mutex> guard(table_mutex_);
+void LockManager::ReleaseLocked(uint64_t txn_id,
+                                const std::vector<std::string>& keys,
+                                const std::vector<std::string>& shared_keys,
+                                bool park) {
+    Inherited* mine = park ? &Mine() : nullptr;
     for (const auto& key : keys) {
         auto it = lock_table_.find(key);
-        if (it != lock_table_.end() && it->second == txn_id) {
+        if (it == lock_table_.end() || it->second.owner != txn_id) continue;
+        LockState& state = it->second;
+        if (mine) {
+            bool hot = std::find(mine->recent.begin(), mine->recent.end(), key) != mine->recent.end();
+            if (mine->recent.size() < kRecentReleases) {
+                mine->recent.push_back(key);
+            } else {
+                mine->recent[mine->next] = key;
+                mine->next = (mine->next + 1) % kRecentReleases;
+            }
+            if (hot) {
+                state.owner = kParked | ThreadSerial();
+                state.sticky = true;
+                mine->parked[key] = &state;
+                continue;
+            }
+        }
+        if (state.sticky) {
+            state.owner = 0;
+        } else {
             lock_table_.erase(it);
         }
     }
+    for (const auto& key : shared_keys) {
+        auto it = lock_table_.find(key);
+        if (it != lock_table_.end() && it->second.readers > 0 && --it->second.readers == 0
+                && !it->second.sticky) {
+            lock_table_.erase(it);
+        }
+    }
+}
+
+size_t LockManager::Size() {
+    std::lock_guard<std::mutex> guard(table_mutex_);
+    if (!inherit_) return lock_table_.size();
+    size_t held = 0;
+    for (const auto& [_, state] : lock_table_) {
+        uint64_t owner = state.owner.load();
+        if ((owner != 0 && !(owner & kParked)) || state.readers > 0) held++;
+    }
+    return held;
 }
 
 // ---------------------------------------------------------------------------
 // TwoPLManager
 // ---------------------------------------------------------------------------
 
-TwoPLManager::TwoPLManager(Database& db, int base_backoff_us)
-    : db_(db), base_backoff_us_(base_backoff_us) {}
+TwoPLManager::TwoPLManager(Database& db, LockInheritance inheritance)
+    : db_(db), lock_mgr_(inheritance) {}
 
-Transaction TwoPLManager::Begin(const std::string& type_name,
-                                 const std::vector<std::string>& keys) {
+Transaction TwoPLManager::NewTxn(uint64_t txn_id, const std::string& type_name,
+                                  const std::vector<std::string>& keys) {
     Transaction txn;
-    txn.txn_id = ++txn_id_counter_;
+    txn.txn_id = txn_id;
     txn.type_name = type_name;
     txn.start_ts = 0;  // 2PL does not use timestamps
-    txn.lock_keys = keys;
+    txn.access = Declared(type_name);
+    txn.isolation = IsolationOf(type_name);
+    LockManager::AssignKeys(txn, keys);
     txn.status = TxnStatus::ACTIVE;
     txn.wall_start = std::chrono::steady_clock::now();
+    return txn;
+}
+
+Transaction TwoPLManager::Begin(const std::string& type_name,
+                                 const std::vector<std::string>& keys) {
+    Transaction txn = NewTxn(++txn_id_counter_, type_name, keys);
 
-    // Conservative 2PL: acquire ALL locks before any execution.
-    // Use exponential backoff + jitter to prevent livelock.
-    thread_local std::mt19937 rng(std::random_device{}());
-    int retry = 0;
-    while (!lock_mgr_.TryAcquireAll(txn.txn_id, keys)) {
-        int cap = std::min(retry, 10);
-        int backoff_us = base_backoff_us_ * (1 << cap);
-        std::uniform_int_distribution<int> jitter(0, backoff_us / 2);
-        std::this_thread::sleep_for(
-            std::chrono::microseconds(backoff_us + jitter(rng)));
-        retry++;
-    }
-    txn.retry_count = retry;
+    // Conservative 2PL: acquire ALL locks before any execution. Waiting
+    // transactions hold nothing, so queueing them cannot deadlock; each grant
+    // pass that passes one over counts as a retry.
+    txn.retry_count = lock_mgr_.Acquire(txn);
+    // With the locks held, the locked keys read the same in the snapshot
+    if (txn.isolation == IsolationLevel::kSnapshot) txn.snapshot = db_.GetSnapshot();
     return txn;
 }
 
+std::optional<Transaction> TwoPLManager::TryBegin(const std::string& type_name,
+                                                  const std::vector<std::string>& keys) {
+    Transaction txn = NewTxn(++txn_id_counter_, type_name, keys);
+    if (!lock_mgr_.TryAcquireAll(txn.txn_id, txn.lock_keys, txn.shared_keys)) return std::nullopt;
+    if (txn.isolation == IsolationLevel::kSnapshot) txn.snapshot = db_.GetSnapshot();
+    return txn;
+}
+
+std::vector<std::optional<Transaction>> TwoPLManager::BeginBatch(
+        const std::vector<BeginRequest>& requests) {
+    uint64_t first_id = txn_id_counter_.fetch_add(requests.size()) + 1;
+    std::vector<Transaction> candidates;
+    candidates.reserve(requests.size());
+    std::vector<Transaction*> pointers;
+    for (size_t i = 0; i < requests.size(); i++) {
+        candidates.push_back(NewTxn(first_id + i, requests[i].type_name, requests[i].keys));
+        pointers.push_back(&candidates.back());
+    }
+    std::vector<bool> acquired = lock_mgr_.TryAcquireEach(pointers);
+
+    std::vector<std::optional<Transaction>> txns(requests.size());
+    std::shared_ptr<const rocksdb::Snapshot> snapshot;
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (!acquired[i]) continue;
+        if (candidates[i].isolation == IsolationLevel::kSnapshot) {
+            if (!snapshot) snapshot = db_.GetSnapshot();
+            candidates[i].snapshot = snapshot;
+        }
+        txns[i] = std::move(candidates[i]);
+    }
+    return txns;
+}
+
 std::optional<std::string> TwoPLManager::Read(Transaction& txn,
                                                const std::string& key) {
+    if (!lock_mgr_.LockOnTouch(txn, key, false)) return std::nullopt;
     return txn.Read(key, db_);
 }
 
+bool TwoPLManager::StartRead(Transaction& txn, const std::string& key,
+                             std::optional<std::string>& value) {
+    if (!lock_mgr_.LockOnTouch(txn, key, false)) {
+        value = std::nullopt;
+        return false;
+    }
+    // Batched fetches read the latest values; snapshot reads go one by one
+    if (txn.snapshot) {
+        value = txn.Read(key, db_);
+        return false;
+    }
+    return !txn.ReadLocal(key, value);
+}
+
+std::optional<std::string> TwoPLManager::FinishRead(Transaction& txn, const std::string& key,
+                                                    std::optional<std::string> fetched) {
+    txn.RecordRead(key, fetched);
+    return fetched;
+}
+
 void TwoPLManager::Write(Transaction& txn, const std::string& key,
                           const std::string& value) {
+    // A snapshot transaction locking a key on its first write also checks
+    // that nothing overwrote it since the snapshot (first committer wins)
+    bool fresh = txn.snapshot
+              && std::find(txn.lock_keys.begin(), txn.lock_keys.end(), key) == txn.lock_keys.end();
+    if (!lock_mgr_.LockOnTouch(txn, key, true)) return;
+    if (fresh && !txn.SnapshotCurrent(key, db_)) {
+        txn.conflict_key = key;
+        txn.status = TxnStatus::ABORTED;
+        return;
+    }
     txn.Write(key, value);
 }
 
 CommitResult TwoPLManager::Commit(Transaction& txn) {
-    // Apply buffered writes to the database
-    for (const auto& [key, value] : txn.write_set) {
-        db_.Put(key, value);
+    if (txn.status == TxnStatus::ABORTED) {
+        Abort(txn);
+        return {false, txn.txn_id, txn.retry_count, txn.conflict_key};
     }
 
+    // Apply buffered writes to the database as one batch
+    db_.CommitWrites(txn.write_set);
+
     txn.status = TxnStatus::COMMITTED;
+    txn.snapshot.reset();
 
     // Release all locks — 2PL shrinking phase
-    lock_mgr_.ReleaseAll(txn.txn_id, txn.lock_keys);
+    lock_mgr_.ReleaseAll(txn.txn_id, txn.lock_keys, txn.shared_keys);
+
+    // No validation step needed: every key touched was locked
+    return {true, txn.txn_id, txn.retry_count, txn.conflict_key};
+}
 
-    // 2PL commit always succeeds; no validation step needed
-    return {true, txn.txn_id, txn.retry_count};
+void TwoPLManager::CommitAsync(Transaction txn, CommitCallback done) {
+    pipeline_.Submit(std::move(txn), std::move(done));
+}
+
+std::vector<CommitResult> TwoPLManager::CommitBatch(std::vector<Transaction>& txns) {
+    std::vector<CommitResult> results(txns.size());
+
+    // Every member still holds the locks on its keys, so the write sets are
+    // disjoint and one batch applies them all
+    std::vector<const std::unordered_map<std::string, std::string>*> write_sets;
+    std::vector<Transaction*> committed;
+    for (size_t i = 0; i < txns.size(); i++) {
+        Transaction& txn = txns[i];
+        if (txn.status == TxnStatus::ABORTED) {
+            Abort(txn);
+            results[i] = {false, txn.txn_id, txn.retry_count, txn.conflict_key};
+            continue;
+        }
+        write_sets.push_back(&txn.write_set);
+        committed.push_back(&txn);
+        txn.status = TxnStatus::COMMITTED;
+        txn.snapshot.reset();
+        results[i] = {true, txn.txn_id, txn.retry_count, txn.conflict_key};
+    }
+    db_.CommitWriteGroup(write_sets);
+
+    // Release all locks — 2PL shrinking phase
+    lock_mgr_.ReleaseEach(committed);
+    return results;
+}
+
+bool TwoPLManager::Prepare(Transaction& txn) {
+    if (txn.status == TxnStatus::ABORTED) {
+        Abort(txn);
+        return false;
+    }
+    txn.status = TxnStatus::PREPARED;
+    return true;
 }
 
 void TwoPLManager::Abort(Transaction& txn) {
     txn.status = TxnStatus::ABORTED;
     txn.read_set.clear();
     txn.write_set.clear();
+    txn.snapshot.reset();
 
     // Release all locks
-    lock_mgr_.ReleaseAll(txn.txn_id, txn.lock_keys);
+    lock_mgr_.ReleaseAll(txn.txn_id, txn.lock_keys, txn.shared_keys);
 }
 
 }  // namespace txn
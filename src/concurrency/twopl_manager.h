@@ -2,49 +2,232 @@
 #define TWOPL_MANAGER_H
 
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <cstdint>
+#include "concurrency/commit_pipeline.h"
 #include "concurrency/transaction_manager.h"
 #include "database/database.h"
 
 namespace txn {
 
-// Manages an exclusive-lock table for Conservative 2PL.
+// Whether a LockManager parks hot locks between a thread's transactions.
+// A named type rather than a bool, so a stray int or bool argument does not
+// turn it on.
+enum class LockInheritance {
+    kOff,
+    kOn,
+};
+
+// Manages the lock table for Conservative 2PL: exclusive locks, and shared
+// locks that any number of readers hold at once.
 // All locks for a transaction are acquired atomically before execution begins.
+//
+// With inheritance on, a thread releasing an exclusive lock on a key it
+// released recently keeps it parked for its next transaction instead of
+// freeing it. Acquire takes the calling thread's parked locks back without
+// the lock table; if those are all the keys it needs, it skips the table's
+// critical section entirely. Any other request treats a parked lock as free
+// and takes it over.
 class LockManager {
 public:
-    // Atomically check all keys are free, then lock them all for txn_id.
-    // Returns false immediately (acquiring nothing) if any key is held.
-    bool TryAcquireAll(uint64_t txn_id, const std::vector<std::string>& keys);
+    explicit LockManager(LockInheritance inheritance = LockInheritance::kOff);
+
+    // Atomically check all keys are free, then lock keys exclusively and
+    // shared_keys in shared mode for txn_id. Returns false immediately
+    // (acquiring nothing) if any key is held in a conflicting mode, setting
+    // *blocked, if given, to that key.
+    bool TryAcquireAll(uint64_t txn_id, const std::vector<std::string>& keys,
+                       const std::vector<std::string>& shared_keys = {},
+                       std::string* blocked = nullptr);
 
     // Release all locks held by txn_id for the given keys.
-    void ReleaseAll(uint64_t txn_id, const std::vector<std::string>& keys);
+    void ReleaseAll(uint64_t txn_id, const std::vector<std::string>& keys,
+                    const std::vector<std::string>& shared_keys = {});
+
+    // Blocks until txn's lock_keys and shared_keys are granted, and returns
+    // how many grant passes found them blocked; the key the last of those
+    // found held goes to txn.conflict_key. Requests are queued, not
+    // rejected: whichever thread finds no pass running drains every queued
+    // request into one critical section and grants, in arrival order, each
+    // one that fits beside the locks held and granted so far (a greedy
+    // independent set of the conflict graph) and does not conflict with an
+    // earlier request still waiting, so no request is passed over forever.
+    // Requests left over wait for the releases that regrant them. The
+    // no-wait paths (TryAcquireAll, LockOnTouch) do not queue and can still
+    // take a key a queued request is waiting for.
+    int Acquire(Transaction& txn);
+
+    // Turns txn_id's shared lock on key exclusive. Fails, keeping the shared
+    // lock, unless txn_id is its only holder.
+    bool TryUpgrade(uint64_t txn_id, const std::string& key);
+
+    // Adds keys to txn's locks, not yet taken: those its type declares
+    // read-only (txn.access) to shared_keys, unless its isolation level
+    // leaves reads unlocked, the rest to lock_keys.
+    static void AssignKeys(Transaction& txn, const std::vector<std::string>& keys);
+
+    // Locks a key txn did not declare up front (data-dependent accesses, e.g.
+    // an order id read from its district) on first touch, without waiting.
+    // If it is held elsewhere txn is doomed: its status becomes ABORTED and
+    // false is returned, so callers drop the access and fail the commit.
+    // No-wait keeps this deadlock-free alongside conservative up-front locks.
+    // Reads of keys the type declares read-only take a shared lock; a write
+    // to a key held shared upgrades it, failing the same way if others share it.
+    // Below repeatable read, reads take no lock; writes are always locked
+    // exclusive, so a read-modify-write still loses no update.
+    bool LockOnTouch(Transaction& txn, const std::string& key, bool write);
+
+    // TryAcquireAll / ReleaseAll for many transactions (their txn_id,
+    // lock_keys and shared_keys) in one critical section. Entry i of the
+    // result tells whether txns[i] got its locks; later entries see the
+    // locks of earlier ones.
+    std::vector<bool> TryAcquireEach(const std::vector<Transaction*>& txns);
+    void ReleaseEach(const std::vector<Transaction*>& txns);
+
+    // Number of keys currently locked, in either mode.
+    size_t Size();
+
+    // Requests passed to Acquire, and the critical sections that granted them
+    uint64_t QueuedRequests() const { return queued_requests_.load(); }
+    uint64_t GrantPasses() const { return grant_passes_.load(); }
+    // Parked locks taken back by their thread's next transaction, and parked
+    // locks taken over by another thread
+    uint64_t InheritedLocks() const { return inherited_locks_.load(); }
+    uint64_t HandOvers() const { return hand_overs_.load(); }
 
 private:
-    std::unordered_map<std::string, uint64_t> lock_table_;  // 0 = free
+    // Set in owner, with the parking thread's serial, while a lock is parked
+    static constexpr uint64_t kParked = uint64_t{1} << 63;
+    // A key is parked if its releasing thread released it among its last
+    // this many exclusive keys
+    static constexpr size_t kRecentReleases = 16;
+
+    struct LockState {
+        // Exclusive holder (0 = none), or kParked | thread serial. Changed
+        // under table_mutex_, except by the parking thread taking its lock back
+        std::atomic<uint64_t> owner{0};
+        int readers = 0;     // shared holders
+        // Parked at some point: kept in the table while free, since parking
+        // threads hold pointers to it
+        bool sticky = false;
+    };
+
+    // One thread's parked locks in this manager
+    struct Inherited {
+        std::unordered_map<std::string, LockState*> parked;
+        std::vector<std::string> recent;  // ring of recently released keys
+        size_t next = 0;
+    };
+
+    // An Acquire call waiting for its locks; lives on the caller's stack
+    struct LockRequest {
+        const Transaction* txn;
+        int passes = 0;      // grant passes that found it blocked
+        std::string blocked;   // guarded by table_mutex_: key the last of them found held
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool granted = false;  // guarded by mutex
+        bool grant = false;    // guarded by mutex: handed the grant passes
+    };
+
+    // Both require table_mutex_. With park, exclusive locks the calling
+    // thread released recently are parked rather than freed.
+    bool TryAcquireLocked(uint64_t txn_id, const std::vector<std::string>& keys,
+                          const std::vector<std::string>& shared_keys,
+                          std::string* blocked = nullptr);
+    void ReleaseLocked(uint64_t txn_id, const std::vector<std::string>& keys,
+                       const std::vector<std::string>& shared_keys, bool park = false);
+    // Requires table_mutex_. False if a transaction other than txn_id holds
+    // state's key; a parked lock is taken over and counts as free.
+    bool FreeOrParked(LockState& state, uint64_t txn_id);
+    // The calling thread's parked locks and release history
+    Inherited& Mine();
+    // Takes back the calling thread's parked locks among txn's exclusive
+    // keys and makes one attempt at the rest. False, holding nothing, if
+    // txn still has to queue.
+    bool TryReclaim(const Transaction& txn);
+    // Moves pending requests to waiting_ and grants them, pass after pass,
+    // until none are pending or self is granted; in the latter case the
+    // passes go to the first pending request
+    void RunGrantPasses(LockRequest& self);
+    // Grants the waiting requests that fit, in order, none ahead of an
+    // earlier conflicting one; requires table_mutex_
+    void GrantWaiting();
+
+    std::unordered_map<std::string, LockState> lock_table_;  // absent = free
     std::mutex table_mutex_;
+    std::vector<LockRequest*> waiting_;  // guarded by table_mutex_, arrival order
+
+    // Requests not yet moved to waiting_; one thread at a time runs grant
+    // passes over them
+    std::mutex pending_mutex_;
+    std::vector<LockRequest*> pending_;  // guarded by pending_mutex_
+    bool granting_ = false;              // guarded by pending_mutex_
+
+    std::atomic<uint64_t> queued_requests_{0};
+    std::atomic<uint64_t> grant_passes_{0};
+
+    bool inherit_;
+    uint64_t instance_;  // distinguishes managers in each thread's Inherited map
+    std::atomic<uint64_t> inherited_locks_{0};
+    std::atomic<uint64_t> hand_overs_{0};
 };
 
 class TwoPLManager : public TransactionManager {
 public:
-    explicit TwoPLManager(Database& db, int base_backoff_us = 100);
+    // inheritance: park hot locks between a thread's transactions (see LockManager)
+    explicit TwoPLManager(Database& db, LockInheritance inheritance = LockInheritance::kOff);
 
     Transaction Begin(const std::string& type_name,
                       const std::vector<std::string>& keys = {}) override;
     std::optional<std::string> Read(Transaction& txn, const std::string& key) override;
     void Write(Transaction& txn, const std::string& key, const std::string& value) override;
-    CommitResult Commit(Transaction& txn) override;  // always returns success=true
+    // Fails only if an undeclared key could not be locked (see LockManager::LockOnTouch)
+    CommitResult Commit(Transaction& txn) override;
+    // Queued for the commit pipeline; locks are held until the group that
+    // carries txn is applied
+    void CommitAsync(Transaction txn, CommitCallback done) override;
+    using TransactionManager::CommitAsync;
+    // One lock-table critical section for the whole batch
+    std::vector<std::optional<Transaction>> BeginBatch(const std::vector<BeginRequest>& requests) override;
+    // One WriteBatch for the batch, then one critical section to release its locks
+    std::vector<CommitResult> CommitBatch(std::vector<Transaction>& txns) override;
     void Abort(Transaction& txn) override;
+    // Locks are already held; fails only for a doomed transaction
+    bool Prepare(Transaction& txn) override;
     std::string ProtocolName() const override { return "2PL"; }
+    // One attempt at the up-front locks instead of Begin's queued wait
+    std::optional<Transaction> TryBegin(const std::string& type_name,
+                                        const std::vector<std::string>& keys) override;
+    bool StartRead(Transaction& txn, const std::string& key,
+                   std::optional<std::string>& value) override;
+    std::vector<std::optional<std::string>> Fetch(const std::vector<std::string>& keys) override {
+        return db_.MultiGet(keys);
+    }
+    std::optional<std::string> FinishRead(Transaction& txn, const std::string& key,
+                                          std::optional<std::string> fetched) override;
+    std::vector<std::pair<std::string, size_t>> StructureSizes() override {
+        return {{"lock_table", lock_mgr_.Size()}};
+    }
+    const LockManager& Locks() const { return lock_mgr_; }
 
 private:
+    // A new transaction that will hold keys; no locks taken yet
+    Transaction NewTxn(uint64_t txn_id, const std::string& type_name,
+                       const std::vector<std::string>& keys);
+
     Database& db_;
     LockManager lock_mgr_;
     std::atomic<uint64_t> txn_id_counter_{0};
-    int base_backoff_us_;
+
+    // Last member: drained before the lock table is destroyed
+    CommitPipeline pipeline_{[this](std::vector<Transaction>& group) {
+        return CommitBatch(group);
+    }};
 };
 
 }  // namespace txn
@@ -0,0 +1,144 @@
+#include "concurrency/versioned_occ_manager.h"
+#include <chrono>
+
+namespace txn {
+
+VersionedOCCManager::VersionedOCCManager(Database& db) : db_(db) {}
+
+Transaction VersionedOCCManager::Begin(const std::string& type_name,
+                                       const std::vector<std::string>& /*keys*/) {
+    Transaction txn;
+    txn.txn_id = ++txn_id_counter_;
+    txn.type_name = type_name;
+    txn.start_ts = 0;  // versions replace timestamps
+    txn.access = Declared(type_name);
+    txn.isolation = IsolationOf(type_name);
+    if (txn.isolation == IsolationLevel::kSnapshot) txn.snapshot = db_.GetSnapshot();
+    txn.status = TxnStatus::ACTIVE;
+    txn.wall_start = std::chrono::steady_clock::now();
+    return txn;
+}
+
+std::optional<std::string> VersionedOCCManager::Read(Transaction& txn, const std::string& key) {
+    std::optional<std::string> value;
+    if (txn.ReadLocal(key, value)) return value;
+
+    uint64_t version;
+    value = db_.GetVersioned(key, version, txn.snapshot.get());
+    txn.RecordRead(key, value);
+    // A later read that sees a newer version fails the check on this one
+    txn.read_versions.emplace(key, version);
+    return value;
+}
+
+void VersionedOCCManager::Write(Transaction& txn, const std::string& key, const std::string& value) {
+    txn.Write(key, value);
+}
+
+std::unordered_map<std::string, uint64_t> VersionedOCCManager::ExpectedVersions(const Transaction& txn) {
+    if (ProtectsReads(txn.isolation)) return txn.read_versions;
+    std::unordered_map<std::string, uint64_t> expected;
+    for (const auto& [key, _] : txn.write_set) {
+        auto it = txn.read_versions.find(key);
+        if (it != txn.read_versions.end()) {
+            expected.emplace(key, it->second);
+        } else if (txn.isolation == IsolationLevel::kSnapshot) {
+            uint64_t version;
+            db_.GetVersioned(key, version, txn.snapshot.get());
+            expected.emplace(key, version);
+        }
+    }
+    return expected;
+}
+
+bool VersionedOCCManager::TouchesPrepared(Transaction& txn) const {
+    if (prepared_keys_.empty()) return false;
+    for (const auto& [key, _] : txn.read_versions) {
+        if (prepared_keys_.count(key)) {
+            txn.conflict_key = key;
+            return true;
+        }
+    }
+    for (const auto& [key, _] : txn.write_set) {
+        if (prepared_keys_.count(key)) {
+            txn.conflict_key = key;
+            return true;
+        }
+    }
+    return false;
+}
+
+void VersionedOCCManager::ReleasePrepared(const Transaction& txn) {
+    for (const auto& [key, _] : txn.read_versions) {
+        auto it = prepared_keys_.find(key);
+        if (it != prepared_keys_.end() && --it->second == 0) prepared_keys_.erase(it);
+    }
+    for (const auto& [key, _] : txn.write_set) {
+        auto it = prepared_keys_.find(key);
+        if (it != prepared_keys_.end() && --it->second == 0) prepared_keys_.erase(it);
+    }
+}
+
+bool VersionedOCCManager::Prepare(Transaction& txn) {
+    if (txn.status == TxnStatus::ABORTED) {
+        Abort(txn);
+        return false;
+    }
+    auto expected = ExpectedVersions(txn);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (TouchesPrepared(txn) || !db_.CommitIfCurrent(expected, {}, &txn.conflict_key)) {
+        txn.status = TxnStatus::ABORTED;
+        txn.snapshot.reset();
+        return false;
+    }
+    // A key both read and written is counted twice and released twice
+    for (const auto& [key, _] : txn.read_versions) prepared_keys_[key]++;
+    for (const auto& [key, _] : txn.write_set) prepared_keys_[key]++;
+    txn.status = TxnStatus::PREPARED;
+    return true;
+}
+
+CommitResult VersionedOCCManager::Commit(Transaction& txn) {
+    if (txn.status == TxnStatus::ABORTED) {
+        Abort(txn);
+        return {false, txn.txn_id, txn.retry_count, txn.conflict_key};
+    }
+
+    bool committed;
+    if (txn.status == TxnStatus::PREPARED) {
+        // Checked in Prepare; pinned keys kept conflicting commits out since
+        std::lock_guard<std::mutex> lock(mutex_);
+        ReleasePrepared(txn);
+        committed = db_.CommitIfCurrent({}, txn.write_set);
+    } else if (txn.write_set.empty() && txn.read_versions.size() <= 1) {
+        // One read is consistent on its own, and nothing is written
+        committed = true;
+    } else {
+        auto expected = ExpectedVersions(txn);
+        std::lock_guard<std::mutex> lock(mutex_);
+        committed = !TouchesPrepared(txn)
+                 && db_.CommitIfCurrent(expected, txn.write_set, &txn.conflict_key);
+    }
+    txn.status = committed ? TxnStatus::COMMITTED : TxnStatus::ABORTED;
+    txn.snapshot.reset();
+    return {committed, txn.txn_id, txn.retry_count, txn.conflict_key};
+}
+
+void VersionedOCCManager::Abort(Transaction& txn) {
+    if (txn.status == TxnStatus::PREPARED) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ReleasePrepared(txn);
+    }
+    txn.status = TxnStatus::ABORTED;
+    txn.read_set.clear();
+    txn.write_set.clear();
+    txn.read_versions.clear();
+    txn.snapshot.reset();
+}
+
+std::vector<std::pair<std::string, size_t>> VersionedOCCManager::StructureSizes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {{"prepared_keys", prepared_keys_.size()}};
+}
+
+} // namespace txn
@@ -1,12 +1,53 @@
 #include "database/database.h"
+#include <chrono>
 #include <iostream>
 #include <rocksdb/options.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+#include <rocksdb/table.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/status.h>
+#include <rocksdb/write_batch.h>
+#include <rocksdb/version.h>
 
 namespace txn {
 
-bool Database::Open(const std::string& db_path) {
+namespace {
+
+// Perf level is per thread; each reader thread enables counting on first use.
+thread_local bool tl_perf_counting = false;
+
+// A value written by CommitIfCurrent is stored as this tag, the version as
+// 8 big-endian bytes, then the value. Workload values never start with a NUL.
+const char kVersionTag[] = {'\0', 'v'};
+constexpr size_t kVersionHeader = sizeof(kVersionTag) + 8;
+
+std::string EncodeVersioned(uint64_t version, const std::string& value) {
+    std::string stored(kVersionTag, sizeof(kVersionTag));
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        stored.push_back(static_cast<char>((version >> shift) & 0xff));
+    }
+    return stored + value;
+}
+
+// Strips the version header from a stored value; 0 if it has none
+uint64_t DecodeVersioned(std::string& value) {
+    if (value.size() < kVersionHeader || value.compare(0, sizeof(kVersionTag), kVersionTag,
+                                                       sizeof(kVersionTag)) != 0) {
+        return 0;
+    }
+    uint64_t version = 0;
+    for (size_t i = sizeof(kVersionTag); i < kVersionHeader; i++) {
+        version = (version << 8) | static_cast<unsigned char>(value[i]);
+    }
+    value.erase(0, kVersionHeader);
+    return version;
+}
+
+} // anonymous namespace
+
+bool Database::Open(const std::string& db_path, const StorageOptions& storage) {
     // Set RocksDB options
     options_.create_if_missing = true;
     options_.error_if_exists = false;
@@ -15,6 +56,18 @@ bool Database::Open(const std::string& db_path) {
     options_.IncreaseParallelism();
     options_.OptimizeLevelStyleCompaction();
 
+    storage_ = storage;
+    options_.use_direct_reads = storage.direct_reads;
+    options_.use_direct_io_for_flush_and_compaction = storage.direct_reads;
+    if (storage.block_cache_bytes > 0) {
+        rocksdb::BlockBasedTableOptions table_options;
+        table_options.block_cache = rocksdb::NewLRUCache(storage.block_cache_bytes);
+        // Index and filter blocks count against the cap instead of living outside it
+        table_options.cache_index_and_filter_blocks = true;
+        options_.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+    }
+    ResetReadStats();
+
     rocksdb::DB* db_raw;
     rocksdb::Status status = rocksdb::DB::Open(options_, db_path, &db_raw);
 
@@ -35,16 +88,51 @@ void Database::Close() {
     }
 }
 
-std::optional<std::string> Database::Get(const std::string& key) {
+std::optional<std::string> Database::Get(const std::string& key, const rocksdb::Snapshot* snapshot) {
+    uint64_t version;
+    return GetVersioned(key, version, snapshot);
+}
+
+std::optional<std::string> Database::GetVersioned(const std::string& key, uint64_t& version,
+                                                  const rocksdb::Snapshot* snapshot) {
+    version = 0;
     if (!db_) {
         std::cerr << "Database not open" << std::endl;
         return std::nullopt;
     }
 
+    rocksdb::ReadOptions read_options;
+    read_options.snapshot = snapshot;
     std::string value;
-    rocksdb::Status status = db_->Get(rocksdb::ReadOptions(), key, &value);
+    rocksdb::Status status;
+    if (storage_.collect_read_stats) {
+        if (!tl_perf_counting) {
+            rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+            tl_perf_counting = true;
+        }
+        rocksdb::PerfContext* perf = rocksdb::get_perf_context();
+        perf->Reset();
+        auto start = std::chrono::steady_clock::now();
+        status = db_->Get(read_options, key, &value);
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (perf->block_read_count > 0) {
+            miss_reads_.fetch_add(1, std::memory_order_relaxed);
+            miss_ns_.fetch_add(ns, std::memory_order_relaxed);
+            blocks_read_.fetch_add(perf->block_read_count, std::memory_order_relaxed);
+            bytes_read_.fetch_add(perf->block_read_byte, std::memory_order_relaxed);
+        } else {
+            hit_reads_.fetch_add(1, std::memory_order_relaxed);
+            hit_ns_.fetch_add(ns, std::memory_order_relaxed);
+        }
+        cache_hits_.fetch_add(perf->block_cache_hit_count, std::memory_order_relaxed);
+    } else {
+        status = db_->Get(read_options, key, &value);
+    }
 
     if (status.ok()) {
+        version = DecodeVersioned(value);
         return value;
     } else if (status.IsNotFound()) {
         return std::nullopt;
@@ -54,6 +142,67 @@ std::optional<std::string> Database::Get(const std::string& key) {
     }
 }
 
+std::shared_ptr<const rocksdb::Snapshot> Database::GetSnapshot() {
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return nullptr;
+    }
+    rocksdb::DB* db = db_.get();
+    return std::shared_ptr<const rocksdb::Snapshot>(
+        db->GetSnapshot(), [db](const rocksdb::Snapshot* snapshot) { db->ReleaseSnapshot(snapshot); });
+}
+
+std::vector<std::optional<std::string>> Database::MultiGet(const std::vector<std::string>& keys) {
+    std::vector<std::optional<std::string>> results(keys.size());
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return results;
+    }
+    if (keys.empty()) return results;
+
+    rocksdb::ReadOptions read_options;
+    read_options.async_io = storage_.async_io;
+    std::vector<rocksdb::Slice> slices(keys.begin(), keys.end());
+    std::vector<std::string> values;
+    std::vector<rocksdb::Status> statuses;
+    if (storage_.collect_read_stats) {
+        if (!tl_perf_counting) {
+            rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+            tl_perf_counting = true;
+        }
+        rocksdb::PerfContext* perf = rocksdb::get_perf_context();
+        perf->Reset();
+        auto start = std::chrono::steady_clock::now();
+        statuses = db_->MultiGet(read_options, slices, &values);
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (perf->block_read_count > 0) {
+            miss_reads_.fetch_add(keys.size(), std::memory_order_relaxed);
+            miss_ns_.fetch_add(ns, std::memory_order_relaxed);
+            blocks_read_.fetch_add(perf->block_read_count, std::memory_order_relaxed);
+            bytes_read_.fetch_add(perf->block_read_byte, std::memory_order_relaxed);
+        } else {
+            hit_reads_.fetch_add(keys.size(), std::memory_order_relaxed);
+            hit_ns_.fetch_add(ns, std::memory_order_relaxed);
+        }
+        cache_hits_.fetch_add(perf->block_cache_hit_count, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        statuses = db_->MultiGet(read_options, slices, &values);
+    }
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (statuses[i].ok()) {
+            DecodeVersioned(values[i]);
+            results[i] = std::move(values[i]);
+        } else if (!statuses[i].IsNotFound()) {
+            std::cerr << "MultiGet failed: " << statuses[i].ToString() << std::endl;
+        }
+    }
+    return results;
+}
+
 bool Database::Put(const std::string& key, const std::string& value) {
     if (!db_) {
         std::cerr << "Database not open" << std::endl;
@@ -86,6 +235,140 @@ bool Database::Delete(const std::string& key) {
     return true;
 }
 
+bool Database::PutBatch(const std::vector<std::pair<std::string, std::string>>& kvs) {
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return false;
+    }
+
+    rocksdb::WriteBatch batch;
+    for (const auto& [key, value] : kvs) {
+        batch.Put(key, value);
+    }
+    rocksdb::Status status = db_->Write(rocksdb::WriteOptions(), &batch);
+
+    if (!status.ok()) {
+        std::cerr << "PutBatch failed: " << status.ToString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool Database::CommitWrites(const std::unordered_map<std::string, std::string>& writes) {
+    return CommitWriteGroup({&writes});
+}
+
+bool Database::CommitWriteGroup(
+        const std::vector<const std::unordered_map<std::string, std::string>*>& write_sets) {
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return false;
+    }
+
+    rocksdb::WriteBatch batch;
+    for (const auto* writes : write_sets) {
+        for (const auto& [key, value] : *writes) {
+            batch.Put(key, value);
+        }
+    }
+    if (batch.Count() == 0) return true;
+
+    rocksdb::WriteOptions write_options;
+    write_options.sync = storage_.sync_commits;
+
+    std::unique_lock<std::mutex> lock(commit_mutex_, std::defer_lock);
+    if (observer_.load(std::memory_order_acquire)) lock.lock();
+    rocksdb::Status status = db_->Write(write_options, &batch);
+    if (!status.ok()) {
+        std::cerr << "CommitWrites failed: " << status.ToString() << std::endl;
+        return false;
+    }
+    if (lock.owns_lock()) {
+        // Re-read under the lock: DetachObserver may have run in between
+        CommitObserver* observer = observer_.load(std::memory_order_relaxed);
+        if (observer) {
+            for (const auto* writes : write_sets) {
+                if (!writes->empty()) observer->OnCommit(*writes);
+            }
+        }
+    }
+    return true;
+}
+
+bool Database::CommitIfCurrent(const std::unordered_map<std::string, uint64_t>& expected,
+                               const std::unordered_map<std::string, std::string>& writes,
+                               std::string* stale_key) {
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(commit_mutex_);
+    uint64_t version;
+    for (const auto& [key, read_version] : expected) {
+        GetVersioned(key, version);
+        if (version != read_version) {
+            if (stale_key) *stale_key = key;
+            return false;
+        }
+    }
+    if (writes.empty()) return true;
+
+    std::unordered_map<std::string, std::string> stored;
+    rocksdb::WriteBatch batch;
+    for (const auto& [key, value] : writes) {
+        auto it = expected.find(key);
+        if (it != expected.end()) {
+            version = it->second;
+        } else {
+            GetVersioned(key, version);
+        }
+        std::string encoded = EncodeVersioned(version + 1, value);
+        batch.Put(key, encoded);
+        stored.emplace(key, std::move(encoded));
+    }
+
+    rocksdb::WriteOptions write_options;
+    write_options.sync = storage_.sync_commits;
+    rocksdb::Status status = db_->Write(write_options, &batch);
+    if (!status.ok()) {
+        std::cerr << "CommitIfCurrent failed: " << status.ToString() << std::endl;
+        return false;
+    }
+    CommitObserver* observer = observer_.load(std::memory_order_relaxed);
+    if (observer) observer->OnCommit(stored);
+    return true;
+}
+
+std::map<std::string, std::string> Database::AttachObserver(CommitObserver* observer) {
+    std::lock_guard<std::mutex> lock(commit_mutex_);
+    std::map<std::string, std::string> contents = Dump();
+    observer_.store(observer, std::memory_order_release);
+    return contents;
+}
+
+void Database::DetachObserver() {
+    std::lock_guard<std::mutex> lock(commit_mutex_);
+    observer_.store(nullptr, std::memory_order_release);
+}
+
+bool Database::Flush() {
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return false;
+    }
+
+    rocksdb::Status status = db_->Flush(rocksdb::FlushOptions());
+
+    if (!status.ok()) {
+        std::cerr << "Flush failed: " << status.ToString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 bool Database::InitializeWithData(const std::map<std::string, std::string>& initial_data) {
     if (!db_) {
         std::cerr << "Database not open" << std::endl;
@@ -131,6 +414,62 @@ bool Database::Clear() {
     return true;
 }
 
+std::map<std::string, std::string> Database::Dump() {
+    std::map<std::string, std::string> contents;
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return contents;
+    }
+
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        contents.emplace(it->key().ToString(), it->value().ToString());
+    }
+    return contents;
+}
+
+bool Database::Restore(const std::map<std::string, std::string>& snapshot) {
+    if (!db_) {
+        std::cerr << "Database not open" << std::endl;
+        return false;
+    }
+
+    // Merge-join the live keys (iterator order) against the snapshot (map order)
+    rocksdb::WriteBatch batch;
+    auto snap = snapshot.begin();
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        std::string key = it->key().ToString();
+        while (snap != snapshot.end() && snap->first < key) {
+            batch.Put(snap->first, snap->second);  // deleted since the snapshot
+            ++snap;
+        }
+        if (snap != snapshot.end() && snap->first == key) {
+            if (it->value().ToString() != snap->second) {
+                batch.Put(key, snap->second);
+            }
+            ++snap;
+        } else {
+            batch.Delete(key);  // inserted since the snapshot
+        }
+    }
+    for (; snap != snapshot.end(); ++snap) {
+        batch.Put(snap->first, snap->second);
+    }
+
+    if (!it->status().ok()) {
+        std::cerr << "Iterator error: " << it->status().ToString() << std::endl;
+        return false;
+    }
+
+    rocksdb::Status status = db_->Write(rocksdb::WriteOptions(), &batch);
+    if (!status.ok()) {
+        std::cerr << "Restore failed: " << status.ToString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
 size_t Database::GetKeyCount() {
     if (!db_) {
         return 0;
@@ -150,4 +489,44 @@ Database::~Database() {
     Close();
 }
 
+ReadStats Database::GetReadStats() const {
+    ReadStats stats;
+    stats.hits        = hit_reads_.load();
+    stats.misses      = miss_reads_.load();
+    stats.blocks_read = blocks_read_.load();
+    stats.bytes_read  = bytes_read_.load();
+    stats.cache_hits  = cache_hits_.load();
+    stats.batches     = batches_.load();
+    if (stats.hits > 0) stats.hit_latency_us = hit_ns_.load() / 1000.0 / stats.hits;
+    if (stats.misses > 0) stats.miss_latency_us = miss_ns_.load() / 1000.0 / stats.misses;
+    return stats;
+}
+
+void Database::ResetReadStats() {
+    hit_reads_   = 0;
+    miss_reads_  = 0;
+    hit_ns_      = 0;
+    miss_ns_     = 0;
+    blocks_read_ = 0;
+    bytes_read_  = 0;
+    cache_hits_  = 0;
+    batches_     = 0;
+}
+
+std::optional<uint64_t> Database::GetIntProperty(const std::string& property) {
+    if (!db_) {
+        return std::nullopt;
+    }
+    uint64_t value = 0;
+    if (!db_->GetIntProperty(property, &value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::string Database::Version() {
+    return std::to_string(ROCKSDB_MAJOR) + "." + std::to_string(ROCKSDB_MINOR) + "."
+         + std::to_string(ROCKSDB_PATCH);
+}
+
 } // namespace txn
@@ -5,10 +5,58 @@
 #include <memory>
 #include <optional>
 #include <map>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
 #include <rocksdb/db.h>
 
 namespace txn {
 
+/**
+ * Storage tuning applied when the database is opened
+ */
+struct StorageOptions {
+    bool direct_reads = false;        // O_DIRECT for reads, flushes and compaction (bypasses page cache)
+    size_t block_cache_bytes = 0;     // LRU block cache capacity; 0 = RocksDB default
+    bool collect_read_stats = false;  // classify every Get as block-cache hit or miss
+    bool async_io = false;            // MultiGet issues a batch's block reads asynchronously
+                                      // (io_uring if RocksDB has it, else synchronous reads)
+    bool sync_commits = false;        // commits wait for the WAL to reach stable storage
+};
+
+/**
+ * Point-read counters collected when StorageOptions::collect_read_stats is set.
+ * A read counts as a miss if it had to read at least one block from storage.
+ */
+struct ReadStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    double hit_latency_us = 0.0;   // mean
+    double miss_latency_us = 0.0;  // mean
+    uint64_t blocks_read = 0;
+    uint64_t bytes_read = 0;
+    uint64_t cache_hits = 0;       // block cache hits across all reads
+    uint64_t batches = 0;          // MultiGet calls; their keys count as reads above
+};
+
+/**
+ * Receives every batch committed through Database::CommitWrites, in commit order
+ */
+class CommitObserver {
+public:
+    virtual ~CommitObserver() = default;
+
+    /**
+     * Called after the batch is written, with the commit lock still held, so
+     * calls are serialized and in the order the batches were applied. A
+     * group commit calls it once per transaction
+     * @param writes The committed transaction's write set
+     */
+    virtual void OnCommit(const std::unordered_map<std::string, std::string>& writes) = 0;
+};
+
 /**
  * Database Layer - Wrapper around RocksDB
  * Provides simple key-value storage with Get/Put/Delete operations
@@ -18,9 +66,10 @@ public:
     /**
      * Opens or creates a database at the specified path
      * @param db_path Path to database directory
+     * @param storage Cache, direct I/O and read-statistics settings
      * @return true if successful, false otherwise
      */
-    bool Open(const std::string& db_path);
+    bool Open(const std::string& db_path, const StorageOptions& storage = {});
 
     /**
      * Closes the database
@@ -30,9 +79,41 @@ public:
     /**
      * Retrieves a value for a given key
      * @param key The key to look up
+     * @param snapshot Read the value as of this snapshot (from GetSnapshot);
+     *                 nullptr reads the latest value
      * @return Optional containing the value if found, empty otherwise
      */
-    std::optional<std::string> Get(const std::string& key);
+    std::optional<std::string> Get(const std::string& key, const rocksdb::Snapshot* snapshot = nullptr);
+
+    /**
+     * Pins the current contents for reads through Get. The snapshot is
+     * released when the last copy of the pointer is dropped, which must
+     * happen before Close
+     * @return The snapshot, or nullptr if the database is not open
+     */
+    std::shared_ptr<const rocksdb::Snapshot> GetSnapshot();
+
+    /**
+     * Retrieves a value with the version stored alongside it by
+     * CommitIfCurrent. Values stored any other way (Put, CommitWrites) and
+     * missing keys are version 0. Get and MultiGet return the value alone
+     * @param key The key to look up
+     * @param version Set to the stored version
+     * @param snapshot Read as of this snapshot; nullptr reads the latest value
+     * @return Optional containing the value if found, empty otherwise
+     */
+    std::optional<std::string> GetVersioned(const std::string& key, uint64_t& version,
+                                            const rocksdb::Snapshot* snapshot = nullptr);
+
+    /**
+     * Retrieves many keys in one RocksDB MultiGet, which reads the blocks they
+     * need in parallel when StorageOptions::async_io is set. With read stats
+     * on, every key of a batch that read from storage counts as a miss, and
+     * each key is charged the batch latency divided by the batch size.
+     * @param keys The keys to look up
+     * @return One entry per key, in order; empty where the key was not found
+     */
+    std::vector<std::optional<std::string>> MultiGet(const std::vector<std::string>& keys);
 
     /**
      * Stores a key-value pair
@@ -49,6 +130,66 @@ public:
      */
     bool Delete(const std::string& key);
 
+    /**
+     * Writes many key-value pairs in one atomic WriteBatch
+     * @param kvs Pairs to store
+     * @return true if successful, false otherwise
+     */
+    bool PutBatch(const std::vector<std::pair<std::string, std::string>>& kvs);
+
+    /**
+     * Applies a committed transaction's write set in one atomic WriteBatch and
+     * passes it to the attached CommitObserver, if any
+     * @param writes Keys and values written by the transaction
+     * @return true if successful, false otherwise
+     */
+    bool CommitWrites(const std::unordered_map<std::string, std::string>& writes);
+
+    /**
+     * Applies the write sets of several committed transactions in one atomic
+     * WriteBatch (one WAL sync with StorageOptions::sync_commits) and passes
+     * each to the attached CommitObserver, in order
+     * @param write_sets The transactions' write sets, in commit order
+     * @return true if successful, false otherwise
+     */
+    bool CommitWriteGroup(const std::vector<const std::unordered_map<std::string, std::string>*>& write_sets);
+
+    /**
+     * Compare-and-set commit: under the commit lock, checks that every key
+     * in expected still has the stored version given, then writes writes in
+     * one atomic WriteBatch, each value stored with its key's version plus
+     * one. The attached CommitObserver, if any, receives the stored values.
+     * With empty writes, only checks
+     * @param expected Keys and the versions the transaction read
+     * @param writes Keys and values written by the transaction
+     * @param stale_key If given, set to a key whose version changed
+     * @return true if the versions matched and the batch was written
+     */
+    bool CommitIfCurrent(const std::unordered_map<std::string, uint64_t>& expected,
+                         const std::unordered_map<std::string, std::string>& writes,
+                         std::string* stale_key = nullptr);
+
+    /**
+     * Captures the database contents and attaches observer in one step, so
+     * the observer sees exactly the commits missing from the returned state.
+     * Attach before transactions start committing: commits already past the
+     * observer check are in neither
+     * @param observer Receives every later CommitWrites batch
+     * @return Contents at the attach point, as from Dump()
+     */
+    std::map<std::string, std::string> AttachObserver(CommitObserver* observer);
+
+    /**
+     * Stops passing commits to the observer; returns once no call is in progress
+     */
+    void DetachObserver();
+
+    /**
+     * Flushes memtables to SST files so later reads go through the block cache
+     * @return true if successful, false otherwise
+     */
+    bool Flush();
+
     /**
      * Initializes database with preset key-value pairs
      * Useful for setting up initial state before workload execution
@@ -64,6 +205,22 @@ public:
      */
     bool Clear();
 
+    /**
+     * Captures every key-value pair currently stored, values as stored
+     * (with the version header of CommitIfCurrent, if any)
+     * @return Ordered map of the full database contents
+     */
+    std::map<std::string, std::string> Dump();
+
+    /**
+     * Resets the database to a previously captured state in one atomic
+     * WriteBatch: keys missing from the snapshot are deleted, and only keys
+     * whose value differs are rewritten
+     * @param snapshot Contents previously returned by Dump()
+     * @return true if successful, false otherwise
+     */
+    bool Restore(const std::map<std::string, std::string>& snapshot);
+
     /**
      * Gets the total number of keys in the database
      * @return Number of keys
@@ -76,12 +233,53 @@ public:
      */
     bool IsOpen() const { return db_ != nullptr; }
 
+    /**
+     * Point-read hit/miss counters since Open or the last ResetReadStats
+     * (all zero unless StorageOptions::collect_read_stats was set)
+     * @return Snapshot of the counters
+     */
+    ReadStats GetReadStats() const;
+
+    /**
+     * Zeroes the point-read counters, e.g. after loading data
+     */
+    void ResetReadStats();
+
+    /**
+     * Reads a numeric RocksDB property
+     * (e.g. "rocksdb.estimate-pending-compaction-bytes")
+     * @param property Property name
+     * @return Optional containing the value if the property is known, empty otherwise
+     */
+    std::optional<uint64_t> GetIntProperty(const std::string& property);
+
+    /**
+     * Version of the RocksDB library this binary was compiled against
+     * @return "MAJOR.MINOR.PATCH"
+     */
+    static std::string Version();
+
     // Destructor
     ~Database();
 
 private:
     std::unique_ptr<rocksdb::DB> db_;
     rocksdb::Options options_;
+    StorageOptions storage_;
+
+    // Commits take commit_mutex_ only while an observer is attached;
+    // CommitIfCurrent always does
+    std::atomic<CommitObserver*> observer_{nullptr};
+    std::mutex commit_mutex_;
+
+    std::atomic<uint64_t> hit_reads_{0};
+    std::atomic<uint64_t> miss_reads_{0};
+    std::atomic<uint64_t> hit_ns_{0};
+    std::atomic<uint64_t> miss_ns_{0};
+    std::atomic<uint64_t> blocks_read_{0};
+    std::atomic<uint64_t> bytes_read_{0};
+    std::atomic<uint64_t> cache_hits_{0};
+    std::atomic<uint64_t> batches_{0};
 };
 
 } // namespace txn
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <climits>
+#include <csignal>
+#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -6,16 +10,28 @@
 #include <vector>
 
 #include "database/database.h"
-#include "concurrency/occ_manager.h"
+#include "concurrency/hybrid_manager.h"
+#include "concurrency/manager_factory.h"
 #include "concurrency/twopl_manager.h"
 #include "workload/workload_template.h"
 #include "workload/workload_executor.h"
 #include "workload/input_parser.h"
 #include "workload/key_selector.h"
-#include "workload/workload1_templates.h"
-#include "workload/workload2_templates.h"
+#include "workload/workload_builder.h"
+#include "workload/sweep_runner.h"
+#include "workload/soak_runner.h"
+#include "workload/data_generator.h"
 #include "workload/record.h"
 #include "metrics/metrics.h"
+#include "metrics/hot_key_tracker.h"
+#include "metrics/run_record.h"
+#include "metrics/run_compare.h"
+#include "server/txn_service.h"
+#include "server/socket_server.h"
+#include "server/shm_server.h"
+#include "cluster/cluster_runner.h"
+#include "replication/log_shipper.h"
+#include "replication/follower.h"
 
 using namespace txn;
 
@@ -25,13 +41,172 @@ struct CLIArgs {
     int hotset_size      = 10;
     double hotset_prob   = 0.5;
     std::string protocol = "occ";
+    std::string timestamps = "central";  // OCC timestamp oracle
+    bool inherit_locks     = false;      // 2PL: park hot locks between a worker's txns
+    std::map<std::string, std::string> template_protocols;  // hybrid: template -> occ | 2pl
+    std::map<std::string, std::string> isolation;  // template -> level; "" = all others
     std::string db_path  = "";         // auto-derived if empty
-    int workload         = 1;
+    std::string workload = "1";
     std::string input_file     = "";   // auto-derived if empty
     std::string csv_output     = "";
     std::string dump_latencies = "";
+    int hot_keys               = 0;    // top-K hot-key report; 0 = off
+    std::string worker_csv     = "";
+    int starvation_warn        = 0;    // retries before a watchdog warning; 0 = off
+    int queue_depth            = 0;    // > 1: coroutine transactions in flight per worker
+    bool async_io              = false;
+    bool sync_commits          = false;  // commits wait for a WAL sync
+    bool async_commit          = false;  // queue-depth commits through CommitAsync
+    int batch_size             = 0;      // > 1: transactions per ExecuteBatch call
+    std::string record         = "";   // JSON Lines run records
+
+    // --compare BASE CAND: diff two run-record files and exit
+    std::string compare_base   = "";
+    std::string compare_cand   = "";
+    CompareConfig compare;
+
+    // --serve PATH / --shm NAME: server mode over a Unix domain socket
+    // and/or shared-memory rings
+    std::string serve_path     = "";
+    std::string shm_name       = "";
+    ShmServerConfig shm;
+    int max_retries            = 0;    // server: aborts before giving up; 0 = until commit
+
+    // --partitions N: in-process cluster with two-phase commit
+    ClusterConfig cluster;
+
+    // --replicate PATH / --follow PATH: log-shipping primary and follower
+    std::string replicate_path = "";
+    std::string follow_path    = "";
+    int read_keys              = 4;    // follower: keys per read-only txn
+
+    // --workload smallbank / ycsb-*: generated workloads
+    WorkloadOptions workload_options;
+
+    // --memory-budget-mb: larger-than-memory mode over a generated dataset
+    size_t memory_budget_mb    = 0;
+    double dataset_multiple    = 4.0;
+    int value_size             = 1024;
+    bool direct_io             = true;
+
+    // --soak SECONDS: long-running drift detection
+    double soak_s              = 0.0;
+    double sample_interval_s   = 10.0;
+    size_t latency_reservoir   = 100000;
+    std::string soak_output    = "results/soak_samples.csv";
+    double drift_threshold_pct = 5.0;
+
+    // --sweep: in-process parameter sweep; empty lists fall back to the single-run value
+    bool sweep                 = false;
+    std::vector<std::string> sweep_workloads;
+    std::vector<std::string> sweep_protocols;
+    std::vector<int> sweep_threads;
+    std::vector<double> sweep_hotset_probs;
+    int repeats                = 5;
+    std::string sweep_output   = "results/sweep_results.csv";
 };
 
+// Splits "a,b,c" into its comma-separated fields.
+static std::vector<std::string> SplitList(const std::string& s) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (pos <= s.size()) {
+        size_t comma = s.find(',', pos);
+        if (comma == std::string::npos) comma = s.size();
+        if (comma > pos) out.push_back(s.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    return out;
+}
+
+// Storage section of the report for larger-than-memory runs.
+static void PrintLockStats(const LockManager& locks) {
+    std::cout << "\n--- Lock Manager ---\n"
+              << "  Queued requests:    " << locks.QueuedRequests() << "\n"
+              << "  Grant passes:       " << locks.GrantPasses() << "\n"
+              << "  Inherited locks:    " << locks.InheritedLocks() << "\n"
+              << "  Hand-overs:         " << locks.HandOvers() << "\n";
+}
+
+static void PrintReadStats(const ReadStats& reads, uint64_t commits, uint64_t aborts) {
+    uint64_t total = reads.hits + reads.misses;
+    uint64_t attempts = commits + aborts;
+    std::cout << std::fixed << std::setprecision(2)
+              << "\n--- Storage I/O ---\n"
+              << "  Point reads:        " << total << "\n"
+              << "  Cache-hit reads:    " << reads.hits << "  avg "
+              << reads.hit_latency_us << " us\n"
+              << "  Storage reads:      " << reads.misses << "  avg "
+              << reads.miss_latency_us << " us\n"
+              << "  Miss rate:          "
+              << (total > 0 ? 100.0 * reads.misses / total : 0.0) << "%\n"
+              << "  Blocks read/commit: "
+              << (commits > 0 ? static_cast<double>(reads.blocks_read) / commits : 0.0) << "\n"
+              << "  KiB read/commit:    "
+              << (commits > 0 ? reads.bytes_read / 1024.0 / commits : 0.0) << "\n"
+              << "  Reads/attempt:      "
+              << (attempts > 0 ? static_cast<double>(total) / attempts : 0.0) << "\n";
+    if (reads.batches > 0) {
+        std::cout << "  MultiGet batches:   " << reads.batches << "  avg "
+                  << static_cast<double>(total) / reads.batches << " keys\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// Signals that stop server mode.
+static sigset_t ShutdownSignals() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    return signals;
+}
+
+// Server mode: serves transactions on the Unix domain socket and/or the
+// shared-memory region (whichever is non-empty) until SIGINT or SIGTERM.
+// main blocks both signals before any thread starts, so sigwait receives
+// them here. Returns the serving time in seconds, or -1 if a transport could
+// not be opened.
+static double ServeUntilSignalled(TransactionManager& mgr, MetricsCollector& metrics,
+                                  const ServiceConfig& config, const std::string& socket_path,
+                                  const std::string& shm_name, const ShmServerConfig& shm_config) {
+    TxnService service(mgr, metrics, config);
+    SocketServer socket_server(service, socket_path);
+    ShmServer shm_server(service, shm_name, shm_config);
+    service.Start();
+    if ((!socket_path.empty() && !socket_server.Start())
+        || (!shm_name.empty() && !shm_server.Start())) {
+        socket_server.Stop();
+        shm_server.Stop();
+        service.Stop();
+        return -1.0;
+    }
+
+    std::cout << "Serving with " << config.num_workers << " workers\n";
+    if (!socket_path.empty()) std::cout << "  Socket:        " << socket_path << "\n";
+    if (!shm_name.empty()) {
+        std::cout << "  Shared memory: " << shm_name << " (" << shm_config.num_slots
+                  << " client slots)\n";
+    }
+    std::cout << "  Templates:";
+    for (size_t i = 0; i < config.templates.size(); i++) {
+        std::cout << " " << i << "=" << config.templates[i].name;
+    }
+    std::cout << "\n  Stop with Ctrl-C or SIGTERM\n" << std::flush;
+
+    sigset_t signals = ShutdownSignals();
+    int sig = 0;
+    sigwait(&signals, &sig);
+
+    std::cout << "\nStopping server (" << socket_server.ConnectionsAccepted()
+              << " socket connections, " << shm_server.ClientsAttached()
+              << " shared-memory clients)\n";
+    socket_server.Stop();
+    shm_server.Stop();
+    service.Stop();
+    return service.ElapsedSeconds();
+}
+
 CLIArgs ParseArgs(int argc, char* argv[]) {
     CLIArgs args;
     for (int i = 1; i < argc; i++) {
@@ -46,29 +221,238 @@ CLIArgs ParseArgs(int argc, char* argv[]) {
             args.hotset_prob = std::stod(argv[++i]);
         } else if (arg == "--protocol" && i + 1 < argc) {
             args.protocol = argv[++i];
+        } else if (arg == "--timestamps" && i + 1 < argc) {
+            args.timestamps = argv[++i];
+        } else if (arg == "--inherit-locks") {
+            args.inherit_locks = true;
+        } else if (arg == "--template-protocols" && i + 1 < argc) {
+            // "payment=2pl,new_order=occ"; an entry without '=' gets no
+            // protocol and is rejected when the manager is created
+            for (const auto& entry : SplitList(argv[++i])) {
+                size_t eq = entry.find('=');
+                args.template_protocols[entry.substr(0, eq)] =
+                    eq == std::string::npos ? "" : entry.substr(eq + 1);
+            }
+        } else if (arg == "--isolation" && i + 1 < argc) {
+            // "snapshot" for every template, or "stock_level=read-committed,..."
+            for (const auto& entry : SplitList(argv[++i])) {
+                size_t eq = entry.find('=');
+                if (eq == std::string::npos) {
+                    args.isolation[""] = entry;
+                } else {
+                    args.isolation[entry.substr(0, eq)] = entry.substr(eq + 1);
+                }
+            }
         } else if (arg == "--db-path" && i + 1 < argc) {
             args.db_path = argv[++i];
         } else if (arg == "--workload" && i + 1 < argc) {
-            args.workload = std::stoi(argv[++i]);
+            args.workload = argv[++i];
+        } else if (arg == "--smallbank-accounts" && i + 1 < argc) {
+            args.workload_options.smallbank.num_accounts = std::stoi(argv[++i]);
+        } else if (arg == "--tpcc-warehouses" && i + 1 < argc) {
+            args.workload_options.tpcc.warehouses = std::stoi(argv[++i]);
+        } else if (arg == "--tpcc-customers" && i + 1 < argc) {
+            args.workload_options.tpcc.customers_per_district = std::stoi(argv[++i]);
+        } else if (arg == "--tpcc-items" && i + 1 < argc) {
+            args.workload_options.tpcc.items = std::stoi(argv[++i]);
+        } else if (arg == "--tpcc-orders" && i + 1 < argc) {
+            args.workload_options.tpcc.orders_per_district = std::stoi(argv[++i]);
+        } else if (arg == "--ycsb-records" && i + 1 < argc) {
+            args.workload_options.ycsb.record_count = std::stoull(argv[++i]);
+        } else if (arg == "--ycsb-ops" && i + 1 < argc) {
+            args.workload_options.ycsb.ops_per_txn = std::stoi(argv[++i]);
+        } else if (arg == "--ycsb-scan-max" && i + 1 < argc) {
+            args.workload_options.ycsb.max_scan_length = std::stoi(argv[++i]);
+        } else if (arg == "--zipf-theta" && i + 1 < argc) {
+            args.workload_options.ycsb.zipf_theta = std::stod(argv[++i]);
         } else if (arg == "--input-file" && i + 1 < argc) {
             args.input_file = argv[++i];
         } else if (arg == "--csv-output" && i + 1 < argc) {
             args.csv_output = argv[++i];
         } else if (arg == "--dump-latencies" && i + 1 < argc) {
             args.dump_latencies = argv[++i];
+        } else if (arg == "--hot-keys" && i + 1 < argc) {
+            args.hot_keys = std::stoi(argv[++i]);
+        } else if (arg == "--worker-csv" && i + 1 < argc) {
+            args.worker_csv = argv[++i];
+        } else if (arg == "--starvation-warn" && i + 1 < argc) {
+            args.starvation_warn = std::stoi(argv[++i]);
+        } else if (arg == "--queue-depth" && i + 1 < argc) {
+            args.queue_depth = std::stoi(argv[++i]);
+        } else if (arg == "--async-io") {
+            args.async_io = true;
+        } else if (arg == "--sync-commits") {
+            args.sync_commits = true;
+        } else if (arg == "--async-commit") {
+            args.async_commit = true;
+        } else if (arg == "--batch-size" && i + 1 < argc) {
+            args.batch_size = std::stoi(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            args.record = argv[++i];
+        } else if (arg == "--compare" && i + 2 < argc) {
+            args.compare_base = argv[++i];
+            args.compare_cand = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            args.compare.threshold_pct = std::stod(argv[++i]);
+        } else if (arg == "--alpha" && i + 1 < argc) {
+            args.compare.alpha = std::stod(argv[++i]);
+        } else if (arg == "--serve" && i + 1 < argc) {
+            args.serve_path = argv[++i];
+        } else if (arg == "--shm" && i + 1 < argc) {
+            args.shm_name = argv[++i];
+        } else if (arg == "--shm-slots" && i + 1 < argc) {
+            args.shm.num_slots = std::stoul(argv[++i]);
+        } else if (arg == "--max-retries" && i + 1 < argc) {
+            args.max_retries = std::stoi(argv[++i]);
+        } else if (arg == "--partitions" && i + 1 < argc) {
+            args.cluster.placement.num_partitions = std::stoi(argv[++i]);
+        } else if (arg == "--partition-by" && i + 1 < argc) {
+            std::string scheme = argv[++i];
+            args.cluster.placement.scheme = scheme == "hash" ? PartitionScheme::kHash
+                                                             : PartitionScheme::kWarehouse;
+        } else if (arg == "--remote-customers") {
+            args.cluster.placement.customer_offset = 1;
+        } else if (arg == "--partition-latency-us" && i + 1 < argc) {
+            args.cluster.latency_us = std::stoi(argv[++i]);
+        } else if (arg == "--partition-handlers" && i + 1 < argc) {
+            args.cluster.handlers_per_partition = std::stoi(argv[++i]);
+        } else if (arg == "--replicate" && i + 1 < argc) {
+            args.replicate_path = argv[++i];
+        } else if (arg == "--follow" && i + 1 < argc) {
+            args.follow_path = argv[++i];
+        } else if (arg == "--read-keys" && i + 1 < argc) {
+            args.read_keys = std::stoi(argv[++i]);
+        } else if (arg == "--memory-budget-mb" && i + 1 < argc) {
+            args.memory_budget_mb = std::stoul(argv[++i]);
+        } else if (arg == "--dataset-multiple" && i + 1 < argc) {
+            args.dataset_multiple = std::stod(argv[++i]);
+        } else if (arg == "--value-size" && i + 1 < argc) {
+            args.value_size = std::stoi(argv[++i]);
+        } else if (arg == "--no-direct-io") {
+            args.direct_io = false;
+        } else if (arg == "--soak" && i + 1 < argc) {
+            args.soak_s = std::stod(argv[++i]);
+        } else if (arg == "--sample-interval" && i + 1 < argc) {
+            args.sample_interval_s = std::stod(argv[++i]);
+        } else if (arg == "--latency-reservoir" && i + 1 < argc) {
+            args.latency_reservoir = std::stoul(argv[++i]);
+        } else if (arg == "--soak-output" && i + 1 < argc) {
+            args.soak_output = argv[++i];
+        } else if (arg == "--drift-threshold" && i + 1 < argc) {
+            args.drift_threshold_pct = std::stod(argv[++i]);
+        } else if (arg == "--sweep") {
+            args.sweep = true;
+        } else if (arg == "--workloads" && i + 1 < argc) {
+            args.sweep_workloads = SplitList(argv[++i]);
+        } else if (arg == "--protocols" && i + 1 < argc) {
+            args.sweep_protocols = SplitList(argv[++i]);
+        } else if (arg == "--threads-list" && i + 1 < argc) {
+            for (const auto& v : SplitList(argv[++i])) args.sweep_threads.push_back(std::stoi(v));
+        } else if (arg == "--hotset-probs" && i + 1 < argc) {
+            for (const auto& v : SplitList(argv[++i])) args.sweep_hotset_probs.push_back(std::stod(v));
+        } else if (arg == "--repeats" && i + 1 < argc) {
+            args.repeats = std::stoi(argv[++i]);
+        } else if (arg == "--sweep-output" && i + 1 < argc) {
+            args.sweep_output = argv[++i];
         } else if (arg == "--help") {
             std::cout
                 << "Usage: transaction_system [options]\n"
-                << "  --workload N           Workload: 1 (bank transfer) or 2 (TPC-C-like)\n"
+                << "  --workload W           Workload: 1 (bank transfer), 2 (TPC-C-like),\n"
+                << "                         smallbank, tpcc (full TPC-C mix)\n"
+                << "                         or ycsb-a .. ycsb-f (YCSB core workloads)\n"
                 << "  --threads N            Worker threads (default: 4)\n"
                 << "  --txns-per-thread N    Transactions per thread (default: 100)\n"
                 << "  --hotset-size N        Hot key set size (default: 10)\n"
                 << "  --hotset-prob P        Hot key probability (default: 0.5)\n"
-                << "  --protocol P           occ | 2pl (default: occ)\n"
+                << "  --protocol P           occ | 2pl | hybrid | occ-versioned (default: occ)\n"
+                << "  --template-protocols L hybrid: protocol per template, e.g.\n"
+                << "                         payment=2pl,new_order=occ (others: occ)\n"
+                << "  --isolation L          read-committed | repeatable-read | snapshot |\n"
+                << "                         serializable for every template, or per template,\n"
+                << "                         e.g. stock_level=snapshot (default: serializable)\n"
+                << "  --timestamps T         OCC timestamp oracle: central | batched | epoch |\n"
+                << "                         clock (default: central)\n"
+                << "  --inherit-locks        2PL: a worker keeps hot locks parked for its next\n"
+                << "                         transaction until another thread asks for them\n"
                 << "  --db-path PATH         Database directory (auto if omitted)\n"
-                << "  --input-file PATH      Input file (auto if omitted)\n"
+                << "  --input-file PATH      Input file (auto if omitted; smallbank and\n"
+                << "                         ycsb-* generate their data when omitted)\n"
+                << "  --smallbank-accounts N Customers generated for smallbank (default: 10000)\n"
                 << "  --csv-output PATH      Append results row to CSV\n"
-                << "  --dump-latencies PATH  Dump raw latency samples to CSV\n";
+                << "  --dump-latencies PATH  Dump raw latency samples to CSV\n"
+                << "  --hot-keys K           Sample accesses and report the K hottest keys\n"
+                << "  --worker-csv PATH      Append per-worker fairness rows to CSV\n"
+                << "  --starvation-warn N    Warn when a transaction retries N times\n"
+                << "  --record PATH          Append a JSON run record (config, environment, metrics)\n"
+                << "  --queue-depth N        Transactions in flight per worker as coroutines, with\n"
+                << "                         their reads batched into one MultiGet (default: off;\n"
+                << "                         workload 1 and larger-than-memory mode)\n"
+                << "  --async-io             MultiGet reads with RocksDB async_io (io_uring)\n"
+                << "  --async-commit         With --queue-depth: commit through the manager's\n"
+                << "                         group-commit pipeline instead of on the worker\n"
+                << "  --sync-commits         Commits wait for the WAL to be synced to storage\n"
+                << "  --batch-size N         Each worker submits N transactions per ExecuteBatch\n"
+                << "                         call: one begin and one commit pass for all N\n"
+                << "\nTPC-C (--workload tpcc; defaults are the spec cardinalities):\n"
+                << "  --tpcc-warehouses N    Warehouses (default: 1)\n"
+                << "  --tpcc-customers N     Customers per district (default: 3000)\n"
+                << "  --tpcc-items N         Items, also stock rows per warehouse (default: 100000)\n"
+                << "  --tpcc-orders N        Initial orders per district (default: 3000)\n"
+                << "\nYCSB workloads (--workload ycsb-a .. ycsb-f):\n"
+                << "  --ycsb-records N       Records loaded before the run (default: 10000)\n"
+                << "  --ycsb-ops N           Operations per transaction (default: 1)\n"
+                << "  --ycsb-scan-max N      Maximum scan length for ycsb-e (default: 100)\n"
+                << "  --zipf-theta T         Zipfian skew, 0 <= T < 1 (default: 0.99)\n"
+                << "\nRegression comparison:\n"
+                << "  --compare BASE CAND    Compare two run-record files and exit\n"
+                << "                         (exit status 1 on significant regression)\n"
+                << "  --threshold PCT        Throughput/p99 change treated as a regression (default: 5)\n"
+                << "  --alpha A              Significance level for Welch's t-test (default: 0.05)\n"
+                << "\nServer mode (load data, then serve transactions until SIGINT/SIGTERM):\n"
+                << "  --serve PATH           Listen on Unix domain socket PATH; --threads sets\n"
+                << "                         the worker count (drive it with load_client)\n"
+                << "  --shm NAME             Also (or only) serve same-host clients over\n"
+                << "                         shared-memory rings, e.g. /txn_engine\n"
+                << "  --shm-slots N          Concurrent shared-memory clients (default: 16)\n"
+                << "  --max-retries N        Aborts before a request fails (default: 0 = retry\n"
+                << "                         until commit)\n"
+                << "\nCluster mode (partitions in one process, two-phase commit across them):\n"
+                << "  --partitions N         Partitions, each with its own database and manager;\n"
+                << "                         N >= 2 enables the mode (--threads coordinators)\n"
+                << "  --partition-by S       warehouse (workload 2 / tpcc keys by warehouse,\n"
+                << "                         others by hash) | hash (default: warehouse)\n"
+                << "  --remote-customers     Place customers one partition over from their\n"
+                << "                         warehouse\n"
+                << "  --partition-latency-us US  One-way message latency (default: 100)\n"
+                << "  --partition-handlers N Message handler threads per partition (default: 4)\n"
+                << "\nReplication (log shipping to a follower process on the same host):\n"
+                << "  --replicate PATH       Wait for a follower on Unix socket PATH after\n"
+                << "                         loading, then stream every commit to it\n"
+                << "  --follow PATH          Run as the follower of that primary: replay into\n"
+                << "                         --db-path (default: db_follower) while --threads\n"
+                << "                         readers run read-only transactions\n"
+                << "  --read-keys N          Keys per follower read-only transaction (default: 4)\n"
+                << "\nLarger-than-memory mode (transfers over a generated dataset):\n"
+                << "  --memory-budget-mb MB  Block cache cap; enables the mode\n"
+                << "  --dataset-multiple X   Dataset size as a multiple of the budget (default: 4)\n"
+                << "  --value-size BYTES     Bytes per account value (default: 1024)\n"
+                << "  --no-direct-io         Keep reads in the OS page cache\n"
+                << "                         (default: use_direct_reads on)\n"
+                << "\nSoak mode (bounded metrics memory, drift detection):\n"
+                << "  --soak SECONDS         Run for SECONDS instead of --txns-per-thread\n"
+                << "  --sample-interval S    Seconds between samples (default: 10)\n"
+                << "  --latency-reservoir N  Latency samples kept per txn type (default: 100000)\n"
+                << "  --soak-output PATH     Per-sample CSV (default: results/soak_samples.csv)\n"
+                << "  --drift-threshold PCT  Trend over the run that counts as drift (default: 5)\n"
+                << "\nSweep mode (in-process, data loaded once per workload):\n"
+                << "  --sweep                Run every combination of the lists below\n"
+                << "  --workloads LIST       e.g. 1,2,ycsb-a (default: --workload)\n"
+                << "  --protocols LIST       e.g. occ,2pl,hybrid (default: --protocol)\n"
+                << "  --threads-list LIST    e.g. 1,2,4,8 (default: --threads)\n"
+                << "  --hotset-probs LIST    e.g. 0.1,0.5,0.9 (default: --hotset-prob)\n"
+                << "  --repeats N            Runs per combination (default: 5)\n"
+                << "  --sweep-output PATH    CSV with means and 95% CIs\n"
+                << "                         (default: results/sweep_results.csv)\n";
             exit(0);
         }
     }
@@ -77,14 +461,124 @@ CLIArgs ParseArgs(int argc, char* argv[]) {
 
 int main(int argc, char* argv[]) {
     CLIArgs args = ParseArgs(argc, argv);
+    const YcsbConfig& ycsb_config = args.workload_options.ycsb;
+    if (args.workload_options.smallbank.num_accounts < 2) {
+        std::cerr << "--smallbank-accounts must be at least 2\n";
+        return 1;
+    }
+    const TpccConfig& tpcc_config = args.workload_options.tpcc;
+    if (tpcc_config.warehouses < 1 || tpcc_config.districts_per_warehouse < 1
+        || tpcc_config.customers_per_district < 1 || tpcc_config.items < 1
+        || tpcc_config.orders_per_district < 1) {
+        std::cerr << "TPC-C warehouses, customers, items and orders must be >= 1\n";
+        return 1;
+    }
+    if (ycsb_config.record_count == 0 || ycsb_config.ops_per_txn < 1
+        || ycsb_config.max_scan_length < 1 || ycsb_config.field_count < 1
+        || ycsb_config.zipf_theta < 0.0 || ycsb_config.zipf_theta >= 1.0) {
+        std::cerr << "Invalid YCSB options: records and ops must be >= 1, 0 <= theta < 1\n";
+        return 1;
+    }
+
+    const bool serving = !args.serve_path.empty() || !args.shm_name.empty();
+    if (serving) {
+        // Before RocksDB or the server start threads, so they inherit the mask
+        sigset_t signals = ShutdownSignals();
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    }
+
+    if (!args.compare_base.empty()) {
+        return CompareRunRecords(args.compare_base, args.compare_cand, args.compare);
+    }
+
+    if (!args.follow_path.empty()) {
+        FollowerConfig follower;
+        follower.socket_path    = args.follow_path;
+        follower.reader_threads = args.threads;
+        follower.keys_per_read  = args.read_keys;
+        if (!args.db_path.empty()) follower.db_path = args.db_path;
+        return RunFollower(follower);
+    }
+
+    if (args.soak_s > 0.0) {
+        SoakConfig soak;
+        soak.workload            = args.workload;
+        soak.protocol            = args.protocol;
+        soak.threads             = args.threads;
+        soak.hotset_size         = args.hotset_size;
+        soak.hotset_prob         = args.hotset_prob;
+        soak.duration_s          = args.soak_s;
+        soak.sample_interval_s   = args.sample_interval_s;
+        soak.latency_reservoir   = args.latency_reservoir;
+        soak.output              = args.soak_output;
+        soak.drift_threshold_pct = args.drift_threshold_pct;
+        soak.workload_options    = args.workload_options;
+        if (!args.db_path.empty()) soak.db_path = args.db_path;
+        return RunSoak(soak);
+    }
+
+    if (args.sweep) {
+        SweepConfig sweep;
+        sweep.workloads       = args.sweep_workloads.empty()
+                              ? std::vector<std::string>{args.workload} : args.sweep_workloads;
+        sweep.protocols       = args.sweep_protocols.empty()
+                              ? std::vector<std::string>{args.protocol} : args.sweep_protocols;
+        sweep.threads         = args.sweep_threads.empty()
+                              ? std::vector<int>{args.threads} : args.sweep_threads;
+        sweep.hotset_probs    = args.sweep_hotset_probs.empty()
+                              ? std::vector<double>{args.hotset_prob} : args.sweep_hotset_probs;
+        sweep.hotset_size     = args.hotset_size;
+        sweep.txns_per_thread = args.txns_per_thread;
+        sweep.repeats         = args.repeats;
+        sweep.output          = args.sweep_output;
+        sweep.record_path     = args.record;
+        sweep.workload_options = args.workload_options;
+        sweep.manager_options.timestamps         = args.timestamps;
+        sweep.manager_options.inherit_locks      = args.inherit_locks;
+        sweep.manager_options.template_protocols = args.template_protocols;
+        sweep.manager_options.isolation          = args.isolation;
+        return RunSweep(sweep);
+    }
+
+    const bool large = args.memory_budget_mb > 0;
+
+    if (args.cluster.placement.num_partitions > 1) {
+        if (serving || large || !args.replicate_path.empty() || args.queue_depth > 1
+                || args.batch_size > 1) {
+            std::cerr << "--partitions cannot be combined with server, replication,"
+                         " queue-depth, batch or larger-than-memory mode\n";
+            return 1;
+        }
+        ClusterRunConfig cluster;
+        cluster.workload         = args.workload;
+        cluster.input_file       = args.input_file;
+        cluster.threads          = args.threads;
+        cluster.txns_per_thread  = args.txns_per_thread;
+        cluster.hotset_size      = args.hotset_size;
+        cluster.hotset_prob      = args.hotset_prob;
+        cluster.workload_options = args.workload_options;
+        cluster.cluster          = args.cluster;
+        cluster.cluster.protocol = args.protocol;
+        cluster.cluster.db_path  = args.db_path.empty() ? "db_cluster_w" + args.workload
+                                                        : args.db_path;
+        std::cout << "Transaction Processing System (cluster mode)\n"
+                  << "============================================\n"
+                  << "Workload:        " << args.workload        << "\n"
+                  << "Protocol:        " << args.protocol        << "\n"
+                  << "Threads:         " << args.threads         << "\n"
+                  << "Txns/thread:     " << args.txns_per_thread << "\n";
+        return RunCluster(cluster);
+    }
 
     // Auto-derive paths
     if (args.db_path.empty()) {
-        args.db_path = "db_w" + std::to_string(args.workload) + "_" + args.protocol;
+        // The generated dataset is kept between runs and reused when it matches
+        args.db_path = large ? "db_large"
+                             : "db_w" + args.workload + "_" + args.protocol;
     }
-    if (args.input_file.empty()) {
-        args.input_file = "workloads/workload" + std::to_string(args.workload)
-                        + "/input" + std::to_string(args.workload) + ".txt";
+    const bool ycsb = YcsbWorkloadLetter(args.workload) != 0;
+    if (args.input_file.empty() && !IsGeneratedWorkload(args.workload)) {
+        args.input_file = DefaultInputFile(args.workload);
     }
 
     std::cout << "Transaction Processing System\n"
@@ -96,146 +590,248 @@ int main(int argc, char* argv[]) {
               << "Hotset size:     " << args.hotset_size     << "\n"
               << "Hotset prob:     " << args.hotset_prob     << "\n"
               << "DB path:         " << args.db_path         << "\n"
-              << "Input file:      " << args.input_file      << "\n\n";
+              << "Input file:      " << (large || args.input_file.empty() ? "(generated)"
+                                                                      : args.input_file) << "\n";
+    if (ycsb) {
+        std::cout << "YCSB:            " << ycsb_config.record_count << " records, "
+                  << ycsb_config.ops_per_txn << " ops/txn, zipf theta "
+                  << ycsb_config.zipf_theta << "\n";
+    }
+    if (large) {
+        std::cout << "Memory budget:   " << args.memory_budget_mb << " MiB block cache, dataset x"
+                  << args.dataset_multiple << ", direct reads "
+                  << (args.direct_io ? "on" : "off") << "\n";
+    }
+    if (args.queue_depth > 1) {
+        std::cout << "Queue depth:     " << args.queue_depth << " txns per worker, async_io "
+                  << (args.async_io ? "on" : "off") << ", async commit "
+                  << (args.async_commit ? "on" : "off") << "\n";
+    }
+    if (args.sync_commits) {
+        std::cout << "Sync commits:    on\n";
+    }
+    if (args.timestamps != "central") {
+        std::cout << "Timestamps:      " << args.timestamps << " oracle\n";
+    }
+    if (args.inherit_locks) {
+        std::cout << "Lock inheritance: on\n";
+    }
+    if (args.protocol == "hybrid") {
+        std::cout << "Template protocols:";
+        for (const auto& [type_name, assigned] : args.template_protocols) {
+            std::cout << " " << type_name << "=" << assigned;
+        }
+        std::cout << " (others occ)\n";
+    }
+    if (!args.isolation.empty()) {
+        std::cout << "Isolation:      ";
+        for (const auto& [type_name, level] : args.isolation) {
+            std::cout << " " << (type_name.empty() ? level : type_name + "=" + level);
+        }
+        std::cout << "\n";
+    }
+    if (args.batch_size > 1) {
+        std::cout << "Batch size:      " << args.batch_size << " txns per ExecuteBatch\n";
+    }
+    if (!args.replicate_path.empty()) {
+        std::cout << "Replicate to:    " << args.replicate_path << "\n";
+    }
+    std::cout << "\n";
 
-    // Parse input file
-    ParseResult parsed = ParseInputFile(args.input_file);
+    // Parse input file (larger-than-memory mode generates its data instead)
+    ParseResult parsed = large                   ? ParseResult{}
+                       : args.input_file.empty() ? LoadWorkloadInput(args.workload, args.workload_options)
+                                                 : ParseInputFile(args.input_file);
+
+    StorageOptions storage;
+    storage.async_io = args.async_io;
+    storage.sync_commits = args.sync_commits;
+    if (large) {
+        storage.direct_reads       = args.direct_io;
+        storage.block_cache_bytes  = args.memory_budget_mb << 20;
+        storage.collect_read_stats = true;
+    }
 
     // Open and initialize database
     Database db;
-    if (!db.Open(args.db_path)) {
+    if (!db.Open(args.db_path, storage)) {
         std::cerr << "Failed to open database: " << args.db_path << "\n";
         return 1;
     }
-    db.InitializeWithData(parsed.initial_data);
 
-    std::cout << "Loaded " << parsed.initial_data.size() << " records\n";
+    uint64_t large_keys = 0;
+    if (large) {
+        LargeDatasetConfig data_config;
+        data_config.target_bytes = static_cast<uint64_t>(
+            (args.memory_budget_mb << 20) * args.dataset_multiple);
+        data_config.value_bytes  = args.value_size;
+        large_keys = GenerateLargeDataset(db, data_config);
+        if (large_keys == 0) {
+            std::cerr << "Failed to generate dataset in " << args.db_path << "\n";
+            return 1;
+        }
+        db.ResetReadStats();
+    } else {
+        db.InitializeWithData(parsed.initial_data);
+        std::cout << "Loaded " << parsed.initial_data.size() << " records\n";
+    }
 
     // Create concurrency manager
-    std::unique_ptr<TransactionManager> mgr_ptr;
-    if (args.protocol == "occ") {
-        mgr_ptr = std::make_unique<OCCManager>(db);
-    } else if (args.protocol == "2pl") {
-        mgr_ptr = std::make_unique<TwoPLManager>(db);
-    } else {
-        std::cerr << "Unknown protocol: " << args.protocol << "\n";
+    ManagerOptions manager_options;
+    manager_options.timestamps    = args.timestamps;
+    manager_options.inherit_locks = args.inherit_locks;
+    manager_options.template_protocols = args.template_protocols;
+    manager_options.isolation = args.isolation;
+    std::unique_ptr<TransactionManager> mgr_ptr = MakeTransactionManager(args.protocol, db,
+                                                                         manager_options);
+    if (!mgr_ptr) {
+        std::cerr << "Unknown protocol, timestamp oracle, template protocol or isolation level: "
+                  << args.protocol << ", " << args.timestamps << "\n";
         return 1;
     }
     TransactionManager& mgr = *mgr_ptr;
 
-    // Build workload templates with injected key_builder lambdas
-    std::vector<WorkloadTemplate> templates;
-
-    if (args.workload == 1) {
-        auto account_keys = parsed.account_keys;
-        int  hotset_size  = args.hotset_size;
-        double hotset_prob = args.hotset_prob;
-
-        auto tmpl = MakeW1TransferTemplate();
-        tmpl.key_builder = [account_keys, hotset_size, hotset_prob]
-                           (std::mt19937& rng) -> std::vector<std::string> {
-            int n       = static_cast<int>(account_keys.size());
-            int hot_max = std::min(hotset_size, n) - 1;
-            std::uniform_real_distribution<double> prob_dist(0.0, 1.0);
-            std::uniform_int_distribution<int>     hot_dist(0, std::max(0, hot_max));
-            std::uniform_int_distribution<int>     all_dist(0, n - 1);
-
-            std::set<int> used;
-            std::vector<std::string> keys;
-            while (static_cast<int>(keys.size()) < 2) {
-                int idx = (prob_dist(rng) < hotset_prob) ? hot_dist(rng) : all_dist(rng);
-                if (used.find(idx) == used.end()) {
-                    used.insert(idx);
-                    keys.push_back(account_keys[idx]);
-                }
-            }
-            return keys;
-        };
-        templates.push_back(std::move(tmpl));
-
-    } else if (args.workload == 2) {
-        int    hotset_size = args.hotset_size;
-        double hotset_prob = args.hotset_prob;
-
-        // Scale hotset size proportionally to each domain's size vs. workload-1's 500 keys.
-        auto make_domain = [&](const std::vector<std::string>& keys)
-                -> MultiDomainKeySelector::DomainConfig {
-            int domain_size  = static_cast<int>(keys.size());
-            int scaled_hot   = std::max(1, domain_size * hotset_size / 500);
-            return {keys, scaled_hot, hotset_prob};
-        };
-
-        auto selector = std::make_shared<MultiDomainKeySelector>(
-            std::map<std::string, MultiDomainKeySelector::DomainConfig>{
-                {"W", make_domain(parsed.warehouse_keys)},
-                {"D", make_domain(parsed.district_keys)},
-                {"S", make_domain(parsed.supply_keys)},
-                {"C", make_domain(parsed.customer_keys)},
-            });
-
-        // new_order: keys = [D, S1, S2, S3] with 3 distinct supply keys
-        auto tmpl_no = MakeW2NewOrderTemplate();
-        tmpl_no.key_builder = [selector](std::mt19937& rng) -> std::vector<std::string> {
-            std::vector<std::string> keys;
-            keys.push_back(selector->SelectFromDomain("D", rng));
-            std::set<std::string> used;
-            while (static_cast<int>(used.size()) < 3) {
-                used.insert(selector->SelectFromDomain("S", rng));
-            }
-            for (const auto& k : used) keys.push_back(k);
-            return keys;
-        };
-        templates.push_back(std::move(tmpl_no));
-
-        // payment: keys = [W, D, C]
-        auto tmpl_pay = MakeW2PaymentTemplate();
-        tmpl_pay.key_builder = [selector](std::mt19937& rng) -> std::vector<std::string> {
-            return {
-                selector->SelectFromDomain("W", rng),
-                selector->SelectFromDomain("D", rng),
-                selector->SelectFromDomain("C", rng),
-            };
-        };
-        templates.push_back(std::move(tmpl_pay));
+    // The follower starts from the loaded data and then receives every commit
+    std::unique_ptr<LogShipper> shipper;
+    if (!args.replicate_path.empty()) {
+        shipper = std::make_unique<LogShipper>(db, args.replicate_path);
+        if (!shipper->Listen()) {
+            db.Close();
+            return 1;
+        }
+        std::cout << "Waiting for a follower on " << args.replicate_path << "...\n";
+        if (!shipper->AcceptFollower()) {
+            db.Close();
+            return 1;
+        }
+        std::cout << "Follower attached\n";
+    }
 
-    } else {
+    // Build workload templates with injected key_builder lambdas
+    std::vector<WorkloadTemplate> templates = large
+        ? std::vector<WorkloadTemplate>{
+              MakeLargeTransferTemplate(large_keys, args.hotset_size, args.hotset_prob)}
+        : BuildWorkloadTemplates(args.workload, parsed, args.hotset_size, args.hotset_prob,
+                                 args.workload_options);
+    if (templates.empty()) {
         std::cerr << "Unknown workload: " << args.workload << "\n";
         return 1;
     }
+    if (args.queue_depth > 1 && args.batch_size > 1) {
+        std::cerr << "--queue-depth and --batch-size cannot be combined\n";
+        return 1;
+    }
+    if (args.queue_depth > 1 && !serving) {
+        for (const auto& tmpl : templates) {
+            if (!tmpl.async_execute) {
+                std::cerr << "--queue-depth: template " << tmpl.name
+                          << " has no coroutine version\n";
+                return 1;
+            }
+        }
+    }
 
     // Configure and run executor
     ExecutorConfig exec_config;
     exec_config.num_threads         = args.threads;
     exec_config.txns_per_thread     = args.txns_per_thread;
-    exec_config.contention          = {static_cast<int>(parsed.initial_data.size()),
+    exec_config.contention          = {large ? static_cast<int>(std::min<uint64_t>(large_keys, INT_MAX))
+                                             : static_cast<int>(parsed.initial_data.size()),
                                        args.hotset_size, args.hotset_prob};
     exec_config.templates           = templates;
     exec_config.retry_backoff_base_us = 100;
+    exec_config.starvation_warn_retries = args.starvation_warn;
+    exec_config.queue_depth         = args.queue_depth;
+    exec_config.async_commit        = args.async_commit;
+    exec_config.batch_size          = args.batch_size;
+
+    std::unique_ptr<HotKeyTracker> hot_keys;
+    if (args.hot_keys > 0) {
+        HotKeyConfig hk_config;
+        hk_config.top_k = args.hot_keys;
+        hot_keys = std::make_unique<HotKeyTracker>(args.threads, hk_config);
+        exec_config.hot_keys = hot_keys.get();
+    }
 
     MetricsCollector metrics;
-    WorkloadExecutor executor(mgr, metrics, exec_config);
+    double elapsed = 0.0;
+    if (serving) {
+        ServiceConfig service_config;
+        service_config.num_workers           = args.threads;
+        service_config.contention            = exec_config.contention;
+        service_config.templates             = templates;
+        service_config.retry_backoff_base_us = exec_config.retry_backoff_base_us;
+        service_config.max_retries           = args.max_retries;
+        elapsed = ServeUntilSignalled(mgr, metrics, service_config, args.serve_path,
+                                      args.shm_name, args.shm);
+        if (elapsed < 0.0) {
+            db.Close();
+            return 1;
+        }
+    } else {
+        WorkloadExecutor executor(mgr, metrics, exec_config);
 
-    std::cout << "Running workload...\n";
-    executor.Run();
+        std::cout << "Running workload...\n";
+        executor.Run();
 
-    double elapsed = executor.ElapsedSeconds();
+        elapsed = executor.ElapsedSeconds();
+    }
+    if (shipper) {
+        shipper->Finish();
+    }
     metrics.PrintReport(elapsed);
+    if (hot_keys) {
+        hot_keys->PrintReport();
+    }
+    if (shipper) {
+        shipper->PrintReport();
+    }
+    if (auto* twopl = dynamic_cast<TwoPLManager*>(&mgr); twopl && args.inherit_locks) {
+        PrintLockStats(twopl->Locks());
+    }
+    if (auto* hybrid = dynamic_cast<HybridManager*>(&mgr); hybrid && args.inherit_locks) {
+        PrintLockStats(hybrid->Locks());
+    }
 
     // Optional CSV output
     if (!args.csv_output.empty()) {
-        metrics.WriteCsvRow(args.csv_output, std::to_string(args.workload),
+        metrics.WriteCsvRow(args.csv_output, args.workload,
                             args.protocol, args.threads, args.hotset_prob, elapsed);
         std::cout << "Results appended to " << args.csv_output << "\n";
     }
 
     if (!args.dump_latencies.empty()) {
-        metrics.DumpLatencies(args.dump_latencies, std::to_string(args.workload),
+        metrics.DumpLatencies(args.dump_latencies, args.workload,
                               args.protocol, args.threads, args.hotset_prob);
         std::cout << "Latencies written to " << args.dump_latencies << "\n";
     }
 
+    if (!args.worker_csv.empty()) {
+        metrics.WriteWorkerCsv(args.worker_csv, args.workload,
+                               args.protocol, args.threads, args.hotset_prob);
+        std::cout << "Per-worker stats appended to " << args.worker_csv << "\n";
+    }
+
+    if (!args.record.empty()) {
+        RunRecord record;
+        record.workload        = args.workload;
+        record.protocol        = args.protocol;
+        record.threads         = args.threads;
+        record.txns_per_thread = args.txns_per_thread;
+        record.hotset_size     = args.hotset_size;
+        record.hotset_prob     = args.hotset_prob;
+        FillRunRecord(record, metrics, elapsed);
+        if (AppendRunRecord(args.record, record)) {
+            std::cout << "Run record appended to " << args.record << "\n";
+        }
+    }
+
+    if (large) {
+        PrintReadStats(db.GetReadStats(), metrics.TotalCommits(), metrics.TotalAborts());
+    }
+
     // Workload 1: verify zero-sum balance conservation
-    if (args.workload == 1) {
+    if (args.workload == "1" && !large) {
         long long initial_total = 0;
         long long final_total   = 0;
 
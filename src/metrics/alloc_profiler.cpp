@@ -0,0 +1,89 @@
+#include "metrics/alloc_profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef TXN_ALLOC_PROFILING
+
+namespace {
+
+// Plain thread_locals with constant initialization: safe to touch from inside
+// operator new, including during thread start-up and shutdown.
+thread_local uint64_t t_allocs = 0;
+thread_local uint64_t t_bytes  = 0;
+
+void* CountedAlloc(std::size_t size) {
+    t_allocs++;
+    t_bytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+void* CountedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    t_allocs++;
+    t_bytes += size;
+    void* p = nullptr;
+    std::size_t a = std::max(static_cast<std::size_t>(align), sizeof(void*));
+    if (posix_memalign(&p, a, size ? size : 1) != 0) return nullptr;
+    return p;
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return CountedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    if (void* p = CountedAlignedAlloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    if (void* p = CountedAlignedAlloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace txn {
+
+bool AllocProfilingEnabled() { return true; }
+
+AllocCounters ThreadAllocCounters() {
+    return {t_allocs, t_bytes};
+}
+
+} // namespace txn
+
+#else
+
+namespace txn {
+
+bool AllocProfilingEnabled() { return false; }
+
+AllocCounters ThreadAllocCounters() { return {}; }
+
+} // namespace txn
+
+#endif // TXN_ALLOC_PROFILING
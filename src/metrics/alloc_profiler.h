@@ -0,0 +1,23 @@
+#ifndef ALLOC_PROFILER_H
+#define ALLOC_PROFILER_H
+
+#include <cstdint>
+
+namespace txn {
+
+struct AllocCounters {
+    uint64_t allocs = 0;
+    uint64_t bytes  = 0;
+};
+
+// True when built with -DTXN_ALLOC_PROFILING=ON, which replaces the global
+// operator new/delete with versions that bump per-thread counters.
+bool AllocProfilingEnabled();
+
+// Allocations made by the calling thread since it started. Always zero when
+// profiling is compiled out. Take two readings and subtract to attribute a region.
+AllocCounters ThreadAllocCounters();
+
+} // namespace txn
+
+#endif // ALLOC_PROFILER_H
@@ -0,0 +1,217 @@
+#include "metrics/hot_key_tracker.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+
+namespace txn {
+
+namespace {
+
+uint64_t Mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t HashKey(const std::string& key) {
+    return Mix64(std::hash<std::string>{}(key));
+}
+
+bool HeapGreater(const HotKeyEstimate& a, const HotKeyEstimate& b) {
+    return a.accesses > b.accesses;
+}
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// CountMinSketch
+// ---------------------------------------------------------------------------
+
+CountMinSketch::CountMinSketch(int width, int depth) : depth_(std::max(1, depth)) {
+    size_t w = 1;
+    while (w < static_cast<size_t>(std::max(1, width))) w <<= 1;
+    width_mask_ = w - 1;
+    counts_.assign(w * depth_, 0);
+}
+
+size_t CountMinSketch::Index(int row, uint64_t hash) const {
+    // Kirsch-Mitzenmacher: row hashes derived from two base hashes
+    uint64_t h2 = Mix64(hash) | 1;
+    return row * (width_mask_ + 1) + ((hash + row * h2) & width_mask_);
+}
+
+void CountMinSketch::Add(uint64_t hash, uint64_t count) {
+    for (int r = 0; r < depth_; r++) {
+        counts_[Index(r, hash)] += count;
+    }
+}
+
+uint64_t CountMinSketch::Estimate(uint64_t hash) const {
+    uint64_t est = UINT64_MAX;
+    for (int r = 0; r < depth_; r++) {
+        est = std::min(est, counts_[Index(r, hash)]);
+    }
+    return est;
+}
+
+void CountMinSketch::Merge(const CountMinSketch& other) {
+    for (size_t i = 0; i < counts_.size() && i < other.counts_.size(); i++) {
+        counts_[i] += other.counts_[i];
+    }
+}
+
+void CountMinSketch::Clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+}
+
+// ---------------------------------------------------------------------------
+// HotKeyTracker
+// ---------------------------------------------------------------------------
+
+HotKeyTracker::HotKeyTracker(int num_threads, const HotKeyConfig& config)
+    : config_(config),
+      global_accesses_(config.width, config.depth),
+      global_conflicts_(config.width, config.depth) {
+    config_.sample_period  = std::max(1, config_.sample_period);
+    config_.merge_interval = std::max(1, config_.merge_interval);
+    config_.top_k          = std::max(1, config_.top_k);
+    for (int i = 0; i < num_threads; i++) {
+        threads_.push_back(std::make_unique<ThreadState>(config_.width, config_.depth));
+    }
+}
+
+void HotKeyTracker::RecordAccess(int thread_id, const std::string& key) {
+    auto& state = *threads_[thread_id];
+    if (++state.sample_tick % config_.sample_period != 0) return;
+
+    uint64_t hash = HashKey(key);
+    state.accesses.Add(hash, config_.sample_period);
+    state.candidates.emplace(key, hash);
+    NotePending(thread_id, state);
+}
+
+void HotKeyTracker::RecordConflict(int thread_id, const std::string& key, uint64_t count) {
+    // Conflicts are rare relative to accesses, so they are never sampled.
+    auto& state = *threads_[thread_id];
+    uint64_t hash = HashKey(key);
+    state.conflicts.Add(hash, count);
+    state.candidates.emplace(key, hash);
+    NotePending(thread_id, state);
+}
+
+void HotKeyTracker::NotePending(int thread_id, ThreadState& state) {
+    if (++state.pending >= config_.merge_interval) {
+        Flush(thread_id);
+    }
+}
+
+void HotKeyTracker::Flush(int thread_id) {
+    auto& state = *threads_[thread_id];
+    if (state.pending == 0) return;
+
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    global_accesses_.Merge(state.accesses);
+    global_conflicts_.Merge(state.conflicts);
+    for (const auto& [key, hash] : state.candidates) {
+        OfferCandidate(key, hash);
+    }
+
+    state.accesses.Clear();
+    state.conflicts.Clear();
+    state.candidates.clear();
+    state.pending = 0;
+}
+
+// Caller holds global_mutex_.
+void HotKeyTracker::OfferCandidate(const std::string& key, uint64_t hash) {
+    uint64_t accesses  = global_accesses_.Estimate(hash);
+    uint64_t conflicts = global_conflicts_.Estimate(hash);
+
+    auto it = std::find_if(top_.begin(), top_.end(),
+        [&key](const HotKeyEstimate& e) { return e.key == key; });
+    if (it != top_.end()) {
+        it->accesses  = accesses;
+        it->conflicts = conflicts;
+        std::make_heap(top_.begin(), top_.end(), HeapGreater);
+        return;
+    }
+
+    if (static_cast<int>(top_.size()) < config_.top_k) {
+        top_.push_back({key, accesses, conflicts});
+        std::push_heap(top_.begin(), top_.end(), HeapGreater);
+        return;
+    }
+
+    // Entries hold the estimates from when they were last offered, and
+    // estimates only grow: bring the minimum up to date until it is current
+    // before comparing, each entry at most once
+    while (true) {
+        uint64_t hash_min = HashKey(top_.front().key);
+        uint64_t current = global_accesses_.Estimate(hash_min);
+        if (current == top_.front().accesses) break;
+        std::pop_heap(top_.begin(), top_.end(), HeapGreater);
+        top_.back().accesses  = current;
+        top_.back().conflicts = global_conflicts_.Estimate(hash_min);
+        std::push_heap(top_.begin(), top_.end(), HeapGreater);
+    }
+    if (accesses > top_.front().accesses) {
+        std::pop_heap(top_.begin(), top_.end(), HeapGreater);
+        top_.back() = {key, accesses, conflicts};
+        std::push_heap(top_.begin(), top_.end(), HeapGreater);
+    }
+}
+
+std::vector<HotKeyEstimate> HotKeyTracker::TopKeys() const {
+    std::vector<HotKeyEstimate> result;
+    {
+        std::lock_guard<std::mutex> lock(global_mutex_);
+        for (const auto& e : top_) {
+            uint64_t hash = HashKey(e.key);
+            result.push_back({e.key, global_accesses_.Estimate(hash),
+                              global_conflicts_.Estimate(hash)});
+        }
+    }
+    std::sort(result.begin(), result.end(), HeapGreater);
+    return result;
+}
+
+uint64_t HotKeyTracker::EstimateAccesses(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    return global_accesses_.Estimate(HashKey(key));
+}
+
+uint64_t HotKeyTracker::EstimateConflicts(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    return global_conflicts_.Estimate(HashKey(key));
+}
+
+bool HotKeyTracker::IsHot(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    return std::any_of(top_.begin(), top_.end(),
+        [&key](const HotKeyEstimate& e) { return e.key == key; });
+}
+
+void HotKeyTracker::PrintReport() const {
+    auto top = TopKeys();
+
+    std::cout << "\n--- Hot Keys (estimated) ---\n";
+    std::cout << "  " << std::left << std::setw(20) << "key"
+              << std::right << std::setw(12) << "accesses"
+              << std::setw(12) << "conflicts"
+              << std::setw(12) << "conflict %" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& e : top) {
+        double pct = e.accesses > 0 ? 100.0 * e.conflicts / e.accesses : 0.0;
+        std::cout << "  " << std::left << std::setw(20) << e.key
+                  << std::right << std::setw(12) << e.accesses
+                  << std::setw(12) << e.conflicts
+                  << std::setw(12) << pct << "\n";
+    }
+}
+
+} // namespace txn
@@ -0,0 +1,98 @@
+#ifndef HOT_KEY_TRACKER_H
+#define HOT_KEY_TRACKER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+namespace txn {
+
+// Count-min sketch over 64-bit key hashes. Estimates never undercount;
+// overcount is bounded by (total / width) with probability 1 - 2^-depth.
+// Not thread-safe: each worker owns its own sketch.
+class CountMinSketch {
+public:
+    CountMinSketch(int width, int depth);
+
+    void Add(uint64_t hash, uint64_t count = 1);
+    uint64_t Estimate(uint64_t hash) const;
+
+    // Adds other's counters into this sketch. Dimensions must match.
+    void Merge(const CountMinSketch& other);
+    void Clear();
+
+private:
+    size_t Index(int row, uint64_t hash) const;
+
+    size_t width_mask_;
+    int depth_;
+    std::vector<uint64_t> counts_;
+};
+
+struct HotKeyConfig {
+    int width          = 2048;  // rounded up to a power of two
+    int depth          = 4;
+    int top_k          = 16;
+    int sample_period  = 1;     // count every Nth access (weighted by N)
+    int merge_interval = 512;   // local events between merges into the global view
+};
+
+struct HotKeyEstimate {
+    std::string key;
+    uint64_t accesses;
+    uint64_t conflicts;
+};
+
+// Online hot-key detector. Each worker records accesses into a private sketch
+// (no shared writes on the hot path); every merge_interval events the local
+// sketch is folded into a global sketch and the top-K heap is refreshed.
+// Query methods are safe to call from any thread at any time.
+class HotKeyTracker {
+public:
+    explicit HotKeyTracker(int num_threads, const HotKeyConfig& config = {});
+
+    void RecordAccess(int thread_id, const std::string& key);
+    void RecordConflict(int thread_id, const std::string& key, uint64_t count = 1);
+
+    // Folds the thread's pending local counts into the global view.
+    void Flush(int thread_id);
+
+    // Hottest keys by estimated access count, descending.
+    std::vector<HotKeyEstimate> TopKeys() const;
+    uint64_t EstimateAccesses(const std::string& key) const;
+    uint64_t EstimateConflicts(const std::string& key) const;
+
+    // True if key is currently in the top-K set.
+    bool IsHot(const std::string& key) const;
+
+    void PrintReport() const;
+
+private:
+    struct alignas(64) ThreadState {
+        ThreadState(int width, int depth)
+            : accesses(width, depth), conflicts(width, depth) {}
+        CountMinSketch accesses;
+        CountMinSketch conflicts;
+        std::unordered_map<std::string, uint64_t> candidates;  // key -> hash
+        uint64_t sample_tick = 0;
+        int pending = 0;
+    };
+
+    void NotePending(int thread_id, ThreadState& state);
+    void OfferCandidate(const std::string& key, uint64_t hash);
+
+    HotKeyConfig config_;
+    std::vector<std::unique_ptr<ThreadState>> threads_;
+
+    mutable std::mutex global_mutex_;
+    CountMinSketch global_accesses_;
+    CountMinSketch global_conflicts_;
+    std::vector<HotKeyEstimate> top_;  // min-heap on accesses, size <= top_k
+};
+
+} // namespace txn
+
+#endif // HOT_KEY_TRACKER_H
@@ -0,0 +1,51 @@
+#include "metrics/latency_histogram.h"
+#include <cmath>
+
+namespace txn {
+
+int LatencyHistogram::BucketIndex(double latency_us) {
+    if (!(latency_us >= 1.0)) return 0;
+    int exp = 0;
+    double mantissa = std::frexp(latency_us, &exp);  // latency = mantissa * 2^exp, mantissa in [0.5, 1)
+    int octave = exp - 1;
+    if (octave >= kOctaves) return kBuckets - 1;
+    int sub = static_cast<int>((mantissa * 2.0 - 1.0) * kSubBuckets);
+    return 1 + octave * kSubBuckets + sub;
+}
+
+double LatencyHistogram::BucketMidpoint(int index) {
+    if (index == 0) return 0.5;
+    int octave = (index - 1) / kSubBuckets;
+    int sub    = (index - 1) % kSubBuckets;
+    return std::ldexp(1.0 + (sub + 0.5) / kSubBuckets, octave);
+}
+
+void LatencyHistogram::Record(double latency_us) {
+    counts_[BucketIndex(latency_us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> LatencyHistogram::Drain() {
+    std::vector<uint64_t> out(kBuckets);
+    for (int i = 0; i < kBuckets; i++) {
+        out[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+    }
+    return out;
+}
+
+double LatencyHistogram::Percentile(const std::vector<uint64_t>& counts, double p) {
+    uint64_t total = 0;
+    for (uint64_t c : counts) total += c;
+    if (total == 0) return 0.0;
+
+    // Nearest rank; bucket granularity makes interpolation pointless
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * total));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) return BucketMidpoint(static_cast<int>(i));
+    }
+    return BucketMidpoint(static_cast<int>(counts.size()) - 1);
+}
+
+} // namespace txn
@@ -0,0 +1,38 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace txn {
+
+// Fixed-size log-linear latency histogram: 16 linear sub-buckets per power of
+// two from 1 us to ~2^32 us (~6% relative resolution). Record is lock-free and
+// memory never grows, so it can run for hours.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBuckets = 16;
+    static constexpr int kOctaves    = 33;
+    static constexpr int kBuckets    = 1 + kOctaves * kSubBuckets;  // bucket 0: < 1 us
+
+    void Record(double latency_us);
+
+    // Returns the counts accumulated since the previous Drain and resets them.
+    // Records racing with a drain land in either this window or the next.
+    std::vector<uint64_t> Drain();
+
+    // Percentile (0-100) of a drained bucket vector, at bucket midpoints.
+    static double Percentile(const std::vector<uint64_t>& counts, double p);
+
+private:
+    static int BucketIndex(double latency_us);
+    static double BucketMidpoint(int index);
+
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+};
+
+} // namespace txn
+
+#endif // LATENCY_HISTOGRAM_H
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <filesystem>
 
 namespace txn {
 
@@ -15,8 +16,39 @@ PerTypeStat& MetricsCollector::GetStat(const std::string& type) {
 void MetricsCollector::RecordCommit(const std::string& type, double latency_us) {
     auto& stat = GetStat(type);
     stat.commits.fetch_add(1);
+    if (latency_window_) {
+        latency_window_->Record(latency_us);
+    }
     std::lock_guard<std::mutex> lock(stat.latency_mutex);
-    stat.latencies_us.push_back(latency_us);
+    stat.latencies_seen++;
+    if (reservoir_cap_ == 0 || stat.latencies_us.size() < reservoir_cap_) {
+        stat.latencies_us.push_back(latency_us);
+        return;
+    }
+    // Algorithm R: keep each of the n samples seen so far with probability cap/n
+    uint64_t slot = stat.reservoir_rng() % stat.latencies_seen;
+    if (slot < reservoir_cap_) {
+        stat.latencies_us[slot] = latency_us;
+    }
+}
+
+size_t MetricsCollector::RetainedLatencySamples() {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    size_t total = 0;
+    for (auto& [_, stat] : stats_) {
+        std::lock_guard<std::mutex> lat_lock(stat.latency_mutex);
+        total += stat.latencies_us.size();
+    }
+    return total;
+}
+
+void MetricsCollector::EnableLatencyWindow() {
+    latency_window_ = std::make_unique<LatencyHistogram>();
+}
+
+std::vector<uint64_t> MetricsCollector::DrainLatencyWindow() {
+    if (!latency_window_) return {};
+    return latency_window_->Drain();
 }
 
 void MetricsCollector::RecordAbort(const std::string& type) {
@@ -24,6 +56,64 @@ void MetricsCollector::RecordAbort(const std::string& type) {
     stat.aborts.fetch_add(1);
 }
 
+void MetricsCollector::InitWorkers(int num_workers) {
+    workers_.clear();
+    for (int i = 0; i < num_workers; i++) {
+        workers_.push_back(std::make_unique<PerWorkerStat>());
+    }
+}
+
+void MetricsCollector::RecordWorkerCommit(int worker, int retries) {
+    auto& w = *workers_[worker];
+    w.commits.fetch_add(1);
+    if (retries > w.max_retry_streak.load()) {
+        w.max_retry_streak.store(retries);
+    }
+}
+
+void MetricsCollector::RecordWorkerAbort(int worker) {
+    workers_[worker]->aborts.fetch_add(1);
+}
+
+void MetricsCollector::RecordWorkerElapsed(int worker, double elapsed_s) {
+    workers_[worker]->elapsed_s.store(elapsed_s);
+}
+
+void MetricsCollector::RecordAllocations(const std::string& type, const std::string& phase,
+                                         const AllocCounters& counters) {
+    auto& stat = GetStat(type);
+    std::lock_guard<std::mutex> lock(stat.latency_mutex);
+    for (auto& [name, totals] : stat.allocs_by_phase) {
+        if (name == phase) {
+            totals.allocs += counters.allocs;
+            totals.bytes  += counters.bytes;
+            return;
+        }
+    }
+    stat.allocs_by_phase.emplace_back(phase, counters);
+}
+
+double MetricsCollector::JainFairness() {
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (const auto& w : workers_) {
+        double elapsed = w->elapsed_s.load();
+        double tps = elapsed > 0.0 ? w->commits.load() / elapsed : 0.0;
+        sum += tps;
+        sum_sq += tps * tps;
+    }
+    if (workers_.empty() || sum_sq == 0.0) return 1.0;
+    return (sum * sum) / (workers_.size() * sum_sq);
+}
+
+int MetricsCollector::MaxRetryStreak() {
+    int result = 0;
+    for (const auto& w : workers_) {
+        result = std::max(result, w->max_retry_streak.load());
+    }
+    return result;
+}
+
 double MetricsCollector::AbortPercentage(const std::string& type) {
     auto& stat = GetStat(type);
     uint64_t c = stat.commits.load();
@@ -63,6 +153,26 @@ double MetricsCollector::Percentile(const std::string& type, double p) {
     return sorted[lo] * (1.0 - frac) + sorted[hi] * frac;
 }
 
+double MetricsCollector::OverallPercentile(double p) {
+    std::vector<double> sorted;
+    {
+        std::lock_guard<std::mutex> lock(map_mutex_);
+        for (auto& [_, stat] : stats_) {
+            std::lock_guard<std::mutex> lat_lock(stat.latency_mutex);
+            sorted.insert(sorted.end(), stat.latencies_us.begin(), stat.latencies_us.end());
+        }
+    }
+    if (sorted.empty()) return 0.0;
+    std::sort(sorted.begin(), sorted.end());
+
+    double index = (p / 100.0) * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(index));
+    size_t hi = static_cast<size_t>(std::ceil(index));
+    if (lo == hi) return sorted[lo];
+    double frac = index - lo;
+    return sorted[lo] * (1.0 - frac) + sorted[hi] * frac;
+}
+
 uint64_t MetricsCollector::TotalCommits() {
     std::lock_guard<std::mutex> lock(map_mutex_);
     uint64_t total = 0;
@@ -81,6 +191,24 @@ uint64_t MetricsCollector::TotalAborts() {
     return total;
 }
 
+void MetricsCollector::SetIsolation(const std::string& type, const std::string& level) {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    isolation_[type] = level;
+}
+
+std::map<std::string, IsolationStat> MetricsCollector::IsolationBreakdown() {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    std::map<std::string, IsolationStat> levels;
+    for (const auto& [type, level] : isolation_) {
+        IsolationStat& totals = levels[level];
+        auto it = stats_.find(type);
+        if (it == stats_.end()) continue;
+        totals.commits += it->second.commits.load();
+        totals.aborts += it->second.aborts.load();
+    }
+    return levels;
+}
+
 namespace {
 
 double ComputeAbortPct(PerTypeStat& stat) {
@@ -131,11 +259,34 @@ void MetricsCollector::PrintReport(double elapsed_s) {
     if (total_all > 0) {
         std::cout << "Overall abort %: " << (100.0 * total_aborts / total_all) << "%\n";
     }
+    if (async_batches_.load() > 0) {
+        std::cout << "Read batches:    " << async_batches_.load() << " (avg "
+                  << static_cast<double>(async_batch_keys_.load()) / async_batches_.load()
+                  << " keys)\n";
+    }
+
+    std::map<std::string, IsolationStat> levels = IsolationBreakdown();
+    if (!levels.empty()) {
+        std::cout << "\n--- Per-Isolation-Level Breakdown ---\n";
+        std::cout << "  level                commits     aborts   abort %      txn/s\n";
+        for (const auto& [level, totals] : levels) {
+            uint64_t attempts = totals.commits + totals.aborts;
+            std::cout << "  " << std::left << std::setw(16) << level << std::right
+                      << std::setw(11) << totals.commits
+                      << std::setw(11) << totals.aborts
+                      << std::setw(10) << (attempts > 0 ? 100.0 * totals.aborts / attempts : 0.0)
+                      << std::setw(11) << (elapsed_s > 0.0 ? totals.commits / elapsed_s : 0.0) << "\n";
+        }
+    }
 
     std::cout << "\n--- Per-Type Breakdown ---\n";
     std::lock_guard<std::mutex> lock(map_mutex_);
     for (auto& [type, stat] : stats_) {
         std::cout << "\n  [" << type << "]\n";
+        auto level = isolation_.find(type);
+        if (level != isolation_.end()) {
+            std::cout << "    Isolation:     " << level->second << "\n";
+        }
         std::cout << "    Commits:       " << stat.commits.load() << "\n";
         std::cout << "    Aborts:        " << stat.aborts.load() << "\n";
         std::cout << "    Abort %:       " << ComputeAbortPct(stat) << "%\n";
@@ -143,35 +294,91 @@ void MetricsCollector::PrintReport(double elapsed_s) {
         std::cout << "    P50 latency:   " << ComputePercentile(stat, 50) << " us\n";
         std::cout << "    P90 latency:   " << ComputePercentile(stat, 90) << " us\n";
         std::cout << "    P99 latency:   " << ComputePercentile(stat, 99) << " us\n";
+
+        std::lock_guard<std::mutex> alloc_lock(stat.latency_mutex);
+        uint64_t commits = stat.commits.load();
+        if (!stat.allocs_by_phase.empty() && commits > 0) {
+            AllocCounters total;
+            std::cout << "    Allocs/commit by phase:\n";
+            for (const auto& [phase, c] : stat.allocs_by_phase) {
+                std::cout << "      " << std::left << std::setw(13) << phase << std::right
+                          << std::setw(10) << static_cast<double>(c.allocs) / commits << " allocs "
+                          << std::setw(10) << static_cast<double>(c.bytes) / commits << " bytes\n";
+                total.allocs += c.allocs;
+                total.bytes  += c.bytes;
+            }
+            std::cout << "      " << std::left << std::setw(13) << "total" << std::right
+                      << std::setw(10) << static_cast<double>(total.allocs) / commits << " allocs "
+                      << std::setw(10) << static_cast<double>(total.bytes) / commits << " bytes\n";
+        }
+    }
+
+    if (!workers_.empty()) {
+        std::cout << "\n--- Per-Worker Breakdown ---\n";
+        std::cout << "  worker    commits     aborts   abort %      txn/s  max retries\n";
+        for (size_t i = 0; i < workers_.size(); i++) {
+            auto& w = *workers_[i];
+            uint64_t c = w.commits.load();
+            uint64_t a = w.aborts.load();
+            double elapsed = w.elapsed_s.load();
+            std::cout << "  " << std::setw(6) << i
+                      << std::setw(11) << c
+                      << std::setw(11) << a
+                      << std::setw(10) << ((c + a) > 0 ? 100.0 * a / (c + a) : 0.0)
+                      << std::setw(11) << (elapsed > 0.0 ? c / elapsed : 0.0)
+                      << std::setw(13) << w.max_retry_streak.load() << "\n";
+        }
+        std::cout << "  Jain fairness:     " << std::setprecision(4) << JainFairness()
+                  << std::setprecision(2) << "\n";
+        std::cout << "  Max retry streak:  " << MaxRetryStreak() << "\n";
+        std::cout << "  Starvation warns:  " << starvation_warnings_.load() << "\n";
     }
     std::cout << "========================================\n";
 }
 
-void MetricsCollector::WriteCsvRow(const std::string& path, const std::string& workload,
-                                    const std::string& protocol, int threads,
-                                    double hotset_prob, double elapsed_s) {
-    // Determine if we need to write a header (file doesn't exist yet or is empty).
-    bool write_header = false;
+std::ofstream AppendCsv(const std::string& path, const std::string& header) {
+    std::string first_line;
+    bool has_content = false;
     {
         std::ifstream check(path);
-        write_header = !check.good();
+        has_content = check.good() && std::getline(check, first_line) && !first_line.empty();
+    }
+    if (has_content && first_line != header) {
+        std::string moved = path + ".old";
+        std::error_code ec;
+        std::filesystem::rename(path, moved, ec);
+        if (ec) {
+            std::cerr << "Not appending to " << path << ": its header does not match ("
+                      << ec.message() << ")\n";
+            return std::ofstream();
+        }
+        std::cerr << "Header of " << path << " does not match; moved it to " << moved << "\n";
+        has_content = false;
     }
 
     std::ofstream file(path, std::ios::app);
-    if (!file.is_open()) return;
+    if (file.is_open() && !has_content) file << header << "\n";
+    return file;
+}
 
-    if (write_header) {
-        file << "workload,protocol,threads,hotset_prob,elapsed_s,"
-             << "total_commits,total_aborts,throughput_tps,abort_rate_pct,"
-             << "txn_type,type_commits,type_aborts,type_abort_pct,"
-             << "type_avg_latency_us,type_p50_us,type_p90_us,type_p99_us\n";
-    }
+void MetricsCollector::WriteCsvRow(const std::string& path, const std::string& workload,
+                                    const std::string& protocol, int threads,
+                                    double hotset_prob, double elapsed_s) {
+    std::ofstream file = AppendCsv(path,
+        "workload,protocol,threads,hotset_prob,elapsed_s,"
+        "total_commits,total_aborts,throughput_tps,abort_rate_pct,"
+        "txn_type,type_commits,type_aborts,type_abort_pct,"
+        "type_avg_latency_us,type_p50_us,type_p90_us,type_p99_us,"
+        "jain_fairness,max_retry_streak");
+    if (!file.is_open()) return;
 
     uint64_t total_commits = TotalCommits();
     uint64_t total_aborts  = TotalAborts();
     double throughput = (elapsed_s > 0.0) ? total_commits / elapsed_s : 0.0;
     uint64_t total_all = total_commits + total_aborts;
     double abort_rate  = (total_all > 0) ? 100.0 * total_aborts / total_all : 0.0;
+    double fairness    = JainFairness();
+    int max_streak     = MaxRetryStreak();
 
     std::lock_guard<std::mutex> lock(map_mutex_);
     file << std::fixed << std::setprecision(6);
@@ -192,26 +399,19 @@ void MetricsCollector::WriteCsvRow(const std::string& path, const std::string& w
              << ComputeAvgLatency(stat)       << ","
              << ComputePercentile(stat, 50.0) << ","
              << ComputePercentile(stat, 90.0) << ","
-             << ComputePercentile(stat, 99.0) << "\n";
+             << ComputePercentile(stat, 99.0) << ","
+             << fairness                      << ","
+             << max_streak                    << "\n";
     }
 }
 
 void MetricsCollector::DumpLatencies(const std::string& path, const std::string& workload,
                                       const std::string& protocol, int threads,
                                       double hotset_prob) {
-    bool write_header = false;
-    {
-        std::ifstream check(path);
-        write_header = !check.good();
-    }
-
-    std::ofstream file(path, std::ios::app);
+    std::ofstream file = AppendCsv(path,
+        "workload,protocol,threads,hotset_prob,txn_type,latency_us");
     if (!file.is_open()) return;
 
-    if (write_header) {
-        file << "workload,protocol,threads,hotset_prob,txn_type,latency_us\n";
-    }
-
     std::lock_guard<std::mutex> lock(map_mutex_);
     file << std::fixed << std::setprecision(3);
     for (auto& [type, stat] : stats_) {
@@ -227,4 +427,31 @@ void MetricsCollector::DumpLatencies(const std::string& path, const std::string&
     }
 }
 
+void MetricsCollector::WriteWorkerCsv(const std::string& path, const std::string& workload,
+                                      const std::string& protocol, int threads,
+                                      double hotset_prob) {
+    std::ofstream file = AppendCsv(path,
+        "workload,protocol,threads,hotset_prob,worker,commits,aborts,"
+        "abort_pct,throughput_tps,max_retry_streak");
+    if (!file.is_open()) return;
+
+    file << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < workers_.size(); i++) {
+        auto& w = *workers_[i];
+        uint64_t c = w.commits.load();
+        uint64_t a = w.aborts.load();
+        double elapsed = w.elapsed_s.load();
+        file << workload    << ","
+             << protocol    << ","
+             << threads     << ","
+             << hotset_prob << ","
+             << i           << ","
+             << c           << ","
+             << a           << ","
+             << ((c + a) > 0 ? 100.0 * a / (c + a) : 0.0) << ","
+             << (elapsed > 0.0 ? c / elapsed : 0.0)       << ","
+             << w.max_retry_streak.load() << "\n";
+    }
+}
+
 } // namespace txn
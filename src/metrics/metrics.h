@@ -1,12 +1,19 @@
 #ifndef METRICS_H
 #define METRICS_H
 
+#include <fstream>
+#include <map>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
+#include <memory>
 #include <cstdint>
+#include <utility>
+#include <random>
+#include "metrics/alloc_profiler.h"
+#include "metrics/latency_histogram.h"
 
 namespace txn {
 
@@ -15,38 +22,115 @@ struct PerTypeStat {
     std::atomic<uint64_t> aborts{0};
     std::mutex latency_mutex;
     std::vector<double> latencies_us;
+    uint64_t latencies_seen = 0;         // commits offered to the reservoir
+    std::mt19937_64 reservoir_rng{0x5eed};
+    // (phase, totals) in first-recorded order; guarded by latency_mutex
+    std::vector<std::pair<std::string, AllocCounters>> allocs_by_phase;
+};
+
+// Commits and aborts of every txn type run at one isolation level
+struct IsolationStat {
+    uint64_t commits = 0;
+    uint64_t aborts = 0;
+};
+
+// Per-worker counters. Each slot is written only by its own worker thread.
+struct PerWorkerStat {
+    std::atomic<uint64_t> commits{0};
+    std::atomic<uint64_t> aborts{0};
+    std::atomic<int> max_retry_streak{0};
+    std::atomic<double> elapsed_s{0.0};
 };
 
 class MetricsCollector {
 public:
     void RecordCommit(const std::string& type, double latency_us);
+
+    // Caps retained latency samples per txn type (uniform reservoir sampling,
+    // so percentiles become estimates). 0 = keep every sample. Call before
+    // recording starts.
+    void SetLatencyReservoir(size_t max_samples_per_type) { reservoir_cap_ = max_samples_per_type; }
+    size_t RetainedLatencySamples();
+
+    // Additionally feeds every commit latency into a fixed-size histogram that
+    // can be drained per sampling interval (soak mode).
+    void EnableLatencyWindow();
+    std::vector<uint64_t> DrainLatencyWindow();
     void RecordAbort(const std::string& type);
 
+    // Per-worker fairness tracking. InitWorkers must be called before any
+    // RecordWorker* call; the executor does this at the start of Run().
+    void InitWorkers(int num_workers);
+    // retries = attempts that did not commit before this one (aborts + lock retries)
+    void RecordWorkerCommit(int worker, int retries);
+    void RecordWorkerAbort(int worker);
+    void RecordWorkerElapsed(int worker, double elapsed_s);
+    void RecordStarvationWarning() { starvation_warnings_.fetch_add(1); }
+    // Batched storage fetches of one queue-depth worker (see AsyncIo)
+    void RecordAsyncBatches(uint64_t batches, uint64_t keys) {
+        async_batches_.fetch_add(batches);
+        async_batch_keys_.fetch_add(keys);
+    }
+
+    // Labels a txn type with the isolation level it runs at; once any type
+    // is labeled, the report breaks commits and aborts down by level.
+    void SetIsolation(const std::string& type, const std::string& level);
+    // Totals per labeled level, by level name
+    std::map<std::string, IsolationStat> IsolationBreakdown();
+
+    // Adds heap allocations attributed to one executor phase of a txn type.
+    void RecordAllocations(const std::string& type, const std::string& phase,
+                           const AllocCounters& counters);
+
+    // Jain's fairness index over per-worker throughput: 1.0 = perfectly fair,
+    // 1/n = one worker did all the work.
+    double JainFairness();
+    int MaxRetryStreak();
+
     double AbortPercentage(const std::string& type);
     double Throughput(double elapsed_s);
     double AvgResponseTime(const std::string& type);
     double Percentile(const std::string& type, double p);
+    double OverallPercentile(double p);  // across all txn types
     uint64_t TotalCommits();
     uint64_t TotalAborts();
 
     void PrintReport(double elapsed_s);
 
-    // Appends one CSV row per txn_type to path (creates header on first write).
+    // Appends one CSV row per txn_type to path (writes the header first; see AppendCsv).
     void WriteCsvRow(const std::string& path, const std::string& workload,
                      const std::string& protocol, int threads, double hotset_prob,
                      double elapsed_s);
 
-    // Dumps raw latency samples for distribution plots (appends; creates header on first write).
+    // Dumps raw latency samples for distribution plots (appends; see AppendCsv).
     void DumpLatencies(const std::string& path, const std::string& workload,
                        const std::string& protocol, int threads, double hotset_prob);
 
+    // Appends one CSV row per worker (writes the header first; see AppendCsv).
+    void WriteWorkerCsv(const std::string& path, const std::string& workload,
+                        const std::string& protocol, int threads, double hotset_prob);
+
 private:
     std::mutex map_mutex_;
     std::unordered_map<std::string, PerTypeStat> stats_;
+    std::unordered_map<std::string, std::string> isolation_;  // type -> level; guarded by map_mutex_
+    std::vector<std::unique_ptr<PerWorkerStat>> workers_;
+    std::atomic<uint64_t> starvation_warnings_{0};
+    std::atomic<uint64_t> async_batches_{0};
+    std::atomic<uint64_t> async_batch_keys_{0};
+    size_t reservoir_cap_ = 0;
+    std::unique_ptr<LatencyHistogram> latency_window_;
 
     PerTypeStat& GetStat(const std::string& type);
 };
 
+// Opens path for appending CSV rows under header, writing header first when
+// the file is new or empty. An existing file whose first line is a different
+// header is moved aside to path + ".old" (with a note on stderr) rather than
+// mixing two schemas in one file. Returns a closed stream if path cannot be
+// opened.
+std::ofstream AppendCsv(const std::string& path, const std::string& header);
+
 } // namespace txn
 
 #endif // METRICS_H
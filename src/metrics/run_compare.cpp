@@ -0,0 +1,186 @@
+#include "metrics/run_compare.h"
+#include "metrics/run_record.h"
+#include "metrics/stats.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace txn {
+
+namespace {
+
+struct Group {
+    std::vector<double> throughput;
+    std::vector<double> p99;
+};
+
+enum class Verdict { kOk, kImproved, kRegression, kUntested };
+
+struct MetricDiff {
+    double base_mean;
+    double cand_mean;
+    double change_pct;
+    double p_value;
+    Verdict verdict;
+};
+
+// higher_is_better: true for throughput, false for latency.
+MetricDiff Diff(const std::vector<double>& base, const std::vector<double>& cand,
+                bool higher_is_better, const CompareConfig& config) {
+    MetricDiff d;
+    d.base_mean  = Mean(base);
+    d.cand_mean  = Mean(cand);
+    d.change_pct = d.base_mean != 0.0 ? 100.0 * (d.cand_mean - d.base_mean) / d.base_mean : 0.0;
+
+    bool testable = base.size() >= 2 && cand.size() >= 2;
+    d.p_value = testable ? WelchTTest(base, cand).p_value : 1.0;
+
+    double worse = higher_is_better ? -d.change_pct : d.change_pct;
+    if (std::fabs(d.change_pct) <= config.threshold_pct) {
+        d.verdict = Verdict::kOk;
+    } else if (!testable) {
+        d.verdict = Verdict::kUntested;
+    } else if (d.p_value >= config.alpha) {
+        d.verdict = Verdict::kOk;
+    } else {
+        d.verdict = worse > 0 ? Verdict::kRegression : Verdict::kImproved;
+    }
+    return d;
+}
+
+std::string VerdictLabel(const MetricDiff& d) {
+    switch (d.verdict) {
+        case Verdict::kOk:         return "ok";
+        case Verdict::kImproved:   return "improved";
+        case Verdict::kRegression: return "REGRESSION";
+        case Verdict::kUntested:   return "?";
+    }
+    return "";
+}
+
+std::set<std::string> Distinct(const std::vector<RunRecord>& records,
+                               std::string (*field)(const RunRecord&)) {
+    std::set<std::string> values;
+    for (const auto& r : records) values.insert(field(r));
+    return values;
+}
+
+std::string Join(const std::set<std::string>& values) {
+    std::string out;
+    for (const auto& v : values) {
+        if (!out.empty()) out += ", ";
+        out += v;
+    }
+    return out;
+}
+
+// Prints the environment of both sets side by side and warns about
+// differences that make throughput numbers incomparable.
+void PrintEnvironment(const std::vector<RunRecord>& base, const std::vector<RunRecord>& cand) {
+    struct EnvField {
+        const char* label;
+        std::string (*get)(const RunRecord&);
+        bool affects_hardware;
+    };
+    static const EnvField kFields[] = {
+        {"git_rev",    [](const RunRecord& r) { return r.env.git_rev; }, false},
+        {"compiler",   [](const RunRecord& r) { return r.env.compiler; }, false},
+        {"build_type", [](const RunRecord& r) { return r.env.build_type; }, false},
+        {"cxx_flags",  [](const RunRecord& r) { return r.env.cxx_flags; }, false},
+        {"rocksdb",    [](const RunRecord& r) { return r.env.rocksdb_version; }, false},
+        {"cpu",        [](const RunRecord& r) { return r.env.cpu_model; }, true},
+        {"cores",      [](const RunRecord& r) { return std::to_string(r.env.cores); }, true},
+        {"host",       [](const RunRecord& r) { return r.env.hostname; }, true},
+    };
+
+    std::cout << "\n--- Environment ---\n";
+    bool hardware_differs = false;
+    for (const auto& f : kFields) {
+        auto b = Distinct(base, f.get);
+        auto c = Distinct(cand, f.get);
+        std::cout << "  " << std::left << std::setw(11) << f.label
+                  << "baseline: " << Join(b) << "\n"
+                  << "  " << std::setw(11) << "" << "candidate: " << Join(c) << "\n";
+        if (f.affects_hardware && b != c) hardware_differs = true;
+    }
+    if (hardware_differs) {
+        std::cout << "  WARNING: result sets come from different hardware; "
+                  << "differences may not be caused by the code.\n";
+    }
+}
+
+} // anonymous namespace
+
+int CompareRunRecords(const std::string& baseline_path, const std::string& candidate_path,
+                      const CompareConfig& config) {
+    std::vector<RunRecord> base_records, cand_records;
+    if (!LoadRunRecords(baseline_path, base_records) ||
+        !LoadRunRecords(candidate_path, cand_records)) {
+        return 2;
+    }
+    if (base_records.empty() || cand_records.empty()) {
+        std::cerr << "No run records to compare\n";
+        return 2;
+    }
+
+    std::map<std::string, Group> base, cand;
+    for (const auto& r : base_records) {
+        base[r.ConfigKey()].throughput.push_back(r.throughput_tps);
+        base[r.ConfigKey()].p99.push_back(r.p99_us);
+    }
+    for (const auto& r : cand_records) {
+        cand[r.ConfigKey()].throughput.push_back(r.throughput_tps);
+        cand[r.ConfigKey()].p99.push_back(r.p99_us);
+    }
+
+    std::cout << "Comparing " << baseline_path << " (" << base_records.size() << " runs) -> "
+              << candidate_path << " (" << cand_records.size() << " runs)\n"
+              << "Threshold: " << config.threshold_pct << "%  alpha: " << config.alpha << "\n";
+    PrintEnvironment(base_records, cand_records);
+
+    int regressions = 0, untested = 0;
+    std::cout << "\n--- Per-Configuration Comparison ---\n" << std::fixed;
+    for (const auto& [key, b] : base) {
+        auto it = cand.find(key);
+        if (it == cand.end()) {
+            std::cout << "  " << key << "\n    missing from candidate\n";
+            continue;
+        }
+        const Group& c = it->second;
+
+        std::cout << "  " << key << "  (n=" << b.throughput.size() << " vs "
+                  << c.throughput.size() << ")\n";
+        auto print = [&](const char* label, const char* unit, const MetricDiff& d) {
+            std::cout << "    " << std::left << std::setw(12) << label << std::right
+                      << std::setprecision(2) << std::setw(12) << d.base_mean << " -> "
+                      << std::setw(12) << d.cand_mean << " " << std::left << std::setw(6) << unit
+                      << std::right << std::showpos << std::setw(8) << d.change_pct << "%"
+                      << std::noshowpos << "  p=" << std::setprecision(4) << d.p_value
+                      << "  " << VerdictLabel(d) << "\n";
+            if (d.verdict == Verdict::kRegression) regressions++;
+            if (d.verdict == Verdict::kUntested) untested++;
+        };
+        print("throughput", "txn/s", Diff(b.throughput, c.throughput, true, config));
+        print("p99", "us", Diff(b.p99, c.p99, false, config));
+    }
+    for (const auto& [key, c] : cand) {
+        if (!base.count(key)) std::cout << "  " << key << "\n    missing from baseline\n";
+    }
+
+    std::cout << "\n";
+    if (untested > 0) {
+        std::cout << untested << " change(s) exceed the threshold but have fewer than 2 runs "
+                  << "per side; rerun with --sweep --repeats N to test them.\n";
+    }
+    if (regressions > 0) {
+        std::cout << regressions << " significant regression(s) found.\n";
+        return 1;
+    }
+    std::cout << "No significant regressions.\n";
+    return 0;
+}
+
+} // namespace txn
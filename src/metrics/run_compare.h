@@ -0,0 +1,25 @@
+#ifndef RUN_COMPARE_H
+#define RUN_COMPARE_H
+
+#include <string>
+
+namespace txn {
+
+struct CompareConfig {
+    double threshold_pct = 5.0;   // relative change that counts as a regression
+    double alpha         = 0.05;  // significance level for Welch's t-test
+};
+
+// Diffs two JSON Lines run-record files (see run_record.h). Runs are grouped by
+// configuration; for every configuration present in both sets, throughput and
+// p99 latency are compared with Welch's t-test. A regression is a change in
+// the bad direction larger than threshold_pct that is also significant at
+// alpha. Groups with fewer than two runs on either side cannot be tested and
+// are marked with '?' but never fail the comparison.
+// Returns 0 if no regression was found, 1 if any was, 2 on input errors.
+int CompareRunRecords(const std::string& baseline_path, const std::string& candidate_path,
+                      const CompareConfig& config);
+
+} // namespace txn
+
+#endif // RUN_COMPARE_H
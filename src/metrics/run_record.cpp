@@ -0,0 +1,336 @@
+#include "metrics/run_record.h"
+#include "metrics/metrics.h"
+#include "database/database.h"
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+// Build metadata is injected by CMake; fall back for builds outside it.
+#ifndef TXN_GIT_REV
+#define TXN_GIT_REV "unknown"
+#endif
+#ifndef TXN_COMPILER
+#define TXN_COMPILER "unknown"
+#endif
+#ifndef TXN_BUILD_TYPE
+#define TXN_BUILD_TYPE ""
+#endif
+#ifndef TXN_CXX_FLAGS
+#define TXN_CXX_FLAGS ""
+#endif
+
+namespace txn {
+
+namespace {
+
+std::string CpuModel() {
+#ifdef __APPLE__
+    char buf[256];
+    size_t len = sizeof(buf);
+    if (sysctlbyname("machdep.cpu.brand_string", buf, &len, nullptr, 0) == 0) {
+        return std::string(buf);
+    }
+#else
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                size_t start = line.find_first_not_of(" \t", colon + 1);
+                return start == std::string::npos ? "" : line.substr(start);
+            }
+        }
+    }
+#endif
+    return "unknown";
+}
+
+std::string Hostname() {
+    char buf[256] = {0};
+    if (gethostname(buf, sizeof(buf) - 1) != 0) return "unknown";
+    return std::string(buf);
+}
+
+std::string UtcTimestamp() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buf;
+}
+
+std::string Quote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\t': out += "\\t";  break;
+            case '\r': out += "\\r";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char esc[8];
+                    std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    out += esc;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+// Minimal JSON reader for run records: objects, strings, numbers and
+// literals. Nested objects are flattened into dotted keys ("config.threads");
+// every scalar is kept as its text.
+class FlatJsonParser {
+public:
+    explicit FlatJsonParser(const std::string& text) : s_(text) {}
+
+    bool Parse(std::map<std::string, std::string>& out) {
+        SkipSpace();
+        if (!ParseObject("", out)) return false;
+        SkipSpace();
+        return pos_ == s_.size();
+    }
+
+private:
+    void SkipSpace() {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) pos_++;
+    }
+
+    bool Consume(char c) {
+        SkipSpace();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseString(std::string& out) {
+        if (!Consume('"')) return false;
+        while (pos_ < s_.size() && s_[pos_] != '"') {
+            char c = s_[pos_++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= s_.size()) return false;
+            char e = s_[pos_++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (pos_ + 4 > s_.size()) return false;
+                    unsigned code = std::stoul(s_.substr(pos_, 4), nullptr, 16);
+                    pos_ += 4;
+                    // Records only escape control characters; keep ASCII, replace the rest
+                    out += code < 0x80 ? static_cast<char>(code) : '?';
+                    break;
+                }
+                default: out += e;
+            }
+        }
+        return Consume('"');
+    }
+
+    bool ParseValue(const std::string& key, std::map<std::string, std::string>& out) {
+        SkipSpace();
+        if (pos_ >= s_.size()) return false;
+        char c = s_[pos_];
+        if (c == '{') return ParseObject(key + ".", out);
+        if (c == '"') {
+            std::string value;
+            if (!ParseString(value)) return false;
+            out[key] = value;
+            return true;
+        }
+        size_t start = pos_;
+        while (pos_ < s_.size() && s_[pos_] != ',' && s_[pos_] != '}'
+               && !std::isspace(static_cast<unsigned char>(s_[pos_]))) {
+            pos_++;
+        }
+        if (pos_ == start) return false;
+        out[key] = s_.substr(start, pos_ - start);
+        return true;
+    }
+
+    bool ParseObject(const std::string& prefix, std::map<std::string, std::string>& out) {
+        if (!Consume('{')) return false;
+        if (Consume('}')) return true;
+        do {
+            std::string key;
+            if (!ParseString(key) || !Consume(':')) return false;
+            if (!ParseValue(prefix + key, out)) return false;
+        } while (Consume(','));
+        return Consume('}');
+    }
+
+    const std::string& s_;
+    size_t pos_ = 0;
+};
+
+std::string Field(const std::map<std::string, std::string>& m, const std::string& key) {
+    auto it = m.find(key);
+    return it == m.end() ? "" : it->second;
+}
+
+double NumField(const std::map<std::string, std::string>& m, const std::string& key) {
+    std::string v = Field(m, key);
+    return v.empty() ? 0.0 : std::strtod(v.c_str(), nullptr);
+}
+
+} // anonymous namespace
+
+RunEnvironment CollectEnvironment() {
+    RunEnvironment env;
+    env.git_rev         = TXN_GIT_REV;
+    env.compiler        = TXN_COMPILER;
+    env.build_type      = TXN_BUILD_TYPE;
+    env.cxx_flags       = TXN_CXX_FLAGS;
+    env.rocksdb_version = Database::Version();
+    env.cpu_model       = CpuModel();
+    env.cores           = static_cast<int>(std::thread::hardware_concurrency());
+    env.hostname        = Hostname();
+    return env;
+}
+
+std::string RunRecord::ConfigKey() const {
+    std::ostringstream key;
+    key << "workload=" << workload << " protocol=" << protocol << " threads=" << threads
+        << " hotset_prob=" << hotset_prob << " hotset_size=" << hotset_size
+        << " txns=" << txns_per_thread;
+    return key.str();
+}
+
+void FillRunRecord(RunRecord& record, MetricsCollector& metrics, double elapsed_s) {
+    uint64_t commits = metrics.TotalCommits();
+    uint64_t aborts  = metrics.TotalAborts();
+
+    record.timestamp      = UtcTimestamp();
+    record.env            = CollectEnvironment();
+    record.elapsed_s      = elapsed_s;
+    record.commits        = commits;
+    record.aborts         = aborts;
+    record.throughput_tps = metrics.Throughput(elapsed_s);
+    record.abort_pct      = (commits + aborts) > 0 ? 100.0 * aborts / (commits + aborts) : 0.0;
+    record.p50_us         = metrics.OverallPercentile(50.0);
+    record.p90_us         = metrics.OverallPercentile(90.0);
+    record.p99_us         = metrics.OverallPercentile(99.0);
+    record.jain_fairness  = metrics.JainFairness();
+}
+
+std::string ToJson(const RunRecord& r) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(6);
+    out << "{\"timestamp\":" << Quote(r.timestamp)
+        << ",\"config\":{"
+        <<   "\"workload\":"         << Quote(r.workload)
+        <<   ",\"protocol\":"        << Quote(r.protocol)
+        <<   ",\"threads\":"         << r.threads
+        <<   ",\"txns_per_thread\":" << r.txns_per_thread
+        <<   ",\"hotset_size\":"     << r.hotset_size
+        <<   ",\"hotset_prob\":"     << r.hotset_prob
+        <<   ",\"repeat\":"          << r.repeat
+        << "},\"env\":{"
+        <<   "\"git_rev\":"          << Quote(r.env.git_rev)
+        <<   ",\"compiler\":"        << Quote(r.env.compiler)
+        <<   ",\"build_type\":"      << Quote(r.env.build_type)
+        <<   ",\"cxx_flags\":"       << Quote(r.env.cxx_flags)
+        <<   ",\"rocksdb_version\":" << Quote(r.env.rocksdb_version)
+        <<   ",\"cpu_model\":"       << Quote(r.env.cpu_model)
+        <<   ",\"cores\":"           << r.env.cores
+        <<   ",\"hostname\":"        << Quote(r.env.hostname)
+        << "},\"metrics\":{"
+        <<   "\"elapsed_s\":"        << r.elapsed_s
+        <<   ",\"commits\":"         << r.commits
+        <<   ",\"aborts\":"          << r.aborts
+        <<   ",\"throughput_tps\":"  << r.throughput_tps
+        <<   ",\"abort_pct\":"       << r.abort_pct
+        <<   ",\"p50_us\":"          << r.p50_us
+        <<   ",\"p90_us\":"          << r.p90_us
+        <<   ",\"p99_us\":"          << r.p99_us
+        <<   ",\"jain_fairness\":"   << r.jain_fairness
+        << "}}";
+    return out.str();
+}
+
+bool AppendRunRecord(const std::string& path, const RunRecord& record) {
+    std::ofstream file(path, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open run record file: " << path << "\n";
+        return false;
+    }
+    file << ToJson(record) << "\n";
+    return true;
+}
+
+bool LoadRunRecords(const std::string& path, std::vector<RunRecord>& records) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open run record file: " << path << "\n";
+        return false;
+    }
+
+    std::string line;
+    int line_num = 0;
+    while (std::getline(file, line)) {
+        line_num++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        std::map<std::string, std::string> m;
+        if (!FlatJsonParser(line).Parse(m)) {
+            std::cerr << path << ":" << line_num << ": malformed run record, skipped\n";
+            continue;
+        }
+
+        RunRecord r;
+        r.timestamp           = Field(m, "timestamp");
+        r.workload            = Field(m, "config.workload");
+        r.protocol            = Field(m, "config.protocol");
+        r.threads             = static_cast<int>(NumField(m, "config.threads"));
+        r.txns_per_thread     = static_cast<int>(NumField(m, "config.txns_per_thread"));
+        r.hotset_size         = static_cast<int>(NumField(m, "config.hotset_size"));
+        r.hotset_prob         = NumField(m, "config.hotset_prob");
+        r.repeat              = static_cast<int>(NumField(m, "config.repeat"));
+        r.env.git_rev         = Field(m, "env.git_rev");
+        r.env.compiler        = Field(m, "env.compiler");
+        r.env.build_type      = Field(m, "env.build_type");
+        r.env.cxx_flags       = Field(m, "env.cxx_flags");
+        r.env.rocksdb_version = Field(m, "env.rocksdb_version");
+        r.env.cpu_model       = Field(m, "env.cpu_model");
+        r.env.cores           = static_cast<int>(NumField(m, "env.cores"));
+        r.env.hostname        = Field(m, "env.hostname");
+        r.elapsed_s           = NumField(m, "metrics.elapsed_s");
+        r.commits             = static_cast<uint64_t>(NumField(m, "metrics.commits"));
+        r.aborts              = static_cast<uint64_t>(NumField(m, "metrics.aborts"));
+        r.throughput_tps      = NumField(m, "metrics.throughput_tps");
+        r.abort_pct           = NumField(m, "metrics.abort_pct");
+        r.p50_us              = NumField(m, "metrics.p50_us");
+        r.p90_us              = NumField(m, "metrics.p90_us");
+        r.p99_us              = NumField(m, "metrics.p99_us");
+        r.jain_fairness       = NumField(m, "metrics.jain_fairness");
+        records.push_back(std::move(r));
+    }
+    return true;
+}
+
+} // namespace txn
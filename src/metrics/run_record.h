@@ -0,0 +1,73 @@
+#ifndef RUN_RECORD_H
+#define RUN_RECORD_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace txn {
+
+class MetricsCollector;
+
+// Where and how a run was produced. Build fields are baked in at configure
+// time; host fields are read when the record is created.
+struct RunEnvironment {
+    std::string git_rev;
+    std::string compiler;
+    std::string build_type;
+    std::string cxx_flags;
+    std::string rocksdb_version;
+    std::string cpu_model;
+    int cores = 0;
+    std::string hostname;
+};
+
+RunEnvironment CollectEnvironment();
+
+// One benchmark run: configuration, environment and headline metrics.
+// Serialized as a single JSON object per line (JSON Lines).
+struct RunRecord {
+    std::string timestamp;  // UTC, ISO 8601
+
+    // Configuration
+    std::string workload;
+    std::string protocol;
+    int threads         = 0;
+    int txns_per_thread = 0;
+    int hotset_size     = 0;
+    double hotset_prob  = 0.0;
+    int repeat          = 0;  // index within a sweep; 0 for single runs
+
+    RunEnvironment env;
+
+    // Metrics
+    double elapsed_s      = 0.0;
+    uint64_t commits      = 0;
+    uint64_t aborts       = 0;
+    double throughput_tps = 0.0;
+    double abort_pct      = 0.0;
+    double p50_us         = 0.0;
+    double p90_us         = 0.0;
+    double p99_us         = 0.0;
+    double jain_fairness  = 0.0;
+
+    // Identifies runs of the same configuration across result sets
+    // (everything except repeat, timestamp and environment).
+    std::string ConfigKey() const;
+};
+
+// Fills timestamp, environment and metrics; configuration is left to the caller.
+void FillRunRecord(RunRecord& record, MetricsCollector& metrics, double elapsed_s);
+
+std::string ToJson(const RunRecord& record);
+
+// Appends one JSON line to path. Returns false if the file cannot be opened.
+bool AppendRunRecord(const std::string& path, const RunRecord& record);
+
+// Reads every record from a JSON Lines file. Malformed lines are reported on
+// stderr and skipped. Returns false if the file cannot be opened.
+bool LoadRunRecords(const std::string& path, std::vector<RunRecord>& records);
+
+} // namespace txn
+
+#endif // RUN_RECORD_H
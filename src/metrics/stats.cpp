@@ -0,0 +1,149 @@
+#include "metrics/stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace txn {
+
+namespace {
+
+// Continued fraction for the regularized incomplete beta function
+// (modified Lentz's method).
+double BetaContinuedFraction(double a, double b, double x) {
+    const double kTiny = 1e-300;
+    double qab = a + b;
+    double qap = a + 1.0;
+    double qam = a - 1.0;
+    double c = 1.0;
+    double d = 1.0 - qab * x / qap;
+    if (std::fabs(d) < kTiny) d = kTiny;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= 200; m++) {
+        int m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < kTiny) d = kTiny;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < kTiny) c = kTiny;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d;
+        if (std::fabs(d) < kTiny) d = kTiny;
+        c = 1.0 + aa / c;
+        if (std::fabs(c) < kTiny) c = kTiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < 1e-12) break;
+    }
+    return h;
+}
+
+// Regularized incomplete beta function I_x(a, b).
+double IncompleteBeta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b)
+                            + a * std::log(x) + b * std::log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        return front * BetaContinuedFraction(a, b, x) / a;
+    }
+    return 1.0 - front * BetaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+} // anonymous namespace
+
+double Mean(const std::vector<double>& values) {
+    if (values.empty()) return 0.0;
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    return sum / values.size();
+}
+
+double SampleStdDev(const std::vector<double>& values) {
+    if (values.size() < 2) return 0.0;
+    double mean = Mean(values);
+    double sq = 0.0;
+    for (double v : values) sq += (v - mean) * (v - mean);
+    return std::sqrt(sq / (values.size() - 1));
+}
+
+double StudentT975(int df) {
+    static const double kTable[] = {
+        0.0,    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+        2.228,  2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+        2.086,  2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+        2.042,
+    };
+    if (df <= 0) return 0.0;
+    if (df <= 30) return kTable[df];
+    if (df <= 60) return 2.000;
+    if (df <= 120) return 1.980;
+    return 1.960;
+}
+
+double ConfidenceHalfWidth95(const std::vector<double>& values) {
+    if (values.size() < 2) return 0.0;
+    return StudentT975(static_cast<int>(values.size()) - 1)
+         * SampleStdDev(values) / std::sqrt(static_cast<double>(values.size()));
+}
+
+double StudentTTwoSidedP(double t, double df) {
+    if (df <= 0.0) return 1.0;
+    if (std::isinf(t)) return 0.0;
+    return IncompleteBeta(df / 2.0, 0.5, df / (df + t * t));
+}
+
+WelchResult WelchTTest(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() < 2 || b.size() < 2) return {0.0, 0.0, 1.0};
+
+    double na = static_cast<double>(a.size());
+    double nb = static_cast<double>(b.size());
+    double va = SampleStdDev(a) * SampleStdDev(a) / na;
+    double vb = SampleStdDev(b) * SampleStdDev(b) / nb;
+    double diff = Mean(b) - Mean(a);
+
+    if (va + vb == 0.0) {
+        // Both samples constant: any difference is exact
+        if (diff == 0.0) return {0.0, na + nb - 2.0, 1.0};
+        return {diff > 0 ? INFINITY : -INFINITY, na + nb - 2.0, 0.0};
+    }
+
+    double t = diff / std::sqrt(va + vb);
+    double df = (va + vb) * (va + vb)
+              / (va * va / (na - 1.0) + vb * vb / (nb - 1.0));
+    return {t, df, StudentTTwoSidedP(t, df)};
+}
+
+TrendResult LinearTrend(const std::vector<double>& x, const std::vector<double>& y) {
+    size_t n = std::min(x.size(), y.size());
+    if (n < 2) return {0.0, n == 1 ? y[0] : 0.0, 1.0};
+
+    std::vector<double> xs(x.begin(), x.begin() + n);
+    std::vector<double> ys(y.begin(), y.begin() + n);
+    double mx = Mean(xs);
+    double my = Mean(ys);
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sxx += (xs[i] - mx) * (xs[i] - mx);
+        sxy += (xs[i] - mx) * (ys[i] - my);
+    }
+    if (sxx == 0.0) return {0.0, my, 1.0};
+
+    double slope = sxy / sxx;
+    double intercept = my - slope * mx;
+    if (n < 3) return {slope, intercept, 1.0};
+
+    double ssr = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double r = ys[i] - (intercept + slope * xs[i]);
+        ssr += r * r;
+    }
+    double df = static_cast<double>(n - 2);
+    double se = std::sqrt(ssr / df / sxx);
+    if (se == 0.0) return {slope, intercept, slope == 0.0 ? 1.0 : 0.0};
+    return {slope, intercept, StudentTTwoSidedP(slope / se, df)};
+}
+
+} // namespace txn
@@ -0,0 +1,41 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <vector>
+
+namespace txn {
+
+// Summary statistics over repeated measurements.
+double Mean(const std::vector<double>& values);
+double SampleStdDev(const std::vector<double>& values);
+
+// Two-sided 97.5% quantile of Student's t with df degrees of freedom.
+double StudentT975(int df);
+
+// Half-width of the 95% confidence interval for the mean (0 for n < 2).
+double ConfidenceHalfWidth95(const std::vector<double>& values);
+
+struct WelchResult {
+    double t;        // (mean(b) - mean(a)) / standard error
+    double df;       // Welch-Satterthwaite degrees of freedom; 0 if untestable
+    double p_value;  // two-sided; 1.0 when either sample has fewer than 2 values
+};
+
+// Welch's unequal-variance t-test for a difference in means between a and b.
+WelchResult WelchTTest(const std::vector<double>& a, const std::vector<double>& b);
+
+struct TrendResult {
+    double slope;      // change in y per unit of x
+    double intercept;
+    double p_value;    // two-sided test of slope == 0; 1.0 with fewer than 3 points
+};
+
+// Ordinary least-squares fit y = intercept + slope * x with a t-test on the slope.
+TrendResult LinearTrend(const std::vector<double>& x, const std::vector<double>& y);
+
+// Two-sided p-value of Student's t statistic with df degrees of freedom.
+double StudentTTwoSidedP(double t, double df);
+
+} // namespace txn
+
+#endif // STATS_H
@@ -0,0 +1,220 @@
+#include "replication/follower.h"
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace txn {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+Follower::Follower(Database& db) : db_(db) {}
+
+bool Follower::Connect(const std::string& socket_path) {
+    return stream_.Connect(socket_path);
+}
+
+std::optional<std::vector<std::string>> Follower::ReceiveSnapshot() {
+    std::vector<std::string> keys;
+    ReplicationRecord record;
+    while (stream_.Receive(record)) {
+        if (record.kind != ReplicationKind::kSnapshot) {
+            std::cerr << "Replication stream did not start with a snapshot\n";
+            return std::nullopt;
+        }
+        if (record.writes.empty()) {
+            applied_seq_ = record.seq;
+            snapshot_keys_ = keys.size();
+            return keys;
+        }
+        for (const auto& [key, _] : record.writes) keys.push_back(key);
+        if (!db_.PutBatch(record.writes)) return std::nullopt;
+    }
+    std::cerr << "Primary disconnected during the snapshot\n";
+    return std::nullopt;
+}
+
+bool Follower::ApplyStream() {
+    std::vector<ReplicationRecord> group;
+    ReplicationRecord record;
+    while (true) {
+        // Take every frame already received, so a backlog is applied in one batch
+        do {
+            if (!stream_.Receive(record)) {
+                std::cerr << "Primary disconnected after commit " << applied_seq_.load() << "\n";
+                return false;
+            }
+            if (record.kind == ReplicationKind::kEnd) break;
+            if (record.kind != ReplicationKind::kBatch) {
+                std::cerr << "Unexpected replication frame\n";
+                return false;
+            }
+            group.push_back(std::move(record));
+        } while (stream_.HasBufferedFrame());
+
+        if (!group.empty() && !Apply(group)) return false;
+        group.clear();
+
+        if (record.kind == ReplicationKind::kEnd) {
+            if (record.seq != applied_seq_) {
+                std::cerr << "Primary ended at commit " << record.seq << " but commit "
+                          << applied_seq_.load() << " is the last received\n";
+                return false;
+            }
+            ReplicationRecord ack;
+            ack.kind = ReplicationKind::kAck;
+            ack.seq = applied_seq_;
+            return stream_.Send(ack);
+        }
+    }
+}
+
+bool Follower::Apply(const std::vector<ReplicationRecord>& batches) {
+    // Everything before a gap is still applied
+    size_t valid = 0;
+    while (valid < batches.size() && batches[valid].seq == applied_seq_ + valid + 1) valid++;
+
+    if (valid > 0) {
+        std::vector<std::pair<std::string, std::string>> writes;
+        for (size_t i = 0; i < valid; i++) {
+            // Later commits of the group overwrite earlier ones, as they would in sequence
+            writes.insert(writes.end(), batches[i].writes.begin(), batches[i].writes.end());
+        }
+        {
+            apply_waiting_ = true;
+            std::unique_lock<std::shared_mutex> lock(position_mutex_);
+            apply_waiting_ = false;
+            if (!db_.PutBatch(writes)) return false;
+            applied_seq_ = batches[valid - 1].seq;
+        }
+
+        uint64_t now = NowNs();
+        for (size_t i = 0; i < valid; i++) {
+            uint64_t commit_ns = batches[i].commit_ns;
+            double lag_us = now > commit_ns ? (now - commit_ns) / 1000.0 : 0.0;
+            lag_.Record(lag_us);
+            lag_sum_us_ += lag_us;
+            if (lag_us > lag_max_us_) lag_max_us_ = lag_us;
+            lag_samples_++;
+        }
+        writes_ += writes.size();
+        apply_groups_++;
+    }
+
+    if (valid < batches.size()) {
+        std::cerr << "Replication gap: expected commit " << applied_seq_ + 1
+                  << ", got " << batches[valid].seq << "\n";
+        return false;
+    }
+    return true;
+}
+
+uint64_t Follower::ReadAt(const std::vector<std::string>& keys,
+                          std::vector<std::optional<std::string>>& values) {
+    // shared_mutex may prefer readers; back off so a waiting apply cannot starve
+    while (apply_waiting_.load(std::memory_order_relaxed)) std::this_thread::yield();
+    std::shared_lock<std::shared_mutex> lock(position_mutex_);
+    values.clear();
+    for (const auto& key : keys) values.push_back(db_.Get(key));
+    return applied_seq_.load();
+}
+
+FollowerStats Follower::Stats() {
+    FollowerStats stats;
+    stats.snapshot_keys = snapshot_keys_;
+    stats.applied_seq   = applied_seq_.load();
+    stats.writes        = writes_;
+    stats.apply_groups  = apply_groups_;
+    if (lag_samples_ > 0) {
+        std::vector<uint64_t> counts = lag_.Drain();
+        stats.lag_mean_us = lag_sum_us_ / lag_samples_;
+        stats.lag_p50_us  = LatencyHistogram::Percentile(counts, 50.0);
+        stats.lag_p99_us  = LatencyHistogram::Percentile(counts, 99.0);
+        stats.lag_max_us  = lag_max_us_;
+    }
+    return stats;
+}
+
+int RunFollower(const FollowerConfig& config) {
+    if (config.reader_threads < 0 || config.keys_per_read < 1) {
+        std::cerr << "Follower needs >= 0 reader threads and >= 1 key per read\n";
+        return 1;
+    }
+    std::filesystem::remove_all(config.db_path);
+    Database db;
+    if (!db.Open(config.db_path)) {
+        std::cerr << "Failed to open database: " << config.db_path << "\n";
+        return 1;
+    }
+
+    std::cout << "Transaction Processing System (follower)\n"
+              << "========================================\n"
+              << "Primary:         " << config.socket_path    << "\n"
+              << "DB path:         " << config.db_path        << "\n"
+              << "Reader threads:  " << config.reader_threads << "\n\n";
+
+    Follower follower(db);
+    if (!follower.Connect(config.socket_path)) return 1;
+    auto keys = follower.ReceiveSnapshot();
+    if (!keys) return 1;
+    std::cout << "Loaded snapshot of " << keys->size() << " records at commit "
+              << follower.AppliedSeq() << "\nApplying commits...\n";
+
+    // Read-only transactions over random snapshot keys while the stream replays
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> read_txns{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < (keys->empty() ? 0 : config.reader_threads); t++) {
+        readers.emplace_back([&, t]() {
+            std::mt19937 rng(t + 1);
+            std::uniform_int_distribution<size_t> pick(0, keys->size() - 1);
+            std::vector<std::string> txn_keys(config.keys_per_read);
+            std::vector<std::optional<std::string>> values;
+            uint64_t local = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                for (auto& key : txn_keys) key = (*keys)[pick(rng)];
+                follower.ReadAt(txn_keys, values);
+                local++;
+            }
+            read_txns += local;
+        });
+    }
+
+    auto start = Clock::now();
+    bool ok = follower.ApplyStream();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    done = true;
+    for (auto& t : readers) t.join();
+
+    FollowerStats stats = follower.Stats();
+    std::cout << std::fixed << std::setprecision(2)
+              << "\nReplication (follower):\n"
+              << "  Applied through: commit " << stats.applied_seq
+              << (ok ? "" : " (stream broken)") << "\n"
+              << "  Writes applied:  " << stats.writes << " in " << stats.apply_groups
+              << " write batches\n"
+              << "  Apply rate:      " << (elapsed > 0.0 ? stats.applied_seq / elapsed : 0.0)
+              << " commits/sec over " << elapsed << " s\n"
+              << "  Lag (us):        mean " << stats.lag_mean_us << ", p50 " << stats.lag_p50_us
+              << ", p99 " << stats.lag_p99_us << ", max " << stats.lag_max_us << "\n"
+              << "  Read-only txns:  " << read_txns.load() << " ("
+              << (elapsed > 0.0 ? read_txns.load() / elapsed : 0.0) << " txns/sec, "
+              << config.keys_per_read << " keys each)\n";
+
+    db.Close();
+    return ok ? 0 : 1;
+}
+
+} // namespace txn
@@ -0,0 +1,85 @@
+#ifndef FOLLOWER_H
+#define FOLLOWER_H
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "database/database.h"
+#include "metrics/latency_histogram.h"
+#include "replication/replication_stream.h"
+
+namespace txn {
+
+struct FollowerStats {
+    uint64_t snapshot_keys = 0;
+    uint64_t applied_seq   = 0;   // last commit applied
+    uint64_t writes        = 0;   // key-value pairs applied after the snapshot
+    uint64_t apply_groups  = 0;   // batches are applied in groups, one WriteBatch each
+    double lag_mean_us     = 0.0; // primary commit to follower apply
+    double lag_p50_us      = 0.0;
+    double lag_p99_us      = 0.0;
+    double lag_max_us      = 0.0;
+};
+
+// Follower side of log-shipping replication. Loads the primary's snapshot
+// into an empty database, then applies commit batches strictly in sequence
+// order. Every batch already received is applied in one WriteBatch; readers
+// are excluded while it is written, so ReadAt always sees the state after
+// some commit seq, never part of one.
+class Follower {
+public:
+    explicit Follower(Database& db);
+
+    bool Connect(const std::string& socket_path);
+    // Receives and stores the snapshot. Returns its keys, or nullopt if the
+    // stream broke.
+    std::optional<std::vector<std::string>> ReceiveSnapshot();
+    // Applies batches until the primary's end marker, then acknowledges the
+    // last commit. False on a broken stream or a gap in the sequence.
+    bool ApplyStream();
+
+    // Read-only transaction: reads keys at one applied position and returns
+    // that position (the commit seq whose effects it sees, 0 = snapshot).
+    uint64_t ReadAt(const std::vector<std::string>& keys,
+                    std::vector<std::optional<std::string>>& values);
+
+    uint64_t AppliedSeq() const { return applied_seq_.load(); }
+    FollowerStats Stats();
+
+private:
+    bool Apply(const std::vector<ReplicationRecord>& batches);
+
+    Database& db_;
+    ReplicationStream stream_;
+    std::shared_mutex position_mutex_;  // shared: readers, exclusive: apply
+    std::atomic<bool> apply_waiting_{false};
+    std::atomic<uint64_t> applied_seq_{0};
+
+    uint64_t snapshot_keys_ = 0;
+    uint64_t writes_ = 0;
+    uint64_t apply_groups_ = 0;
+    LatencyHistogram lag_;
+    double lag_sum_us_ = 0.0;
+    double lag_max_us_ = 0.0;
+    uint64_t lag_samples_ = 0;
+};
+
+struct FollowerConfig {
+    std::string socket_path;
+    std::string db_path  = "db_follower";  // emptied before the snapshot is loaded
+    int reader_threads   = 4;              // read-only transactions during replay
+    int keys_per_read    = 4;
+};
+
+// transaction_system --follow: connects to a primary started with
+// --replicate, replays its stream while reader threads run read-only
+// transactions, and reports replication lag, apply rate and reader
+// throughput. Returns 0 on success, 1 on errors.
+int RunFollower(const FollowerConfig& config);
+
+} // namespace txn
+
+#endif // FOLLOWER_H
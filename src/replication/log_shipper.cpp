@@ -0,0 +1,202 @@
+#include "replication/log_shipper.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace txn {
+
+namespace {
+
+// Snapshot frames stay well under kMaxFrameBytes
+constexpr size_t kSnapshotChunkBytes = 1u << 20;
+
+} // anonymous namespace
+
+LogShipper::LogShipper(Database& db, const std::string& socket_path)
+    : db_(db), socket_path_(socket_path) {}
+
+LogShipper::~LogShipper() {
+    db_.DetachObserver();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finishing_ = true;
+    }
+    cv_.notify_all();
+    if (sender_.joinable()) sender_.join();
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(socket_path_.c_str());
+    }
+}
+
+bool LogShipper::Listen() {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << socket_path_ << "\n";
+        return false;
+    }
+    std::strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    unlink(socket_path_.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || listen(listen_fd_, 1) < 0) {
+        std::cerr << "Failed to listen on " << socket_path_ << ": " << std::strerror(errno) << "\n";
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool LogShipper::AcceptFollower() {
+    int fd;
+    while ((fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC)) < 0) {
+        if (errno != EINTR) {
+            std::cerr << "accept: " << std::strerror(errno) << "\n";
+            return false;
+        }
+    }
+    stream_.Adopt(fd);
+
+    // Everything committed from here on is a batch after the snapshot
+    std::map<std::string, std::string> contents = db_.AttachObserver(this);
+    snapshot_keys_ = contents.size();
+
+    ReplicationRecord chunk;
+    chunk.kind = ReplicationKind::kSnapshot;
+    size_t chunk_bytes = 0;
+    std::string out;
+    for (auto& [key, value] : contents) {
+        chunk_bytes += key.size() + value.size();
+        chunk.writes.emplace_back(key, std::move(value));
+        if (chunk_bytes >= kSnapshotChunkBytes) {
+            AppendReplicationFrame(out, chunk);
+            chunk.writes.clear();
+            chunk_bytes = 0;
+        }
+    }
+    if (!chunk.writes.empty()) AppendReplicationFrame(out, chunk);
+    chunk.writes.clear();
+    AppendReplicationFrame(out, chunk);  // end of snapshot
+    if (!stream_.Send(out)) {
+        db_.DetachObserver();
+        std::cerr << "Follower disconnected during the snapshot\n";
+        return false;
+    }
+
+    sender_ = std::thread(&LogShipper::SendLoop, this);
+    return true;
+}
+
+void LogShipper::OnCommit(const std::unordered_map<std::string, std::string>& writes) {
+    last_commit_ = Clock::now();
+    ReplicationRecord record;
+    record.kind = ReplicationKind::kBatch;
+    record.seq = ++seq_;
+    record.commit_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           last_commit_.time_since_epoch()).count();
+    record.writes.assign(writes.begin(), writes.end());
+    writes_ += writes.size();
+    if (lost_.load(std::memory_order_relaxed)) return;  // nowhere to ship
+
+    bool was_empty;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        was_empty = pending_.empty();
+        AppendReplicationFrame(pending_, record);
+    }
+    if (was_empty) cv_.notify_one();
+}
+
+void LogShipper::SendLoop() {
+    std::string sending;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return !pending_.empty() || finishing_; });
+        if (pending_.empty()) return;  // finishing and drained
+        // Everything queued since the last send goes out in one write
+        sending.swap(pending_);
+        lock.unlock();
+        if (!stream_.Send(sending)) {
+            std::cerr << "Follower disconnected; replication stopped\n";
+            lost_ = true;
+            lock.lock();
+            pending_.clear();
+            return;
+        }
+        sending.clear();
+        lock.lock();
+    }
+}
+
+bool LogShipper::Finish() {
+    if (!sender_.joinable()) return false;
+    db_.DetachObserver();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finishing_ = true;
+    }
+    cv_.notify_all();
+    sender_.join();
+    if (lost_) return false;
+
+    ReplicationRecord end;
+    end.kind = ReplicationKind::kEnd;
+    end.seq = seq_;
+    ReplicationRecord ack;
+    bool ok = stream_.Send(end);
+    while (ok && (ok = stream_.Receive(ack))) {
+        if (ack.kind == ReplicationKind::kAck && ack.seq >= seq_) break;
+    }
+    if (!ok) {
+        std::cerr << "Follower disconnected before acknowledging commit " << seq_ << "\n";
+        lost_ = true;
+        return false;
+    }
+    acked_seq_ = ack.seq;
+    if (seq_ > 0) {
+        catch_up_ms_ = std::chrono::duration<double, std::milli>(Clock::now() - last_commit_).count();
+    }
+    stream_.Close();
+    return true;
+}
+
+ShipperStats LogShipper::Stats() const {
+    ShipperStats stats;
+    stats.snapshot_keys = snapshot_keys_;
+    stats.batches       = seq_;
+    stats.writes        = writes_;
+    stats.bytes         = stream_.BytesSent();
+    stats.send_calls    = stream_.SendCalls();
+    stats.acked_seq     = acked_seq_;
+    stats.catch_up_ms   = catch_up_ms_;
+    stats.follower_lost = lost_.load();
+    return stats;
+}
+
+void LogShipper::PrintReport() const {
+    ShipperStats stats = Stats();
+    std::cout << "\nReplication (primary):\n"
+              << "  Snapshot keys:   " << stats.snapshot_keys << "\n"
+              << "  Batches shipped: " << stats.batches << " (" << stats.writes << " writes)\n"
+              << "  Bytes shipped:   " << stats.bytes << " in " << stats.send_calls << " sends\n";
+    if (stats.follower_lost) {
+        std::cout << "  Follower:        lost before the end of the run\n";
+    } else {
+        std::cout << "  Follower acked:  commit " << stats.acked_seq << ", "
+                  << std::fixed << std::setprecision(2) << stats.catch_up_ms
+                  << " ms after the last commit\n";
+    }
+}
+
+} // namespace txn
@@ -0,0 +1,83 @@
+#ifndef LOG_SHIPPER_H
+#define LOG_SHIPPER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "database/database.h"
+#include "replication/replication_stream.h"
+
+namespace txn {
+
+struct ShipperStats {
+    uint64_t snapshot_keys = 0;
+    uint64_t batches       = 0;   // commits shipped
+    uint64_t writes        = 0;   // key-value pairs in those commits
+    uint64_t bytes         = 0;   // on the wire, snapshot included
+    uint64_t send_calls    = 0;   // batches are coalesced into fewer sends
+    uint64_t acked_seq     = 0;   // last commit the follower confirmed
+    double catch_up_ms     = 0.0; // last commit to the follower's final ack
+    bool follower_lost     = false;
+};
+
+// Primary side of log-shipping replication: an engine-level commit log
+// rather than RocksDB's WAL (GetUpdatesSince), so every committed write set
+// is one record whatever the storage options.
+//
+// Attached to the database as its CommitObserver, it numbers commits in
+// apply order and encodes them into a buffer that a sender thread ships to
+// the follower, so commits never wait on the socket. The follower starts
+// from a snapshot taken at the attach point.
+class LogShipper : public CommitObserver {
+public:
+    LogShipper(Database& db, const std::string& socket_path);
+    ~LogShipper() override;
+
+    // Binds the socket (replacing a stale one).
+    bool Listen();
+    // Blocks until a follower connects, sends it the current contents and
+    // starts shipping commits. Call before transactions start committing.
+    bool AcceptFollower();
+    // Detaches from the database, ships the end marker and waits for the
+    // follower to acknowledge the last commit. False if the follower was lost.
+    bool Finish();
+
+    void OnCommit(const std::unordered_map<std::string, std::string>& writes) override;
+
+    ShipperStats Stats() const;
+    void PrintReport() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void SendLoop();
+
+    Database& db_;
+    std::string socket_path_;
+    int listen_fd_ = -1;
+    ReplicationStream stream_;
+    std::thread sender_;
+
+    // Written by OnCommit (serialized by the database's commit lock)
+    uint64_t seq_ = 0;
+    uint64_t writes_ = 0;
+    Clock::time_point last_commit_{};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string pending_;  // encoded frames not yet handed to the sender
+    bool finishing_ = false;
+    std::atomic<bool> lost_{false};
+
+    uint64_t snapshot_keys_ = 0;
+    uint64_t acked_seq_ = 0;
+    double catch_up_ms_ = 0.0;
+};
+
+} // namespace txn
+
+#endif // LOG_SHIPPER_H
@@ -0,0 +1,107 @@
+#include "replication/replication_stream.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace txn {
+
+ReplicationStream::~ReplicationStream() {
+    Close();
+}
+
+bool ReplicationStream::Connect(const std::string& socket_path) {
+    Close();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << socket_path << "\n";
+        return false;
+    }
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0 || connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Failed to connect to " << socket_path << ": " << std::strerror(errno) << "\n";
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void ReplicationStream::Adopt(int fd) {
+    Close();
+    fd_ = fd;
+}
+
+void ReplicationStream::Close() {
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+    inbuf_.clear();
+    in_pos_ = 0;
+}
+
+bool ReplicationStream::Send(const std::string& data) {
+    if (fd_ < 0) return false;
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = send(fd_, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += n;
+    }
+    bytes_sent_ += data.size();
+    send_calls_++;
+    return true;
+}
+
+bool ReplicationStream::Send(const ReplicationRecord& record) {
+    std::string frame;
+    AppendReplicationFrame(frame, record);
+    return Send(frame);
+}
+
+bool ReplicationStream::Receive(ReplicationRecord& record) {
+    while (true) {
+        std::string_view payload;
+        size_t consumed = 0;
+        FrameStatus status = NextFrame(inbuf_.data() + in_pos_, inbuf_.size() - in_pos_,
+                                       payload, consumed);
+        if (status == FrameStatus::kComplete) {
+            in_pos_ += consumed;
+            return DecodeReplication(payload, record);
+        }
+        if (status == FrameStatus::kInvalid || !ReadMore()) return false;
+    }
+}
+
+bool ReplicationStream::HasBufferedFrame() const {
+    std::string_view payload;
+    size_t consumed = 0;
+    return NextFrame(inbuf_.data() + in_pos_, inbuf_.size() - in_pos_, payload, consumed)
+           == FrameStatus::kComplete;
+}
+
+bool ReplicationStream::ReadMore() {
+    // Drop consumed frames before growing the buffer
+    if (in_pos_ > 0) {
+        inbuf_.erase(0, in_pos_);
+        in_pos_ = 0;
+    }
+    char buf[64 * 1024];
+    while (true) {
+        ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+        if (n > 0) {
+            inbuf_.append(buf, n);
+            return true;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        return false;
+    }
+}
+
+} // namespace txn
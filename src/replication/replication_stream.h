@@ -0,0 +1,52 @@
+#ifndef REPLICATION_STREAM_H
+#define REPLICATION_STREAM_H
+
+#include <cstddef>
+#include <string>
+#include "server/wire_protocol.h"
+
+namespace txn {
+
+// Blocking, connected Unix domain socket carrying replication frames. Used by
+// one thread per direction: the primary only sends until its final Receive of
+// the follower's ack, the follower only receives until it sends that ack.
+class ReplicationStream {
+public:
+    ReplicationStream() = default;
+    ~ReplicationStream();
+    ReplicationStream(const ReplicationStream&) = delete;
+    ReplicationStream& operator=(const ReplicationStream&) = delete;
+
+    // Follower side: connects to the primary's socket.
+    bool Connect(const std::string& socket_path);
+    // Primary side: takes ownership of an accepted connection.
+    void Adopt(int fd);
+    void Close();
+    bool Connected() const { return fd_ >= 0; }
+
+    // Sends every byte of data (encoded frames). False once the peer is gone.
+    bool Send(const std::string& data);
+    bool Send(const ReplicationRecord& record);
+
+    // Blocks until the next frame arrives. Returns false when the connection
+    // is closed or the frame is malformed.
+    bool Receive(ReplicationRecord& record);
+    // Whether a complete frame is already buffered, i.e. Receive won't block.
+    bool HasBufferedFrame() const;
+
+    uint64_t BytesSent() const { return bytes_sent_; }
+    uint64_t SendCalls() const { return send_calls_; }
+
+private:
+    bool ReadMore();
+
+    int fd_ = -1;
+    std::string inbuf_;
+    size_t in_pos_ = 0;  // start of the first unparsed frame in inbuf_
+    uint64_t bytes_sent_ = 0;
+    uint64_t send_calls_ = 0;
+};
+
+} // namespace txn
+
+#endif // REPLICATION_STREAM_H
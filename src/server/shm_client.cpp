@@ -0,0 +1,172 @@
+#include "server/shm_client.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace txn {
+
+namespace {
+
+constexpr int kSleepTimeoutMs = 100;  // re-checks engine liveness while asleep
+
+} // anonymous namespace
+
+ShmTxnClient::~ShmTxnClient() {
+    Close();
+}
+
+bool ShmTxnClient::Connect(const std::string& name) {
+    Close();
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(ShmRegionHeader)) {
+        std::cerr << "Failed to open shared memory " << name << ": " << std::strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    region_bytes_ = st.st_size;
+    base_ = mmap(nullptr, region_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base_ == MAP_FAILED) {
+        std::cerr << "mmap: " << std::strerror(errno) << "\n";
+        base_ = nullptr;
+        return false;
+    }
+
+    header_ = static_cast<ShmRegionHeader*>(base_);
+    bool valid = header_->magic == kShmMagic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || header_->version != kShmVersion
+        || ShmRegionBytes(header_->num_slots, header_->ring_bytes) != region_bytes_
+        || !EngineAlive()) {
+        std::cerr << name << " is not a running transaction engine\n";
+        Close();
+        return false;
+    }
+
+    ShmSlot* slots = ShmSlots(base_);
+    for (uint32_t i = 0; i < header_->num_slots; i++) {
+        uint32_t expected = kSlotFree;
+        if (!slots[i].state.compare_exchange_strong(expected, kSlotClaiming)) continue;
+        slots[i].client_pid.store(getpid());
+        slots[i].requests.Reset();
+        slots[i].responses.Reset();
+        slots[i].client_bell.sleeping.store(0);
+        requests_  = ShmRing(&slots[i].requests, ShmRingData(base_, i, false), header_->ring_bytes);
+        responses_ = ShmRing(&slots[i].responses, ShmRingData(base_, i, true), header_->ring_bytes);
+        slot_ = &slots[i];
+        slot_->state.store(kSlotActive, std::memory_order_release);
+        header_->engine_bell.Ring();
+        return true;
+    }
+    std::cerr << "All " << header_->num_slots << " shared-memory slots of " << name
+              << " are in use\n";
+    Close();
+    return false;
+}
+
+void ShmTxnClient::Close() {
+    if (slot_) {
+        // The engine frees the slot once it sees this
+        slot_->state.store(kSlotClosing, std::memory_order_release);
+        header_->engine_bell.Ring();
+        slot_ = nullptr;
+    }
+    if (base_) munmap(base_, region_bytes_);
+    base_ = nullptr;
+    header_ = nullptr;
+    in_flight_ = 0;
+    stashed_.clear();
+}
+
+uint64_t ShmTxnClient::SubmitTemplate(uint16_t template_id, const std::vector<std::string>& keys) {
+    TxnRequest request;
+    request.kind = RequestKind::kTemplate;
+    request.template_id = template_id;
+    request.keys = keys;
+    return Enqueue(request);
+}
+
+uint64_t ShmTxnClient::SubmitOps(const std::vector<TxnOp>& ops) {
+    TxnRequest request;
+    request.kind = RequestKind::kOps;
+    request.ops = ops;
+    return Enqueue(request);
+}
+
+uint64_t ShmTxnClient::Enqueue(TxnRequest& request) {
+    request.id = next_id_;
+    frame_.clear();
+    AppendRequestFrame(frame_, request);
+    if (frame_.size() > requests_.Capacity()) return 0;
+    while (!requests_.TryWrite(frame_)) {
+        // Ring full: publish what is buffered so the engine can drain it
+        requests_.Publish();
+        header_->engine_bell.Ring();
+        if (!EngineAlive()) return 0;
+        std::this_thread::yield();
+    }
+    next_id_++;
+    in_flight_++;
+    return request.id;
+}
+
+bool ShmTxnClient::Flush() {
+    if (!EngineAlive()) return false;
+    if (requests_.HasUnpublished()) {
+        requests_.Publish();
+        header_->engine_bell.Ring();
+    }
+    return true;
+}
+
+bool ShmTxnClient::Receive(TxnResponse& response) {
+    if (!stashed_.empty()) {
+        response = std::move(stashed_.front());
+        stashed_.pop_front();
+        return true;
+    }
+    int idle = 0;
+    while (true) {
+        std::string_view payload;
+        size_t consumed = 0;
+        if (responses_.PeekFrame(scratch_, payload, consumed)) {
+            bool ok = DecodeResponse(payload, response);
+            responses_.Consume(consumed);
+            if (!ok) return false;
+            if (in_flight_ > 0) in_flight_--;
+            return true;
+        }
+        if (!EngineAlive()) return false;
+        if (++idle < spin_polls_) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t bell = slot_->client_bell.PrepareSleep();
+        if (!responses_.Empty() || !EngineAlive()) {
+            slot_->client_bell.CancelSleep();
+        } else {
+            slot_->client_bell.Wait(bell, kSleepTimeoutMs);
+        }
+        idle = 0;
+    }
+}
+
+bool ShmTxnClient::Execute(const std::vector<TxnOp>& ops, TxnResponse& response) {
+    uint64_t id = SubmitOps(ops);
+    if (id == 0 || !Flush()) return false;
+    std::deque<TxnResponse> others;
+    bool ok;
+    while ((ok = Receive(response)) && response.id != id) {
+        others.push_back(std::move(response));
+    }
+    for (auto& other : others) stashed_.push_back(std::move(other));
+    return ok;
+}
+
+} // namespace txn
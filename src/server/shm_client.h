@@ -0,0 +1,72 @@
+#ifndef SHM_CLIENT_H
+#define SHM_CLIENT_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "server/shm_ring.h"
+#include "server/wire_protocol.h"
+
+namespace txn {
+
+// Same-host client over the engine's shared-memory rings (transaction_system
+// --shm NAME). Same interface as TxnClient: Submit* encodes straight into
+// this client's request ring without publishing, Flush publishes the batch
+// with one store and wakes the engine only if its poller is asleep, and
+// Receive spins briefly before sleeping on a futex. No system calls are made
+// while both sides are busy. Not thread-safe: use one client per thread.
+class ShmTxnClient {
+public:
+    ShmTxnClient() = default;
+    ~ShmTxnClient();
+    ShmTxnClient(const ShmTxnClient&) = delete;
+    ShmTxnClient& operator=(const ShmTxnClient&) = delete;
+
+    // Maps the region and claims a free slot.
+    bool Connect(const std::string& name);
+    void Close();
+    bool Connected() const { return slot_ != nullptr; }
+
+    // Both return the request id, or 0 if the request is larger than the
+    // ring or the engine has stopped. Empty keys = the server picks them.
+    uint64_t SubmitTemplate(uint16_t template_id = kAnyTemplate,
+                            const std::vector<std::string>& keys = {});
+    uint64_t SubmitOps(const std::vector<TxnOp>& ops);
+
+    bool Flush();
+
+    // Blocks until the next response arrives. Returns false once the engine
+    // has stopped or a malformed frame is received.
+    bool Receive(TxnResponse& response);
+
+    // Submits ops, flushes and waits for their response. Responses to other
+    // in-flight requests that arrive first are kept for later Receive calls.
+    bool Execute(const std::vector<TxnOp>& ops, TxnResponse& response);
+
+    size_t InFlight() const { return in_flight_; }
+
+    void SetSpinPolls(int polls) { spin_polls_ = polls; }
+
+private:
+    uint64_t Enqueue(TxnRequest& request);
+    bool EngineAlive() const { return header_->engine_alive.load(std::memory_order_acquire) != 0; }
+
+    void* base_ = nullptr;
+    size_t region_bytes_ = 0;
+    ShmRegionHeader* header_ = nullptr;
+    ShmSlot* slot_ = nullptr;
+    ShmRing requests_;
+    ShmRing responses_;
+    int spin_polls_ = 2000;  // empty polls before sleeping in Receive
+
+    uint64_t next_id_ = 1;
+    size_t in_flight_ = 0;
+    std::string frame_;    // encode buffer
+    std::string scratch_;  // wrapped response frames
+    std::deque<TxnResponse> stashed_;
+};
+
+} // namespace txn
+
+#endif // SHM_CLIENT_H
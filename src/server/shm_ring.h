@@ -0,0 +1,208 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace txn {
+
+// Shared-memory transport for same-host clients. One region (shm_open name)
+// holds a header, one slot per client and two byte rings per slot: requests
+// (client -> engine) and responses (engine -> client). The rings carry the
+// same length-prefixed frames as the socket transport.
+//
+// Region layout: ShmRegionHeader | ShmSlot[num_slots] |
+//                per slot: request data[ring_bytes], response data[ring_bytes]
+
+constexpr uint64_t kShmMagic   = 0x54584e53484d3031ULL;  // "TXNSHM01"
+constexpr uint32_t kShmVersion = 1;
+
+// Futex on a word in shared memory (not FUTEX_PRIVATE: waiters are in other
+// processes). Waits only while *addr == expected, for at most timeout_ms.
+inline void FutexWait(std::atomic<uint32_t>* addr, uint32_t expected, int timeout_ms) {
+    timespec ts{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+inline void FutexWakeAll(std::atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Wakeup for a consumer that sleeps when it runs out of work. The consumer
+// calls PrepareSleep, re-checks for work, then Wait; producers call Ring
+// after publishing. The fences make either the consumer see the new work or
+// the producer see the sleeping flag.
+struct ShmDoorbell {
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> sleeping;
+
+    uint32_t PrepareSleep() {
+        uint32_t bell = seq.load();
+        sleeping.store(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return bell;
+    }
+
+    void Wait(uint32_t bell, int timeout_ms) {
+        FutexWait(&seq, bell, timeout_ms);
+        sleeping.store(0, std::memory_order_relaxed);
+    }
+
+    void CancelSleep() { sleeping.store(0, std::memory_order_relaxed); }
+
+    void Ring() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {
+            seq.fetch_add(1);
+            FutexWakeAll(&seq);
+        }
+    }
+};
+
+// Positions of one SPSC ring. head and tail only grow; the byte offset is
+// position % capacity.
+struct ShmRingHeader {
+    alignas(64) std::atomic<uint64_t> head;   // written by the consumer
+    alignas(64) std::atomic<uint64_t> tail;   // written by the producer
+
+    void Reset() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+};
+
+enum ShmSlotState : uint32_t {
+    kSlotFree     = 0,
+    kSlotClaiming = 1,  // client is resetting the rings
+    kSlotActive   = 2,
+    kSlotClosing  = 3,  // client detached; the engine frees the slot
+};
+
+struct ShmSlot {
+    alignas(64) std::atomic<uint32_t> state;
+    std::atomic<int32_t> client_pid;
+    ShmDoorbell client_bell;  // client waiting for responses
+    ShmRingHeader requests;
+    ShmRingHeader responses;
+};
+
+struct ShmRegionHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t num_slots;
+    uint64_t ring_bytes;
+    std::atomic<uint32_t> engine_alive;
+    // The engine's poller sleeps on this when every request ring is empty
+    alignas(64) ShmDoorbell engine_bell;
+};
+
+inline size_t ShmRegionBytes(uint32_t num_slots, uint64_t ring_bytes) {
+    return sizeof(ShmRegionHeader) + num_slots * sizeof(ShmSlot) + num_slots * 2 * ring_bytes;
+}
+
+inline ShmSlot* ShmSlots(void* base) {
+    return reinterpret_cast<ShmSlot*>(static_cast<char*>(base) + sizeof(ShmRegionHeader));
+}
+
+inline char* ShmRingData(void* base, uint32_t slot, bool responses) {
+    auto* header = static_cast<ShmRegionHeader*>(base);
+    char* data = reinterpret_cast<char*>(ShmSlots(base) + header->num_slots);
+    return data + (2 * static_cast<uint64_t>(slot) + (responses ? 1 : 0)) * header->ring_bytes;
+}
+
+// One side of an SPSC ring. The producer buffers writes locally and makes
+// them visible with Publish, so a batch of frames costs one release store
+// (and at most one wakeup). capacity must be a power of two.
+class ShmRing {
+public:
+    ShmRing() = default;
+    ShmRing(ShmRingHeader* header, char* data, uint64_t capacity)
+        : header_(header), data_(data), mask_(capacity - 1) {}
+
+    ShmRingHeader* Header() const { return header_; }
+    uint64_t Capacity() const { return mask_ + 1; }
+
+    // Producer: restart after the rings were reset.
+    void ResetProducer() { pending_tail_ = 0; }
+
+    // Producer: copies one encoded frame in; false if it does not fit yet.
+    bool TryWrite(std::string_view frame) {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (Capacity() - (pending_tail_ - head) < frame.size()) return false;
+        CopyIn(pending_tail_, frame.data(), frame.size());
+        pending_tail_ += frame.size();
+        return true;
+    }
+
+    bool HasUnpublished() const {
+        return pending_tail_ != header_->tail.load(std::memory_order_relaxed);
+    }
+
+    void Publish() { header_->tail.store(pending_tail_, std::memory_order_release); }
+
+    // Consumer: next complete frame, or false if none is published. The
+    // payload points into shared memory unless the frame wraps around the
+    // end of the buffer, in which case it is copied into scratch. Call
+    // Consume(consumed) once the payload has been decoded.
+    bool PeekFrame(std::string& scratch, std::string_view& payload, size_t& consumed) const {
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        uint64_t available = header_->tail.load(std::memory_order_acquire) - head;
+        uint32_t len;
+        if (available < sizeof(len)) return false;
+        CopyOut(head, reinterpret_cast<char*>(&len), sizeof(len));
+        if (available - sizeof(len) < len) return false;
+        uint64_t start = (head + sizeof(len)) & mask_;
+        if (start + len <= Capacity()) {
+            payload = std::string_view(data_ + start, len);
+        } else {
+            scratch.resize(len);
+            CopyOut(head + sizeof(len), scratch.data(), len);
+            payload = scratch;
+        }
+        consumed = sizeof(len) + len;
+        return true;
+    }
+
+    void Consume(size_t bytes) {
+        header_->head.store(header_->head.load(std::memory_order_relaxed) + bytes,
+                            std::memory_order_release);
+    }
+
+    bool Empty() const {
+        return header_->tail.load(std::memory_order_acquire)
+            == header_->head.load(std::memory_order_relaxed);
+    }
+
+private:
+    void CopyIn(uint64_t pos, const char* src, size_t n) {
+        uint64_t off = pos & mask_;
+        size_t first = std::min<uint64_t>(n, Capacity() - off);
+        std::memcpy(data_ + off, src, first);
+        std::memcpy(data_, src + first, n - first);
+    }
+
+    void CopyOut(uint64_t pos, char* dst, size_t n) const {
+        uint64_t off = pos & mask_;
+        size_t first = std::min<uint64_t>(n, Capacity() - off);
+        std::memcpy(dst, data_ + off, first);
+        std::memcpy(dst + first, data_, n - first);
+    }
+
+    ShmRingHeader* header_ = nullptr;
+    char* data_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t pending_tail_ = 0;  // producer only
+};
+
+} // namespace txn
+
+#endif // SHM_RING_H
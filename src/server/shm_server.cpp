@@ -0,0 +1,229 @@
+#include "server/shm_server.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace txn {
+
+namespace {
+
+constexpr size_t kMaxBatchPerSlot = 256;  // fairness between slots per poll
+constexpr int kSleepTimeoutMs = 100;      // also bounds how long dead clients hold a slot
+constexpr auto kPidCheckInterval = std::chrono::milliseconds(100);
+
+bool ProcessAlive(int32_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+} // anonymous namespace
+
+class ShmServer::SlotSink : public ResponseSink {
+public:
+    SlotSink(ShmServer* server, uint32_t idx, uint64_t generation)
+        : server_(server), idx_(idx), generation_(generation) {}
+
+    void Deliver(TxnResponse&& response) override {
+        server_->Deliver(idx_, generation_, response);
+    }
+
+private:
+    ShmServer* server_;
+    uint32_t idx_;
+    uint64_t generation_;
+};
+
+ShmServer::ShmServer(TxnService& service, const std::string& name, const ShmServerConfig& config)
+    : service_(service), name_(name), config_(config) {}
+
+ShmServer::~ShmServer() {
+    Stop();
+    if (base_) munmap(base_, region_bytes_);
+}
+
+bool ShmServer::Start() {
+    if (config_.num_slots == 0 || config_.ring_bytes < 4096
+        || (config_.ring_bytes & (config_.ring_bytes - 1)) != 0) {
+        std::cerr << "Shared-memory rings need >= 1 slot and a power-of-two size >= 4096\n";
+        return false;
+    }
+    region_bytes_ = ShmRegionBytes(config_.num_slots, config_.ring_bytes);
+
+    shm_unlink(name_.c_str());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, region_bytes_) < 0) {
+        std::cerr << "Failed to create shared memory " << name_ << ": "
+                  << std::strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    base_ = mmap(nullptr, region_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base_ == MAP_FAILED) {
+        std::cerr << "mmap: " << std::strerror(errno) << "\n";
+        base_ = nullptr;
+        shm_unlink(name_.c_str());
+        return false;
+    }
+
+    // ftruncate zero-fills, so every slot starts free with empty rings
+    header_ = static_cast<ShmRegionHeader*>(base_);
+    header_->version    = kShmVersion;
+    header_->num_slots  = config_.num_slots;
+    header_->ring_bytes = config_.ring_bytes;
+    header_->engine_alive.store(1);
+    slots_ = ShmSlots(base_);
+    for (uint32_t i = 0; i < config_.num_slots; i++) {
+        auto st = std::make_unique<SlotState>();
+        st->requests  = ShmRing(&slots_[i].requests, ShmRingData(base_, i, false), config_.ring_bytes);
+        st->responses = ShmRing(&slots_[i].responses, ShmRingData(base_, i, true), config_.ring_bytes);
+        state_.push_back(std::move(st));
+    }
+    // Clients check the magic last, after the rest of the header is in place
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kShmMagic;
+
+    stopping_ = false;
+    poller_ = std::thread(&ShmServer::PollLoop, this);
+    return true;
+}
+
+void ShmServer::Stop() {
+    if (poller_.joinable()) {
+        stopping_ = true;
+        header_->engine_bell.seq.fetch_add(1);
+        FutexWakeAll(&header_->engine_bell.seq);
+        poller_.join();
+    }
+    if (header_ && header_->engine_alive.exchange(0)) {
+        for (uint32_t i = 0; i < config_.num_slots; i++) {
+            slots_[i].client_bell.seq.fetch_add(1);
+            FutexWakeAll(&slots_[i].client_bell.seq);
+        }
+        // Clients already mapped keep their mapping; new ones cannot attach
+        shm_unlink(name_.c_str());
+    }
+}
+
+void ShmServer::PollLoop() {
+    int idle = 0;
+    auto last_pid_check = std::chrono::steady_clock::now();
+    while (!stopping_) {
+        auto now = std::chrono::steady_clock::now();
+        bool check_pid = now - last_pid_check >= kPidCheckInterval;
+        if (check_pid) last_pid_check = now;
+
+        bool any = false;
+        for (uint32_t i = 0; i < config_.num_slots; i++) {
+            UpdateSlot(i, check_pid);
+            if (state_[i]->attached && DrainSlot(i)) any = true;
+        }
+        if (any) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < config_.spin_polls) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Idle: sleep until a client rings, re-checking after announcing it
+        uint32_t bell = header_->engine_bell.PrepareSleep();
+        bool pending = false;
+        for (uint32_t i = 0; i < config_.num_slots && !pending; i++) {
+            uint32_t s = slots_[i].state.load(std::memory_order_acquire);
+            pending = (state_[i]->attached && !state_[i]->requests.Empty())
+                   || (state_[i]->attached != (s == kSlotActive));
+        }
+        if (pending || stopping_) {
+            header_->engine_bell.CancelSleep();
+        } else {
+            header_->engine_bell.Wait(bell, kSleepTimeoutMs);
+        }
+        idle = 0;
+    }
+}
+
+// Follows the client's side of the slot state: attaches newly active slots
+// and frees slots whose client closed or died.
+void ShmServer::UpdateSlot(uint32_t idx, bool check_pid) {
+    SlotState& st = *state_[idx];
+    ShmSlot& slot = slots_[idx];
+    uint32_t s = slot.state.load(std::memory_order_acquire);
+
+    if (!st.attached && s == kSlotActive) {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        st.attached = true;
+        st.generation++;
+        st.responses.ResetProducer();
+        st.sink = std::make_shared<SlotSink>(this, idx, st.generation);
+        clients_attached_.fetch_add(1);
+        return;
+    }
+
+    // pid 0 = a claiming client that has not stored its pid yet
+    int32_t pid = slot.client_pid.load();
+    bool dead = check_pid && s != kSlotFree && pid != 0 && !ProcessAlive(pid);
+    if (s == kSlotClosing || dead) {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        st.attached = false;
+        st.generation++;
+        st.sink.reset();
+        slot.client_pid.store(0);
+        slot.state.store(kSlotFree, std::memory_order_release);
+    }
+}
+
+bool ShmServer::DrainSlot(uint32_t idx) {
+    SlotState& st = *state_[idx];
+    std::vector<ServiceRequest> batch;
+    std::string_view payload;
+    size_t consumed = 0;
+    while (batch.size() < kMaxBatchPerSlot && st.requests.PeekFrame(st.scratch, payload, consumed)) {
+        ServiceRequest item;
+        bool ok = DecodeRequest(payload, item.request);
+        st.requests.Consume(consumed);
+        if (!ok) {
+            std::cerr << "Dropping malformed request frame from shared-memory slot " << idx << "\n";
+            continue;
+        }
+        item.sink = st.sink;
+        batch.push_back(std::move(item));
+    }
+    if (batch.empty()) return false;
+    service_.Submit(std::move(batch));
+    return true;
+}
+
+void ShmServer::Deliver(uint32_t idx, uint64_t generation, const TxnResponse& response) {
+    thread_local std::string frame;
+    frame.clear();
+    AppendResponseFrame(frame, response);
+
+    SlotState& st = *state_[idx];
+    ShmSlot& slot = slots_[idx];
+    std::lock_guard<std::mutex> lock(st.mutex);
+    if (!st.attached || st.generation != generation) return;  // client gone
+    if (frame.size() > st.responses.Capacity()) {
+        TxnResponse error;
+        error.id = response.id;
+        error.status = ResponseStatus::kBadRequest;
+        error.error = "response larger than the shared-memory ring";
+        frame.clear();
+        AppendResponseFrame(frame, error);
+    }
+    // A full ring means the client is behind; wait unless it left or died
+    for (int spins = 1; !st.responses.TryWrite(frame); spins++) {
+        if (stopping_ || slot.state.load(std::memory_order_acquire) != kSlotActive) return;
+        if (spins % 1024 == 0 && !ProcessAlive(slot.client_pid.load())) return;
+        std::this_thread::yield();
+    }
+    st.responses.Publish();
+    slot.client_bell.Ring();
+}
+
+} // namespace txn
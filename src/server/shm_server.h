@@ -0,0 +1,80 @@
+#ifndef SHM_SERVER_H
+#define SHM_SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "server/shm_ring.h"
+#include "server/txn_service.h"
+
+namespace txn {
+
+struct ShmServerConfig {
+    uint32_t num_slots  = 16;        // concurrent clients
+    uint64_t ring_bytes = 1u << 20;  // per ring, power of two; bounds the largest frame
+    int spin_polls      = 2000;      // empty polls before the poller sleeps on its futex
+};
+
+// Shared-memory front end for a TxnService (see shm_ring.h for the layout).
+// One poller thread drains every active slot's request ring and submits each
+// slot's frames as one batch; it spins while there is traffic and sleeps on
+// a futex when all rings stay empty. Service workers write responses
+// straight into the slot's response ring and wake the client only if it is
+// sleeping. Slots of clients that detach or die are reclaimed by the poller.
+//
+// As with SocketServer: stop the server before the service, and the service
+// before destroying the server.
+class ShmServer {
+public:
+    ShmServer(TxnService& service, const std::string& name,
+              const ShmServerConfig& config = {});
+    ~ShmServer();
+
+    // Creates the region (replacing a stale one) and starts the poller.
+    // Returns false with a message on stderr on failure.
+    bool Start();
+    // Marks the engine gone, wakes waiting clients and unlinks the region.
+    void Stop();
+
+    uint64_t ClientsAttached() const { return clients_attached_.load(); }
+
+private:
+    class SlotSink;
+
+    // Engine-side state of one slot. generation changes whenever the slot is
+    // attached or freed, so responses for a departed client are dropped.
+    struct SlotState {
+        std::mutex mutex;  // guards responses and generation for service workers
+        bool attached = false;
+        uint64_t generation = 0;
+        ShmRing requests;
+        ShmRing responses;
+        std::shared_ptr<SlotSink> sink;
+        std::string scratch;  // poller: wrapped request frames
+    };
+
+    void PollLoop();
+    bool DrainSlot(uint32_t idx);     // true if any request was read
+    void UpdateSlot(uint32_t idx, bool check_pid);
+    void Deliver(uint32_t idx, uint64_t generation, const TxnResponse& response);
+
+    TxnService& service_;
+    std::string name_;
+    ShmServerConfig config_;
+    void* base_ = nullptr;
+    size_t region_bytes_ = 0;
+    ShmRegionHeader* header_ = nullptr;
+    ShmSlot* slots_ = nullptr;
+    std::vector<std::unique_ptr<SlotState>> state_;
+
+    std::thread poller_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> clients_attached_{0};
+};
+
+} // namespace txn
+
+#endif // SHM_SERVER_H
@@ -0,0 +1,300 @@
+#include "server/socket_server.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace txn {
+
+namespace {
+
+constexpr int kMaxEvents = 64;
+constexpr size_t kReadChunk = 64 * 1024;
+
+} // anonymous namespace
+
+// Per-connection state. Buffers other than outbox_ belong to the event loop;
+// outbox_ collects encoded responses from service workers until the loop
+// picks them up.
+class SocketServer::Connection : public ResponseSink,
+                                 public std::enable_shared_from_this<Connection> {
+public:
+    Connection(SocketServer* server, int fd) : fd(fd), server_(server) {}
+
+    void Deliver(TxnResponse&& response) override {
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) return;
+            was_empty = outbox_.empty();
+            AppendResponseFrame(outbox_, response);
+        }
+        // Only the first response of a batch wakes the loop
+        if (was_empty) server_->MarkReady(shared_from_this());
+    }
+
+    std::string TakeOutbox() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string out;
+        out.swap(outbox_);
+        return out;
+    }
+
+    void MarkClosed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        outbox_.clear();
+    }
+
+    bool Closed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    const int fd;
+    std::string inbuf;
+    std::string wbuf;           // encoded responses not yet accepted by the socket
+    bool want_write = false;    // EPOLLOUT registered
+
+private:
+    SocketServer* server_;
+    std::mutex mutex_;
+    std::string outbox_;
+    bool closed_ = false;
+};
+
+SocketServer::SocketServer(TxnService& service, const std::string& socket_path)
+    : service_(service), socket_path_(socket_path) {}
+
+SocketServer::~SocketServer() {
+    Stop();
+    if (wake_fd_ >= 0) close(wake_fd_);
+}
+
+bool SocketServer::Start() {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << socket_path_ << "\n";
+        return false;
+    }
+    std::strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    unlink(socket_path_.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || listen(listen_fd_, SOMAXCONN) < 0) {
+        std::cerr << "Failed to listen on " << socket_path_ << ": " << std::strerror(errno) << "\n";
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (wake_fd_ < 0) wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+        std::cerr << "epoll/eventfd: " << std::strerror(errno) << "\n";
+        Stop();
+        return false;
+    }
+    for (int fd : {listen_fd_, wake_fd_}) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    stopping_ = false;
+    loop_ = std::thread(&SocketServer::EventLoop, this);
+    return true;
+}
+
+void SocketServer::Stop() {
+    if (loop_.joinable()) {
+        stopping_ = true;
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = write(wake_fd_, &one, sizeof(one));
+        loop_.join();
+    }
+    for (auto& [fd, conn] : connections_) {
+        conn->MarkClosed();
+        close(fd);
+    }
+    connections_.clear();
+    {
+        std::lock_guard<std::mutex> lock(ready_mutex_);
+        ready_.clear();
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(socket_path_.c_str());
+        listen_fd_ = -1;
+    }
+    // wake_fd_ stays open: workers still finishing may call MarkReady
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+}
+
+void SocketServer::EventLoop() {
+    epoll_event events[kMaxEvents];
+    while (!stopping_) {
+        int n = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listen_fd_) {
+                AcceptConnections();
+                continue;
+            }
+            if (fd == wake_fd_) {
+                uint64_t count;
+                [[maybe_unused]] ssize_t r = read(wake_fd_, &count, sizeof(count));
+                FlushReady();
+                continue;
+            }
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) continue;
+            auto conn = it->second;
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !ReadRequests(conn)) {
+                CloseConnection(fd);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !WriteResponses(*conn)) {
+                CloseConnection(fd);
+            }
+        }
+    }
+}
+
+void SocketServer::AcceptConnections() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "accept: " << std::strerror(errno) << "\n";
+            }
+            return;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+        connections_[fd] = std::make_shared<Connection>(this, fd);
+        connections_accepted_.fetch_add(1);
+    }
+}
+
+// Reads until the socket would block, then submits every complete frame as
+// one batch. Returns false when the connection should be closed (peer hung
+// up, I/O error or malformed frame).
+bool SocketServer::ReadRequests(const std::shared_ptr<Connection>& conn) {
+    bool open = true;
+    char buf[kReadChunk];
+    while (true) {
+        ssize_t n = recv(conn->fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            conn->inbuf.append(buf, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) open = false;
+        break;
+    }
+
+    std::vector<ServiceRequest> batch;
+    size_t pos = 0;
+    while (true) {
+        std::string_view payload;
+        size_t consumed = 0;
+        FrameStatus status = NextFrame(conn->inbuf.data() + pos, conn->inbuf.size() - pos,
+                                       payload, consumed);
+        if (status == FrameStatus::kIncomplete) break;
+        ServiceRequest item;
+        if (status == FrameStatus::kInvalid || !DecodeRequest(payload, item.request)) {
+            open = false;
+            break;
+        }
+        item.sink = conn;
+        batch.push_back(std::move(item));
+        pos += consumed;
+    }
+    conn->inbuf.erase(0, pos);
+    if (!batch.empty()) service_.Submit(std::move(batch));
+    return open;
+}
+
+// Writes as much pending output as the socket accepts, toggling EPOLLOUT
+// while some remains. Returns false on a write error.
+bool SocketServer::WriteResponses(Connection& conn) {
+    conn.wbuf += conn.TakeOutbox();
+    size_t written = 0;
+    while (written < conn.wbuf.size()) {
+        ssize_t n = send(conn.fd, conn.wbuf.data() + written, conn.wbuf.size() - written,
+                         MSG_NOSIGNAL);
+        if (n > 0) {
+            written += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    conn.wbuf.erase(0, written);
+
+    bool want_write = !conn.wbuf.empty();
+    if (want_write != conn.want_write) {
+        epoll_event ev{};
+        ev.events = want_write ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.fd = conn.fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+        conn.want_write = want_write;
+    }
+    return true;
+}
+
+void SocketServer::FlushReady() {
+    std::vector<std::shared_ptr<Connection>> ready;
+    {
+        std::lock_guard<std::mutex> lock(ready_mutex_);
+        ready.swap(ready_);
+    }
+    for (auto& conn : ready) {
+        if (conn->Closed()) continue;
+        if (!WriteResponses(*conn)) CloseConnection(conn->fd);
+    }
+}
+
+void SocketServer::CloseConnection(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;
+    it->second->MarkClosed();
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(it);
+}
+
+void SocketServer::MarkReady(std::shared_ptr<Connection> conn) {
+    {
+        std::lock_guard<std::mutex> lock(ready_mutex_);
+        ready_.push_back(std::move(conn));
+    }
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = write(wake_fd_, &one, sizeof(one));
+}
+
+} // namespace txn
@@ -0,0 +1,64 @@
+#ifndef SOCKET_SERVER_H
+#define SOCKET_SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "server/txn_service.h"
+
+namespace txn {
+
+// Unix domain socket front end for a TxnService. One epoll event-loop thread
+// accepts connections, reads every complete request frame available on a
+// connection and submits them to the service as one batch, and writes back
+// all responses that completed since its last wakeup in one send per
+// connection. Service workers hand responses to the loop through an eventfd.
+//
+// Stop the server before the service, and the service before destroying the
+// server: responses finishing after Stop are dropped.
+class SocketServer {
+public:
+    SocketServer(TxnService& service, const std::string& socket_path);
+    ~SocketServer();
+
+    // Binds the socket (replacing a stale one) and starts the event loop.
+    // Returns false with a message on stderr on failure.
+    bool Start();
+    // Closes every connection and removes the socket file.
+    void Stop();
+
+    uint64_t ConnectionsAccepted() const { return connections_accepted_.load(); }
+
+private:
+    class Connection;
+
+    void EventLoop();
+    void AcceptConnections();
+    bool ReadRequests(const std::shared_ptr<Connection>& conn);
+    bool WriteResponses(Connection& conn);
+    void FlushReady();
+    void CloseConnection(int fd);
+    void MarkReady(std::shared_ptr<Connection> conn);  // called by service workers
+
+    TxnService& service_;
+    std::string socket_path_;
+    int listen_fd_ = -1;
+    int epoll_fd_  = -1;
+    int wake_fd_   = -1;
+    std::thread loop_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> connections_accepted_{0};
+
+    std::unordered_map<int, std::shared_ptr<Connection>> connections_;  // event loop only
+
+    std::mutex ready_mutex_;
+    std::vector<std::shared_ptr<Connection>> ready_;  // connections with responses queued
+};
+
+} // namespace txn
+
+#endif // SOCKET_SERVER_H
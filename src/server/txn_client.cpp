@@ -0,0 +1,130 @@
+#include "server/txn_client.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace txn {
+
+TxnClient::~TxnClient() {
+    Close();
+}
+
+bool TxnClient::Connect(const std::string& socket_path) {
+    Close();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << socket_path << "\n";
+        return false;
+    }
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0 || connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Failed to connect to " << socket_path << ": " << std::strerror(errno) << "\n";
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void TxnClient::Close() {
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+    in_flight_ = 0;
+    outbuf_.clear();
+    inbuf_.clear();
+    in_pos_ = 0;
+    stashed_.clear();
+}
+
+uint64_t TxnClient::SubmitTemplate(uint16_t template_id, const std::vector<std::string>& keys) {
+    TxnRequest request;
+    request.id = next_id_++;
+    request.kind = RequestKind::kTemplate;
+    request.template_id = template_id;
+    request.keys = keys;
+    AppendRequestFrame(outbuf_, request);
+    in_flight_++;
+    return request.id;
+}
+
+uint64_t TxnClient::SubmitOps(const std::vector<TxnOp>& ops) {
+    TxnRequest request;
+    request.id = next_id_++;
+    request.kind = RequestKind::kOps;
+    request.ops = ops;
+    AppendRequestFrame(outbuf_, request);
+    in_flight_++;
+    return request.id;
+}
+
+bool TxnClient::Flush() {
+    size_t written = 0;
+    while (written < outbuf_.size()) {
+        ssize_t n = send(fd_, outbuf_.data() + written, outbuf_.size() - written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += n;
+    }
+    outbuf_.clear();
+    return true;
+}
+
+bool TxnClient::Receive(TxnResponse& response) {
+    if (!stashed_.empty()) {
+        response = std::move(stashed_.front());
+        stashed_.pop_front();
+        return true;
+    }
+    while (true) {
+        std::string_view payload;
+        size_t consumed = 0;
+        FrameStatus status = NextFrame(inbuf_.data() + in_pos_, inbuf_.size() - in_pos_,
+                                       payload, consumed);
+        if (status == FrameStatus::kComplete) {
+            in_pos_ += consumed;
+            if (!DecodeResponse(payload, response)) return false;
+            if (in_flight_ > 0) in_flight_--;
+            return true;
+        }
+        if (status == FrameStatus::kInvalid || !ReadMore()) return false;
+    }
+}
+
+bool TxnClient::Execute(const std::vector<TxnOp>& ops, TxnResponse& response) {
+    uint64_t id = SubmitOps(ops);
+    if (!Flush()) return false;
+    std::deque<TxnResponse> others;
+    bool ok;
+    while ((ok = Receive(response)) && response.id != id) {
+        others.push_back(std::move(response));
+    }
+    for (auto& other : others) stashed_.push_back(std::move(other));
+    return ok;
+}
+
+bool TxnClient::ReadMore() {
+    // Drop consumed frames before growing the buffer
+    if (in_pos_ > 0) {
+        inbuf_.erase(0, in_pos_);
+        in_pos_ = 0;
+    }
+    char buf[64 * 1024];
+    while (true) {
+        ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+        if (n > 0) {
+            inbuf_.append(buf, n);
+            return true;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        return false;
+    }
+}
+
+} // namespace txn
@@ -0,0 +1,61 @@
+#ifndef TXN_CLIENT_H
+#define TXN_CLIENT_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "server/wire_protocol.h"
+
+namespace txn {
+
+// Client for the transaction server's Unix domain socket (transaction_system
+// --serve). Submit* only encodes a request into the send buffer; Flush sends
+// everything buffered in one write, so several requests can be batched and
+// kept in flight before any response is read. Responses arrive in completion
+// order, not submission order; match them by id. Not thread-safe: use one
+// client per thread.
+class TxnClient {
+public:
+    TxnClient() = default;
+    ~TxnClient();
+    TxnClient(const TxnClient&) = delete;
+    TxnClient& operator=(const TxnClient&) = delete;
+
+    bool Connect(const std::string& socket_path);
+    void Close();
+    bool Connected() const { return fd_ >= 0; }
+
+    // Both return the request id. Empty keys = the server picks them.
+    uint64_t SubmitTemplate(uint16_t template_id = kAnyTemplate,
+                            const std::vector<std::string>& keys = {});
+    uint64_t SubmitOps(const std::vector<TxnOp>& ops);
+
+    bool Flush();
+
+    // Blocks until the next response arrives. Returns false when the
+    // connection is closed or a malformed frame is received.
+    bool Receive(TxnResponse& response);
+
+    // Submits ops, flushes and waits for their response. Responses to other
+    // in-flight requests that arrive first are kept for later Receive calls.
+    bool Execute(const std::vector<TxnOp>& ops, TxnResponse& response);
+
+    // Submitted requests whose response has not been received yet.
+    size_t InFlight() const { return in_flight_; }
+
+private:
+    bool ReadMore();
+
+    int fd_ = -1;
+    uint64_t next_id_ = 1;
+    size_t in_flight_ = 0;
+    std::string outbuf_;
+    std::string inbuf_;
+    size_t in_pos_ = 0;  // start of the first unparsed frame in inbuf_
+    std::deque<TxnResponse> stashed_;
+};
+
+} // namespace txn
+
+#endif // TXN_CLIENT_H
@@ -0,0 +1,258 @@
+#include "server/txn_service.h"
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <set>
+
+namespace txn {
+
+namespace {
+
+TxnResponse BadRequest(uint64_t id, const std::string& error) {
+    TxnResponse response;
+    response.id = id;
+    response.status = ResponseStatus::kBadRequest;
+    response.error = error;
+    return response;
+}
+
+// Passes a template's calls through to the manager and keeps enough of the
+// transaction it has open (id, locks, partitions) to abort it, so a
+// template that throws midway leaves no locks or active-set entry behind.
+class AbortOnThrow : public TransactionManager {
+public:
+    explicit AbortOnThrow(TransactionManager& mgr) : mgr_(mgr) {}
+
+    Transaction Begin(const std::string& type_name,
+                      const std::vector<std::string>& keys = {}) override {
+        Transaction txn = mgr_.Begin(type_name, keys);
+        Track(txn);
+        return txn;
+    }
+    std::optional<std::string> Read(Transaction& txn, const std::string& key) override {
+        auto value = mgr_.Read(txn, key);
+        Track(txn);  // 2PL may have locked key on touch
+        return value;
+    }
+    void Write(Transaction& txn, const std::string& key, const std::string& value) override {
+        mgr_.Write(txn, key, value);
+        Track(txn);
+    }
+    CommitResult Commit(Transaction& txn) override {
+        open_.reset();
+        return mgr_.Commit(txn);
+    }
+    void Abort(Transaction& txn) override {
+        open_.reset();
+        mgr_.Abort(txn);
+    }
+    bool Prepare(Transaction& txn) override {
+        bool prepared = mgr_.Prepare(txn);
+        Track(txn);
+        return prepared;
+    }
+    std::string ProtocolName() const override { return mgr_.ProtocolName(); }
+
+    // Aborts the transaction left open, if any
+    void AbortOpen() {
+        if (!open_) return;
+        mgr_.Abort(*open_);
+        open_.reset();
+    }
+
+private:
+    void Track(const Transaction& txn) {
+        if (open_ && open_->txn_id == txn.txn_id && open_->status == txn.status
+                && open_->lock_keys.size() == txn.lock_keys.size()
+                && open_->shared_keys.size() == txn.shared_keys.size()
+                && open_->partitions.size() == txn.partitions.size()) {
+            return;
+        }
+        Transaction shell;
+        shell.txn_id = txn.txn_id;
+        shell.type_name = txn.type_name;
+        shell.start_ts = txn.start_ts;
+        shell.status = txn.status;
+        shell.lock_keys = txn.lock_keys;
+        shell.shared_keys = txn.shared_keys;
+        shell.access = txn.access;
+        shell.isolation = txn.isolation;
+        shell.partitions = txn.partitions;
+        shell.home_partition = txn.home_partition;
+        open_ = std::move(shell);
+    }
+
+    TransactionManager& mgr_;
+    std::optional<Transaction> open_;
+};
+
+} // anonymous namespace
+
+TxnService::TxnService(TransactionManager& mgr, MetricsCollector& metrics,
+                       const ServiceConfig& config)
+    : mgr_(mgr), metrics_(metrics), config_(config) {
+    for (const auto& tmpl : config_.templates) mgr_.Declare(tmpl.name, tmpl.access);
+}
+
+TxnService::~TxnService() {
+    Stop();
+}
+
+void TxnService::Start() {
+    metrics_.InitWorkers(config_.num_workers);
+    start_ = std::chrono::steady_clock::now();
+    for (int i = 0; i < config_.num_workers; i++) {
+        workers_.emplace_back(&TxnService::WorkerThread, this, i);
+    }
+}
+
+void TxnService::Stop() {
+    if (workers_.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+    elapsed_s_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+}
+
+void TxnService::Submit(std::vector<ServiceRequest>&& batch) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (auto& item : batch) queue_.push_back(std::move(item));
+    }
+    if (batch.size() == 1) {
+        queue_cv_.notify_one();
+    } else {
+        queue_cv_.notify_all();
+    }
+}
+
+void TxnService::WorkerThread(int worker_id) {
+    auto worker_start = std::chrono::steady_clock::now();
+    std::mt19937 rng(worker_id + std::chrono::steady_clock::now().time_since_epoch().count());
+    KeySelector key_selector(config_.contention, rng);
+    std::vector<double> weights;
+    for (const auto& tmpl : config_.templates) weights.push_back(tmpl.weight);
+    std::discrete_distribution<size_t> template_dist(weights.begin(), weights.end());
+
+    while (true) {
+        ServiceRequest item;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) break;  // stopping and drained
+            item = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        TxnResponse response = Execute(worker_id, item.request, rng, key_selector, template_dist);
+        if (item.sink) item.sink->Deliver(std::move(response));
+    }
+
+    metrics_.RecordWorkerElapsed(worker_id, std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - worker_start).count());
+}
+
+TxnResponse TxnService::Execute(int worker_id, TxnRequest& request, std::mt19937& rng,
+                                KeySelector& key_selector,
+                                std::discrete_distribution<size_t>& template_dist) {
+    TxnResponse response;
+    response.id = request.id;
+
+    std::string type_name;
+    std::vector<std::string> keys;
+    std::function<CommitResult()> attempt;
+    const WorkloadTemplate* committed_template = nullptr;  // for on_commit
+    AbortOnThrow guarded(mgr_);
+
+    if (request.kind == RequestKind::kTemplate) {
+        if (config_.templates.empty()) return BadRequest(request.id, "no templates loaded");
+        size_t idx = request.template_id;
+        if (request.template_id == kAnyTemplate) {
+            idx = template_dist(rng);
+        } else if (idx >= config_.templates.size()) {
+            return BadRequest(request.id, "unknown template id " + std::to_string(idx));
+        }
+        const WorkloadTemplate& tmpl = config_.templates[idx];
+        if (request.keys.empty()) {
+            keys = tmpl.key_builder ? tmpl.key_builder(rng)
+                                    : key_selector.SelectDistinctKeys(tmpl.num_input_keys);
+        } else if (!AcceptsClientKeys(tmpl, request.keys)) {
+            return BadRequest(request.id, tmpl.num_input_keys > 0 && !tmpl.accepts_keys
+                ? tmpl.name + " needs " + std::to_string(tmpl.num_input_keys) + " keys"
+                : tmpl.name + " does not accept these keys");
+        } else {
+            keys = std::move(request.keys);
+        }
+        type_name = tmpl.name;
+        committed_template = &tmpl;
+        attempt = [&] { return tmpl.execute(guarded, keys); };
+    } else {
+        if (request.ops.empty()) return BadRequest(request.id, "empty op list");
+        // Declared up front so 2PL can lock them before the first op
+        std::set<std::string> seen;
+        for (const auto& op : request.ops) {
+            if (seen.insert(op.key).second) keys.push_back(op.key);
+        }
+        type_name = "ops";
+        attempt = [&] {
+            response.reads.clear();
+            auto txn = mgr_.Begin("ops", keys);
+            for (const auto& op : request.ops) {
+                if (op.type == OpType::kRead) {
+                    response.reads.push_back(mgr_.Read(txn, op.key));
+                } else {
+                    mgr_.Write(txn, op.key, op.value);
+                }
+            }
+            return mgr_.Commit(txn);
+        };
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int retries = 0;
+    while (true) {
+        CommitResult result;
+        try {
+            result = attempt();
+        } catch (const std::exception& e) {
+            // E.g. a stored field a template parses as a number was
+            // overwritten by an op list: fail the request, not the worker
+            guarded.AbortOpen();
+            metrics_.RecordAbort(type_name);
+            metrics_.RecordWorkerAbort(worker_id);
+            return BadRequest(request.id, type_name + " failed: " + e.what());
+        }
+        if (result.success) {
+            if (committed_template && committed_template->on_commit) {
+                committed_template->on_commit(keys);
+            }
+            double latency_us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+            metrics_.RecordCommit(type_name, latency_us);
+            // 2PL retries happen inside Begin and only surface here
+            metrics_.RecordWorkerCommit(worker_id, retries + result.retries);
+            response.retries = retries + result.retries;
+            response.latency_us = static_cast<uint32_t>(latency_us);
+            return response;
+        }
+        metrics_.RecordAbort(type_name);
+        metrics_.RecordWorkerAbort(worker_id);
+        retries++;
+        if (config_.max_retries > 0 && retries >= config_.max_retries) {
+            response.status = ResponseStatus::kAborted;
+            response.retries = retries;
+            response.reads.clear();
+            return response;
+        }
+
+        // Exponential backoff with jitter, as in WorkloadExecutor
+        int backoff_us = config_.retry_backoff_base_us * (1 << std::min(retries, 10));
+        std::uniform_int_distribution<int> jitter(0, backoff_us);
+        std::this_thread::sleep_for(std::chrono::microseconds(backoff_us + jitter(rng)));
+    }
+}
+
+} // namespace txn
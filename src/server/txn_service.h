@@ -0,0 +1,80 @@
+#ifndef TXN_SERVICE_H
+#define TXN_SERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "concurrency/transaction_manager.h"
+#include "metrics/metrics.h"
+#include "server/wire_protocol.h"
+#include "workload/key_selector.h"
+#include "workload/workload_template.h"
+
+namespace txn {
+
+// Receives the response to a submitted request, on a service worker thread.
+class ResponseSink {
+public:
+    virtual ~ResponseSink() = default;
+    virtual void Deliver(TxnResponse&& response) = 0;
+};
+
+struct ServiceConfig {
+    int num_workers = 4;
+    ContentionConfig contention;              // keys for templates without a key_builder
+    std::vector<WorkloadTemplate> templates;  // addressed by index in template requests
+    int retry_backoff_base_us = 100;
+    int max_retries = 0;                      // aborts before giving up; 0 = retry until commit
+};
+
+struct ServiceRequest {
+    TxnRequest request;
+    std::shared_ptr<ResponseSink> sink;
+};
+
+// Transport-independent core of server mode: a pool of worker threads runs
+// submitted requests against the manager, retrying aborts with the executor's
+// exponential backoff, and records them in the same metrics as a local run.
+// Template requests are reported under the template's name, op lists as "ops".
+class TxnService {
+public:
+    TxnService(TransactionManager& mgr, MetricsCollector& metrics, const ServiceConfig& config);
+    ~TxnService();
+
+    void Start();
+    // Finishes every queued request, then joins the workers.
+    void Stop();
+
+    // Queues a batch under a single lock acquisition.
+    void Submit(std::vector<ServiceRequest>&& batch);
+
+    const ServiceConfig& Config() const { return config_; }
+    double ElapsedSeconds() const { return elapsed_s_; }
+
+private:
+    void WorkerThread(int worker_id);
+    TxnResponse Execute(int worker_id, TxnRequest& request, std::mt19937& rng,
+                        KeySelector& key_selector, std::discrete_distribution<size_t>& template_dist);
+
+    TransactionManager& mgr_;
+    MetricsCollector& metrics_;
+    ServiceConfig config_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<ServiceRequest> queue_;
+    bool stopping_ = false;
+
+    std::vector<std::thread> workers_;
+    std::chrono::steady_clock::time_point start_;
+    double elapsed_s_ = 0.0;
+};
+
+} // namespace txn
+
+#endif // TXN_SERVICE_H
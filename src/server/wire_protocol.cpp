@@ -0,0 +1,198 @@
+#include "server/wire_protocol.h"
+#include <cstring>
+
+namespace txn {
+
+namespace {
+
+template <typename T>
+void Put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename Len>
+void PutString(std::string& out, const std::string& s) {
+    Put<Len>(out, static_cast<Len>(s.size()));
+    out.append(s);
+}
+
+// Bounds-checked cursor over a payload; every Get fails once data runs out.
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    template <typename T>
+    bool Get(T& value) {
+        if (data_.size() - pos_ < sizeof(T)) return false;
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    template <typename Len>
+    bool GetString(std::string& s) {
+        Len len;
+        if (!Get(len) || data_.size() - pos_ < len) return false;
+        s.assign(data_.data() + pos_, len);
+        pos_ += len;
+        return true;
+    }
+
+    bool AtEnd() const { return pos_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+// Writes a placeholder length, appends the payload via fill, then patches it.
+template <typename Fill>
+void AppendFrame(std::string& out, Fill fill) {
+    size_t start = out.size();
+    Put<uint32_t>(out, 0);
+    fill();
+    uint32_t len = static_cast<uint32_t>(out.size() - start - sizeof(uint32_t));
+    std::memcpy(&out[start], &len, sizeof(len));
+}
+
+} // anonymous namespace
+
+void AppendRequestFrame(std::string& out, const TxnRequest& request) {
+    AppendFrame(out, [&] {
+        Put<uint64_t>(out, request.id);
+        Put<uint8_t>(out, static_cast<uint8_t>(request.kind));
+        if (request.kind == RequestKind::kTemplate) {
+            Put<uint16_t>(out, request.template_id);
+            Put<uint16_t>(out, static_cast<uint16_t>(request.keys.size()));
+            for (const auto& key : request.keys) PutString<uint16_t>(out, key);
+        } else {
+            Put<uint16_t>(out, static_cast<uint16_t>(request.ops.size()));
+            for (const auto& op : request.ops) {
+                Put<uint8_t>(out, static_cast<uint8_t>(op.type));
+                PutString<uint16_t>(out, op.key);
+                if (op.type == OpType::kWrite) PutString<uint32_t>(out, op.value);
+            }
+        }
+    });
+}
+
+void AppendResponseFrame(std::string& out, const TxnResponse& response) {
+    AppendFrame(out, [&] {
+        Put<uint64_t>(out, response.id);
+        Put<uint8_t>(out, static_cast<uint8_t>(response.status));
+        Put<uint32_t>(out, response.retries);
+        Put<uint32_t>(out, response.latency_us);
+        PutString<uint16_t>(out, response.error);
+        Put<uint16_t>(out, static_cast<uint16_t>(response.reads.size()));
+        for (const auto& value : response.reads) {
+            Put<uint8_t>(out, value.has_value() ? 1 : 0);
+            PutString<uint32_t>(out, value.value_or(""));
+        }
+    });
+}
+
+void AppendReplicationFrame(std::string& out, const ReplicationRecord& record) {
+    AppendFrame(out, [&] {
+        Put<uint8_t>(out, static_cast<uint8_t>(record.kind));
+        Put<uint64_t>(out, record.seq);
+        Put<uint64_t>(out, record.commit_ns);
+        Put<uint32_t>(out, static_cast<uint32_t>(record.writes.size()));
+        for (const auto& [key, value] : record.writes) {
+            PutString<uint16_t>(out, key);
+            PutString<uint32_t>(out, value);
+        }
+    });
+}
+
+FrameStatus NextFrame(const char* data, size_t size, std::string_view& payload, size_t& consumed) {
+    uint32_t len;
+    if (size < sizeof(len)) return FrameStatus::kIncomplete;
+    std::memcpy(&len, data, sizeof(len));
+    if (len > kMaxFrameBytes) return FrameStatus::kInvalid;
+    if (size - sizeof(len) < len) return FrameStatus::kIncomplete;
+    payload = std::string_view(data + sizeof(len), len);
+    consumed = sizeof(len) + len;
+    return FrameStatus::kComplete;
+}
+
+bool DecodeRequest(std::string_view payload, TxnRequest& request) {
+    Reader in(payload);
+    uint8_t kind;
+    if (!in.Get(request.id) || !in.Get(kind)) return false;
+    request.keys.clear();
+    request.ops.clear();
+    if (kind == static_cast<uint8_t>(RequestKind::kTemplate)) {
+        request.kind = RequestKind::kTemplate;
+        uint16_t num_keys;
+        if (!in.Get(request.template_id) || !in.Get(num_keys)) return false;
+        request.keys.resize(num_keys);
+        for (auto& key : request.keys) {
+            if (!in.GetString<uint16_t>(key)) return false;
+        }
+    } else if (kind == static_cast<uint8_t>(RequestKind::kOps)) {
+        request.kind = RequestKind::kOps;
+        uint16_t num_ops;
+        if (!in.Get(num_ops)) return false;
+        request.ops.resize(num_ops);
+        for (auto& op : request.ops) {
+            uint8_t type;
+            if (!in.Get(type) || !in.GetString<uint16_t>(op.key)) return false;
+            if (type == static_cast<uint8_t>(OpType::kRead)) {
+                op.type = OpType::kRead;
+            } else if (type == static_cast<uint8_t>(OpType::kWrite)) {
+                op.type = OpType::kWrite;
+                if (!in.GetString<uint32_t>(op.value)) return false;
+            } else {
+                return false;
+            }
+        }
+    } else {
+        return false;
+    }
+    return in.AtEnd();
+}
+
+bool DecodeResponse(std::string_view payload, TxnResponse& response) {
+    Reader in(payload);
+    uint8_t status;
+    uint16_t num_reads;
+    if (!in.Get(response.id) || !in.Get(status) || !in.Get(response.retries)
+        || !in.Get(response.latency_us) || !in.GetString<uint16_t>(response.error)
+        || !in.Get(num_reads)) {
+        return false;
+    }
+    if (status > static_cast<uint8_t>(ResponseStatus::kBadRequest)) return false;
+    response.status = static_cast<ResponseStatus>(status);
+    response.reads.assign(num_reads, std::nullopt);
+    for (auto& value : response.reads) {
+        uint8_t found;
+        std::string s;
+        if (!in.Get(found) || !in.GetString<uint32_t>(s)) return false;
+        if (found) value = std::move(s);
+    }
+    return in.AtEnd();
+}
+
+bool DecodeReplication(std::string_view payload, ReplicationRecord& record) {
+    Reader in(payload);
+    uint8_t kind;
+    uint32_t num_writes;
+    if (!in.Get(kind) || !in.Get(record.seq) || !in.Get(record.commit_ns)
+        || !in.Get(num_writes)) {
+        return false;
+    }
+    if (kind < static_cast<uint8_t>(ReplicationKind::kSnapshot)
+        || kind > static_cast<uint8_t>(ReplicationKind::kAck)) {
+        return false;
+    }
+    record.kind = static_cast<ReplicationKind>(kind);
+    record.writes.clear();
+    for (uint32_t i = 0; i < num_writes; i++) {
+        std::string key, value;
+        if (!in.GetString<uint16_t>(key) || !in.GetString<uint32_t>(value)) return false;
+        record.writes.emplace_back(std::move(key), std::move(value));
+    }
+    return in.AtEnd();
+}
+
+} // namespace txn
@@ -0,0 +1,127 @@
+#ifndef WIRE_PROTOCOL_H
+#define WIRE_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace txn {
+
+// Binary protocol spoken between TxnClient and the transaction server.
+// Clients and server share a host, so integers are in host byte order.
+//
+// Every message is a frame: u32 payload length, then the payload.
+//
+// Request payload:
+//   u64 request_id, u8 kind
+//   kind = kTemplate: u16 template_id, u16 key count, keys
+//   kind = kOps:      u16 op count, ops (u8 type, key, and for writes a value)
+// Response payload:
+//   u64 request_id, u8 status, u32 retries, u32 latency_us, error,
+//   u16 read count, reads (u8 found, value)
+//
+// Keys and errors are u16-length strings, values u32-length strings.
+// Requests on one connection may be pipelined; responses can come back in
+// any order and are matched by request_id.
+
+constexpr uint32_t kMaxFrameBytes = 16u << 20;
+
+// template_id asking the server to pick a template by its mix weight.
+constexpr uint16_t kAnyTemplate = 0xFFFF;
+
+enum class RequestKind : uint8_t {
+    kTemplate = 1,  // run a server-side workload template
+    kOps      = 2,  // run an explicit list of reads and writes
+};
+
+enum class OpType : uint8_t {
+    kRead  = 1,
+    kWrite = 2,
+};
+
+struct TxnOp {
+    OpType type;
+    std::string key;
+    std::string value;  // writes only
+};
+
+struct TxnRequest {
+    uint64_t id = 0;
+    RequestKind kind = RequestKind::kTemplate;
+    uint16_t template_id = kAnyTemplate;
+    // Template keys; empty = the server picks them with the template's key builder.
+    std::vector<std::string> keys;
+    std::vector<TxnOp> ops;
+};
+
+enum class ResponseStatus : uint8_t {
+    kCommitted  = 0,
+    kAborted    = 1,  // retry budget exhausted
+    kBadRequest = 2,  // unknown template, wrong key count, empty op list
+};
+
+struct TxnResponse {
+    uint64_t id = 0;
+    ResponseStatus status = ResponseStatus::kCommitted;
+    uint32_t retries = 0;     // attempts that did not commit before the last one
+    uint32_t latency_us = 0;  // server-side, from dequeue to commit
+    std::string error;        // set for kBadRequest
+    // One entry per read op of a kOps request, in op order; nullopt = key not found.
+    std::vector<std::optional<std::string>> reads;
+};
+
+// Replication stream between a primary (transaction_system --replicate PATH)
+// and its follower (--follow PATH), same framing:
+//   u8 kind, u64 seq, u64 commit_ns, u32 write count, writes (key, value)
+// Primary to follower:
+//   kind = kSnapshot: part of the primary's state at position seq; a
+//                     kSnapshot frame without writes ends the snapshot
+//   kind = kBatch:    the write set of commit seq; seqs are consecutive
+//   kind = kEnd:      the primary stopped after commit seq
+// Follower to primary:
+//   kind = kAck:      every commit up to seq is applied (sent after kEnd)
+// commit_ns is the primary's steady_clock at commit (kBatch only); both
+// processes share the host's monotonic clock, so the follower can compute
+// replication lag from it directly.
+
+enum class ReplicationKind : uint8_t {
+    kSnapshot = 1,
+    kBatch    = 2,
+    kEnd      = 3,
+    kAck      = 4,
+};
+
+struct ReplicationRecord {
+    ReplicationKind kind = ReplicationKind::kBatch;
+    uint64_t seq = 0;
+    uint64_t commit_ns = 0;
+    std::vector<std::pair<std::string, std::string>> writes;
+};
+
+// Appends one complete frame to out.
+void AppendRequestFrame(std::string& out, const TxnRequest& request);
+void AppendResponseFrame(std::string& out, const TxnResponse& response);
+void AppendReplicationFrame(std::string& out, const ReplicationRecord& record);
+
+enum class FrameStatus {
+    kComplete,
+    kIncomplete,  // need more bytes
+    kInvalid,     // length over kMaxFrameBytes
+};
+
+// Looks for a frame at the start of [data, data + size). On kComplete,
+// payload points into data and consumed is the frame's total size.
+FrameStatus NextFrame(const char* data, size_t size, std::string_view& payload, size_t& consumed);
+
+// Return false on a malformed payload.
+bool DecodeRequest(std::string_view payload, TxnRequest& request);
+bool DecodeResponse(std::string_view payload, TxnResponse& response);
+bool DecodeReplication(std::string_view payload, ReplicationRecord& record);
+
+} // namespace txn
+
+#endif // WIRE_PROTOCOL_H
@@ -0,0 +1,60 @@
+#ifndef ACCESS_SET_H
+#define ACCESS_SET_H
+
+#include <string>
+#include <vector>
+
+namespace txn {
+
+enum class AccessMode {
+    kRead,             // read only
+    kWrite,            // written without being read first
+    kReadModifyWrite,  // read, then written with a value derived from it
+    kIncrement,        // a numeric field moved by a fixed amount
+};
+
+inline bool AccessWrites(AccessMode mode) { return mode != AccessMode::kRead; }
+
+// How a transaction type uses the keys of one table: every key starting
+// with prefix ("" matches any key), and the record fields it touches
+// (none listed: the whole value).
+struct KeyAccess {
+    std::string prefix;
+    AccessMode mode;
+    std::vector<std::string> fields;
+};
+
+// The accesses a transaction type declares, covering declared and
+// data-dependent keys alike. The first entry whose prefix matches a key
+// applies. A key no entry matches, or any key of a type that declares
+// nothing, is taken to be read and written.
+struct AccessSet {
+    std::vector<KeyAccess> entries;
+
+    bool Empty() const { return entries.empty(); }
+
+    const KeyAccess* Find(const std::string& key) const {
+        for (const auto& entry : entries) {
+            if (key.compare(0, entry.prefix.size(), entry.prefix) == 0) return &entry;
+        }
+        return nullptr;
+    }
+
+    AccessMode ModeOf(const std::string& key) const {
+        const KeyAccess* entry = Find(key);
+        return entry ? entry->mode : AccessMode::kReadModifyWrite;
+    }
+
+    // Declared, and nothing is written
+    bool ReadOnly() const {
+        if (entries.empty()) return false;
+        for (const auto& entry : entries) {
+            if (AccessWrites(entry.mode)) return false;
+        }
+        return true;
+    }
+};
+
+} // namespace txn
+
+#endif // ACCESS_SET_H
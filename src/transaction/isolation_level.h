@@ -0,0 +1,51 @@
+#ifndef ISOLATION_LEVEL_H
+#define ISOLATION_LEVEL_H
+
+#include <string>
+
+namespace txn {
+
+// Isolation a transaction type runs at (TransactionManager::SetIsolation).
+// Writes are always buffered and applied atomically at commit, so no level
+// sees uncommitted data.
+enum class IsolationLevel {
+    kReadCommitted,   // reads see the latest committed value; only writes are
+                      // checked, so a read-modify-write loses no update
+    kRepeatableRead,  // every read stays valid until commit (same as serializable
+                      // for point reads: there are no range reads to phantom)
+    kSnapshot,        // reads see the database as of Begin; only write-write
+                      // conflicts abort (first committer wins)
+    kSerializable,    // the default
+};
+
+// Reads are protected until commit: by validation under OCC, by shared
+// locks held to commit under 2PL. Writes are protected at every level.
+inline bool ProtectsReads(IsolationLevel level) {
+    return level == IsolationLevel::kRepeatableRead || level == IsolationLevel::kSerializable;
+}
+
+inline std::string IsolationName(IsolationLevel level) {
+    switch (level) {
+        case IsolationLevel::kReadCommitted:  return "read-committed";
+        case IsolationLevel::kRepeatableRead: return "repeatable-read";
+        case IsolationLevel::kSnapshot:       return "snapshot";
+        case IsolationLevel::kSerializable:   return "serializable";
+    }
+    return "serializable";
+}
+
+// Level for an --isolation name; false for an unknown name
+inline bool ParseIsolationLevel(const std::string& name, IsolationLevel& level) {
+    for (IsolationLevel candidate : {IsolationLevel::kReadCommitted, IsolationLevel::kRepeatableRead,
+                                     IsolationLevel::kSnapshot, IsolationLevel::kSerializable}) {
+        if (name == IsolationName(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace txn
+
+#endif // ISOLATION_LEVEL_H
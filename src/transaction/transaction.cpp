@@ -3,23 +3,40 @@
 namespace txn {
 
 std::optional<std::string> Transaction::Read(const std::string& key, Database& db) {
+    std::optional<std::string> value;
+    if (ReadLocal(key, value)) return value;
+
+    // Read from database
+    value = db.Get(key, snapshot.get());
+    RecordRead(key, value);
+    return value;
+}
+
+bool Transaction::ReadLocal(const std::string& key, std::optional<std::string>& value) {
     // Read-your-writes: check write_set first
     auto it = write_set.find(key);
-    if (it != write_set.end()) {
-        read_set[key] = it->second;
-        return it->second;
-    }
+    if (it == write_set.end()) return false;
+    read_set[key] = it->second;
+    value = it->second;
+    return true;
+}
 
-    // Read from database
-    auto value = db.Get(key);
+void Transaction::RecordRead(const std::string& key, const std::optional<std::string>& value) {
     if (value.has_value()) {
         read_set[key] = value.value();
     }
-    return value;
 }
 
 void Transaction::Write(const std::string& key, const std::string& value) {
     write_set[key] = value;
 }
 
+const std::unordered_map<std::string, std::string>& Transaction::ConflictKeys() const {
+    return ProtectsReads(isolation) ? read_set : write_set;
+}
+
+bool Transaction::SnapshotCurrent(const std::string& key, Database& db) const {
+    return !snapshot || db.Get(key, snapshot.get()) == db.Get(key);
+}
+
 } // namespace txn
@@ -6,13 +6,17 @@
 #include <optional>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "database/database.h"
+#include "transaction/access_set.h"
+#include "transaction/isolation_level.h"
 
 namespace txn {
 
 enum class TxnStatus {
     ACTIVE,
+    PREPARED,   // voted yes in two-phase commit; Commit must follow
     COMMITTED,
     ABORTED
 };
@@ -28,16 +32,53 @@ struct Transaction {
     std::unordered_map<std::string, std::string> read_set;
     std::unordered_map<std::string, std::string> write_set;
 
-    std::vector<std::string> lock_keys;  // keys held under 2PL (empty for OCC)
+    std::vector<std::string> lock_keys;    // keys held exclusively under 2PL (empty for OCC)
+    std::vector<std::string> shared_keys;  // keys held in shared mode under 2PL
+
+    // Accesses declared for type_name (TransactionManager::Declare), if any
+    const AccessSet* access = nullptr;
+
+    // Level set for type_name (TransactionManager::SetIsolation). Snapshot
+    // transactions read through snapshot, pinned by Begin until the
+    // transaction commits or aborts.
+    IsolationLevel isolation = IsolationLevel::kSerializable;
+    std::shared_ptr<const rocksdb::Snapshot> snapshot;
+
+    // VersionedOCCManager only: stored version of each key read from the
+    // database, as of its first read (0 for a missing key)
+    std::unordered_map<std::string, uint64_t> read_versions;
+
+    // ClusterManager only: partitions with a branch of this transaction, and
+    // the partition coordinating it (-1 until the first key is known)
+    std::vector<int> partitions;
+    int home_partition = -1;
 
     std::chrono::steady_clock::time_point wall_start;
     int retry_count = 0;
+    // Last key found in conflict (validation failure, held lock), reported
+    // in CommitResult::conflict_key
+    std::string conflict_key;
 
     // Read: check write_set first (read-your-writes), else read from DB
+    // (through snapshot, if set)
     std::optional<std::string> Read(const std::string& key, Database& db);
 
+    // The two halves of Read, for reads fetched in a batch: ReadLocal serves
+    // key from write_set if it can, RecordRead notes a value read from the DB
+    bool ReadLocal(const std::string& key, std::optional<std::string>& value);
+    void RecordRead(const std::string& key, const std::optional<std::string>& value);
+
     // Write: buffer in write_set only
     void Write(const std::string& key, const std::string& value);
+
+    // Keys a commit by another transaction invalidates, by isolation level:
+    // read_set (repeatable read, serializable) or write_set (snapshot and
+    // read committed: first committer wins, so no update is lost)
+    const std::unordered_map<std::string, std::string>& ConflictKeys() const;
+
+    // Snapshot transactions: key's latest committed value is still the one
+    // in snapshot, so nothing has overwritten it since Begin
+    bool SnapshotCurrent(const std::string& key, Database& db) const;
 };
 
 } // namespace txn
@@ -0,0 +1,121 @@
+#include "workload/async_txn.h"
+
+namespace txn {
+
+AsyncIo::BeginAwaiter AsyncIo::Begin(const std::string& type_name,
+                                     const std::vector<std::string>& keys) {
+    return BeginAwaiter(*this, type_name, keys);
+}
+
+AsyncIo::ReadAwaiter AsyncIo::Read(Transaction& txn, std::vector<std::string> keys) {
+    return ReadAwaiter(*this, txn, std::move(keys));
+}
+
+AsyncIo::CommitAwaiter AsyncIo::Commit(Transaction txn) {
+    return CommitAwaiter(*this, std::move(txn));
+}
+
+void AsyncIo::WaitForCommit(std::chrono::microseconds timeout) {
+    std::unique_lock<std::mutex> lock(completed_mutex_);
+    completed_cv_.wait_for(lock, timeout, [this] { return !completed_.empty(); });
+}
+
+bool AsyncIo::BeginAwaiter::TryBegin() {
+    txn_ = io_.mgr_.TryBegin(type_name_, keys_);
+    if (!txn_) {
+        attempts_++;
+        return false;
+    }
+    // Busy-lock attempts count as retries, as they do inside a blocking Begin
+    txn_->retry_count += attempts_;
+    return true;
+}
+
+bool AsyncIo::BeginAwaiter::await_ready() {
+    return TryBegin();
+}
+
+void AsyncIo::BeginAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    io_.begins_.push_back(this);
+}
+
+bool AsyncIo::ReadAwaiter::await_ready() {
+    values_.resize(keys_.size());
+    for (size_t i = 0; i < keys_.size(); i++) {
+        if (io_.mgr_.StartRead(txn_, keys_[i], values_[i])) fetch_.push_back(i);
+    }
+    return fetch_.empty();
+}
+
+void AsyncIo::ReadAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    io_.reads_.push_back(this);
+}
+
+bool AsyncIo::CommitAwaiter::await_ready() {
+    if (io_.async_commit_) return false;
+    result_ = io_.mgr_.Commit(txn_);
+    return true;
+}
+
+void AsyncIo::CommitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    io_.commits_++;
+    AsyncIo& io = io_;
+    io.mgr_.CommitAsync(std::move(txn_), [this, &io, handle](const CommitResult& result) {
+        result_ = result;
+        // The coroutine, and this awaiter with it, may be gone once the
+        // handle is published: only io is touched after this point
+        std::lock_guard<std::mutex> lock(io.completed_mutex_);
+        io.completed_.push_back(handle);
+        io.completed_cv_.notify_one();
+    });
+}
+
+size_t AsyncIo::Poll() {
+    std::vector<std::coroutine_handle<>> ready;
+    {
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        ready.swap(completed_);
+    }
+    commits_ -= ready.size();
+
+    // Retry begins first: a read served below may finish a lock holder, but
+    // its locks are only released once that coroutine resumes and commits
+    std::vector<BeginAwaiter*> begins;
+    begins.swap(begins_);
+    for (BeginAwaiter* begin : begins) {
+        if (begin->TryBegin()) {
+            ready.push_back(begin->handle_);
+        } else {
+            begins_.push_back(begin);
+        }
+    }
+
+    std::vector<ReadAwaiter*> reads;
+    reads.swap(reads_);
+    if (!reads.empty()) {
+        std::vector<std::string> keys;
+        for (ReadAwaiter* read : reads) {
+            for (size_t i : read->fetch_) keys.push_back(read->keys_[i]);
+        }
+        std::vector<std::optional<std::string>> values = mgr_.Fetch(keys);
+        batches_++;
+        batched_keys_ += keys.size();
+
+        size_t next = 0;
+        for (ReadAwaiter* read : reads) {
+            for (size_t i : read->fetch_) {
+                read->values_[i] = mgr_.FinishRead(read->txn_, read->keys_[i],
+                                                   std::move(values[next++]));
+            }
+            ready.push_back(read->handle_);
+        }
+    }
+
+    // Resumed coroutines may suspend again and queue new work for the next Poll
+    for (auto handle : ready) handle.resume();
+    return ready.size();
+}
+
+} // namespace txn
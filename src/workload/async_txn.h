@@ -0,0 +1,170 @@
+#ifndef ASYNC_TXN_H
+#define ASYNC_TXN_H
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "concurrency/transaction_manager.h"
+
+namespace txn {
+
+// Coroutine returned by a template's async_execute. Starts suspended; the
+// executor resumes it once, after which it runs until it awaits an AsyncIo
+// operation (AsyncIo resumes it) or returns its CommitResult.
+class AsyncTxn {
+public:
+    struct promise_type {
+        CommitResult result{false, 0, 0, {}};
+        std::exception_ptr error;
+
+        AsyncTxn get_return_object() {
+            return AsyncTxn(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(CommitResult value) { result = value; }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    AsyncTxn() = default;
+    explicit AsyncTxn(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    AsyncTxn(AsyncTxn&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    AsyncTxn& operator=(AsyncTxn&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    AsyncTxn(const AsyncTxn&) = delete;
+    AsyncTxn& operator=(const AsyncTxn&) = delete;
+    ~AsyncTxn() {
+        if (handle_) handle_.destroy();
+    }
+
+    // Runs the body up to its first suspension point.
+    void Start() { handle_.resume(); }
+    bool Valid() const { return static_cast<bool>(handle_); }
+    bool Done() const { return handle_.done(); }
+    // Only once Done(); rethrows an exception that escaped the body.
+    CommitResult Result() const {
+        if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+        return handle_.promise().result;
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Per-worker I/O scheduler for AsyncTxn coroutines. Reads that need storage
+// and 2PL begins whose locks are busy suspend the coroutine instead of the
+// thread; Poll then serves every suspended read with one manager Fetch (a
+// Database::MultiGet) and retries the begins, so a worker keeps the I/O of
+// many transactions in flight at once. With async_commit, awaited commits
+// go through the manager's CommitAsync and resume their coroutine in the
+// first Poll after the outcome arrives; otherwise they commit inline. Not
+// thread-safe apart from commit completion: one AsyncIo per worker thread.
+class AsyncIo {
+public:
+    explicit AsyncIo(TransactionManager& mgr, bool async_commit = false)
+        : mgr_(mgr), async_commit_(async_commit) {}
+
+    class BeginAwaiter;
+    class ReadAwaiter;
+    class CommitAwaiter;
+
+    // co_await io.Begin("transfer", keys) -> Transaction
+    BeginAwaiter Begin(const std::string& type_name, const std::vector<std::string>& keys);
+    // co_await io.Read(txn, keys) -> one value per key, in order
+    ReadAwaiter Read(Transaction& txn, std::vector<std::string> keys);
+    // co_await io.Commit(std::move(txn)) -> CommitResult
+    CommitAwaiter Commit(Transaction txn);
+
+    // Serves pending reads and retries pending begins, then resumes every
+    // coroutine that can continue. Returns how many were resumed.
+    size_t Poll();
+    // Coroutines waiting on a read, a begin or a commit.
+    size_t Pending() const { return reads_.size() + begins_.size() + commits_; }
+    // Sleeps up to timeout, returning early once a commit completes.
+    void WaitForCommit(std::chrono::microseconds timeout);
+    uint64_t Batches() const { return batches_; }
+    uint64_t BatchedKeys() const { return batched_keys_; }
+
+    class BeginAwaiter {
+    public:
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        Transaction await_resume() { return std::move(*txn_); }
+
+    private:
+        friend class AsyncIo;
+        BeginAwaiter(AsyncIo& io, const std::string& type_name, const std::vector<std::string>& keys)
+            : io_(io), type_name_(type_name), keys_(keys) {}
+        bool TryBegin();
+
+        AsyncIo& io_;
+        std::string type_name_;
+        std::vector<std::string> keys_;
+        std::optional<Transaction> txn_;
+        int attempts_ = 0;
+        std::coroutine_handle<> handle_;
+    };
+
+    class ReadAwaiter {
+    public:
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        std::vector<std::optional<std::string>> await_resume() { return std::move(values_); }
+
+    private:
+        friend class AsyncIo;
+        ReadAwaiter(AsyncIo& io, Transaction& txn, std::vector<std::string> keys)
+            : io_(io), txn_(txn), keys_(std::move(keys)) {}
+
+        AsyncIo& io_;
+        Transaction& txn_;
+        std::vector<std::string> keys_;
+        std::vector<std::optional<std::string>> values_;
+        std::vector<size_t> fetch_;  // indices of keys_ that need storage
+        std::coroutine_handle<> handle_;
+    };
+
+    class CommitAwaiter {
+    public:
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        CommitResult await_resume() { return result_; }
+
+    private:
+        friend class AsyncIo;
+        CommitAwaiter(AsyncIo& io, Transaction txn) : io_(io), txn_(std::move(txn)) {}
+
+        AsyncIo& io_;
+        Transaction txn_;
+        CommitResult result_{false, 0, 0, {}};
+    };
+
+private:
+    TransactionManager& mgr_;
+    bool async_commit_;
+    std::vector<ReadAwaiter*> reads_;
+    std::vector<BeginAwaiter*> begins_;
+    size_t commits_ = 0;  // submitted, coroutine not resumed yet
+
+    // Filled by CommitAsync callbacks, which may run on another thread
+    std::mutex completed_mutex_;
+    std::condition_variable completed_cv_;
+    std::vector<std::coroutine_handle<>> completed_;
+    uint64_t batches_ = 0;
+    uint64_t batched_keys_ = 0;
+};
+
+} // namespace txn
+
+#endif // ASYNC_TXN_H
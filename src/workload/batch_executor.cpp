@@ -0,0 +1,131 @@
+#include "workload/batch_executor.h"
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+
+namespace txn {
+
+namespace {
+
+// Shows a template's execute one transaction already begun by BeginBatch:
+// Begin hands it over and Commit parks it for the batch commit. Anything
+// else, including a second transaction, goes straight to the manager.
+class BatchMember : public TransactionManager {
+public:
+    BatchMember(TransactionManager& mgr, Transaction txn)
+        : mgr_(mgr), txn_id_(txn.txn_id), txn_(std::move(txn)) {}
+
+    Transaction Begin(const std::string& type_name,
+                      const std::vector<std::string>& keys = {}) override {
+        if (begun_) return mgr_.Begin(type_name, keys);
+        begun_ = true;
+        return std::move(txn_);
+    }
+    std::optional<std::string> Read(Transaction& txn, const std::string& key) override {
+        return mgr_.Read(txn, key);
+    }
+    void Write(Transaction& txn, const std::string& key, const std::string& value) override {
+        mgr_.Write(txn, key, value);
+    }
+    CommitResult Commit(Transaction& txn) override {
+        if (txn.txn_id != txn_id_ || parked_) return mgr_.Commit(txn);
+        // Reported as committed for now; the batch commit decides
+        parked_ = std::move(txn);
+        return {true, txn_id_, parked_->retry_count, parked_->conflict_key};
+    }
+    void Abort(Transaction& txn) override { mgr_.Abort(txn); }
+    bool Prepare(Transaction& txn) override { return mgr_.Prepare(txn); }
+    std::string ProtocolName() const override { return mgr_.ProtocolName(); }
+
+    // The parked transaction, or nullopt if execute aborted it. A
+    // transaction execute never began is aborted here.
+    std::optional<Transaction> TakeParked() {
+        if (!begun_) {
+            begun_ = true;
+            mgr_.Abort(txn_);
+        }
+        return std::move(parked_);
+    }
+
+private:
+    TransactionManager& mgr_;
+    uint64_t txn_id_;
+    Transaction txn_;
+    bool begun_ = false;
+    std::optional<Transaction> parked_;
+};
+
+} // anonymous namespace
+
+std::vector<CommitResult> ExecuteBatch(TransactionManager& mgr,
+                                       const std::vector<BatchRequest>& requests,
+                                       int busy_backoff_us) {
+    std::vector<CommitResult> results(requests.size());
+    std::vector<int> busy_rounds(requests.size(), 0);
+    std::vector<size_t> waiting(requests.size());
+    for (size_t i = 0; i < requests.size(); i++) waiting[i] = i;
+
+    while (!waiting.empty()) {
+        // A request sharing a key with an earlier one of the round waits for
+        // the next round: under OCC it would read the value from before the
+        // earlier one's write and fail validation, under 2PL the earlier one
+        // holds the lock until the round commits
+        std::unordered_set<std::string> round_keys;
+        std::vector<size_t> round;
+        std::vector<size_t> deferred;
+        for (size_t i : waiting) {
+            bool overlaps = false;
+            for (const auto& key : requests[i].keys) {
+                if (round_keys.count(key)) {
+                    overlaps = true;
+                    break;
+                }
+            }
+            if (overlaps) {
+                deferred.push_back(i);
+                continue;
+            }
+            round_keys.insert(requests[i].keys.begin(), requests[i].keys.end());
+            round.push_back(i);
+        }
+
+        std::vector<BeginRequest> begins;
+        begins.reserve(round.size());
+        for (size_t i : round) begins.push_back({requests[i].tmpl->name, requests[i].keys});
+        std::vector<std::optional<Transaction>> txns = mgr.BeginBatch(begins);
+
+        std::vector<size_t> still_waiting;
+        std::vector<size_t> parked_idx;
+        std::vector<Transaction> parked;
+        for (size_t j = 0; j < round.size(); j++) {
+            size_t i = round[j];
+            if (!txns[j]) {
+                busy_rounds[i]++;
+                still_waiting.push_back(i);
+                continue;
+            }
+            txns[j]->retry_count += busy_rounds[i];
+            BatchMember member(mgr, std::move(*txns[j]));
+            results[i] = requests[i].tmpl->execute(member, requests[i].keys);
+            auto txn = member.TakeParked();
+            if (txn) {
+                parked_idx.push_back(i);
+                parked.push_back(std::move(*txn));
+            }
+        }
+
+        std::vector<CommitResult> committed = mgr.CommitBatch(parked);
+        for (size_t k = 0; k < parked_idx.size(); k++) results[parked_idx[k]] = committed[k];
+
+        // Nothing started: every remaining request waits on another thread
+        if (!still_waiting.empty() && still_waiting.size() == round.size()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(busy_backoff_us));
+        }
+        still_waiting.insert(still_waiting.end(), deferred.begin(), deferred.end());
+        waiting.swap(still_waiting);
+    }
+    return results;
+}
+
+} // namespace txn
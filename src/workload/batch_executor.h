@@ -0,0 +1,30 @@
+#ifndef BATCH_EXECUTOR_H
+#define BATCH_EXECUTOR_H
+
+#include <string>
+#include <vector>
+#include "concurrency/transaction_manager.h"
+#include "workload/workload_template.h"
+
+namespace txn {
+
+// One transaction of a batch: a template and its input keys
+struct BatchRequest {
+    const WorkloadTemplate* tmpl;
+    std::vector<std::string> keys;
+};
+
+// Runs independent transactions through the manager's batch entry points,
+// in rounds: one BeginBatch, each template's execute in turn on the calling
+// thread, then one CommitBatch. Requests sharing a declared key go to
+// successive rounds, as do requests whose 2PL locks are held by another
+// thread; those busy rounds count as retries, as they do inside a blocking
+// Begin. Returns one result per request, in order, as execute would have;
+// failed ones are for the caller to retry.
+std::vector<CommitResult> ExecuteBatch(TransactionManager& mgr,
+                                       const std::vector<BatchRequest>& requests,
+                                       int busy_backoff_us = 100);
+
+} // namespace txn
+
+#endif // BATCH_EXECUTOR_H
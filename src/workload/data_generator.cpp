@@ -0,0 +1,104 @@
+#include "workload/data_generator.h"
+#include "workload/workload1_templates.h"
+#include "workload/record.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace txn {
+
+namespace {
+
+const char* const kMarkerKey = "__large_dataset__";
+const size_t kBatchBytes = 4 << 20;
+
+std::string MarkerValue(uint64_t num_keys, int value_bytes) {
+    return "keys=" + std::to_string(num_keys) + "|value_bytes=" + std::to_string(value_bytes);
+}
+
+} // anonymous namespace
+
+std::string LargeDatasetKey(uint64_t index) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "A_%010llu", static_cast<unsigned long long>(index));
+    return buf;
+}
+
+uint64_t GenerateLargeDataset(Database& db, const LargeDatasetConfig& config) {
+    size_t key_bytes = LargeDatasetKey(0).size();
+    uint64_t per_entry = key_bytes + std::max(config.value_bytes, 1);
+    uint64_t num_keys = std::max<uint64_t>(2, config.target_bytes / per_entry);
+
+    std::string marker = MarkerValue(num_keys, config.value_bytes);
+    auto existing = db.Get(kMarkerKey);
+    if (existing.has_value() && existing.value() == marker) {
+        std::cout << "Reusing generated dataset: " << num_keys << " accounts\n";
+        return num_keys;
+    }
+
+    std::cout << "Generating " << num_keys << " accounts x " << config.value_bytes
+              << " B (~" << (num_keys * per_entry >> 20) << " MiB)...\n";
+
+    static const char kAlphabet[] =
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> pick(0, sizeof(kAlphabet) - 2);
+
+    std::vector<std::pair<std::string, std::string>> batch;
+    size_t batch_bytes = 0;
+    uint64_t report_every = std::max<uint64_t>(1, num_keys / 10);
+    for (uint64_t i = 0; i < num_keys; i++) {
+        Record rec;
+        rec["balance"] = "1000";
+        rec["name"] = "Account-" + std::to_string(i);
+        std::string value = SerializeRecord(rec);
+        // "|pad=" plus padding brings the value up to value_bytes
+        int pad = config.value_bytes - static_cast<int>(value.size()) - 5;
+        if (pad > 0) {
+            std::string padding(pad, 'x');
+            for (auto& c : padding) c = kAlphabet[pick(rng)];
+            rec["pad"] = std::move(padding);
+            value = SerializeRecord(rec);
+        }
+
+        batch_bytes += key_bytes + value.size();
+        batch.emplace_back(LargeDatasetKey(i), std::move(value));
+        if (batch_bytes >= kBatchBytes) {
+            if (!db.PutBatch(batch)) return 0;
+            batch.clear();
+            batch_bytes = 0;
+        }
+        if ((i + 1) % report_every == 0) {
+            std::cout << "  " << (i + 1) * 100 / num_keys << "%\n";
+        }
+    }
+    if (!batch.empty() && !db.PutBatch(batch)) return 0;
+
+    if (!db.Put(kMarkerKey, marker) || !db.Flush()) return 0;
+    return num_keys;
+}
+
+WorkloadTemplate MakeLargeTransferTemplate(uint64_t num_keys, int hotset_size,
+                                           double hotset_prob) {
+    auto tmpl = MakeW1TransferTemplate();
+    tmpl.key_builder = [num_keys, hotset_size, hotset_prob]
+                       (std::mt19937& rng) -> std::vector<std::string> {
+        uint64_t hot_max = std::min<uint64_t>(std::max(hotset_size, 2), num_keys) - 1;
+        std::uniform_real_distribution<double> prob_dist(0.0, 1.0);
+        std::uniform_int_distribution<uint64_t> hot_dist(0, hot_max);
+        std::uniform_int_distribution<uint64_t> all_dist(0, num_keys - 1);
+
+        uint64_t a = prob_dist(rng) < hotset_prob ? hot_dist(rng) : all_dist(rng);
+        uint64_t b = a;
+        while (b == a) {
+            b = prob_dist(rng) < hotset_prob ? hot_dist(rng) : all_dist(rng);
+        }
+        return {LargeDatasetKey(a), LargeDatasetKey(b)};
+    };
+    return tmpl;
+}
+
+} // namespace txn
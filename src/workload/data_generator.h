@@ -0,0 +1,35 @@
+#ifndef DATA_GENERATOR_H
+#define DATA_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include "database/database.h"
+#include "workload/workload_template.h"
+
+namespace txn {
+
+struct LargeDatasetConfig {
+    uint64_t target_bytes = 0;   // approximate total key + value bytes
+    int value_bytes       = 1024;
+};
+
+// Key of account i in a generated dataset: "A_" + 10-digit zero-padded index.
+std::string LargeDatasetKey(uint64_t index);
+
+// Fills db with workload-1-style accounts (balance=1000, name, random padding
+// up to value_bytes) until target_bytes is reached, then flushes to SST files.
+// Padding is random alphanumerics so block compression cannot shrink the data
+// back into memory. A marker key records the parameters; if the database
+// already holds a matching dataset it is reused instead of regenerated.
+// Returns the number of accounts, or 0 on failure.
+uint64_t GenerateLargeDataset(Database& db, const LargeDatasetConfig& config);
+
+// Transfer template over accounts [0, num_keys) of a generated dataset. Keys
+// are computed from indices, so no key list is held in memory. The first
+// hotset_size accounts form the hot set.
+WorkloadTemplate MakeLargeTransferTemplate(uint64_t num_keys, int hotset_size,
+                                           double hotset_prob);
+
+} // namespace txn
+
+#endif // DATA_GENERATOR_H
@@ -111,6 +111,10 @@ ParseResult ParseInputFile(const std::string& path) {
             } else if (prefix == 'C') {
                 result.customer_keys.push_back(key);
             }
+        } else if (key.rfind("CK_", 0) == 0) {
+            result.checking_keys.push_back(key);
+        } else if (key.rfind("SV_", 0) == 0) {
+            result.savings_keys.push_back(key);
         }
     }
 
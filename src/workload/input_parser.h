@@ -14,6 +14,8 @@ struct ParseResult {
     std::vector<std::string> district_keys;   // D_*
     std::vector<std::string> supply_keys;     // S_*
     std::vector<std::string> customer_keys;   // C_*
+    std::vector<std::string> checking_keys;   // CK_* (SmallBank)
+    std::vector<std::string> savings_keys;    // SV_* (SmallBank)
 };
 
 // Parses workloads/workload*/input*.txt.
@@ -0,0 +1,193 @@
+#ifndef SMALLBANK_TEMPLATES_H
+#define SMALLBANK_TEMPLATES_H
+
+#include "workload/workload_template.h"
+#include "workload/record.h"
+
+namespace txn {
+
+// SmallBank: every customer c has a checking record CK_c and a savings
+// record SV_c, each with an integer "balance" field. Six short transaction
+// types run over them in the standard mix (weights below). Customers are
+// picked with the usual hotset parameters, so --hotset-size/--hotset-prob
+// define the SmallBank hotspot. key_builder lambdas are injected in
+// workload_builder.cpp.
+struct SmallBankConfig {
+    int num_accounts = 10000;  // customers generated when no input file is given
+    int min_balance  = 10000;
+    int max_balance  = 50000;
+};
+
+namespace smallbank {
+
+constexpr int kDepositAmount  = 1;
+constexpr int kSavingsAmount  = 20;
+constexpr int kCheckAmount    = 5;
+constexpr int kPaymentAmount  = 5;
+constexpr int kOverdraftFee   = 1;
+
+inline std::string CheckingKey(const std::string& customer) { return "CK_" + customer; }
+inline std::string SavingsKey(const std::string& customer)  { return "SV_" + customer; }
+
+inline int Balance(const std::optional<std::string>& value) {
+    return value.has_value() ? GetIntField(DeserializeRecord(value.value()), "balance") : 0;
+}
+
+// Rewrites only the balance field, keeping any other fields of the record.
+inline void WriteBalance(TransactionManager& mgr, Transaction& txn, const std::string& key,
+                         const std::optional<std::string>& old_value, int balance) {
+    Record rec = old_value.has_value() ? DeserializeRecord(old_value.value()) : Record{};
+    SetIntField(rec, "balance", balance);
+    mgr.Write(txn, key, SerializeRecord(rec));
+}
+
+} // namespace smallbank
+
+// Balance — keys: [SV_c, CK_c]. Read-only total of both accounts.
+inline WorkloadTemplate MakeSmallBankBalanceTemplate() {
+    WorkloadTemplate tmpl{
+        "balance",
+        2,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("balance", keys);
+            mgr.Read(txn, keys[0]);
+            mgr.Read(txn, keys[1]);
+            return mgr.Commit(txn);
+        },
+        15.0
+    };
+    tmpl.access.entries = {
+        {"SV_", AccessMode::kRead, {"balance"}},
+        {"CK_", AccessMode::kRead, {"balance"}},
+    };
+    return tmpl;
+}
+
+// DepositChecking — keys: [CK_c]. Adds kDepositAmount to checking.
+inline WorkloadTemplate MakeSmallBankDepositCheckingTemplate() {
+    WorkloadTemplate tmpl{
+        "deposit_checking",
+        1,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("deposit_checking", keys);
+            auto ck = mgr.Read(txn, keys[0]);
+            smallbank::WriteBalance(mgr, txn, keys[0], ck,
+                                    smallbank::Balance(ck) + smallbank::kDepositAmount);
+            return mgr.Commit(txn);
+        },
+        15.0
+    };
+    tmpl.access.entries = {
+        {"CK_", AccessMode::kIncrement, {"balance"}},
+    };
+    return tmpl;
+}
+
+// TransactSavings — keys: [SV_c]. Adds kSavingsAmount to savings.
+inline WorkloadTemplate MakeSmallBankTransactSavingsTemplate() {
+    WorkloadTemplate tmpl{
+        "transact_savings",
+        1,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("transact_savings", keys);
+            auto sv = mgr.Read(txn, keys[0]);
+            smallbank::WriteBalance(mgr, txn, keys[0], sv,
+                                    smallbank::Balance(sv) + smallbank::kSavingsAmount);
+            return mgr.Commit(txn);
+        },
+        15.0
+    };
+    tmpl.access.entries = {
+        {"SV_", AccessMode::kIncrement, {"balance"}},
+    };
+    return tmpl;
+}
+
+// Amalgamate — keys: [SV_c1, CK_c1, CK_c2]. Moves both of c1's balances
+// into c2's checking account.
+inline WorkloadTemplate MakeSmallBankAmalgamateTemplate() {
+    WorkloadTemplate tmpl{
+        "amalgamate",
+        3,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("amalgamate", keys);
+            auto sv1 = mgr.Read(txn, keys[0]);
+            auto ck1 = mgr.Read(txn, keys[1]);
+            auto ck2 = mgr.Read(txn, keys[2]);
+            int total = smallbank::Balance(sv1) + smallbank::Balance(ck1);
+            smallbank::WriteBalance(mgr, txn, keys[0], sv1, 0);
+            smallbank::WriteBalance(mgr, txn, keys[1], ck1, 0);
+            smallbank::WriteBalance(mgr, txn, keys[2], ck2, smallbank::Balance(ck2) + total);
+            return mgr.Commit(txn);
+        },
+        15.0
+    };
+    tmpl.access.entries = {
+        {"SV_", AccessMode::kReadModifyWrite, {"balance"}},
+        {"CK_", AccessMode::kReadModifyWrite, {"balance"}},
+    };
+    return tmpl;
+}
+
+// WriteCheck — keys: [SV_c, CK_c]. Debits kCheckAmount from checking, plus
+// kOverdraftFee if the customer's combined balance does not cover it.
+inline WorkloadTemplate MakeSmallBankWriteCheckTemplate() {
+    WorkloadTemplate tmpl{
+        "write_check",
+        2,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("write_check", keys);
+            auto sv = mgr.Read(txn, keys[0]);
+            auto ck = mgr.Read(txn, keys[1]);
+            int debit = smallbank::kCheckAmount;
+            if (smallbank::Balance(sv) + smallbank::Balance(ck) < debit) {
+                debit += smallbank::kOverdraftFee;
+            }
+            smallbank::WriteBalance(mgr, txn, keys[1], ck, smallbank::Balance(ck) - debit);
+            return mgr.Commit(txn);
+        },
+        15.0
+    };
+    tmpl.access.entries = {
+        {"SV_", AccessMode::kRead, {"balance"}},
+        {"CK_", AccessMode::kReadModifyWrite, {"balance"}},
+    };
+    return tmpl;
+}
+
+// SendPayment — keys: [CK_c1, CK_c2]. Moves kPaymentAmount between checking
+// accounts. With insufficient funds nothing is written and the (read-only)
+// transaction still commits, standing in for SmallBank's user abort.
+inline WorkloadTemplate MakeSmallBankSendPaymentTemplate() {
+    WorkloadTemplate tmpl{
+        "send_payment",
+        2,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("send_payment", keys);
+            auto ck1 = mgr.Read(txn, keys[0]);
+            auto ck2 = mgr.Read(txn, keys[1]);
+            int from = smallbank::Balance(ck1);
+            if (from >= smallbank::kPaymentAmount) {
+                smallbank::WriteBalance(mgr, txn, keys[0], ck1, from - smallbank::kPaymentAmount);
+                smallbank::WriteBalance(mgr, txn, keys[1], ck2,
+                                        smallbank::Balance(ck2) + smallbank::kPaymentAmount);
+            }
+            return mgr.Commit(txn);
+        },
+        25.0
+    };
+    tmpl.access.entries = {
+        {"CK_", AccessMode::kReadModifyWrite, {"balance"}},
+    };
+    return tmpl;
+}
+
+} // namespace txn
+
+#endif // SMALLBANK_TEMPLATES_H
@@ -0,0 +1,229 @@
+#include "workload/soak_runner.h"
+#include "workload/workload_builder.h"
+#include "workload/workload_executor.h"
+#include "workload/input_parser.h"
+#include "concurrency/manager_factory.h"
+#include "database/database.h"
+#include "metrics/metrics.h"
+#include "metrics/latency_histogram.h"
+#include "metrics/stats.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+namespace txn {
+
+namespace {
+
+// Resident set size of this process in bytes (0 if unavailable).
+uint64_t ResidentSetBytes() {
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#else
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size_pages = 0, resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) return 0;
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// One time series sampled over the soak run.
+struct Series {
+    std::string name;
+    std::vector<double> values;
+};
+
+} // anonymous namespace
+
+int RunSoak(const SoakConfig& config) {
+    ParseResult parsed = LoadWorkloadInput(config.workload, config.workload_options);
+    auto templates = BuildWorkloadTemplates(config.workload, parsed, config.hotset_size,
+                                            config.hotset_prob, config.workload_options);
+    if (templates.empty()) {
+        std::cerr << "Unknown workload: " << config.workload << "\n";
+        return 2;
+    }
+
+    std::filesystem::remove_all(config.db_path);
+    Database db;
+    if (!db.Open(config.db_path)) {
+        std::cerr << "Failed to open database: " << config.db_path << "\n";
+        return 2;
+    }
+    db.InitializeWithData(parsed.initial_data);
+
+    auto mgr = MakeTransactionManager(config.protocol, db);
+    if (!mgr) {
+        std::cerr << "Unknown protocol: " << config.protocol << "\n";
+        return 2;
+    }
+
+    std::ofstream csv(config.output);
+    if (!csv.is_open()) {
+        std::cerr << "Cannot open soak output: " << config.output << "\n";
+        return 2;
+    }
+
+    MetricsCollector metrics;
+    metrics.SetLatencyReservoir(config.latency_reservoir);
+    metrics.EnableLatencyWindow();
+
+    ExecutorConfig exec_config;
+    exec_config.num_threads = config.threads;
+    exec_config.duration_s  = config.duration_s;
+    exec_config.contention  = {static_cast<int>(parsed.initial_data.size()),
+                               config.hotset_size, config.hotset_prob};
+    exec_config.templates   = templates;
+
+    // Fixed series first, then whatever the manager reports
+    std::vector<Series> series = {
+        {"throughput_tps", {}}, {"abort_pct", {}}, {"p99_us", {}}, {"rss_bytes", {}},
+        {"latency_samples", {}}, {"pending_compaction_bytes", {}},
+    };
+    for (const auto& [name, _] : mgr->StructureSizes()) {
+        series.push_back({name, {}});
+    }
+    std::vector<double> times;
+
+    csv << "elapsed_s";
+    for (const auto& s : series) csv << "," << s.name;
+    csv << "\n" << std::fixed << std::setprecision(3);
+
+    std::cout << "Soak: workload " << config.workload << ", " << config.protocol << ", "
+              << config.threads << " threads, " << config.duration_s << " s, sampling every "
+              << config.sample_interval_s << " s\n"
+              << "Samples: " << config.output << "\n\n";
+
+    WorkloadExecutor executor(*mgr, metrics, exec_config);
+    std::atomic<bool> done{false};
+    std::thread runner([&]() {
+        executor.Run();
+        done.store(true);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    auto last = start;
+    uint64_t last_commits = 0, last_aborts = 0;
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(config.sample_interval_s));
+    auto next = start + interval;
+
+    while (true) {
+        // Sleep in short steps so the final partial interval is not overslept
+        while (!done.load() && std::chrono::steady_clock::now() < next) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        bool finished = done.load();
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last).count();
+        double t  = std::chrono::duration<double>(now - start).count();
+        // A trailing sliver of an interval is too noisy to keep
+        if (finished && dt < config.sample_interval_s * 0.5) break;
+
+        uint64_t commits = metrics.TotalCommits();
+        uint64_t aborts  = metrics.TotalAborts();
+        uint64_t dc = commits - last_commits;
+        uint64_t da = aborts - last_aborts;
+
+        std::vector<double> row = {
+            dt > 0.0 ? dc / dt : 0.0,
+            (dc + da) > 0 ? 100.0 * da / (dc + da) : 0.0,
+            LatencyHistogram::Percentile(metrics.DrainLatencyWindow(), 99.0),
+            static_cast<double>(ResidentSetBytes()),
+            static_cast<double>(metrics.RetainedLatencySamples()),
+            static_cast<double>(db.GetIntProperty("rocksdb.estimate-pending-compaction-bytes")
+                                    .value_or(0)),
+        };
+        for (const auto& [_, size] : mgr->StructureSizes()) {
+            row.push_back(static_cast<double>(size));
+        }
+
+        times.push_back(t);
+        csv << t;
+        for (size_t i = 0; i < series.size() && i < row.size(); i++) {
+            series[i].values.push_back(row[i]);
+            csv << "," << row[i];
+        }
+        csv << "\n";
+        csv.flush();
+
+        std::cout << "[soak " << std::fixed << std::setprecision(0) << std::setw(6) << t << " s] "
+                  << std::setprecision(1) << row[0] << " txn/s  abort " << row[1]
+                  << "%  p99 " << row[2] << " us  rss " << std::setprecision(1)
+                  << row[3] / (1024.0 * 1024.0) << " MiB\n";
+        std::cout.unsetf(std::ios::floatfield);
+
+        last = now;
+        last_commits = commits;
+        last_aborts  = aborts;
+        next += interval;
+        if (finished) break;
+    }
+    runner.join();
+
+    metrics.PrintReport(executor.ElapsedSeconds());
+
+    // Drift analysis over post-warm-up samples
+    size_t skip = static_cast<size_t>(times.size() * config.warmup_fraction);
+    std::vector<double> x(times.begin() + skip, times.end());
+    std::cout << "\n--- Drift Analysis (" << x.size() << " samples after warm-up) ---\n";
+    if (x.size() < 3) {
+        std::cout << "  Not enough samples; run longer or lower --sample-interval.\n";
+        db.Close();
+        std::filesystem::remove_all(config.db_path);
+        return 0;
+    }
+
+    double span = x.back() - x.front();
+    int drifting = 0;
+    std::cout << "  " << std::left << std::setw(26) << "series" << std::right
+              << std::setw(16) << "mean" << std::setw(16) << "slope/hour"
+              << std::setw(12) << "change %" << std::setw(12) << "p-value" << "  verdict\n";
+    for (const auto& s : series) {
+        std::vector<double> y(s.values.begin() + skip, s.values.end());
+        TrendResult trend = LinearTrend(x, y);
+        double mean = Mean(y);
+        double change_pct = mean != 0.0 ? 100.0 * trend.slope * span / std::fabs(mean)
+                          : (trend.slope != 0.0 ? INFINITY : 0.0);
+        bool drift = trend.p_value < config.alpha
+                  && std::fabs(change_pct) > config.drift_threshold_pct;
+        if (drift) drifting++;
+
+        std::cout << "  " << std::left << std::setw(26) << s.name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(16) << mean
+                  << std::setw(16) << trend.slope * 3600.0
+                  << std::showpos << std::setw(12) << change_pct << std::noshowpos
+                  << std::setprecision(4) << std::setw(12) << trend.p_value
+                  << "  " << (drift ? "DRIFT" : "stable") << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+
+    db.Close();
+    std::filesystem::remove_all(config.db_path);
+
+    if (drifting > 0) {
+        std::cout << "\n" << drifting << " series drifted by more than "
+                  << config.drift_threshold_pct << "% (p < " << config.alpha << ").\n";
+        return 1;
+    }
+    std::cout << "\nNo significant drift.\n";
+    return 0;
+}
+
+} // namespace txn
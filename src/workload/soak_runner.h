@@ -0,0 +1,43 @@
+#ifndef SOAK_RUNNER_H
+#define SOAK_RUNNER_H
+
+#include <cstddef>
+#include <string>
+#include "workload/workload_builder.h"
+
+namespace txn {
+
+struct SoakConfig {
+    std::string workload = "1";
+    std::string protocol = "occ";
+    int threads          = 4;
+    int hotset_size      = 10;
+    double hotset_prob   = 0.5;
+    std::string db_path  = "tmp_db_soak";
+    WorkloadOptions workload_options;   // generated workloads (smallbank, ycsb-*)
+
+    double duration_s        = 3600.0;
+    double sample_interval_s = 10.0;
+    size_t latency_reservoir = 100000;  // retained latency samples per txn type
+
+    std::string output = "results/soak_samples.csv";  // one row per sample (overwritten)
+
+    // Drift is flagged when a series' fitted trend changes it by more than
+    // drift_threshold_pct over the run and the slope is significant at alpha.
+    // The first warmup_fraction of samples is excluded from the fit.
+    double drift_threshold_pct = 5.0;
+    double alpha               = 0.01;
+    double warmup_fraction     = 0.1;
+};
+
+// Runs one workload for duration_s with bounded metrics memory: latencies go
+// into a fixed-size reservoir plus a per-interval histogram. Every
+// sample_interval_s it records throughput, abort rate and p99 for that
+// interval, process RSS, manager structure sizes and RocksDB compaction debt.
+// At the end each series is tested for a linear trend.
+// Returns 0 if no drift was detected, 1 if any series drifted, 2 on setup errors.
+int RunSoak(const SoakConfig& config);
+
+} // namespace txn
+
+#endif // SOAK_RUNNER_H
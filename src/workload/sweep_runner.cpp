@@ -0,0 +1,153 @@
+#include "workload/sweep_runner.h"
+#include "workload/workload_builder.h"
+#include "workload/workload_executor.h"
+#include "workload/input_parser.h"
+#include "concurrency/manager_factory.h"
+#include "database/database.h"
+#include "metrics/metrics.h"
+#include "metrics/stats.h"
+#include "metrics/run_record.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace txn {
+
+namespace {
+
+struct RunSample {
+    double throughput_tps;
+    double abort_pct;
+    double p50_us;
+    double p99_us;
+};
+
+void WriteSweepRow(std::ofstream& file, const std::string& workload, const std::string& protocol,
+                   int threads, double hotset_prob, const std::vector<RunSample>& samples) {
+    std::vector<double> tps, aborts, p50, p99;
+    for (const auto& s : samples) {
+        tps.push_back(s.throughput_tps);
+        aborts.push_back(s.abort_pct);
+        p50.push_back(s.p50_us);
+        p99.push_back(s.p99_us);
+    }
+
+    file << workload    << ","
+         << protocol    << ","
+         << threads     << ","
+         << hotset_prob << ","
+         << samples.size() << ","
+         << Mean(tps)    << "," << ConfidenceHalfWidth95(tps)    << ","
+         << Mean(aborts) << "," << ConfidenceHalfWidth95(aborts) << ","
+         << Mean(p50)    << "," << ConfidenceHalfWidth95(p50)    << ","
+         << Mean(p99)    << "," << ConfidenceHalfWidth95(p99)    << "\n";
+    file.flush();
+}
+
+} // anonymous namespace
+
+int RunSweep(const SweepConfig& config) {
+    std::ofstream out = AppendCsv(config.output,
+        "workload,protocol,threads,hotset_prob,repeats,"
+        "throughput_mean,throughput_ci95,abort_pct_mean,abort_pct_ci95,"
+        "p50_us_mean,p50_us_ci95,p99_us_mean,p99_us_ci95");
+    if (!out.is_open()) {
+        std::cerr << "Cannot open sweep output: " << config.output << "\n";
+        return 1;
+    }
+    out << std::fixed << std::setprecision(6);
+
+    size_t total = config.workloads.size() * config.protocols.size()
+                 * config.threads.size() * config.hotset_probs.size();
+    size_t config_num = 0;
+
+    for (const auto& workload : config.workloads) {
+        // Load once per workload
+        ParseResult parsed = LoadWorkloadInput(workload, config.workload_options);
+        std::string db_path = config.db_prefix + "_w" + workload + "_sweep";
+        std::filesystem::remove_all(db_path);
+
+        Database db;
+        if (!db.Open(db_path)) {
+            std::cerr << "Failed to open database: " << db_path << "\n";
+            return 1;
+        }
+        db.InitializeWithData(parsed.initial_data);
+        const auto snapshot = db.Dump();
+
+        for (const auto& protocol : config.protocols) {
+            for (int threads : config.threads) {
+                for (double hotset_prob : config.hotset_probs) {
+                    config_num++;
+
+                    std::vector<RunSample> samples;
+                    for (int rep = 0; rep < config.repeats; rep++) {
+                        db.Restore(snapshot);
+                        // Rebuilt per run: insert counters must match the restored data
+                        auto templates = BuildWorkloadTemplates(workload, parsed, config.hotset_size,
+                                                                hotset_prob, config.workload_options);
+                        if (templates.empty()) {
+                            std::cerr << "Unknown workload: " << workload << "\n";
+                            return 1;
+                        }
+                        auto mgr = MakeTransactionManager(protocol, db, config.manager_options);
+                        if (!mgr) {
+                            std::cerr << "Unknown protocol: " << protocol << "\n";
+                            return 1;
+                        }
+
+                        ExecutorConfig exec_config;
+                        exec_config.num_threads     = threads;
+                        exec_config.txns_per_thread = config.txns_per_thread;
+                        exec_config.contention      = {static_cast<int>(parsed.initial_data.size()),
+                                                       config.hotset_size, hotset_prob};
+                        exec_config.templates       = templates;
+
+                        MetricsCollector metrics;
+                        WorkloadExecutor executor(*mgr, metrics, exec_config);
+                        executor.Run();
+
+                        RunRecord record;
+                        record.workload        = workload;
+                        record.protocol        = protocol;
+                        record.threads         = threads;
+                        record.txns_per_thread = config.txns_per_thread;
+                        record.hotset_size     = config.hotset_size;
+                        record.hotset_prob     = hotset_prob;
+                        record.repeat          = rep;
+                        FillRunRecord(record, metrics, executor.ElapsedSeconds());
+                        if (!config.record_path.empty()) {
+                            AppendRunRecord(config.record_path, record);
+                        }
+
+                        samples.push_back({record.throughput_tps, record.abort_pct,
+                                           record.p50_us, record.p99_us});
+                    }
+
+                    WriteSweepRow(out, workload, protocol, threads, hotset_prob, samples);
+
+                    std::vector<double> tps;
+                    for (const auto& s : samples) tps.push_back(s.throughput_tps);
+                    std::cout << "[" << config_num << "/" << total << "] workload=" << workload
+                              << " protocol=" << protocol << " threads=" << threads
+                              << " hotset_prob=" << hotset_prob << ": "
+                              << std::fixed << std::setprecision(1) << Mean(tps) << " ± "
+                              << ConfidenceHalfWidth95(tps) << " txn/s\n";
+                    std::cout.unsetf(std::ios::floatfield);
+                }
+            }
+        }
+
+        db.Close();
+        std::filesystem::remove_all(db_path);
+    }
+
+    std::cout << "Sweep results appended to " << config.output << "\n";
+    if (!config.record_path.empty()) {
+        std::cout << "Run records appended to " << config.record_path << "\n";
+    }
+    return 0;
+}
+
+} // namespace txn
@@ -0,0 +1,36 @@
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+#include <string>
+#include <vector>
+#include "concurrency/manager_factory.h"
+#include "workload/workload_builder.h"
+
+namespace txn {
+
+struct SweepConfig {
+    std::vector<std::string> workloads = {"1"};
+    std::vector<std::string> protocols = {"occ"};
+    std::vector<int> threads           = {4};
+    std::vector<double> hotset_probs   = {0.5};
+    int hotset_size     = 10;
+    int txns_per_thread = 100;
+    int repeats         = 5;
+    std::string db_prefix = "tmp_db";                      // DB dir: <prefix>_w<N>_sweep
+    std::string output    = "results/sweep_results.csv";   // appended; header on first write
+    std::string record_path;                               // JSON run record per repeat; empty = off
+    WorkloadOptions workload_options;                      // generated workloads (smallbank, ycsb-*)
+    ManagerOptions manager_options;                        // every run's manager, whatever its protocol
+};
+
+// Runs every workload x protocol x threads x hotset_prob combination
+// `repeats` times inside this process. Each workload's data is loaded once and
+// restored from an in-memory snapshot before every run, so configurations do
+// not pay for process start-up or a full reload. Writes one CSV row per
+// configuration with means and 95% confidence half-widths.
+// Returns a process exit code.
+int RunSweep(const SweepConfig& config);
+
+} // namespace txn
+
+#endif // SWEEP_RUNNER_H
@@ -0,0 +1,436 @@
+#ifndef TPCC_TEMPLATES_H
+#define TPCC_TEMPLATES_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "workload/workload_template.h"
+#include "workload/record.h"
+
+namespace txn {
+
+// Full TPC-C transaction mix (new_order 45, payment 43, order_status 4,
+// delivery 4, stock_level 4) over generated data. Defaults are the spec's
+// per-warehouse cardinalities; scale them down for quick runs.
+struct TpccConfig {
+    int warehouses              = 1;
+    int districts_per_warehouse = 10;
+    int customers_per_district  = 3000;
+    int items                   = 100000;
+    int orders_per_district     = 3000;  // initial orders; the last 30% are undelivered
+};
+
+// Money is in whole dollars so the int fields stay far from overflow.
+// Keys (all ids 1-based):
+//   W_w          warehouse         {ytd, tax}
+//   D_w_d        district          {ytd, tax, next_o_id}
+//   C_w_d_c      customer          {last, balance, ytd_payment, payment_cnt, delivery_cnt}
+//   CL_w_d_LAST  last-name index   {ids: comma-separated customer ids}
+//   CO_w_d_c     customer's latest order {o_id}
+//   I_i          item              {price}
+//   S_w_i        stock             {qty, ytd, order_cnt, remote_cnt}
+//   O_w_d_o      order             {c_id, carrier_id, ol_cnt, all_local}
+//   NO_w_d_o     new-order entry   {o_id, delivered}
+//   OL_w_d_o_n   order line        {i_id, supply_w_id, quantity, amount, delivered}
+//   DP_w_d       delivery cursor   {next_o_id}: oldest undelivered order
+//   H_w_d_c_n    history           {w_id, d_id, amount}
+// The store has no range scans or deletes, so the index, latest-order and
+// delivery-cursor records stand in for the secondary index, the max(o_id)
+// lookup and the min(NO_O_ID) scan; delivered new-order entries are flagged
+// rather than deleted.
+//
+// Keys that depend on data read inside the transaction (orders, order lines,
+// customers found by last name) are not declared to Begin; 2PL locks them on
+// first touch and OCC validates them like any other read.
+namespace tpcc {
+
+inline std::string WarehouseKey(int w) { return "W_" + std::to_string(w); }
+inline std::string DistrictKey(int w, int d) {
+    return "D_" + std::to_string(w) + "_" + std::to_string(d);
+}
+inline std::string CustomerKey(int w, int d, int c) {
+    return "C_" + std::to_string(w) + "_" + std::to_string(d) + "_" + std::to_string(c);
+}
+inline std::string CustomerNameKey(int w, int d, const std::string& last) {
+    return "CL_" + std::to_string(w) + "_" + std::to_string(d) + "_" + last;
+}
+inline std::string CustomerLastOrderKey(int w, int d, int c) {
+    return "CO_" + std::to_string(w) + "_" + std::to_string(d) + "_" + std::to_string(c);
+}
+inline std::string ItemKey(int i) { return "I_" + std::to_string(i); }
+inline std::string StockKey(int w, int i) {
+    return "S_" + std::to_string(w) + "_" + std::to_string(i);
+}
+inline std::string OrderKey(int w, int d, int o) {
+    return "O_" + std::to_string(w) + "_" + std::to_string(d) + "_" + std::to_string(o);
+}
+inline std::string NewOrderKey(int w, int d, int o) {
+    return "NO_" + std::to_string(w) + "_" + std::to_string(d) + "_" + std::to_string(o);
+}
+inline std::string OrderLineKey(int w, int d, int o, int n) {
+    return "OL_" + std::to_string(w) + "_" + std::to_string(d) + "_" + std::to_string(o)
+         + "_" + std::to_string(n);
+}
+inline std::string DeliveryCursorKey(int w, int d) {
+    return "DP_" + std::to_string(w) + "_" + std::to_string(d);
+}
+inline std::string HistoryKey(int w, int d, int c, uint64_t n) {
+    return "H_" + std::to_string(w) + "_" + std::to_string(d) + "_" + std::to_string(c)
+         + "_" + std::to_string(n);
+}
+
+// Numeric ids of a key after its prefix: "OL_1_2_30_4" -> {1, 2, 30, 4}.
+// Non-numeric parts (a last name) are skipped.
+inline std::vector<int> KeyIds(const std::string& key) {
+    std::vector<int> ids;
+    size_t pos = key.find('_');
+    while (pos != std::string::npos) {
+        size_t next = key.find('_', pos + 1);
+        std::string part = key.substr(pos + 1, next == std::string::npos ? next : next - pos - 1);
+        char* end = nullptr;
+        long v = std::strtol(part.c_str(), &end, 10);
+        if (!part.empty() && *end == '\0') ids.push_back(static_cast<int>(v));
+        pos = next;
+    }
+    return ids;
+}
+
+// Customer last name for n in [0, 999]: three syllables picked by its digits.
+inline std::string LastName(int n) {
+    static const char* kSyllables[] = {"BAR", "OUGHT", "ABLE", "PRI", "PRES",
+                                       "ESE", "ANTI", "CALLY", "ATION", "EING"};
+    return std::string(kSyllables[n / 100]) + kSyllables[(n / 10) % 10] + kSyllables[n % 10];
+}
+
+// Non-uniform random NURand(A, x, y) from the spec, with a fixed C per A.
+inline int NURand(std::mt19937& rng, int a, int x, int y) {
+    int c = a == 255 ? 157 : (a == 1023 ? 259 : 7911);
+    std::uniform_int_distribution<int> r_a(0, a);
+    std::uniform_int_distribution<int> r_xy(x, y);
+    return (((r_a(rng) | r_xy(rng)) + c) % (y - x + 1)) + x;
+}
+
+// Quantities and amounts chosen during execution; execute() has no RNG of its own.
+inline int Uniform(int lo, int hi) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+inline Record Load(TransactionManager& mgr, Transaction& txn, const std::string& key) {
+    auto val = mgr.Read(txn, key);
+    return val.has_value() ? DeserializeRecord(val.value()) : Record{};
+}
+
+inline void Store(TransactionManager& mgr, Transaction& txn, const std::string& key,
+                  const Record& rec) {
+    mgr.Write(txn, key, SerializeRecord(rec));
+}
+
+// Resolves a customer key: C_* as is, CL_* via the last-name index, taking
+// the middle match as the spec requires. "" if no customer has that name.
+inline std::string ResolveCustomer(TransactionManager& mgr, Transaction& txn,
+                                   const std::string& key) {
+    if (key.rfind("CL_", 0) != 0) return key;
+    Record index = Load(mgr, txn, key);
+    std::vector<int> ids;
+    const std::string& list = index["ids"];
+    for (size_t pos = 0; pos < list.size();) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        ids.push_back(std::atoi(list.substr(pos, comma - pos).c_str()));
+        pos = comma + 1;
+    }
+    if (ids.empty()) return "";
+    auto wd = KeyIds(key);
+    return CustomerKey(wd[0], wd[1], ids[(ids.size() - 1) / 2]);
+}
+
+} // namespace tpcc
+
+// new_order — keys: [W, D, C, CO, I_1..I_n, S_1..S_n] for n order lines.
+// Takes the order id from the district, inserts the order, its new-order
+// entry and n order lines, and updates stock (remote if S's warehouse != W).
+inline WorkloadTemplate MakeTpccNewOrderTemplate() {
+    WorkloadTemplate tmpl{
+        "new_order",
+        0,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            using namespace tpcc;
+            auto txn = mgr.Begin("new_order", keys);
+            auto wd = KeyIds(keys[1]);
+            int w = wd[0], d = wd[1];
+            int c = KeyIds(keys[2])[2];
+            int n = static_cast<int>(keys.size() - 4) / 2;
+
+            Load(mgr, txn, keys[0]);  // warehouse tax
+            Record district = Load(mgr, txn, keys[1]);
+            int o = GetIntField(district, "next_o_id");
+            SetIntField(district, "next_o_id", o + 1);
+            Store(mgr, txn, keys[1], district);
+            Load(mgr, txn, keys[2]);  // customer discount
+
+            bool all_local = true;
+            for (int k = 0; k < n; k++) {
+                if (KeyIds(keys[4 + n + k])[0] != w) all_local = false;
+            }
+
+            Record order;
+            SetIntField(order, "c_id", c);
+            SetIntField(order, "carrier_id", 0);
+            SetIntField(order, "ol_cnt", n);
+            SetIntField(order, "all_local", all_local ? 1 : 0);
+            Store(mgr, txn, OrderKey(w, d, o), order);
+
+            Record new_order;
+            SetIntField(new_order, "o_id", o);
+            SetIntField(new_order, "delivered", 0);
+            Store(mgr, txn, NewOrderKey(w, d, o), new_order);
+
+            Record last_order;
+            SetIntField(last_order, "o_id", o);
+            Store(mgr, txn, keys[3], last_order);
+
+            for (int k = 0; k < n; k++) {
+                const std::string& item_key  = keys[4 + k];
+                const std::string& stock_key = keys[4 + n + k];
+                int supply_w = KeyIds(stock_key)[0];
+                int quantity = Uniform(1, 10);
+
+                Record item  = Load(mgr, txn, item_key);
+                Record stock = Load(mgr, txn, stock_key);
+                int qty = GetIntField(stock, "qty");
+                SetIntField(stock, "qty", qty >= quantity + 10 ? qty - quantity : qty - quantity + 91);
+                SetIntField(stock, "ytd", GetIntField(stock, "ytd") + quantity);
+                SetIntField(stock, "order_cnt", GetIntField(stock, "order_cnt") + 1);
+                if (supply_w != w) {
+                    SetIntField(stock, "remote_cnt", GetIntField(stock, "remote_cnt") + 1);
+                }
+                Store(mgr, txn, stock_key, stock);
+
+                Record line;
+                SetIntField(line, "i_id", KeyIds(item_key)[0]);
+                SetIntField(line, "supply_w_id", supply_w);
+                SetIntField(line, "quantity", quantity);
+                SetIntField(line, "amount", quantity * GetIntField(item, "price"));
+                SetIntField(line, "delivered", 0);
+                Store(mgr, txn, OrderLineKey(w, d, o, k + 1), line);
+            }
+
+            return mgr.Commit(txn);
+        },
+        45.0
+    };
+    tmpl.access.entries = {
+        {"W_", AccessMode::kRead, {"tax"}},
+        {"D_", AccessMode::kReadModifyWrite, {"next_o_id"}},
+        {"C_", AccessMode::kRead, {}},
+        {"CO_", AccessMode::kWrite, {"o_id"}},
+        {"I_", AccessMode::kRead, {"price"}},
+        {"S_", AccessMode::kReadModifyWrite, {"qty", "ytd", "order_cnt", "remote_cnt"}},
+        {"O_", AccessMode::kWrite, {"c_id", "carrier_id", "ol_cnt", "all_local"}},
+        {"NO_", AccessMode::kWrite, {"o_id", "delivered"}},
+        {"OL_", AccessMode::kWrite, {"i_id", "supply_w_id", "quantity", "amount", "delivered"}},
+    };
+    return tmpl;
+}
+
+// payment — keys: [W, D, C or CL]. The customer may belong to another
+// warehouse (remote payment) and may be looked up by last name.
+inline WorkloadTemplate MakeTpccPaymentTemplate() {
+    WorkloadTemplate tmpl{
+        "payment",
+        0,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            using namespace tpcc;
+            auto txn = mgr.Begin("payment", keys);
+            int amount = Uniform(1, 5000);
+
+            Record warehouse = Load(mgr, txn, keys[0]);
+            SetIntField(warehouse, "ytd", GetIntField(warehouse, "ytd") + amount);
+            Store(mgr, txn, keys[0], warehouse);
+
+            Record district = Load(mgr, txn, keys[1]);
+            SetIntField(district, "ytd", GetIntField(district, "ytd") + amount);
+            Store(mgr, txn, keys[1], district);
+
+            std::string customer_key = ResolveCustomer(mgr, txn, keys[2]);
+            if (!customer_key.empty()) {
+                Record customer = Load(mgr, txn, customer_key);
+                SetIntField(customer, "balance", GetIntField(customer, "balance") - amount);
+                SetIntField(customer, "ytd_payment", GetIntField(customer, "ytd_payment") + amount);
+                SetIntField(customer, "payment_cnt", GetIntField(customer, "payment_cnt") + 1);
+                Store(mgr, txn, customer_key, customer);
+
+                static std::atomic<uint64_t> history_seq{0};
+                auto cid = KeyIds(customer_key);
+                auto wd = KeyIds(keys[1]);
+                Record history;
+                SetIntField(history, "w_id", wd[0]);
+                SetIntField(history, "d_id", wd[1]);
+                SetIntField(history, "amount", amount);
+                Store(mgr, txn, HistoryKey(cid[0], cid[1], cid[2], ++history_seq), history);
+            }
+
+            return mgr.Commit(txn);
+        },
+        43.0
+    };
+    tmpl.access.entries = {
+        {"W_", AccessMode::kIncrement, {"ytd"}},
+        {"D_", AccessMode::kIncrement, {"ytd"}},
+        {"CL_", AccessMode::kRead, {"ids"}},
+        {"C_", AccessMode::kReadModifyWrite, {"balance", "ytd_payment", "payment_cnt"}},
+        {"H_", AccessMode::kWrite, {"w_id", "d_id", "amount"}},
+    };
+    return tmpl;
+}
+
+// order_status — keys: [C or CL]. Reads the customer, their latest order and
+// its order lines.
+inline WorkloadTemplate MakeTpccOrderStatusTemplate() {
+    WorkloadTemplate tmpl{
+        "order_status",
+        0,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            using namespace tpcc;
+            auto txn = mgr.Begin("order_status", keys);
+
+            std::string customer_key = ResolveCustomer(mgr, txn, keys[0]);
+            if (!customer_key.empty()) {
+                Load(mgr, txn, customer_key);
+                auto ids = KeyIds(customer_key);
+                int w = ids[0], d = ids[1], c = ids[2];
+                int o = GetIntField(Load(mgr, txn, CustomerLastOrderKey(w, d, c)), "o_id");
+                if (o > 0) {
+                    int ol_cnt = GetIntField(Load(mgr, txn, OrderKey(w, d, o)), "ol_cnt");
+                    for (int n = 1; n <= ol_cnt; n++) Load(mgr, txn, OrderLineKey(w, d, o, n));
+                }
+            }
+
+            return mgr.Commit(txn);
+        },
+        4.0
+    };
+    tmpl.access.entries = {
+        {"CL_", AccessMode::kRead, {"ids"}},
+        {"C_", AccessMode::kRead, {}},
+        {"CO_", AccessMode::kRead, {"o_id"}},
+        {"O_", AccessMode::kRead, {"ol_cnt"}},
+        {"OL_", AccessMode::kRead, {}},
+    };
+    return tmpl;
+}
+
+// delivery — keys: [DP_w_1 .. DP_w_D]. For each district, delivers the oldest
+// undelivered order: flags its new-order entry, sets the carrier, marks the
+// order lines delivered and credits their total to the customer.
+inline WorkloadTemplate MakeTpccDeliveryTemplate() {
+    WorkloadTemplate tmpl{
+        "delivery",
+        0,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            using namespace tpcc;
+            auto txn = mgr.Begin("delivery", keys);
+            int carrier = Uniform(1, 10);
+
+            for (const auto& cursor_key : keys) {
+                auto wd = KeyIds(cursor_key);
+                int w = wd[0], d = wd[1];
+                Record cursor = Load(mgr, txn, cursor_key);
+                int o = GetIntField(cursor, "next_o_id");
+
+                auto no_val = mgr.Read(txn, NewOrderKey(w, d, o));
+                if (!no_val.has_value()) continue;  // nothing to deliver in this district
+                Record new_order = DeserializeRecord(no_val.value());
+                SetIntField(new_order, "delivered", 1);
+                Store(mgr, txn, NewOrderKey(w, d, o), new_order);
+
+                Record order = Load(mgr, txn, OrderKey(w, d, o));
+                SetIntField(order, "carrier_id", carrier);
+                Store(mgr, txn, OrderKey(w, d, o), order);
+
+                int total = 0;
+                for (int n = 1; n <= GetIntField(order, "ol_cnt"); n++) {
+                    std::string line_key = OrderLineKey(w, d, o, n);
+                    Record line = Load(mgr, txn, line_key);
+                    total += GetIntField(line, "amount");
+                    SetIntField(line, "delivered", 1);
+                    Store(mgr, txn, line_key, line);
+                }
+
+                std::string customer_key = CustomerKey(w, d, GetIntField(order, "c_id"));
+                Record customer = Load(mgr, txn, customer_key);
+                SetIntField(customer, "balance", GetIntField(customer, "balance") + total);
+                SetIntField(customer, "delivery_cnt", GetIntField(customer, "delivery_cnt") + 1);
+                Store(mgr, txn, customer_key, customer);
+
+                SetIntField(cursor, "next_o_id", o + 1);
+                Store(mgr, txn, cursor_key, cursor);
+            }
+
+            return mgr.Commit(txn);
+        },
+        4.0
+    };
+    tmpl.access.entries = {
+        {"DP_", AccessMode::kReadModifyWrite, {"next_o_id"}},
+        {"NO_", AccessMode::kReadModifyWrite, {"delivered"}},
+        {"O_", AccessMode::kReadModifyWrite, {"c_id", "carrier_id", "ol_cnt"}},
+        {"OL_", AccessMode::kReadModifyWrite, {"amount", "delivered"}},
+        {"C_", AccessMode::kReadModifyWrite, {"balance", "delivery_cnt"}},
+    };
+    return tmpl;
+}
+
+// stock_level — keys: [D]. Counts distinct items in the district's last 20
+// orders whose home-warehouse stock is below a random threshold in [10, 20].
+inline WorkloadTemplate MakeTpccStockLevelTemplate() {
+    WorkloadTemplate tmpl{
+        "stock_level",
+        0,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            using namespace tpcc;
+            auto txn = mgr.Begin("stock_level", keys);
+            auto wd = KeyIds(keys[0]);
+            int w = wd[0], d = wd[1];
+            int threshold = Uniform(10, 20);
+
+            int next_o = GetIntField(Load(mgr, txn, keys[0]), "next_o_id");
+            std::set<int> items;
+            for (int o = std::max(1, next_o - 20); o < next_o; o++) {
+                int ol_cnt = GetIntField(Load(mgr, txn, OrderKey(w, d, o)), "ol_cnt");
+                for (int n = 1; n <= ol_cnt; n++) {
+                    items.insert(GetIntField(Load(mgr, txn, OrderLineKey(w, d, o, n)), "i_id"));
+                }
+            }
+            int low_stock = 0;
+            for (int i : items) {
+                if (GetIntField(Load(mgr, txn, StockKey(w, i)), "qty") < threshold) low_stock++;
+            }
+            (void)low_stock;
+
+            return mgr.Commit(txn);
+        },
+        4.0
+    };
+    tmpl.access.entries = {
+        {"D_", AccessMode::kRead, {"next_o_id"}},
+        {"O_", AccessMode::kRead, {"ol_cnt"}},
+        {"OL_", AccessMode::kRead, {"i_id"}},
+        {"S_", AccessMode::kRead, {"qty"}},
+    };
+    return tmpl;
+}
+
+} // namespace txn
+
+#endif // TPCC_TEMPLATES_H
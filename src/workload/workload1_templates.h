@@ -6,11 +6,26 @@
 
 namespace txn {
 
+// Moves 1 from the first account to the second, given both values as read.
+inline void ApplyW1Transfer(TransactionManager& mgr, Transaction& txn,
+                            const std::vector<std::string>& keys,
+                            const std::optional<std::string>& val_a,
+                            const std::optional<std::string>& val_b) {
+    Record rec_a = val_a.has_value() ? DeserializeRecord(val_a.value()) : Record{};
+    Record rec_b = val_b.has_value() ? DeserializeRecord(val_b.value()) : Record{};
+
+    SetIntField(rec_a, "balance", GetIntField(rec_a, "balance") - 1);
+    SetIntField(rec_b, "balance", GetIntField(rec_b, "balance") + 1);
+
+    mgr.Write(txn, keys[0], SerializeRecord(rec_a));
+    mgr.Write(txn, keys[1], SerializeRecord(rec_b));
+}
+
 // Transfer template for workload 1.
 // Keys: [A_src, A_dst] — decrements src balance by 1, increments dst balance by 1.
 // key_builder must be injected in main.cpp with account_keys.
 inline WorkloadTemplate MakeW1TransferTemplate() {
-    return {
+    WorkloadTemplate tmpl{
         "transfer",
         2,
         nullptr, // key_builder injected in main.cpp
@@ -19,19 +34,26 @@ inline WorkloadTemplate MakeW1TransferTemplate() {
 
             auto val_a = mgr.Read(txn, keys[0]);
             auto val_b = mgr.Read(txn, keys[1]);
-
-            Record rec_a = val_a.has_value() ? DeserializeRecord(val_a.value()) : Record{};
-            Record rec_b = val_b.has_value() ? DeserializeRecord(val_b.value()) : Record{};
-
-            SetIntField(rec_a, "balance", GetIntField(rec_a, "balance") - 1);
-            SetIntField(rec_b, "balance", GetIntField(rec_b, "balance") + 1);
-
-            mgr.Write(txn, keys[0], SerializeRecord(rec_a));
-            mgr.Write(txn, keys[1], SerializeRecord(rec_b));
+            ApplyW1Transfer(mgr, txn, keys, val_a, val_b);
 
             return mgr.Commit(txn);
         }
     };
+    // Both balances are fetched with one awaited read, and the commit is
+    // awaited through the manager's commit pipeline
+    tmpl.async_execute = [](TransactionManager& mgr, AsyncIo& io,
+                            std::vector<std::string> keys) -> AsyncTxn {
+        Transaction txn = co_await io.Begin("transfer", keys);
+
+        auto values = co_await io.Read(txn, keys);
+        ApplyW1Transfer(mgr, txn, keys, values[0], values[1]);
+
+        co_return co_await io.Commit(std::move(txn));
+    };
+    tmpl.access.entries = {
+        {"A_", AccessMode::kReadModifyWrite, {"balance"}},
+    };
+    return tmpl;
 }
 
 } // namespace txn
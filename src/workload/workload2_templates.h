@@ -12,7 +12,7 @@ namespace txn {
 //   S1-S3 — supply: decrement qty, increment ytd and order_cnt
 // key_builder must be injected in main.cpp.
 inline WorkloadTemplate MakeW2NewOrderTemplate() {
-    return {
+    WorkloadTemplate tmpl{
         "new_order",
         4,
         nullptr, // key_builder injected in main.cpp
@@ -38,6 +38,11 @@ inline WorkloadTemplate MakeW2NewOrderTemplate() {
             return mgr.Commit(txn);
         }
     };
+    tmpl.access.entries = {
+        {"D_", AccessMode::kReadModifyWrite, {"next_o_id"}},
+        {"S_", AccessMode::kReadModifyWrite, {"qty", "ytd", "order_cnt"}},
+    };
+    return tmpl;
 }
 
 // Payment template for workload 2.
@@ -47,7 +52,7 @@ inline WorkloadTemplate MakeW2NewOrderTemplate() {
 //   C — customer:  balance -= 5, ytd_payment += 5, payment_cnt += 1
 // key_builder must be injected in main.cpp.
 inline WorkloadTemplate MakeW2PaymentTemplate() {
-    return {
+    WorkloadTemplate tmpl{
         "payment",
         3,
         nullptr, // key_builder injected in main.cpp
@@ -77,6 +82,12 @@ inline WorkloadTemplate MakeW2PaymentTemplate() {
             return mgr.Commit(txn);
         }
     };
+    tmpl.access.entries = {
+        {"W_", AccessMode::kIncrement, {"ytd"}},
+        {"D_", AccessMode::kIncrement, {"ytd"}},
+        {"C_", AccessMode::kReadModifyWrite, {"balance", "ytd_payment", "payment_cnt"}},
+    };
+    return tmpl;
 }
 
 } // namespace txn
@@ -0,0 +1,507 @@
+#include "workload/workload_builder.h"
+#include "workload/key_selector.h"
+#include "workload/workload1_templates.h"
+#include "workload/workload2_templates.h"
+#include "workload/record.h"
+#include "workload/zipfian.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+namespace txn {
+
+namespace {
+
+// Keynum space shared by one build of the YCSB templates. Inserts reserve
+// keynums from next_keynum; reads draw below acked_keynum, which, like
+// YCSB's acknowledged counter, only passes a keynum once its insert and
+// every one before it have committed. Reads therefore never find a
+// reserved but unwritten record. An insert that is abandoned (the server's
+// retry limit) holds the mark back for the rest of the run, as in YCSB.
+struct YcsbKeyspace {
+    explicit YcsbKeyspace(const YcsbConfig& c)
+        : config(c), next_keynum(c.record_count), acked_keynum(c.record_count),
+          zipf(c.zipf_theta), latest(c.record_count, c.zipf_theta) {}
+
+    // Marks the keynums of a committed insert's keys
+    void Acknowledge(const std::vector<std::string>& keys) {
+        std::lock_guard<std::mutex> lock(ack_mutex);
+        for (const auto& key : keys) acked_above.insert(YcsbKeynum(key));
+        uint64_t acked = acked_keynum.load(std::memory_order_relaxed);
+        while (!acked_above.empty() && *acked_above.begin() == acked) {
+            acked_above.erase(acked_above.begin());
+            acked++;
+        }
+        acked_keynum.store(acked, std::memory_order_release);
+    }
+
+    YcsbConfig config;
+    std::atomic<uint64_t> next_keynum;
+    std::atomic<uint64_t> acked_keynum;
+    std::mutex ack_mutex;
+    std::set<uint64_t> acked_above;  // committed keynums past a gap; guarded by ack_mutex
+    ScrambledZipfianGenerator zipf;
+    SkewedLatestGenerator latest;
+};
+
+// Initial TPC-C database, following the spec's population rules at the
+// configured cardinalities.
+void GenerateTpccData(const TpccConfig& config, ParseResult& parsed) {
+    using namespace tpcc;
+    std::mt19937 rng(std::random_device{}());
+    auto uniform = [&rng](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    auto put = [&parsed](const std::string& key, const Record& rec) {
+        parsed.initial_data[key] = SerializeRecord(rec);
+    };
+    const int name_max = std::min(999, config.customers_per_district - 1);
+    const int first_undelivered = config.orders_per_district * 7 / 10 + 1;
+
+    for (int i = 1; i <= config.items; i++) {
+        Record item;
+        SetIntField(item, "price", uniform(1, 100));
+        put(ItemKey(i), item);
+    }
+
+    for (int w = 1; w <= config.warehouses; w++) {
+        Record warehouse;
+        SetIntField(warehouse, "ytd", 300000);
+        SetIntField(warehouse, "tax", uniform(0, 2000));
+        put(WarehouseKey(w), warehouse);
+        parsed.warehouse_keys.push_back(WarehouseKey(w));
+
+        for (int i = 1; i <= config.items; i++) {
+            Record stock;
+            SetIntField(stock, "qty", uniform(10, 100));
+            SetIntField(stock, "ytd", 0);
+            SetIntField(stock, "order_cnt", 0);
+            SetIntField(stock, "remote_cnt", 0);
+            put(StockKey(w, i), stock);
+        }
+
+        for (int d = 1; d <= config.districts_per_warehouse; d++) {
+            Record district;
+            SetIntField(district, "ytd", 30000);
+            SetIntField(district, "tax", uniform(0, 2000));
+            SetIntField(district, "next_o_id", config.orders_per_district + 1);
+            put(DistrictKey(w, d), district);
+            parsed.district_keys.push_back(DistrictKey(w, d));
+
+            Record cursor;
+            SetIntField(cursor, "next_o_id", first_undelivered);
+            put(DeliveryCursorKey(w, d), cursor);
+
+            std::map<std::string, std::string> by_name;
+            for (int c = 1; c <= config.customers_per_district; c++) {
+                // The first 1000 customers cover every last name once
+                std::string last = LastName(c <= 1000 ? c - 1 : NURand(rng, 255, 0, name_max));
+                Record customer{{"last", last}};
+                SetIntField(customer, "balance", -10);
+                SetIntField(customer, "ytd_payment", 10);
+                SetIntField(customer, "payment_cnt", 1);
+                SetIntField(customer, "delivery_cnt", 0);
+                put(CustomerKey(w, d, c), customer);
+                parsed.customer_keys.push_back(CustomerKey(w, d, c));
+
+                auto& ids = by_name[last];
+                ids += (ids.empty() ? "" : ",") + std::to_string(c);
+            }
+            for (const auto& [last, ids] : by_name) {
+                put(CustomerNameKey(w, d, last), Record{{"ids", ids}});
+            }
+
+            // Orders go to a random permutation of the customers
+            std::vector<int> customers(config.customers_per_district);
+            for (int c = 0; c < config.customers_per_district; c++) customers[c] = c + 1;
+            std::shuffle(customers.begin(), customers.end(), rng);
+            for (int o = 1; o <= config.orders_per_district; o++) {
+                int c = customers[(o - 1) % customers.size()];
+                bool delivered = o < first_undelivered;
+                int ol_cnt = uniform(5, 15);
+
+                Record order;
+                SetIntField(order, "c_id", c);
+                SetIntField(order, "carrier_id", delivered ? uniform(1, 10) : 0);
+                SetIntField(order, "ol_cnt", ol_cnt);
+                SetIntField(order, "all_local", 1);
+                put(OrderKey(w, d, o), order);
+
+                for (int n = 1; n <= ol_cnt; n++) {
+                    Record line;
+                    SetIntField(line, "i_id", uniform(1, config.items));
+                    SetIntField(line, "supply_w_id", w);
+                    SetIntField(line, "quantity", 5);
+                    SetIntField(line, "amount", delivered ? 0 : uniform(1, 9999));
+                    SetIntField(line, "delivered", delivered ? 1 : 0);
+                    put(OrderLineKey(w, d, o, n), line);
+                }
+                if (!delivered) {
+                    Record new_order;
+                    SetIntField(new_order, "o_id", o);
+                    SetIntField(new_order, "delivered", 0);
+                    put(NewOrderKey(w, d, o), new_order);
+                }
+
+                Record last_order;
+                SetIntField(last_order, "o_id", o);
+                put(CustomerLastOrderKey(w, d, c), last_order);
+            }
+        }
+    }
+}
+
+// TPC-C templates with keys drawn around a uniformly chosen home warehouse.
+std::vector<WorkloadTemplate> BuildTpccTemplates(const TpccConfig& config) {
+    using namespace tpcc;
+    const int num_w = config.warehouses;
+    const int num_d = config.districts_per_warehouse;
+    const int num_c = config.customers_per_district;
+    const int num_i = config.items;
+    const int name_max = std::min(999, num_c - 1);
+
+    auto uniform = [](std::mt19937& rng, int lo, int hi) {
+        return std::uniform_int_distribution<int>(lo, hi)(rng);
+    };
+    // Any warehouse but w (w itself when there is only one)
+    auto other_warehouse = [num_w, uniform](std::mt19937& rng, int w) {
+        if (num_w == 1) return w;
+        int other = uniform(rng, 1, num_w - 1);
+        return other >= w ? other + 1 : other;
+    };
+    // 60% by last name, 40% by id
+    auto customer = [num_c, name_max, uniform](std::mt19937& rng, int w, int d) {
+        if (uniform(rng, 1, 100) <= 60) {
+            return CustomerNameKey(w, d, LastName(NURand(rng, 255, 0, name_max)));
+        }
+        return CustomerKey(w, d, NURand(rng, 1023, 1, num_c));
+    };
+
+    auto new_order = MakeTpccNewOrderTemplate();
+    new_order.key_builder = [=](std::mt19937& rng) -> std::vector<std::string> {
+        int w = uniform(rng, 1, num_w);
+        int d = uniform(rng, 1, num_d);
+        int c = NURand(rng, 1023, 1, num_c);
+        int lines = std::min(uniform(rng, 5, 15), num_i);
+
+        std::set<int> used;
+        std::vector<std::string> items, stock;
+        while (static_cast<int>(items.size()) < lines) {
+            int i = NURand(rng, 8191, 1, num_i);
+            if (!used.insert(i).second) continue;
+            int supply_w = uniform(rng, 1, 100) == 1 ? other_warehouse(rng, w) : w;
+            items.push_back(ItemKey(i));
+            stock.push_back(StockKey(supply_w, i));
+        }
+
+        std::vector<std::string> keys = {WarehouseKey(w), DistrictKey(w, d), CustomerKey(w, d, c),
+                                         CustomerLastOrderKey(w, d, c)};
+        keys.insert(keys.end(), items.begin(), items.end());
+        keys.insert(keys.end(), stock.begin(), stock.end());
+        return keys;
+    };
+
+    auto payment = MakeTpccPaymentTemplate();
+    payment.key_builder = [=](std::mt19937& rng) -> std::vector<std::string> {
+        int w = uniform(rng, 1, num_w);
+        int d = uniform(rng, 1, num_d);
+        bool home = uniform(rng, 1, 100) <= 85;
+        int c_w = home ? w : other_warehouse(rng, w);
+        int c_d = home ? d : uniform(rng, 1, num_d);
+        return {WarehouseKey(w), DistrictKey(w, d), customer(rng, c_w, c_d)};
+    };
+
+    auto order_status = MakeTpccOrderStatusTemplate();
+    order_status.key_builder = [=](std::mt19937& rng) -> std::vector<std::string> {
+        return {customer(rng, uniform(rng, 1, num_w), uniform(rng, 1, num_d))};
+    };
+
+    auto delivery = MakeTpccDeliveryTemplate();
+    delivery.key_builder = [=](std::mt19937& rng) -> std::vector<std::string> {
+        int w = uniform(rng, 1, num_w);
+        std::vector<std::string> keys;
+        for (int d = 1; d <= num_d; d++) keys.push_back(DeliveryCursorKey(w, d));
+        return keys;
+    };
+
+    auto stock_level = MakeTpccStockLevelTemplate();
+    stock_level.key_builder = [=](std::mt19937& rng) -> std::vector<std::string> {
+        return {DistrictKey(uniform(rng, 1, num_w), uniform(rng, 1, num_d))};
+    };
+
+    return {new_order, payment, order_status, delivery, stock_level};
+}
+
+} // anonymous namespace
+
+std::string DefaultInputFile(const std::string& workload) {
+    return "workloads/workload" + workload + "/input" + workload + ".txt";
+}
+
+char YcsbWorkloadLetter(const std::string& workload) {
+    if (workload.size() != 6 || workload.compare(0, 5, "ycsb-") != 0) return 0;
+    char letter = static_cast<char>(std::tolower(static_cast<unsigned char>(workload[5])));
+    return (letter >= 'a' && letter <= 'f') ? letter : 0;
+}
+
+bool IsGeneratedWorkload(const std::string& workload) {
+    return workload == "smallbank" || workload == "tpcc" || YcsbWorkloadLetter(workload) != 0;
+}
+
+ParseResult LoadWorkloadInput(const std::string& workload, const WorkloadOptions& options) {
+    if (!IsGeneratedWorkload(workload)) return ParseInputFile(DefaultInputFile(workload));
+
+    ParseResult parsed;
+    if (workload == "smallbank") {
+        const auto& config = options.smallbank;
+        std::mt19937 rng(std::random_device{}());
+        std::uniform_int_distribution<int> balance(config.min_balance, config.max_balance);
+        for (int c = 1; c <= config.num_accounts; c++) {
+            std::string customer = std::to_string(c);
+            for (const auto& key : {smallbank::CheckingKey(customer),
+                                    smallbank::SavingsKey(customer)}) {
+                Record rec{{"name", "Customer-" + customer}};
+                SetIntField(rec, "balance", balance(rng));
+                parsed.initial_data[key] = SerializeRecord(rec);
+            }
+            parsed.checking_keys.push_back(smallbank::CheckingKey(customer));
+            parsed.savings_keys.push_back(smallbank::SavingsKey(customer));
+        }
+        return parsed;
+    }
+    if (workload == "tpcc") {
+        GenerateTpccData(options.tpcc, parsed);
+        return parsed;
+    }
+
+    for (uint64_t i = 0; i < options.ycsb.record_count; i++) {
+        parsed.initial_data[YcsbKey(i)] = YcsbRecordValue(options.ycsb);
+    }
+    return parsed;
+}
+
+std::vector<WorkloadTemplate> BuildYcsbTemplates(char letter, const YcsbConfig& ycsb) {
+    auto keyspace = std::make_shared<YcsbKeyspace>(ycsb);
+    const int ops = std::max(1, ycsb.ops_per_txn);
+    const bool latest = letter == 'd';
+
+    auto choose = [keyspace, latest](std::mt19937& rng) -> uint64_t {
+        uint64_t n = keyspace->acked_keynum.load(std::memory_order_acquire);
+        return latest ? keyspace->latest.Next(rng, n) : keyspace->zipf.Next(rng, n);
+    };
+
+    // ops distinct existing records
+    auto existing_keys = [keyspace, choose, ops](std::mt19937& rng) -> std::vector<std::string> {
+        uint64_t n = keyspace->acked_keynum.load(std::memory_order_acquire);
+        size_t want = static_cast<size_t>(std::min<uint64_t>(ops, n));
+        std::set<uint64_t> used;
+        std::vector<std::string> keys;
+        while (keys.size() < want) {
+            uint64_t keynum = choose(rng);
+            if (used.insert(keynum).second) keys.push_back(YcsbKey(keynum));
+        }
+        return keys;
+    };
+
+    // ops freshly reserved keynums
+    auto insert_keys = [keyspace, ops](std::mt19937&) -> std::vector<std::string> {
+        uint64_t first = keyspace->next_keynum.fetch_add(ops, std::memory_order_relaxed);
+        std::vector<std::string> keys;
+        for (int i = 0; i < ops; i++) keys.push_back(YcsbKey(first + i));
+        return keys;
+    };
+
+    // ops scan ranges, each [start, start + len) clipped to the record count
+    auto scan_keys = [keyspace, choose, ops](std::mt19937& rng) -> std::vector<std::string> {
+        uint64_t n = keyspace->acked_keynum.load(std::memory_order_acquire);
+        std::uniform_int_distribution<int> len_dist(1, std::max(1, keyspace->config.max_scan_length));
+        std::set<uint64_t> used;
+        std::vector<std::string> keys;
+        for (int i = 0; i < ops; i++) {
+            uint64_t start = choose(rng);
+            uint64_t end = std::min<uint64_t>(start + len_dist(rng), n);
+            for (uint64_t k = start; k < end; k++) {
+                if (used.insert(k).second) keys.push_back(YcsbKey(k));
+            }
+        }
+        return keys;
+    };
+
+    auto with = [](WorkloadTemplate tmpl, auto key_builder, double weight) {
+        tmpl.key_builder = key_builder;
+        tmpl.weight = weight;
+        return tmpl;
+    };
+
+    auto read   = MakeYcsbReadTemplate(ops);
+    auto update = MakeYcsbUpdateTemplate(ycsb);
+    auto insert = MakeYcsbInsertTemplate(ycsb);
+    insert.on_commit = [keyspace](const std::vector<std::string>& keys) { keyspace->Acknowledge(keys); };
+    // Its keynums must come from next_keynum, or the acknowledged mark breaks
+    insert.accepts_keys = [](const std::vector<std::string>&) { return false; };
+    switch (letter) {
+        case 'a': return {with(read, existing_keys, 0.50), with(update, existing_keys, 0.50)};
+        case 'b': return {with(read, existing_keys, 0.95), with(update, existing_keys, 0.05)};
+        case 'c': return {with(read, existing_keys, 1.00)};
+        case 'd': return {with(read, existing_keys, 0.95), with(insert, insert_keys, 0.05)};
+        case 'e': return {with(MakeYcsbScanTemplate(ops), scan_keys, 0.95),
+                          with(insert, insert_keys, 0.05)};
+        case 'f': return {with(read, existing_keys, 0.50),
+                          with(MakeYcsbReadModifyWriteTemplate(ycsb), existing_keys, 0.50)};
+    }
+    return {};
+}
+
+std::vector<WorkloadTemplate> BuildWorkloadTemplates(const std::string& workload,
+                                                     const ParseResult& parsed,
+                                                     int hotset_size, double hotset_prob,
+                                                     const WorkloadOptions& options) {
+    if (char letter = YcsbWorkloadLetter(workload)) {
+        return BuildYcsbTemplates(letter, options.ycsb);
+    }
+    if (workload == "tpcc") {
+        return BuildTpccTemplates(options.tpcc);
+    }
+
+    std::vector<WorkloadTemplate> templates;
+
+    if (workload == "1") {
+        auto account_keys = parsed.account_keys;
+
+        auto tmpl = MakeW1TransferTemplate();
+        tmpl.key_builder = [account_keys, hotset_size, hotset_prob]
+                           (std::mt19937& rng) -> std::vector<std::string> {
+            int n       = static_cast<int>(account_keys.size());
+            int hot_max = std::min(hotset_size, n) - 1;
+            std::uniform_real_distribution<double> prob_dist(0.0, 1.0);
+            std::uniform_int_distribution<int>     hot_dist(0, std::max(0, hot_max));
+            std::uniform_int_distribution<int>     all_dist(0, n - 1);
+
+            std::set<int> used;
+            std::vector<std::string> keys;
+            while (static_cast<int>(keys.size()) < 2) {
+                int idx = (prob_dist(rng) < hotset_prob) ? hot_dist(rng) : all_dist(rng);
+                if (used.find(idx) == used.end()) {
+                    used.insert(idx);
+                    keys.push_back(account_keys[idx]);
+                }
+            }
+            return keys;
+        };
+        templates.push_back(std::move(tmpl));
+
+    } else if (workload == "2") {
+        // Scale hotset size proportionally to each domain's size vs. workload-1's 500 keys.
+        auto make_domain = [&](const std::vector<std::string>& keys)
+                -> MultiDomainKeySelector::DomainConfig {
+            int domain_size  = static_cast<int>(keys.size());
+            int scaled_hot   = std::max(1, domain_size * hotset_size / 500);
+            return {keys, scaled_hot, hotset_prob};
+        };
+
+        auto selector = std::make_shared<MultiDomainKeySelector>(
+            std::map<std::string, MultiDomainKeySelector::DomainConfig>{
+                {"W", make_domain(parsed.warehouse_keys)},
+                {"D", make_domain(parsed.district_keys)},
+                {"S", make_domain(parsed.supply_keys)},
+                {"C", make_domain(parsed.customer_keys)},
+            });
+
+        // new_order: keys = [D, S1, S2, S3] with 3 distinct supply keys
+        auto tmpl_no = MakeW2NewOrderTemplate();
+        tmpl_no.key_builder = [selector](std::mt19937& rng) -> std::vector<std::string> {
+            std::vector<std::string> keys;
+            keys.push_back(selector->SelectFromDomain("D", rng));
+            std::set<std::string> used;
+            while (static_cast<int>(used.size()) < 3) {
+                used.insert(selector->SelectFromDomain("S", rng));
+            }
+            for (const auto& k : used) keys.push_back(k);
+            return keys;
+        };
+        templates.push_back(std::move(tmpl_no));
+
+        // payment: keys = [W, D, C]
+        auto tmpl_pay = MakeW2PaymentTemplate();
+        tmpl_pay.key_builder = [selector](std::mt19937& rng) -> std::vector<std::string> {
+            return {
+                selector->SelectFromDomain("W", rng),
+                selector->SelectFromDomain("D", rng),
+                selector->SelectFromDomain("C", rng),
+            };
+        };
+        templates.push_back(std::move(tmpl_pay));
+
+    } else if (workload == "smallbank") {
+        // Customers are the ids behind CK_<id>; an input file may list them in any order
+        auto customers = std::make_shared<std::vector<std::string>>();
+        for (const auto& key : parsed.checking_keys) customers->push_back(key.substr(3));
+        if (customers->size() < 2) return templates;
+
+        // Picks n distinct customers, hotspot first with probability hotset_prob
+        auto pick = [customers, hotset_size, hotset_prob](std::mt19937& rng, int n) {
+            int total   = static_cast<int>(customers->size());
+            int hot_max = std::max(1, std::min(hotset_size, total)) - 1;
+            std::uniform_real_distribution<double> prob_dist(0.0, 1.0);
+            std::uniform_int_distribution<int>     hot_dist(0, hot_max);
+            std::uniform_int_distribution<int>     all_dist(0, total - 1);
+
+            std::vector<std::string> picked;
+            while (static_cast<int>(picked.size()) < n) {
+                int idx = (prob_dist(rng) < hotset_prob) ? hot_dist(rng) : all_dist(rng);
+                const auto& c = (*customers)[idx];
+                if (std::find(picked.begin(), picked.end(), c) == picked.end()) {
+                    picked.push_back(c);
+                }
+            }
+            return picked;
+        };
+
+        using namespace smallbank;
+        auto tmpl = MakeSmallBankBalanceTemplate();
+        tmpl.key_builder = [pick](std::mt19937& rng) -> std::vector<std::string> {
+            auto c = pick(rng, 1);
+            return {SavingsKey(c[0]), CheckingKey(c[0])};
+        };
+        templates.push_back(std::move(tmpl));
+
+        tmpl = MakeSmallBankDepositCheckingTemplate();
+        tmpl.key_builder = [pick](std::mt19937& rng) -> std::vector<std::string> {
+            return {CheckingKey(pick(rng, 1)[0])};
+        };
+        templates.push_back(std::move(tmpl));
+
+        tmpl = MakeSmallBankTransactSavingsTemplate();
+        tmpl.key_builder = [pick](std::mt19937& rng) -> std::vector<std::string> {
+            return {SavingsKey(pick(rng, 1)[0])};
+        };
+        templates.push_back(std::move(tmpl));
+
+        tmpl = MakeSmallBankAmalgamateTemplate();
+        tmpl.key_builder = [pick](std::mt19937& rng) -> std::vector<std::string> {
+            auto c = pick(rng, 2);
+            return {SavingsKey(c[0]), CheckingKey(c[0]), CheckingKey(c[1])};
+        };
+        templates.push_back(std::move(tmpl));
+
+        tmpl = MakeSmallBankWriteCheckTemplate();
+        tmpl.key_builder = [pick](std::mt19937& rng) -> std::vector<std::string> {
+            auto c = pick(rng, 1);
+            return {SavingsKey(c[0]), CheckingKey(c[0])};
+        };
+        templates.push_back(std::move(tmpl));
+
+        tmpl = MakeSmallBankSendPaymentTemplate();
+        tmpl.key_builder = [pick](std::mt19937& rng) -> std::vector<std::string> {
+            auto c = pick(rng, 2);
+            return {CheckingKey(c[0]), CheckingKey(c[1])};
+        };
+        templates.push_back(std::move(tmpl));
+    }
+
+    return templates;
+}
+
+} // namespace txn
@@ -0,0 +1,67 @@
+#ifndef WORKLOAD_BUILDER_H
+#define WORKLOAD_BUILDER_H
+
+#include <string>
+#include <vector>
+#include "workload/workload_template.h"
+#include "workload/input_parser.h"
+#include "workload/ycsb_templates.h"
+#include "workload/smallbank_templates.h"
+#include "workload/tpcc_templates.h"
+
+namespace txn {
+
+// Parameters of the workloads whose data is generated rather than read from
+// an input file.
+struct WorkloadOptions {
+    YcsbConfig ycsb;
+    SmallBankConfig smallbank;
+    TpccConfig tpcc;
+};
+
+// Builds the templates for a workload with key_builder lambdas injected over
+// the parsed key domains. Returns an empty vector for an unknown workload.
+//   1      — transfer over A_* accounts
+//   2      — new_order + payment over W/D/S/C domains, hotset scaled per domain
+//   smallbank — the six SmallBank transactions over CK_*/SV_* records; the
+//               first hotset_size customers form the hotspot
+//   tpcc   — full TPC-C mix; each transaction picks a home warehouse and
+//            its keys are drawn within it (NURand customers and items, 1%
+//            remote stock, 15% remote payments)
+//   ycsb-X — YCSB core workload A-F (see BuildYcsbTemplates); hotset
+//            parameters are ignored in favour of the YCSB distributions
+// Templates that insert keep a shared insert counter, so rebuild them after
+// restoring the database to its initial data.
+std::vector<WorkloadTemplate> BuildWorkloadTemplates(const std::string& workload,
+                                                     const ParseResult& parsed,
+                                                     int hotset_size, double hotset_prob,
+                                                     const WorkloadOptions& options = {});
+
+// YCSB core workload templates for letter 'a'..'f', weighted by the standard
+// operation mix over ycsb.record_count preloaded records:
+//   a — 50% read, 50% update           (scrambled Zipfian)
+//   b — 95% read, 5% update            (scrambled Zipfian)
+//   c — 100% read                      (scrambled Zipfian)
+//   d — 95% read, 5% insert            (latest: recent inserts are hottest)
+//   e — 95% scan, 5% insert            (scrambled Zipfian scan start)
+//   f — 50% read, 50% read-modify-write (scrambled Zipfian)
+std::vector<WorkloadTemplate> BuildYcsbTemplates(char letter, const YcsbConfig& ycsb);
+
+// 'a'..'f' for "ycsb-a".."ycsb-f" (either case), 0 for anything else.
+char YcsbWorkloadLetter(const std::string& workload);
+
+// True for workloads whose initial data is generated when no input file is given.
+bool IsGeneratedWorkload(const std::string& workload);
+
+// Initial data for a workload: parsed from DefaultInputFile for 1 and 2,
+// generated for smallbank (smallbank.num_accounts customers with random
+// balances), tpcc (the initial database of TpccConfig) and ycsb-*
+// (ycsb.record_count records).
+ParseResult LoadWorkloadInput(const std::string& workload, const WorkloadOptions& options = {});
+
+// Default input file for a workload: workloads/workloadN/inputN.txt
+std::string DefaultInputFile(const std::string& workload);
+
+} // namespace txn
+
+#endif // WORKLOAD_BUILDER_H
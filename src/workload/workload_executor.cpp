@@ -1,16 +1,98 @@
 #include "workload/workload_executor.h"
+#include "workload/batch_executor.h"
 #include <thread>
 #include <random>
 #include <chrono>
+#include <iostream>
+#include <array>
+#include "metrics/alloc_profiler.h"
 
 namespace txn {
 
+namespace {
+
+// Executor phases that heap allocations are attributed to under TXN_ALLOC_PROFILING.
+enum AllocPhase { kPhaseSelectKeys, kPhaseExecute, kPhaseRecord, kPhaseBackoff, kNumAllocPhases };
+const char* const kAllocPhaseNames[kNumAllocPhases] = {"select_keys", "execute", "record", "backoff"};
+
+// A worker's allocation totals per template per phase, charged by diffing the
+// thread's counters at each phase boundary. Does nothing unless profiling is
+// compiled in.
+class AllocLedger {
+public:
+    explicit AllocLedger(size_t num_templates)
+        : enabled_(AllocProfilingEnabled()),
+          totals_(enabled_ ? num_templates : 0),
+          mark_(ThreadAllocCounters()) {}
+
+    // Starts a region without charging what was allocated before it
+    void Mark() {
+        if (enabled_) mark_ = ThreadAllocCounters();
+    }
+
+    // Charges everything since the last mark or charge to one template
+    void Charge(size_t tmpl_idx, AllocPhase phase) {
+        if (!enabled_) return;
+        AllocCounters delta = Take();
+        totals_[tmpl_idx][phase].allocs += delta.allocs;
+        totals_[tmpl_idx][phase].bytes  += delta.bytes;
+    }
+
+    // Charges everything since the last mark or charge evenly across the
+    // transactions that shared the region, one template index each
+    void ChargeShared(const std::vector<size_t>& tmpl_idxs, AllocPhase phase) {
+        if (!enabled_) return;
+        AllocCounters delta = Take();
+        if (tmpl_idxs.empty()) return;
+        uint64_t n = tmpl_idxs.size();
+        for (size_t i = 0; i < tmpl_idxs.size(); i++) {
+            // The remainder goes to the first members so the totals still add up
+            auto& t = totals_[tmpl_idxs[i]][phase];
+            t.allocs += delta.allocs / n + (i < delta.allocs % n ? 1 : 0);
+            t.bytes  += delta.bytes  / n + (i < delta.bytes  % n ? 1 : 0);
+        }
+    }
+
+    void Report(MetricsCollector& metrics, const std::vector<WorkloadTemplate>& templates) const {
+        for (size_t t = 0; t < totals_.size(); t++) {
+            for (int phase = 0; phase < kNumAllocPhases; phase++) {
+                metrics.RecordAllocations(templates[t].name, kAllocPhaseNames[phase],
+                                          totals_[t][phase]);
+            }
+        }
+    }
+
+private:
+    AllocCounters Take() {
+        AllocCounters now = ThreadAllocCounters();
+        AllocCounters delta{now.allocs - mark_.allocs, now.bytes - mark_.bytes};
+        mark_ = now;
+        return delta;
+    }
+
+    bool enabled_;
+    std::vector<std::array<AllocCounters, kNumAllocPhases>> totals_;
+    AllocCounters mark_;
+};
+
+} // anonymous namespace
+
 WorkloadExecutor::WorkloadExecutor(TransactionManager& mgr, MetricsCollector& metrics,
                                    const ExecutorConfig& config)
-    : mgr_(mgr), metrics_(metrics), config_(config) {}
+    : mgr_(mgr), metrics_(metrics), config_(config) {
+    for (const auto& tmpl : config_.templates) {
+        mgr_.Declare(tmpl.name, tmpl.access);
+        if (mgr_.HasIsolationLevels()) {
+            metrics_.SetIsolation(tmpl.name, IsolationName(mgr_.IsolationOf(tmpl.name)));
+        }
+    }
+}
 
 void WorkloadExecutor::Run() {
+    metrics_.InitWorkers(config_.num_threads);
     auto start = std::chrono::steady_clock::now();
+    deadline_ = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(config_.duration_s));
 
     std::vector<std::thread> threads;
     threads.reserve(config_.num_threads);
@@ -31,41 +113,348 @@ double WorkloadExecutor::ElapsedSeconds() const {
     return elapsed_s_;
 }
 
+bool WorkloadExecutor::RecordAttempt(int thread_id, const WorkloadTemplate& tmpl,
+                                     const std::vector<std::string>& keys,
+                                     const CommitResult& result, int& retries,
+                                     std::chrono::steady_clock::time_point wall_start) {
+    if (config_.hot_keys) {
+        for (const auto& key : keys) {
+            config_.hot_keys->RecordAccess(thread_id, key);
+        }
+        // OCC reports conflicts as aborts, 2PL as lock retries inside Begin.
+        // They are charged to the key the manager found in conflict; one it
+        // cannot name (e.g. a cluster branch's) is not counted.
+        uint64_t conflicts = result.success ? result.retries : 1;
+        if (conflicts > 0 && !result.conflict_key.empty()) {
+            config_.hot_keys->RecordConflict(thread_id, result.conflict_key, conflicts);
+        }
+    }
+
+    if (result.success) {
+        if (tmpl.on_commit) tmpl.on_commit(keys);
+        auto wall_end = std::chrono::steady_clock::now();
+        double latency_us = std::chrono::duration<double, std::micro>(
+            wall_end - wall_start).count();
+        metrics_.RecordCommit(tmpl.name, latency_us);
+        // 2PL retries happen inside Begin and only surface here
+        int streak = retries + result.retries;
+        metrics_.RecordWorkerCommit(thread_id, streak);
+        if (config_.starvation_warn_retries > 0 && retries < config_.starvation_warn_retries
+                && streak >= config_.starvation_warn_retries) {
+            WarnStarvation(thread_id, tmpl.name, keys, streak);
+        }
+        return true;
+    }
+
+    metrics_.RecordAbort(tmpl.name);
+    metrics_.RecordWorkerAbort(thread_id);
+    retries++;
+    if (retries == config_.starvation_warn_retries) {
+        WarnStarvation(thread_id, tmpl.name, keys, retries);
+    }
+    return false;
+}
+
+int WorkloadExecutor::BackoffUs(int retries, std::mt19937& rng) const {
+    // Exponential backoff with jitter
+    int backoff_us = config_.retry_backoff_base_us * (1 << std::min(retries, 10));
+    std::uniform_int_distribution<int> jitter(0, backoff_us);
+    return backoff_us + jitter(rng);
+}
+
 void WorkloadExecutor::WorkerThread(int thread_id) {
+    if (config_.queue_depth > 1) {
+        AsyncWorkerThread(thread_id);
+        return;
+    }
+    if (config_.batch_size > 1) {
+        BatchWorkerThread(thread_id);
+        return;
+    }
+    auto worker_start = std::chrono::steady_clock::now();
     std::mt19937 rng(thread_id + std::chrono::steady_clock::now().time_since_epoch().count());
     KeySelector key_selector(config_.contention, rng);
-    std::uniform_int_distribution<int> template_dist(0, config_.templates.size() - 1);
+    std::vector<double> weights;
+    for (const auto& tmpl : config_.templates) weights.push_back(tmpl.weight);
+    std::discrete_distribution<size_t> template_dist(weights.begin(), weights.end());
+
+    AllocLedger allocs(config_.templates.size());
 
-    for (int i = 0; i < config_.txns_per_thread; i++) {
-        // Pick a random template
-        auto& tmpl = config_.templates[template_dist(rng)];
+    const bool timed = config_.duration_s > 0.0;
+    for (int i = 0; timed || i < config_.txns_per_thread; i++) {
+        if (timed && std::chrono::steady_clock::now() >= deadline_) break;
+
+        // Pick a template by weight
+        size_t tmpl_idx = template_dist(rng);
+        auto& tmpl = config_.templates[tmpl_idx];
+        allocs.Mark();
         std::vector<std::string> keys = tmpl.key_builder
             ? tmpl.key_builder(rng)
             : key_selector.SelectDistinctKeys(tmpl.num_input_keys);
+        allocs.Charge(tmpl_idx, kPhaseSelectKeys);
 
         auto wall_start = std::chrono::steady_clock::now();
         int retries = 0;
 
         while (true) {
             auto result = tmpl.execute(mgr_, keys);
+            allocs.Charge(tmpl_idx, kPhaseExecute);
+            bool committed = RecordAttempt(thread_id, tmpl, keys, result, retries, wall_start);
+            allocs.Charge(tmpl_idx, kPhaseRecord);
+            if (committed) break;
+
+            std::this_thread::sleep_for(std::chrono::microseconds(BackoffUs(retries, rng)));
+            allocs.Charge(tmpl_idx, kPhaseBackoff);
+        }
+    }
+
+    allocs.Report(metrics_, config_.templates);
+
+    if (config_.hot_keys) {
+        config_.hot_keys->Flush(thread_id);
+    }
+
+    metrics_.RecordWorkerElapsed(thread_id, std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - worker_start).count());
+}
+
+void WorkloadExecutor::AsyncWorkerThread(int thread_id) {
+    using Clock = std::chrono::steady_clock;
+    auto worker_start = Clock::now();
+    std::mt19937 rng(thread_id + worker_start.time_since_epoch().count());
+    KeySelector key_selector(config_.contention, rng);
+    std::vector<double> weights;
+    for (const auto& tmpl : config_.templates) weights.push_back(tmpl.weight);
+    std::discrete_distribution<size_t> template_dist(weights.begin(), weights.end());
+
+    // One slot per in-flight transaction. A slot's coroutine is either not
+    // started yet (new, or retrying after its backoff), suspended in io, or done.
+    struct Slot {
+        size_t tmpl_idx = 0;
+        std::vector<std::string> keys;
+        AsyncTxn task;
+        bool started = false;
+        Clock::time_point wall_start;
+        Clock::time_point not_before;
+        int retries = 0;
+    };
+    std::vector<Slot> slots(config_.queue_depth);
+    AsyncIo io(mgr_, config_.async_commit);
+
+    // Coroutine steps are charged to their own slot. Work done for several
+    // slots at once (the batched fetch, waits) is shared evenly across the
+    // unfinished slots that are suspended in io (started) or backing off (not).
+    AllocLedger allocs(config_.templates.size());
+    std::vector<size_t> sharing;
+    auto share_with = [&](bool started) {
+        sharing.clear();
+        for (const auto& slot : slots) {
+            if (slot.task.Valid() && slot.started == started && !slot.task.Done()) {
+                sharing.push_back(slot.tmpl_idx);
+            }
+        }
+    };
+
+    const bool timed = config_.duration_s > 0.0;
+    int issued = 0;
+    size_t in_flight = 0;
+    while (true) {
+        auto now = Clock::now();
+        bool more = timed ? now < deadline_ : issued < config_.txns_per_thread;
+        Clock::time_point next_wake = Clock::time_point::max();
+
+        for (auto& slot : slots) {
+            if (!slot.task.Valid()) {
+                if (!more) continue;
+                slot.tmpl_idx = template_dist(rng);
+                const auto& tmpl = config_.templates[slot.tmpl_idx];
+                allocs.Mark();
+                slot.keys = tmpl.key_builder ? tmpl.key_builder(rng)
+                                             : key_selector.SelectDistinctKeys(tmpl.num_input_keys);
+                allocs.Charge(slot.tmpl_idx, kPhaseSelectKeys);
+                slot.wall_start = now;
+                slot.not_before = now;
+                slot.retries = 0;
+                slot.task = tmpl.async_execute(mgr_, io, slot.keys);
+                allocs.Charge(slot.tmpl_idx, kPhaseExecute);
+                slot.started = false;
+                issued++;
+                in_flight++;
+                more = timed || issued < config_.txns_per_thread;
+            }
+            if (!slot.started) {
+                if (now < slot.not_before) {
+                    next_wake = std::min(next_wake, slot.not_before);
+                    continue;
+                }
+                slot.started = true;
+                allocs.Mark();
+                slot.task.Start();
+                allocs.Charge(slot.tmpl_idx, kPhaseExecute);
+            }
+        }
+
+        // One batched fetch for every read the coroutines are waiting on
+        share_with(true);
+        allocs.Mark();
+        size_t resumed = io.Pending() > 0 ? io.Poll() : 0;
+        allocs.ChargeShared(sharing, kPhaseExecute);
+
+        for (auto& slot : slots) {
+            if (!slot.task.Valid() || !slot.started || !slot.task.Done()) continue;
+            const auto& tmpl = config_.templates[slot.tmpl_idx];
+            allocs.Mark();
+            bool committed = RecordAttempt(thread_id, tmpl, slot.keys, slot.task.Result(),
+                                           slot.retries, slot.wall_start);
+            allocs.Charge(slot.tmpl_idx, kPhaseRecord);
+            if (committed) {
+                slot.task = AsyncTxn();
+                in_flight--;
+            } else {
+                // Retry from scratch once the backoff has passed
+                slot.not_before = Clock::now() + std::chrono::microseconds(BackoffUs(slot.retries, rng));
+                slot.task = tmpl.async_execute(mgr_, io, slot.keys);
+                allocs.Charge(slot.tmpl_idx, kPhaseExecute);
+                slot.started = false;
+                next_wake = std::min(next_wake, slot.not_before);
+            }
+        }
+
+        if (in_flight == 0 && !more) break;
+        if (resumed == 0 && io.Pending() == 0 && next_wake != Clock::time_point::max()) {
+            // Everything is backing off
+            share_with(false);
+            allocs.Mark();
+            std::this_thread::sleep_until(next_wake);
+            allocs.ChargeShared(sharing, kPhaseBackoff);
+        } else if (resumed == 0 && io.Pending() > 0) {
+            // Only lock waits and commits left: wait for a commit to complete,
+            // or give the lock holders on other threads a moment
+            share_with(true);
+            allocs.Mark();
+            io.WaitForCommit(std::chrono::microseconds(config_.retry_backoff_base_us));
+            allocs.ChargeShared(sharing, kPhaseBackoff);
+        }
+    }
+
+    metrics_.RecordAsyncBatches(io.Batches(), io.BatchedKeys());
+    allocs.Report(metrics_, config_.templates);
 
-            if (result.success) {
-                auto wall_end = std::chrono::steady_clock::now();
-                double latency_us = std::chrono::duration<double, std::micro>(
-                    wall_end - wall_start).count();
-                metrics_.RecordCommit(tmpl.name, latency_us);
-                break;
+    if (config_.hot_keys) {
+        config_.hot_keys->Flush(thread_id);
+    }
+
+    metrics_.RecordWorkerElapsed(thread_id, std::chrono::duration<double>(
+        Clock::now() - worker_start).count());
+}
+
+void WorkloadExecutor::BatchWorkerThread(int thread_id) {
+    using Clock = std::chrono::steady_clock;
+    auto worker_start = Clock::now();
+    std::mt19937 rng(thread_id + worker_start.time_since_epoch().count());
+    KeySelector key_selector(config_.contention, rng);
+    std::vector<double> weights;
+    for (const auto& tmpl : config_.templates) weights.push_back(tmpl.weight);
+    std::discrete_distribution<size_t> template_dist(weights.begin(), weights.end());
+
+    // A transaction stays in the window until it commits; failed ones sit
+    // out their backoff and rejoin a later batch
+    struct Entry {
+        size_t tmpl_idx;
+        BatchRequest request;
+        Clock::time_point wall_start;
+        Clock::time_point not_before;
+        int retries = 0;
+    };
+    std::vector<Entry> window;
+
+    // A batch's execution, and a sleep waiting out backoffs, is shared evenly
+    // across the transactions it covered
+    AllocLedger allocs(config_.templates.size());
+    std::vector<size_t> sharing;
+
+    const bool timed = config_.duration_s > 0.0;
+    int issued = 0;
+    while (true) {
+        auto now = Clock::now();
+        bool more = timed ? now < deadline_ : issued < config_.txns_per_thread;
+        while (more && window.size() < static_cast<size_t>(config_.batch_size)) {
+            size_t tmpl_idx = template_dist(rng);
+            const auto& tmpl = config_.templates[tmpl_idx];
+            allocs.Mark();
+            std::vector<std::string> keys = tmpl.key_builder
+                ? tmpl.key_builder(rng)
+                : key_selector.SelectDistinctKeys(tmpl.num_input_keys);
+            allocs.Charge(tmpl_idx, kPhaseSelectKeys);
+            window.push_back({tmpl_idx, {&tmpl, std::move(keys)}, now, now, 0});
+            issued++;
+            more = timed || issued < config_.txns_per_thread;
+        }
+        if (window.empty()) break;
+
+        std::vector<size_t> ready;
+        Clock::time_point next_wake = Clock::time_point::max();
+        std::vector<BatchRequest> batch;
+        allocs.Mark();
+        sharing.clear();
+        for (size_t i = 0; i < window.size(); i++) {
+            if (window[i].not_before <= now) {
+                ready.push_back(i);
+                batch.push_back(window[i].request);
+                sharing.push_back(window[i].tmpl_idx);
             } else {
-                metrics_.RecordAbort(tmpl.name);
-                retries++;
+                next_wake = std::min(next_wake, window[i].not_before);
+            }
+        }
+        if (batch.empty()) {
+            // Everything is backing off
+            for (const auto& entry : window) sharing.push_back(entry.tmpl_idx);
+            std::this_thread::sleep_until(next_wake);
+            allocs.ChargeShared(sharing, kPhaseBackoff);
+            continue;
+        }
 
-                // Exponential backoff with jitter
-                int backoff_us = config_.retry_backoff_base_us * (1 << std::min(retries, 10));
-                std::uniform_int_distribution<int> jitter(0, backoff_us);
-                std::this_thread::sleep_for(std::chrono::microseconds(backoff_us + jitter(rng)));
+        std::vector<CommitResult> results = ExecuteBatch(mgr_, batch, config_.retry_backoff_base_us);
+        allocs.ChargeShared(sharing, kPhaseExecute);
+        std::vector<bool> committed(window.size(), false);
+        for (size_t k = 0; k < ready.size(); k++) {
+            Entry& entry = window[ready[k]];
+            committed[ready[k]] = RecordAttempt(thread_id, *entry.request.tmpl, entry.request.keys,
+                                                results[k], entry.retries, entry.wall_start);
+            allocs.Charge(entry.tmpl_idx, kPhaseRecord);
+            if (!committed[ready[k]]) {
+                entry.not_before = Clock::now() + std::chrono::microseconds(BackoffUs(entry.retries, rng));
             }
         }
+        size_t kept = 0;
+        for (size_t i = 0; i < window.size(); i++) {
+            if (committed[i]) continue;
+            if (kept != i) window[kept] = std::move(window[i]);
+            kept++;
+        }
+        window.erase(window.begin() + kept, window.end());
+    }
+
+    allocs.Report(metrics_, config_.templates);
+
+    if (config_.hot_keys) {
+        config_.hot_keys->Flush(thread_id);
+    }
+
+    metrics_.RecordWorkerElapsed(thread_id, std::chrono::duration<double>(
+        Clock::now() - worker_start).count());
+}
+
+void WorkloadExecutor::WarnStarvation(int thread_id, const std::string& type,
+                                      const std::vector<std::string>& keys, int retries) {
+    metrics_.RecordStarvationWarning();
+    std::string key_list;
+    for (const auto& key : keys) {
+        if (!key_list.empty()) key_list += ", ";
+        key_list += key;
     }
+    std::cerr << "[watchdog] worker " << thread_id << ": " << type << " retried "
+              << retries << " times (keys: " << key_list << ")\n";
 }
 
 } // namespace txn
@@ -3,10 +3,13 @@
 
 #include <vector>
 #include <cstdint>
+#include <chrono>
+#include <random>
 #include "workload/workload_template.h"
 #include "workload/key_selector.h"
 #include "concurrency/transaction_manager.h"
 #include "metrics/metrics.h"
+#include "metrics/hot_key_tracker.h"
 
 namespace txn {
 
@@ -16,6 +19,19 @@ struct ExecutorConfig {
     ContentionConfig contention;
     std::vector<WorkloadTemplate> templates;
     int retry_backoff_base_us = 100;
+    HotKeyTracker* hot_keys = nullptr;  // optional access sampler, one slot per thread
+    int starvation_warn_retries = 0;    // warn when a txn retries this many times; 0 = off
+    double duration_s = 0.0;            // > 0: run for this long instead of txns_per_thread
+    // > 1: each worker keeps this many transactions in flight as coroutines
+    // (WorkloadTemplate::async_execute, required for every template), with
+    // their reads batched per worker; 0 or 1: one transaction at a time
+    int queue_depth = 0;
+    // Queue-depth mode: awaited commits go through the manager's CommitAsync
+    // pipeline instead of committing on the worker thread
+    bool async_commit = false;
+    // > 1: each worker submits this many transactions at a time through
+    // ExecuteBatch, and retries the failed ones in its next batch
+    int batch_size = 0;
 };
 
 class WorkloadExecutor {
@@ -28,11 +44,22 @@ public:
 
 private:
     void WorkerThread(int thread_id);
+    void AsyncWorkerThread(int thread_id);
+    void BatchWorkerThread(int thread_id);
+    // Records the outcome of one attempt; returns true if it committed.
+    // retries counts the attempts that failed so far.
+    bool RecordAttempt(int thread_id, const WorkloadTemplate& tmpl,
+                       const std::vector<std::string>& keys, const CommitResult& result,
+                       int& retries, std::chrono::steady_clock::time_point wall_start);
+    int BackoffUs(int retries, std::mt19937& rng) const;
+    void WarnStarvation(int thread_id, const std::string& type,
+                        const std::vector<std::string>& keys, int retries);
 
     TransactionManager& mgr_;
     MetricsCollector& metrics_;
     ExecutorConfig config_;
     double elapsed_s_ = 0.0;
+    std::chrono::steady_clock::time_point deadline_;  // used when duration_s > 0
 };
 
 } // namespace txn
@@ -6,6 +6,7 @@
 #include <functional>
 #include <random>
 #include "concurrency/transaction_manager.h"
+#include "workload/async_txn.h"
 
 namespace txn {
 
@@ -16,10 +17,35 @@ struct WorkloadTemplate {
     // Receives the thread-local RNG; nullptr means use the default selector.
     std::function<std::vector<std::string>(std::mt19937&)> key_builder;
     std::function<CommitResult(TransactionManager&, const std::vector<std::string>&)> execute;
+    // Relative probability of picking this template; equal weights = uniform mix.
+    double weight = 1.0;
+    // Optional coroutine form of execute for queue-depth mode
+    // (ExecutorConfig::queue_depth > 1): Begin and reads are awaited through
+    // the worker's AsyncIo. Keys are taken by value: they must outlive every
+    // suspension.
+    std::function<AsyncTxn(TransactionManager&, AsyncIo&, std::vector<std::string>)> async_execute = nullptr;
+    // Keys read and written, by table prefix, and the fields used. The
+    // executor declares them to the manager under the template's name, which
+    // must be the type name execute passes to Begin. Empty: not declared.
+    AccessSet access = {};
+    // Optional: called with the transaction's keys once it has committed
+    // for good (after any batch commit), e.g. to acknowledge inserted keys
+    std::function<void(const std::vector<std::string>&)> on_commit = nullptr;
+    // Optional: whether keys sent by a client (server mode) have the shape
+    // execute expects. Unset, a template with num_input_keys == 0 derives
+    // its keys' layout from its key_builder and refuses client keys; others
+    // need at least num_input_keys keys.
+    std::function<bool(const std::vector<std::string>&)> accepts_keys = nullptr;
 };
 
+// Whether client-supplied keys may be passed to tmpl.execute (see accepts_keys)
+inline bool AcceptsClientKeys(const WorkloadTemplate& tmpl, const std::vector<std::string>& keys) {
+    if (tmpl.accepts_keys) return tmpl.accepts_keys(keys);
+    return tmpl.num_input_keys > 0 && static_cast<int>(keys.size()) >= tmpl.num_input_keys;
+}
+
 inline WorkloadTemplate MakeTransferTemplate() {
-    return {
+    WorkloadTemplate tmpl{
         "transfer",
         2,
         nullptr,
@@ -42,10 +68,14 @@ inline WorkloadTemplate MakeTransferTemplate() {
             return mgr.Commit(txn);
         }
     };
+    tmpl.access.entries = {
+        {"", AccessMode::kReadModifyWrite, {}},
+    };
+    return tmpl;
 }
 
 inline WorkloadTemplate MakeBalanceCheckTemplate() {
-    return {
+    WorkloadTemplate tmpl{
         "balance_check",
         1,
         nullptr,
@@ -58,10 +88,14 @@ inline WorkloadTemplate MakeBalanceCheckTemplate() {
             return mgr.Commit(txn);
         }
     };
+    tmpl.access.entries = {
+        {"", AccessMode::kRead, {}},
+    };
+    return tmpl;
 }
 
 inline WorkloadTemplate MakeWriteHeavyTemplate(int n) {
-    return {
+    WorkloadTemplate tmpl{
         "write_heavy",
         n,
         nullptr,
@@ -77,6 +111,10 @@ inline WorkloadTemplate MakeWriteHeavyTemplate(int n) {
             return mgr.Commit(txn);
         }
     };
+    tmpl.access.entries = {
+        {"", AccessMode::kReadModifyWrite, {}},
+    };
+    return tmpl;
 }
 
 } // namespace txn
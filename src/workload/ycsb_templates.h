@@ -0,0 +1,171 @@
+#ifndef YCSB_TEMPLATES_H
+#define YCSB_TEMPLATES_H
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include "workload/workload_template.h"
+#include "workload/zipfian.h"
+#include "workload/record.h"
+
+namespace txn {
+
+// YCSB core workloads A-F. Each YCSB operation type is its own template, so
+// the report shows per-operation latency as YCSB does; the workload mix is
+// expressed through template weights. Every transaction performs ops_per_txn
+// operations of its type (1 = classic single-operation YCSB).
+struct YcsbConfig {
+    uint64_t record_count = 10000;  // records loaded before the run
+    int field_count       = 10;     // fields per record: field0..fieldN-1
+    int field_length      = 100;    // bytes per field
+    int ops_per_txn       = 1;
+    int max_scan_length   = 100;    // scan length is uniform in [1, max]
+    double zipf_theta     = ZipfianGenerator::kDefaultTheta;
+};
+
+// Key of record keynum: "user" + 10-digit zero-padded number, so key order
+// matches insertion order and a scan is a run of consecutive keynums.
+inline std::string YcsbKey(uint64_t keynum) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "user%010llu", static_cast<unsigned long long>(keynum));
+    return buf;
+}
+
+// Inverse of YcsbKey
+inline uint64_t YcsbKeynum(const std::string& key) {
+    return std::stoull(key.substr(4));
+}
+
+// Field contents are random; execute() has no RNG of its own, so they come
+// from a thread-local generator.
+inline std::mt19937& YcsbValueRng() {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return rng;
+}
+
+inline std::string YcsbFieldValue(int length) {
+    static const char kChars[] =
+        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    std::uniform_int_distribution<int> dist(0, sizeof(kChars) - 2);
+    std::string value(length, ' ');
+    for (auto& c : value) c = kChars[dist(YcsbValueRng())];
+    return value;
+}
+
+inline std::string YcsbFieldName(int i) {
+    return "field" + std::to_string(i);
+}
+
+inline std::string YcsbRecordValue(const YcsbConfig& config) {
+    Record rec;
+    for (int i = 0; i < config.field_count; i++) {
+        rec[YcsbFieldName(i)] = YcsbFieldValue(config.field_length);
+    }
+    return SerializeRecord(rec);
+}
+
+// Templates below take their keys from a key_builder injected in
+// workload_builder.cpp (Zipfian, latest or scan ranges over the keynums).
+
+// read: keys = records to read.
+inline WorkloadTemplate MakeYcsbReadTemplate(int ops) {
+    WorkloadTemplate tmpl{
+        "read",
+        ops,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("read", keys);
+            for (const auto& key : keys) mgr.Read(txn, key);
+            return mgr.Commit(txn);
+        }
+    };
+    tmpl.access.entries = {
+        {"", AccessMode::kRead, {}},
+    };
+    return tmpl;
+}
+
+// update: overwrites every record in keys with fresh field values without
+// reading it first (YCSB writeallfields=true), so it has no read set.
+inline WorkloadTemplate MakeYcsbUpdateTemplate(const YcsbConfig& config) {
+    WorkloadTemplate tmpl{
+        "update",
+        config.ops_per_txn,
+        nullptr,
+        [config](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("update", keys);
+            for (const auto& key : keys) mgr.Write(txn, key, YcsbRecordValue(config));
+            return mgr.Commit(txn);
+        }
+    };
+    tmpl.access.entries = {
+        {"", AccessMode::kWrite, {}},
+    };
+    return tmpl;
+}
+
+// insert: keys = new keynums reserved by the key_builder.
+inline WorkloadTemplate MakeYcsbInsertTemplate(const YcsbConfig& config) {
+    WorkloadTemplate tmpl{
+        "insert",
+        config.ops_per_txn,
+        nullptr,
+        [config](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("insert", keys);
+            for (const auto& key : keys) mgr.Write(txn, key, YcsbRecordValue(config));
+            return mgr.Commit(txn);
+        }
+    };
+    tmpl.access.entries = {
+        {"", AccessMode::kWrite, {}},
+    };
+    return tmpl;
+}
+
+// scan: keys = the concatenated key ranges of ops_per_txn scans, read as
+// point reads so both protocols see the full range in their read/lock sets.
+inline WorkloadTemplate MakeYcsbScanTemplate(int ops) {
+    WorkloadTemplate tmpl{
+        "scan",
+        ops,
+        nullptr,
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("scan", keys);
+            for (const auto& key : keys) mgr.Read(txn, key);
+            return mgr.Commit(txn);
+        }
+    };
+    tmpl.access.entries = {
+        {"", AccessMode::kRead, {}},
+    };
+    return tmpl;
+}
+
+// read_modify_write: reads each record and rewrites one random field.
+inline WorkloadTemplate MakeYcsbReadModifyWriteTemplate(const YcsbConfig& config) {
+    WorkloadTemplate tmpl{
+        "read_modify_write",
+        config.ops_per_txn,
+        nullptr,
+        [config](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("read_modify_write", keys);
+            for (const auto& key : keys) {
+                auto val = mgr.Read(txn, key);
+                Record rec = val.has_value() ? DeserializeRecord(val.value()) : Record{};
+                std::uniform_int_distribution<int> field(0, config.field_count - 1);
+                rec[YcsbFieldName(field(YcsbValueRng()))] = YcsbFieldValue(config.field_length);
+                mgr.Write(txn, key, SerializeRecord(rec));
+            }
+            return mgr.Commit(txn);
+        }
+    };
+    tmpl.access.entries = {
+        {"", AccessMode::kReadModifyWrite, {}},
+    };
+    return tmpl;
+}
+
+} // namespace txn
+
+#endif // YCSB_TEMPLATES_H
@@ -0,0 +1,125 @@
+#ifndef ZIPFIAN_H
+#define ZIPFIAN_H
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace txn {
+
+// Zipfian generator over [0, items) using the rejection-free method of Gray et
+// al. ("Quickly Generating Billion-Record Synthetic Databases"), as in YCSB.
+// Item 0 is the most popular.
+//
+// zeta(n) is computed exactly once for the initial item count. When Next is
+// called with a different count (the key space grows as inserts land), the
+// tail is extended with the integral approximation of the sum, so Next stays
+// const and can be shared by all worker threads without locking.
+class ZipfianGenerator {
+public:
+    static constexpr double kDefaultTheta = 0.99;
+
+    explicit ZipfianGenerator(uint64_t items, double theta = kDefaultTheta)
+        : items_(items), theta_(theta), zeta_n_(Zeta(items, theta)) { Init(); }
+
+    // For very large item counts whose zeta is known in advance.
+    ZipfianGenerator(uint64_t items, double theta, double zeta_n)
+        : items_(items), theta_(theta), zeta_n_(zeta_n) { Init(); }
+
+    uint64_t Next(std::mt19937& rng) const { return Next(rng, items_); }
+
+    uint64_t Next(std::mt19937& rng, uint64_t items) const {
+        if (items <= 1) return 0;
+        double zeta_n = ZetaAt(items);
+        double eta = (1.0 - std::pow(2.0 / items, 1.0 - theta_)) / (1.0 - zeta2_ / zeta_n);
+
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zeta_n;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta_)) return 1;
+        uint64_t ret = static_cast<uint64_t>(items * std::pow(eta * u - eta + 1.0, alpha_));
+        return ret < items ? ret : items - 1;
+    }
+
+    // zeta(items) from zeta(items_) plus the integral of x^-theta between the
+    // two counts (midpoint-corrected).
+    double ZetaAt(uint64_t items) const {
+        if (items == items_) return zeta_n_;
+        auto integral = [this](double x) { return std::pow(x, 1.0 - theta_) / (1.0 - theta_); };
+        return zeta_n_ + integral(items + 0.5) - integral(items_ + 0.5);
+    }
+
+    static double Zeta(uint64_t n, double theta) {
+        double sum = 0.0;
+        for (uint64_t i = 1; i <= n; i++) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+private:
+    void Init() {
+        alpha_ = 1.0 / (1.0 - theta_);
+        zeta2_ = Zeta(2, theta_);
+    }
+
+    uint64_t items_;
+    double theta_;
+    double zeta_n_;
+    double alpha_ = 0.0;
+    double zeta2_ = 0.0;
+};
+
+// YCSB's scrambled Zipfian: draws from a Zipfian over a huge fixed item space
+// and hashes the result into [0, items), so popular keys are spread across the
+// key space instead of clustered at the low end.
+class ScrambledZipfianGenerator {
+public:
+    explicit ScrambledZipfianGenerator(double theta = ZipfianGenerator::kDefaultTheta)
+        : zipf_(kItemSpace, theta, theta == ZipfianGenerator::kDefaultTheta
+                                       ? kZetaItemSpace
+                                       : ZipfianGenerator(kZetaPrefix, theta).ZetaAt(kItemSpace)) {}
+
+    uint64_t Next(std::mt19937& rng, uint64_t items) const {
+        if (items == 0) return 0;
+        return Fnv1a64(zipf_.Next(rng)) % items;
+    }
+
+private:
+    // Constants from YCSB's ScrambledZipfianGenerator (theta = 0.99). Other
+    // thetas sum the first kZetaPrefix terms exactly and extend the rest.
+    static constexpr uint64_t kItemSpace = 10000000000ULL;
+    static constexpr double kZetaItemSpace = 26.46902820178302;
+    static constexpr uint64_t kZetaPrefix = 100000;
+
+    static uint64_t Fnv1a64(uint64_t value) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (int i = 0; i < 8; i++) {
+            hash ^= value & 0xff;
+            hash *= 0x100000001b3ULL;
+            value >>= 8;
+        }
+        return hash;
+    }
+
+    ZipfianGenerator zipf_;
+};
+
+// YCSB's "latest" distribution: Zipfian over recency, so the most recently
+// inserted item is the most popular.
+class SkewedLatestGenerator {
+public:
+    explicit SkewedLatestGenerator(uint64_t initial_items,
+                                   double theta = ZipfianGenerator::kDefaultTheta)
+        : zipf_(initial_items, theta) {}
+
+    uint64_t Next(std::mt19937& rng, uint64_t items) const {
+        if (items == 0) return 0;
+        return items - 1 - zipf_.Next(rng, items);
+    }
+
+private:
+    ZipfianGenerator zipf_;
+};
+
+} // namespace txn
+
+#endif // ZIPFIAN_H
@@ -95,6 +95,232 @@ void test_lock_all_or_nothing_no_partial_hold() {
     lm.ReleaseAll(3, {"a"});
 }
 
+void test_lock_acquire_each_in_order() {
+    std::cout << "\n=== Test: TryAcquireEach grants in order, ReleaseEach frees ===" << std::endl;
+
+    LockManager lm;
+    Transaction t1, t2, t3;
+    t1.txn_id = 1;
+    t1.lock_keys = {"a", "b"};
+    t2.txn_id = 2;
+    t2.lock_keys = {"b", "c"};  // overlaps t1 on "b"
+    t3.txn_id = 3;
+    t3.lock_keys = {"c", "d"};  // free, since t2 took nothing
+
+    auto acquired = lm.TryAcquireEach({&t1, &t2, &t3});
+    assert(acquired.size() == 3);
+    assert(acquired[0] && !acquired[1] && acquired[2]);
+    assert(lm.Size() == 4);
+    std::cout << "  PASSED: Later entries see earlier grants, failures hold nothing" << std::endl;
+
+    lm.ReleaseEach({&t1, &t3});
+    assert(lm.Size() == 0);
+    assert(lm.TryAcquireAll(4, {"a", "b", "c", "d"}));
+    std::cout << "  PASSED: ReleaseEach frees every granted key" << std::endl;
+
+    lm.ReleaseAll(4, {"a", "b", "c", "d"});
+}
+
+void test_lock_shared_mode() {
+    std::cout << "\n=== Test: Shared locks coexist, exclusive and upgrades wait for sole holder ===" << std::endl;
+
+    LockManager lm;
+    assert(lm.TryAcquireAll(1, {}, {"a"}));
+    assert(lm.TryAcquireAll(2, {"b"}, {"a"}));  // shares "a", holds "b"
+    assert(!lm.TryAcquireAll(3, {"a"}));        // exclusive: readers present
+    assert(!lm.TryAcquireAll(3, {}, {"b"}));    // shared: exclusive holder present
+    assert(lm.Size() == 2);
+    std::cout << "  PASSED: Readers share, writers and readers exclude each other" << std::endl;
+
+    assert(!lm.TryUpgrade(1, "a"));  // txn 2 still shares it
+    lm.ReleaseAll(2, {"b"}, {"a"});
+    assert(lm.TryUpgrade(1, "a"));
+    assert(!lm.TryAcquireAll(3, {}, {"a"}));
+    lm.ReleaseAll(1, {"a"});
+    assert(lm.Size() == 0);
+    std::cout << "  PASSED: Sole reader upgrades; releases free every mode" << std::endl;
+}
+
+void test_lock_acquire_queues_until_release() {
+    std::cout << "\n=== Test: Acquire queues blocked requests and grants them on release ===" << std::endl;
+
+    LockManager lm;
+    assert(lm.TryAcquireAll(1, {"a"}));
+
+    Transaction blocked;
+    blocked.txn_id = 2;
+    blocked.lock_keys = {"a", "b"};
+    std::atomic<bool> done{false};
+    int passes = -1;
+    std::thread waiter([&] {
+        passes = lm.Acquire(blocked);
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(!done);
+    assert(lm.Size() == 1);  // queued holding nothing, not partially granted
+    std::cout << "  PASSED: Conflicting request waits without holding locks" << std::endl;
+
+    lm.ReleaseAll(1, {"a"});
+    waiter.join();
+    assert(done && passes == 1);
+    assert(lm.Size() == 2);
+    lm.ReleaseAll(2, blocked.lock_keys);
+    std::cout << "  PASSED: Release grants the queued request" << std::endl;
+
+    // Many threads contending for a few keys: every request is granted once,
+    // by fewer grant passes than requests when arrivals are batched
+    const int NUM_THREADS = 8;
+    const int ACQUIRES_PER_THREAD = 200;
+    std::atomic<int> in_critical{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&, t] {
+            Transaction txn;
+            txn.lock_keys = {"hot_" + std::to_string(t % 2)};
+            for (int i = 0; i < ACQUIRES_PER_THREAD; i++) {
+                txn.txn_id = 100 + t * ACQUIRES_PER_THREAD + i;
+                lm.Acquire(txn);
+                assert(++in_critical <= 2);  // one holder per key
+                in_critical--;
+                lm.ReleaseAll(txn.txn_id, txn.lock_keys);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    assert(lm.Size() == 0);
+    assert(lm.QueuedRequests() == 1 + NUM_THREADS * ACQUIRES_PER_THREAD);
+    assert(lm.GrantPasses() <= lm.QueuedRequests());
+    std::cout << "  PASSED: " << lm.QueuedRequests() << " requests granted by "
+              << lm.GrantPasses() << " grant passes" << std::endl;
+}
+
+void test_lock_exclusive_not_starved_by_readers() {
+    std::cout << "\n=== Test: A queued exclusive request is not starved by continuous shared load ===" << std::endl;
+
+    // A reader arriving behind a queued writer waits, though the key is
+    // only held shared
+    LockManager lm;
+    assert(lm.TryAcquireAll(1, {}, {"k"}));
+    Transaction writer;
+    writer.txn_id = 2;
+    writer.lock_keys = {"k"};
+    Transaction reader;
+    reader.txn_id = 3;
+    reader.shared_keys = {"k"};
+    std::atomic<bool> writer_granted{false};
+    std::atomic<bool> reader_granted{false};
+    std::thread w([&] { lm.Acquire(writer); writer_granted = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::thread r([&] { lm.Acquire(reader); reader_granted = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(!writer_granted && !reader_granted);
+
+    lm.ReleaseAll(1, {}, {"k"});
+    w.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(!reader_granted);
+    lm.ReleaseAll(writer.txn_id, writer.lock_keys);
+    r.join();
+    lm.ReleaseAll(reader.txn_id, {}, reader.shared_keys);
+    assert(lm.Size() == 0);
+    std::cout << "  PASSED: Later shared request waits behind the queued exclusive one" << std::endl;
+
+    // Overlapping readers keep "k" shared almost all the time; the writer
+    // still gets it well before they give up
+    const int NUM_READERS = 8;
+    std::atomic<bool> writer_done{false};
+    std::atomic<int> reads{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < NUM_READERS; t++) {
+        readers.emplace_back([&, t] {
+            Transaction txn;
+            txn.shared_keys = {"k"};
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            for (uint64_t i = 0; !writer_done && std::chrono::steady_clock::now() < deadline; i++) {
+                txn.txn_id = 100 + t * 1000000 + i;
+                lm.Acquire(txn);
+                reads++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                lm.ReleaseAll(txn.txn_id, {}, txn.shared_keys);
+            }
+        });
+    }
+    while (reads < NUM_READERS * 4) std::this_thread::yield();
+
+    writer.txn_id = 4;
+    auto start = std::chrono::steady_clock::now();
+    lm.Acquire(writer);
+    auto waited = std::chrono::steady_clock::now() - start;
+    writer_done = true;
+    lm.ReleaseAll(writer.txn_id, writer.lock_keys);
+    for (auto& t : readers) t.join();
+
+    assert(waited < std::chrono::seconds(2));
+    assert(lm.Size() == 0);
+    std::cout << "  PASSED: Writer granted after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(waited).count()
+              << " ms under " << NUM_READERS << " overlapping readers" << std::endl;
+}
+
+void test_lock_inheritance() {
+    std::cout << "\n=== Test: Inherited locks are taken back by their thread, handed over to others ===" << std::endl;
+
+    LockManager lm(LockInheritance::kOn);
+    Transaction txn;
+    txn.lock_keys = {"D_1"};
+    for (uint64_t id = 1; id <= 2; id++) {
+        txn.txn_id = id;
+        lm.Acquire(txn);
+        lm.ReleaseAll(id, txn.lock_keys);  // the second release finds D_1 recent: parked
+    }
+    assert(lm.Size() == 0);  // parked locks are free to others
+    txn.txn_id = 3;
+    assert(lm.Acquire(txn) == 0);
+    assert(lm.InheritedLocks() == 1 && lm.QueuedRequests() == 2);
+    assert(!lm.TryAcquireAll(99, {"D_1"}));  // held again, exclusively
+    std::cout << "  PASSED: Next transaction takes the parked lock back without queueing" << std::endl;
+
+    lm.ReleaseAll(3, txn.lock_keys);
+    std::thread other([&] {
+        Transaction theirs;
+        theirs.txn_id = 4;
+        theirs.lock_keys = {"D_1"};
+        lm.Acquire(theirs);
+        lm.ReleaseAll(4, theirs.lock_keys);
+    });
+    other.join();
+    assert(lm.HandOvers() == 1);
+    txn.txn_id = 5;
+    lm.Acquire(txn);  // taken over meanwhile: queues like any request
+    assert(lm.InheritedLocks() == 1 && lm.QueuedRequests() == 4);
+    lm.ReleaseAll(5, txn.lock_keys);
+    std::cout << "  PASSED: Another thread takes a parked lock over" << std::endl;
+
+    // Workers alternating between hot keys: locks stay exclusive
+    const int NUM_THREADS = 4;
+    std::atomic<int> holders[2] = {{0}, {0}};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&, t] {
+            Transaction mine;
+            for (int i = 0; i < 300; i++) {
+                int key = (t + i / 10) % 2;
+                mine.txn_id = 100 + t * 1000 + i;
+                mine.lock_keys = {"hot_" + std::to_string(key)};
+                lm.Acquire(mine);
+                assert(++holders[key] == 1);
+                holders[key]--;
+                lm.ReleaseAll(mine.txn_id, mine.lock_keys);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    assert(lm.Size() == 0);
+    std::cout << "  PASSED: " << lm.InheritedLocks() << " inherited, " << lm.HandOvers()
+              << " handed over, never two holders" << std::endl;
+}
+
 // ============================================================
 // Phase 2: TwoPLManager single-threaded tests
 // ============================================================
@@ -185,6 +411,195 @@ void test_2pl_no_contention_zero_retries() {
     db.Close();
 }
 
+void test_2pl_undeclared_keys() {
+    std::cout << "\n=== Test: Undeclared keys are locked without waiting ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("a", "1");
+    db.Put("x", "10");
+
+    TwoPLManager mgr(db);
+
+    // Free undeclared key: locked on first touch, commit succeeds
+    auto txn1 = mgr.Begin("undeclared_free", {"a"});
+    auto v = mgr.Read(txn1, "x");
+    assert(v.has_value() && v.value() == "10");
+    mgr.Write(txn1, "x", "11");
+    assert(mgr.Commit(txn1).success);
+    assert(db.Get("x").value() == "11");
+
+    // Undeclared key held by another transaction: txn is doomed
+    auto holder = mgr.Begin("holder", {"x"});
+    auto txn2 = mgr.Begin("undeclared_held", {"a"});
+    assert(!mgr.Read(txn2, "x").has_value());
+    mgr.Write(txn2, "a", "2");
+    auto result = mgr.Commit(txn2);
+    assert(!result.success);
+    assert(result.conflict_key == "x");
+    assert(db.Get("a").value() == "1");  // writes of the doomed txn are dropped
+    mgr.Commit(holder);
+
+    // All locks were released: both keys can be taken again
+    auto txn3 = mgr.Begin("after", {"a", "x"});
+    assert(mgr.Commit(txn3).success);
+    std::cout << "  PASSED: Free undeclared keys commit, held ones fail the commit" << std::endl;
+
+    db.Close();
+}
+
+void test_2pl_prepare_votes() {
+    std::cout << "\n=== Test: Prepare keeps locks, doomed txns vote no ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("a", "1");
+    db.Put("x", "10");
+
+    TwoPLManager mgr(db);
+    auto locked = [&mgr]() { return mgr.StructureSizes()[0].second; };  // lock_table
+
+    auto txn1 = mgr.Begin("prepared", {"a"});
+    mgr.Write(txn1, "a", "2");
+    assert(mgr.Prepare(txn1));
+    assert(txn1.status == TxnStatus::PREPARED);
+    assert(locked() == 1);  // still locked until Commit
+    assert(mgr.Commit(txn1).success);
+    assert(db.Get("a").value() == "2");
+    assert(locked() == 0);
+
+    // Undeclared key held elsewhere: the prepare fails and releases everything
+    auto holder = mgr.Begin("holder", {"x"});
+    auto txn2 = mgr.Begin("doomed", {"a"});
+    mgr.Write(txn2, "x", "11");
+    assert(!mgr.Prepare(txn2));
+    mgr.Commit(holder);
+    assert(locked() == 0);
+    assert(db.Get("x").value() == "10");
+    std::cout << "  PASSED: Prepared txns hold their locks, doomed ones vote no" << std::endl;
+
+    db.Close();
+}
+
+void test_2pl_batch_begin_and_commit() {
+    std::cout << "\n=== Test: BeginBatch / CommitBatch ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("a", "1");
+    db.Put("b", "2");
+
+    TwoPLManager mgr(db);
+    auto locked = [&mgr]() { return mgr.StructureSizes()[0].second; };  // lock_table
+
+    auto txns = mgr.BeginBatch({{"first", {"a"}}, {"overlap", {"a", "b"}}, {"second", {"b"}}});
+    assert(txns.size() == 3);
+    assert(txns[0].has_value() && !txns[1].has_value() && txns[2].has_value());
+    assert(locked() == 2);
+    std::cout << "  PASSED: Busy request gets nullopt, the others hold their locks" << std::endl;
+
+    std::vector<Transaction> batch = {std::move(*txns[0]), std::move(*txns[2])};
+    mgr.Write(batch[0], "a", "10");
+    mgr.Write(batch[1], "b", "20");
+    auto results = mgr.CommitBatch(batch);
+    assert(results.size() == 2 && results[0].success && results[1].success);
+    assert(db.Get("a").value() == "10" && db.Get("b").value() == "20");
+    assert(locked() == 0);
+    std::cout << "  PASSED: Batch writes applied and every lock released" << std::endl;
+
+    db.Close();
+}
+
+void test_2pl_declared_reads_share_locks() {
+    std::cout << "\n=== Test: Keys declared read-only are locked shared ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("C_1", "100");
+    db.Put("CL_1", "1");
+    db.Put("X_1", "5");
+
+    TwoPLManager mgr(db);
+    auto locked = [&mgr]() { return mgr.StructureSizes()[0].second; };  // lock_table
+
+    AccessSet lookup;
+    lookup.entries = {{"CL_", AccessMode::kRead, {"ids"}}, {"C_", AccessMode::kReadModifyWrite, {}}};
+    mgr.Declare("lookup", lookup);
+    AccessSet report;
+    report.entries = {{"", AccessMode::kRead, {}}};
+    mgr.Declare("report", report);
+    assert(mgr.Declared("report")->ReadOnly() && !mgr.Declared("lookup")->ReadOnly());
+    assert(mgr.Declared("other") == nullptr);
+
+    // "CL_" is shared, "C_" exclusive: the prefixes do not overlap
+    auto t1 = mgr.Begin("lookup", {"CL_1", "C_1"});
+    assert(t1.shared_keys.size() == 1 && t1.lock_keys.size() == 1);
+    auto t2 = mgr.Begin("report", {"CL_1"});
+    assert(locked() == 2);
+    assert(!mgr.TryBegin("report", {"C_1"}).has_value());
+    assert(!mgr.TryBegin("lookup", {"C_1"}).has_value());
+
+    // Undeclared read-only key: shared, so another reader still gets it
+    assert(mgr.Read(t2, "X_1").value() == "5");
+    auto t3 = mgr.TryBegin("report", {"X_1"});
+    assert(t3.has_value());
+    std::cout << "  PASSED: Readers share declared and undeclared keys" << std::endl;
+
+    // Writing a key held shared with another reader dooms the writer
+    mgr.Write(t2, "CL_1", "2");
+    assert(!mgr.Commit(t2).success);
+    assert(mgr.Commit(*t3).success);
+    // t1 is now the only holder of CL_1 and upgrades
+    mgr.Write(t1, "CL_1", "3");
+    assert(mgr.Commit(t1).success);
+    assert(db.Get("CL_1").value() == "3");
+    assert(locked() == 0);
+    std::cout << "  PASSED: Upgrades need the sole shared lock; all locks released" << std::endl;
+
+    db.Close();
+}
+
+void test_2pl_isolation_levels() {
+    std::cout << "\n=== Test: Weaker isolation levels lock less ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "100");
+    db.Put("B", "0");
+
+    TwoPLManager mgr(db);
+    auto locked = [&mgr]() { return mgr.StructureSizes()[0].second; };  // lock_table
+    mgr.SetIsolation("rc", IsolationLevel::kReadCommitted);
+    mgr.SetIsolation("si", IsolationLevel::kSnapshot);
+
+    // Read committed: undeclared reads take no lock
+    auto rc = mgr.Begin("rc");
+    assert(mgr.Read(rc, "A").value() == "100");
+    assert(locked() == 0);
+    auto writer = mgr.TryBegin("w", {"A"});
+    assert(writer.has_value());
+    mgr.Write(*writer, "A", "90");
+    assert(mgr.Commit(*writer).success);
+    assert(mgr.Read(rc, "A").value() == "90");
+    assert(mgr.Commit(rc).success);
+    std::cout << "  PASSED: Read-committed reads do not block writers" << std::endl;
+
+    // Snapshot: reads come from Begin's snapshot; a write to a key changed
+    // since then dooms the txn (first committer wins)
+    auto si = mgr.Begin("si");
+    assert(mgr.Read(si, "A").value() == "90");
+    auto writer2 = mgr.TryBegin("w", {"A"});
+    assert(writer2.has_value());
+    mgr.Write(*writer2, "A", "80");
+    assert(mgr.Commit(*writer2).success);
+    assert(mgr.Read(si, "A").value() == "90");  // as of Begin
+    mgr.Write(si, "B", "10");  // unchanged since Begin
+    assert(si.status == TxnStatus::ACTIVE);
+    mgr.Write(si, "A", "70");
+    assert(si.status == TxnStatus::ABORTED);
+    assert(!mgr.Commit(si).success);
+    assert(db.Get("A").value() == "80" && db.Get("B").value() == "0");
+    assert(locked() == 0);
+    std::cout << "  PASSED: Snapshot reads are stable; stale writes abort" << std::endl;
+
+    db.Close();
+}
+
 // ============================================================
 // Phase 3: Multi-threaded correctness
 // ============================================================
@@ -354,14 +769,19 @@ void test_2pl_high_contention_all_commit() {
         }
     };
 
+    // Hold every hot key while the workers start, so their first requests
+    // queue behind it whatever the core count
+    auto holder = mgr.Begin("hot_hold", {"hot_0", "hot_1", "hot_2"});
     std::vector<std::thread> threads;
     for (int t = 0; t < NUM_THREADS; t++) {
         threads.emplace_back(worker, t);
     }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(mgr.Commit(holder).success);
     for (auto& t : threads) t.join();
 
     std::cout << "  Commits: " << total_commits.load()
-              << ", Lock retries (backoffs): " << total_retries.load() << std::endl;
+              << ", Lock retries (grant passes waited): " << total_retries.load() << std::endl;
 
     assert(total_commits.load() == NUM_THREADS * TXNS_PER_THREAD);
     assert(total_retries.load() > 0);  // contention caused some retries
@@ -426,12 +846,22 @@ int main() {
         test_lock_acquire_fails_if_held();
         test_lock_release_allows_reacquire();
         test_lock_all_or_nothing_no_partial_hold();
+        test_lock_acquire_each_in_order();
+        test_lock_shared_mode();
+        test_lock_acquire_queues_until_release();
+        test_lock_exclusive_not_starved_by_readers();
+        test_lock_inheritance();
 
         // Phase 2: TwoPLManager single-threaded
         test_2pl_basic_commit();
         test_2pl_read_your_writes();
         test_2pl_commit_always_success();
         test_2pl_no_contention_zero_retries();
+        test_2pl_undeclared_keys();
+        test_2pl_prepare_votes();
+        test_2pl_batch_begin_and_commit();
+        test_2pl_declared_reads_share_locks();
+        test_2pl_isolation_levels();
 
         // Phase 3: Multi-threaded correctness
         test_2pl_partitioned_zero_retries();
@@ -0,0 +1,358 @@
+#include "workload/async_txn.h"
+#include "workload/batch_executor.h"
+#include "workload/workload_executor.h"
+#include "workload/workload_template.h"
+#include "concurrency/manager_factory.h"
+#include "metrics/metrics.h"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace txn;
+
+static void open_fresh(Database& db, const std::map<std::string, std::string>& data) {
+    std::filesystem::remove_all("test_async_db");
+    assert(db.Open("test_async_db"));
+    assert(db.InitializeWithData(data));
+}
+
+// Transfer of 10 between two plain integer balances, awaiting both reads at
+// once and then the commit
+static AsyncTxn AsyncTransfer(TransactionManager& mgr, AsyncIo& io, std::vector<std::string> keys) {
+    Transaction txn = co_await io.Begin("transfer", keys);
+    auto values = co_await io.Read(txn, keys);
+    mgr.Write(txn, keys[0], std::to_string(std::stoi(values[0].value()) - 10));
+    mgr.Write(txn, keys[1], std::to_string(std::stoi(values[1].value()) + 10));
+    co_return co_await io.Commit(std::move(txn));
+}
+
+static void run_until_done(AsyncIo& io, const std::vector<AsyncTxn*>& txns) {
+    auto done = [&txns] {
+        for (AsyncTxn* t : txns) {
+            if (!t->Done()) return false;
+        }
+        return true;
+    };
+    while (!done()) {
+        io.Poll();
+        if (!done()) io.WaitForCommit(std::chrono::microseconds(1000));
+    }
+}
+
+static AsyncTxn OverwriteThenRead(TransactionManager& mgr, AsyncIo& io, std::vector<std::string> keys) {
+    Transaction txn = co_await io.Begin("overwrite", keys);
+    mgr.Write(txn, keys[0], "7");
+    auto values = co_await io.Read(txn, keys);
+    assert(values[0].value() == "7");
+    co_return mgr.Commit(txn);
+}
+
+// ============================================================
+// Phase 1: AsyncIo
+// ============================================================
+
+void test_reads_of_suspended_txns_share_one_fetch() {
+    std::cout << "\n=== Test: Suspended reads are served by one batched fetch ===" << std::endl;
+
+    Database db;
+    open_fresh(db, {{"A_1", "100"}, {"A_2", "200"}, {"A_3", "300"}, {"A_4", "400"}});
+    auto mgr = MakeTransactionManager("occ", db);
+    AsyncIo io(*mgr, true);
+
+    AsyncTxn first = AsyncTransfer(*mgr, io, {"A_1", "A_2"});
+    AsyncTxn second = AsyncTransfer(*mgr, io, {"A_3", "A_4"});
+    first.Start();
+    second.Start();
+    assert(!first.Done() && !second.Done());
+    assert(io.Pending() == 2);  // both parked on their reads, nothing fetched yet
+
+    assert(io.Poll() == 2);
+    run_until_done(io, {&first, &second});  // commits complete on the committer thread
+    assert(first.Result().success && second.Result().success);
+    assert(io.Batches() == 1 && io.BatchedKeys() == 4);
+    assert(db.Get("A_1").value() == "90" && db.Get("A_4").value() == "410");
+    std::cout << "  PASSED: Two transactions, four keys, one fetch" << std::endl;
+
+    // Read-your-writes is served without suspending
+    AsyncTxn local = OverwriteThenRead(*mgr, io, {"A_1"});
+    local.Start();
+    assert(local.Done() && local.Result().success && io.Batches() == 1);
+    std::cout << "  PASSED: Buffered writes answer reads without a fetch" << std::endl;
+
+    mgr.reset();
+    db.Close();
+}
+
+void test_busy_2pl_begin_suspends_instead_of_blocking() {
+    std::cout << "\n=== Test: A 2PL begin on held locks suspends the coroutine ===" << std::endl;
+
+    Database db;
+    open_fresh(db, {{"A_1", "100"}, {"A_2", "200"}});
+    auto mgr = MakeTransactionManager("2pl", db);
+    AsyncIo io(*mgr, true);
+
+    // Same thread, same keys: a blocking Begin would wait for its own sibling forever
+    AsyncTxn holder = AsyncTransfer(*mgr, io, {"A_1", "A_2"});
+    AsyncTxn waiter = AsyncTransfer(*mgr, io, {"A_2", "A_1"});
+    holder.Start();
+    waiter.Start();
+    assert(io.Pending() == 2);  // holder on its read, waiter on the locks
+
+    run_until_done(io, {&holder, &waiter});
+    assert(holder.Result().success && waiter.Result().success);
+    assert(waiter.Result().retries > 0);
+    assert(db.Get("A_1").value() == "100" && db.Get("A_2").value() == "200");
+    assert(io.Pending() == 0);
+    std::cout << "  PASSED: Waiter resumed after the holder committed ("
+              << waiter.Result().retries << " lock retries)" << std::endl;
+
+    mgr.reset();
+    db.Close();
+}
+
+// ============================================================
+// Phase 2: Asynchronous commit
+// ============================================================
+
+void test_commit_async_futures() {
+    std::cout << "\n=== Test: CommitAsync delivers outcomes through futures ===" << std::endl;
+
+    for (const std::string protocol : {"occ", "2pl"}) {
+        std::map<std::string, std::string> data;
+        for (int a = 1; a <= 20; a++) data["A_" + std::to_string(a)] = "100";
+        Database db;
+        open_fresh(db, data);
+        auto mgr = MakeTransactionManager(protocol, db);
+
+        // Disjoint increments, all submitted before any outcome is awaited
+        std::vector<std::future<CommitResult>> outcomes;
+        for (int a = 1; a <= 20; a++) {
+            std::string key = "A_" + std::to_string(a);
+            Transaction txn = mgr->Begin("increment", {key});
+            int balance = std::stoi(mgr->Read(txn, key).value());
+            mgr->Write(txn, key, std::to_string(balance + a));
+            outcomes.push_back(mgr->CommitAsync(std::move(txn)));
+        }
+        for (auto& outcome : outcomes) assert(outcome.get().success);
+        for (int a = 1; a <= 20; a++) {
+            assert(db.Get("A_" + std::to_string(a)).value() == std::to_string(100 + a));
+        }
+
+        // The synchronous Commit still works next to the pipeline
+        Transaction txn = mgr->Begin("sync", {"A_1"});
+        mgr->Write(txn, "A_1", "0");
+        assert(mgr->Commit(txn).success && db.Get("A_1").value() == "0");
+        std::cout << "  PASSED: " << protocol << ": 20 pipelined commits applied" << std::endl;
+
+        mgr.reset();
+        db.Close();
+    }
+}
+
+void test_commit_async_stale_read_aborts() {
+    std::cout << "\n=== Test: Conflicting OCC commits in flight together ===" << std::endl;
+
+    Database db;
+    open_fresh(db, {{"A_1", "100"}});
+    auto mgr = MakeTransactionManager("occ", db);
+
+    // Both read A_1 before either commits: whether they land in one group
+    // or two, only the first may commit
+    Transaction first = mgr->Begin("first");
+    Transaction second = mgr->Begin("second");
+    int a = std::stoi(mgr->Read(first, "A_1").value());
+    int b = std::stoi(mgr->Read(second, "A_1").value());
+    mgr->Write(first, "A_1", std::to_string(a + 1));
+    mgr->Write(second, "A_1", std::to_string(b + 2));
+    auto first_outcome = mgr->CommitAsync(std::move(first));
+    auto second_outcome = mgr->CommitAsync(std::move(second));
+    assert(first_outcome.get().success);
+    assert(!second_outcome.get().success);
+    assert(db.Get("A_1").value() == "101");
+    std::cout << "  PASSED: Second commit saw the first's write and aborted" << std::endl;
+
+    // Callback form
+    std::promise<bool> called;
+    Transaction blind = mgr->Begin("blind");
+    mgr->Write(blind, "A_2", "5");
+    mgr->CommitAsync(std::move(blind), [&called](const CommitResult& result) {
+        called.set_value(result.success);
+    });
+    assert(called.get_future().get() && db.Get("A_2").value() == "5");
+    for (const auto& [name, size] : mgr->StructureSizes()) {
+        if (name == "active_txns") assert(size == 0);
+    }
+    std::cout << "  PASSED: Completion callback runs with the outcome" << std::endl;
+
+    mgr.reset();
+    db.Close();
+}
+
+// ============================================================
+// Phase 3: Queue-depth executor
+// ============================================================
+
+void test_queue_depth_executor_conserves_balance() {
+    std::cout << "\n=== Test: Queue-depth workers commit every transfer ===" << std::endl;
+
+    const int NUM_ACCOUNTS = 8;
+    for (const std::string protocol : {"occ", "2pl"}) {
+        std::map<std::string, std::string> data;
+        for (int a = 1; a <= NUM_ACCOUNTS; a++) data["A_" + std::to_string(a)] = "1000";
+        Database db;
+        open_fresh(db, data);
+        auto mgr = MakeTransactionManager(protocol, db);
+
+        ExecutorConfig config;
+        config.num_threads = 2;
+        config.txns_per_thread = 200;
+        config.queue_depth = 8;
+        config.async_commit = true;
+        config.retry_backoff_base_us = 20;
+        WorkloadTemplate transfer = MakeTransferTemplate();
+        transfer.key_builder = [](std::mt19937& rng) {
+            std::uniform_int_distribution<int> dist(1, NUM_ACCOUNTS);
+            int a = dist(rng), b = dist(rng);
+            while (b == a) b = dist(rng);
+            return std::vector<std::string>{"A_" + std::to_string(a), "A_" + std::to_string(b)};
+        };
+        transfer.async_execute = AsyncTransfer;
+        config.templates = {transfer};
+
+        MetricsCollector metrics;
+        WorkloadExecutor executor(*mgr, metrics, config);
+        executor.Run();
+
+        assert(metrics.TotalCommits() == 400);
+        long long total = 0;
+        for (const auto& [key, _] : data) total += std::stoi(db.Get(key).value());
+        assert(total == 1000LL * NUM_ACCOUNTS);
+        for (const auto& [name, size] : mgr->StructureSizes()) {
+            if (name == "lock_table") assert(size == 0);
+        }
+        std::cout << "  PASSED: " << protocol << ": 400 commits, " << metrics.TotalAborts()
+                  << " aborts, balance conserved" << std::endl;
+
+        mgr.reset();
+        db.Close();
+    }
+}
+
+// ============================================================
+// Phase 4: Batched submission
+// ============================================================
+
+void test_execute_batch_defers_overlapping_requests() {
+    std::cout << "\n=== Test: ExecuteBatch runs overlapping requests in later rounds ===" << std::endl;
+
+    for (const std::string protocol : {"occ", "2pl"}) {
+        Database db;
+        open_fresh(db, {{"A_1", "100"}, {"A_2", "100"}, {"A_3", "100"}, {"A_4", "100"}});
+        auto mgr = MakeTransactionManager(protocol, db);
+
+        // Three transfers touch A_1 and cannot share a round
+        WorkloadTemplate transfer = MakeTransferTemplate();
+        std::vector<BatchRequest> requests = {
+            {&transfer, {"A_1", "A_2"}}, {&transfer, {"A_1", "A_3"}},
+            {&transfer, {"A_4", "A_1"}}, {&transfer, {"A_3", "A_4"}}};
+        auto results = ExecuteBatch(*mgr, requests);
+
+        assert(results.size() == 4);
+        for (const auto& result : results) assert(result.success);
+        assert(db.Get("A_1").value() == "90");
+        assert(db.Get("A_2").value() == "110");
+        assert(db.Get("A_3").value() == "100");
+        assert(db.Get("A_4").value() == "100");
+        for (const auto& [name, size] : mgr->StructureSizes()) {
+            if (name == "lock_table" || name == "active_txns") assert(size == 0);
+        }
+        std::cout << "  PASSED: " << protocol << ": 4 transfers committed, none lost" << std::endl;
+
+        mgr.reset();
+        db.Close();
+    }
+}
+
+void test_batch_executor_conserves_balance() {
+    std::cout << "\n=== Test: Batch workers commit every transfer ===" << std::endl;
+
+    const int NUM_ACCOUNTS = 8;
+    for (const std::string protocol : {"occ", "2pl"}) {
+        std::map<std::string, std::string> data;
+        for (int a = 1; a <= NUM_ACCOUNTS; a++) data["A_" + std::to_string(a)] = "1000";
+        Database db;
+        open_fresh(db, data);
+        auto mgr = MakeTransactionManager(protocol, db);
+
+        ExecutorConfig config;
+        config.num_threads = 2;
+        config.txns_per_thread = 200;
+        config.batch_size = 8;
+        config.retry_backoff_base_us = 20;
+        WorkloadTemplate transfer = MakeTransferTemplate();
+        transfer.key_builder = [](std::mt19937& rng) {
+            std::uniform_int_distribution<int> dist(1, NUM_ACCOUNTS);
+            int a = dist(rng), b = dist(rng);
+            while (b == a) b = dist(rng);
+            return std::vector<std::string>{"A_" + std::to_string(a), "A_" + std::to_string(b)};
+        };
+        config.templates = {transfer};
+
+        MetricsCollector metrics;
+        WorkloadExecutor executor(*mgr, metrics, config);
+        executor.Run();
+
+        assert(metrics.TotalCommits() == 400);
+        long long total = 0;
+        for (const auto& [key, _] : data) total += std::stoi(db.Get(key).value());
+        assert(total == 1000LL * NUM_ACCOUNTS);
+        for (const auto& [name, size] : mgr->StructureSizes()) {
+            if (name == "lock_table") assert(size == 0);
+        }
+        std::cout << "  PASSED: " << protocol << ": 400 commits, " << metrics.TotalAborts()
+                  << " aborts, balance conserved" << std::endl;
+
+        mgr.reset();
+        db.Close();
+    }
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main() {
+    std::cout << "Starting Async Transaction Tests" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    try {
+        // Phase 1: AsyncIo
+        test_reads_of_suspended_txns_share_one_fetch();
+        test_busy_2pl_begin_suspends_instead_of_blocking();
+
+        // Phase 2: Asynchronous commit
+        test_commit_async_futures();
+        test_commit_async_stale_read_aborts();
+
+        // Phase 3: Queue-depth executor
+        test_queue_depth_executor_conserves_balance();
+
+        // Phase 4: Batched submission
+        test_execute_batch_defers_overlapping_requests();
+        test_batch_executor_conserves_balance();
+
+        std::cout << "\n================================" << std::endl;
+        std::cout << "All Async Transaction Tests Passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "\nTEST FAILED with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include "cluster/cluster_manager.h"
+#include "cluster/partitioner.h"
+#include "workload/workload_executor.h"
+#include "workload/workload_template.h"
+#include "metrics/metrics.h"
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace txn;
+
+static ClusterConfig make_config(int partitions, const std::string& protocol, int latency_us = 0) {
+    ClusterConfig config;
+    config.placement.num_partitions = partitions;
+    config.protocol = protocol;
+    config.latency_us = latency_us;
+    config.handlers_per_partition = 2;
+    config.db_path = "test_cluster_db";
+    return config;
+}
+
+static size_t structure_size(TransactionManager& mgr, const std::string& name) {
+    for (const auto& [n, size] : mgr.StructureSizes()) {
+        if (n == name) return size;
+    }
+    return 0;
+}
+
+// ============================================================
+// Phase 1: Placement
+// ============================================================
+
+void test_partitioner_placement() {
+    std::cout << "\n=== Test: Warehouse placement and remote customers ===" << std::endl;
+
+    PartitionConfig config;
+    config.num_partitions = 3;
+    Partitioner local(config);
+    assert(local.PartitionOf("W_1") == 0);
+    assert(local.PartitionOf("D_2_7") == 1);
+    assert(local.PartitionOf("S_3_99") == 2);
+    assert(local.PartitionOf("W_4") == 0);
+    assert(local.PartitionOf("C_2_1_5") == local.PartitionOf("W_2"));
+    std::cout << "  PASSED: Warehouse-scoped keys follow their warehouse" << std::endl;
+
+    config.customer_offset = 1;
+    Partitioner remote(config);
+    assert(remote.PartitionOf("C_2_1_5") == 2);
+    assert(remote.PartitionOf("CL_3_1_BARBAR") == 0);
+    assert(remote.PartitionOf("D_2_1") == 1);
+    std::cout << "  PASSED: Customers placed one partition over" << std::endl;
+
+    // Keys without a warehouse are hashed, stably and in range
+    for (const std::string key : {"I_17", "A_3", "user42", "CK_9"}) {
+        int p = local.PartitionOf(key);
+        assert(p >= 0 && p < 3 && p == local.PartitionOf(key));
+    }
+    config.scheme = PartitionScheme::kHash;
+    config.num_partitions = 1;
+    assert(Partitioner(config).PartitionOf("W_3") == 0);
+    std::cout << "  PASSED: Other keys hashed into range" << std::endl;
+}
+
+// ============================================================
+// Phase 2: Two-phase commit
+// ============================================================
+
+void test_single_and_distributed_commits() {
+    std::cout << "\n=== Test: One-partition txns commit directly, others via 2PC ===" << std::endl;
+
+    ClusterManager cluster(make_config(2, "occ", 50));
+    assert(cluster.Open());
+    assert(cluster.Load({{"W_1", "100"}, {"W_2", "200"}}));
+    assert(cluster.PartitionAt(0).Db().Get("W_1").value() == "100");
+    assert(!cluster.PartitionAt(0).Db().Get("W_2").has_value());
+
+    auto txn = cluster.Begin("local", {"W_1"});
+    assert(cluster.Read(txn, "W_1").value() == "100");
+    cluster.Write(txn, "W_1", "101");
+    assert(cluster.Read(txn, "W_1").value() == "101");  // read-your-writes at the coordinator
+    assert(cluster.Commit(txn).success);
+    ClusterStats stats = cluster.Stats();
+    assert(stats.single_partition_commits == 1 && stats.messages == 0);
+    std::cout << "  PASSED: Home-partition txn commits without messages" << std::endl;
+
+    auto dist = cluster.Begin("transfer", {"W_1", "W_2"});
+    int a = std::stoi(cluster.Read(dist, "W_1").value());
+    int b = std::stoi(cluster.Read(dist, "W_2").value());
+    cluster.Write(dist, "W_1", std::to_string(a - 10));
+    cluster.Write(dist, "W_2", std::to_string(b + 10));
+    assert(dist.partitions.size() == 2 && dist.home_partition == 0);
+    assert(cluster.Commit(dist).success);
+    stats = cluster.Stats();
+    assert(stats.distributed_commits == 1);
+    // begin, read, prepare, commit on the remote partition: a request and a reply each
+    assert(stats.messages == 8);
+    assert(cluster.Get("W_1").value() == "91");
+    assert(cluster.PartitionAt(1).Db().Get("W_2").value() == "210");
+    assert(cluster.PartitionAt(0).OpenBranches() == 0 && cluster.PartitionAt(1).OpenBranches() == 0);
+    std::cout << "  PASSED: Two-partition txn commits through 2PC" << std::endl;
+
+    cluster.Close();
+}
+
+void test_prepare_no_vote_aborts_everywhere() {
+    std::cout << "\n=== Test: A no vote aborts every branch ===" << std::endl;
+
+    ClusterManager cluster(make_config(2, "occ"));
+    assert(cluster.Open());
+    assert(cluster.Load({{"W_1", "100"}, {"W_2", "200"}}));
+
+    auto dist = cluster.Begin("transfer", {"W_1", "W_2"});
+    cluster.Read(dist, "W_1");
+    cluster.Read(dist, "W_2");
+    cluster.Write(dist, "W_1", "90");
+    cluster.Write(dist, "W_2", "210");
+
+    // A conflicting single-partition commit makes partition 1 vote no
+    auto other = cluster.Begin("other", {"W_2"});
+    cluster.Write(other, "W_2", "500");
+    assert(cluster.Commit(other).success);
+
+    assert(!cluster.Commit(dist).success);
+    assert(dist.status == TxnStatus::ABORTED);
+    ClusterStats stats = cluster.Stats();
+    assert(stats.distributed_aborts == 1 && stats.distributed_commits == 0);
+    assert(cluster.Get("W_1").value() == "100");  // partition 0 had prepared; rolled back
+    assert(cluster.Get("W_2").value() == "500");
+    assert(structure_size(cluster, "prepared_keys") == 0);
+    assert(structure_size(cluster, "open_branches") == 0);
+    std::cout << "  PASSED: No partial writes, prepared keys released" << std::endl;
+
+    cluster.Close();
+}
+
+void test_cluster_transfers_conserve_balance() {
+    std::cout << "\n=== Test: Concurrent cross-partition transfers conserve the total ===" << std::endl;
+
+    const int NUM_WAREHOUSES = 6;
+    for (const std::string protocol : {"occ", "2pl"}) {
+        ClusterManager cluster(make_config(3, protocol, 20));
+        assert(cluster.Open());
+        std::map<std::string, std::string> data;
+        for (int w = 1; w <= NUM_WAREHOUSES; w++) data["W_" + std::to_string(w)] = "1000";
+        assert(cluster.Load(data));
+
+        ExecutorConfig config;
+        config.num_threads = 4;
+        config.txns_per_thread = 100;
+        config.retry_backoff_base_us = 20;
+        WorkloadTemplate transfer = MakeTransferTemplate();
+        transfer.key_builder = [](std::mt19937& rng) {
+            std::uniform_int_distribution<int> dist(1, NUM_WAREHOUSES);
+            int a = dist(rng), b = dist(rng);
+            while (b == a) b = dist(rng);
+            return std::vector<std::string>{"W_" + std::to_string(a), "W_" + std::to_string(b)};
+        };
+        config.templates = {transfer};
+
+        MetricsCollector metrics;
+        WorkloadExecutor executor(cluster, metrics, config);
+        executor.Run();
+
+        ClusterStats stats = cluster.Stats();
+        assert(metrics.TotalCommits() == 400);
+        assert(stats.single_partition_commits + stats.distributed_commits == 400);
+        assert(stats.distributed_commits > 0 && stats.single_partition_commits > 0);
+        long long total = 0;
+        for (const auto& [key, _] : data) total += std::stoi(cluster.Get(key).value());
+        assert(total == 1000LL * NUM_WAREHOUSES);
+        assert(structure_size(cluster, "open_branches") == 0);
+        assert(structure_size(cluster, "lock_table") == 0);
+        assert(structure_size(cluster, "prepared_keys") == 0);
+        std::cout << "  PASSED: " << protocol << ": " << stats.distributed_commits
+                  << " distributed + " << stats.single_partition_commits
+                  << " single-partition commits, balance conserved" << std::endl;
+
+        cluster.Close();
+    }
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main() {
+    std::cout << "Starting Cluster Tests" << std::endl;
+    std::cout << "======================" << std::endl;
+
+    try {
+        // Phase 1: Placement
+        test_partitioner_placement();
+
+        // Phase 2: Two-phase commit
+        test_single_and_distributed_commits();
+        test_prepare_no_vote_aborts_everywhere();
+        test_cluster_transfers_conserve_balance();
+
+        std::cout << "\n======================" << std::endl;
+        std::cout << "All Cluster Tests Passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "\nTEST FAILED with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -110,6 +110,32 @@ void test_persistence() {
     }
 }
 
+void test_multiget() {
+    std::cout << "\n=== Testing MultiGet ===" << std::endl;
+
+    for (bool async_io : {false, true}) {
+        Database db;
+        StorageOptions storage;
+        storage.async_io = async_io;
+        storage.collect_read_stats = true;
+        assert(db.Open("test_db", storage));
+        db.Clear();
+        assert(db.Put("a", "1"));
+        assert(db.Put("c", "3"));
+
+        auto values = db.MultiGet({"c", "b", "a", "c"});
+        assert(values.size() == 4);
+        assert(values[0].value() == "3" && !values[1].has_value());
+        assert(values[2].value() == "1" && values[3].value() == "3");
+        assert(db.MultiGet({}).empty());
+
+        ReadStats stats = db.GetReadStats();
+        assert(stats.batches == 1 && stats.hits + stats.misses == 4);
+        db.Close();
+    }
+    std::cout << "✓ MultiGet returns values in key order, with and without async_io" << std::endl;
+}
+
 int main() {
     std::cout << "Starting Database Layer Tests\n" << std::endl;
 
@@ -118,6 +144,7 @@ int main() {
         test_initialization();
         test_structured_values();
         test_persistence();
+        test_multiget();
 
         std::cout << "\n=== All Tests Passed! ===" << std::endl;
     } catch (const std::exception& e) {
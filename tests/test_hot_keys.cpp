@@ -0,0 +1,177 @@
+#include "metrics/hot_key_tracker.h"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <random>
+#include <string>
+
+using namespace txn;
+
+// ============================================================
+// Phase 1: CountMinSketch
+// ============================================================
+
+void test_sketch_never_undercounts() {
+    std::cout << "\n=== Test: Sketch Never Undercounts ===" << std::endl;
+
+    CountMinSketch sketch(64, 4);
+    for (uint64_t h = 1; h <= 500; h++) {
+        sketch.Add(h * 0x9e3779b97f4a7c15ULL, h % 7 + 1);
+    }
+    for (uint64_t h = 1; h <= 500; h++) {
+        assert(sketch.Estimate(h * 0x9e3779b97f4a7c15ULL) >= h % 7 + 1);
+    }
+    std::cout << "  PASSED: Every estimate >= true count" << std::endl;
+}
+
+void test_sketch_merge() {
+    std::cout << "\n=== Test: Sketch Merge ===" << std::endl;
+
+    CountMinSketch a(1024, 4);
+    CountMinSketch b(1024, 4);
+    a.Add(42, 10);
+    b.Add(42, 5);
+    a.Merge(b);
+    assert(a.Estimate(42) == 15);
+
+    a.Clear();
+    assert(a.Estimate(42) == 0);
+    std::cout << "  PASSED: Merge sums counters, Clear resets them" << std::endl;
+}
+
+// ============================================================
+// Phase 2: HotKeyTracker
+// ============================================================
+
+void test_tracker_finds_hot_keys() {
+    std::cout << "\n=== Test: Tracker Finds Hot Keys ===" << std::endl;
+
+    HotKeyConfig config;
+    config.top_k = 3;
+    config.merge_interval = 64;
+    HotKeyTracker tracker(1, config);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> cold(0, 999);
+    for (int i = 0; i < 20000; i++) {
+        // 60% of accesses go to three hot keys
+        if (i % 5 < 3) {
+            tracker.RecordAccess(0, "hot_" + std::to_string(i % 3));
+        } else {
+            tracker.RecordAccess(0, "cold_" + std::to_string(cold(rng)));
+        }
+    }
+    tracker.Flush(0);
+
+    auto top = tracker.TopKeys();
+    assert(top.size() == 3);
+    for (const auto& e : top) {
+        assert(e.key.rfind("hot_", 0) == 0);
+    }
+    assert(tracker.IsHot("hot_0"));
+    assert(!tracker.IsHot("cold_1"));
+    assert(top[0].accesses >= top[1].accesses);
+    std::cout << "  PASSED: Top-3 are exactly the hot keys, sorted by accesses" << std::endl;
+}
+
+void test_tracker_conflicts() {
+    std::cout << "\n=== Test: Tracker Conflict Estimates ===" << std::endl;
+
+    HotKeyTracker tracker(1);
+    for (int i = 0; i < 100; i++) tracker.RecordAccess(0, "k");
+    tracker.RecordConflict(0, "k", 25);
+    tracker.Flush(0);
+
+    assert(tracker.EstimateAccesses("k") >= 100);
+    assert(tracker.EstimateConflicts("k") >= 25);
+    auto top = tracker.TopKeys();
+    assert(top.size() == 1 && top[0].conflicts >= 25);
+    std::cout << "  PASSED: Conflicts tracked alongside accesses" << std::endl;
+}
+
+void test_tracker_evicts_on_current_estimates() {
+    std::cout << "\n=== Test: Tracker Evicts On Current Estimates ===" << std::endl;
+
+    // One counter: every key's estimate is the total, so no newcomer ever
+    // beats a resident. The resident's stored estimate (10) is stale once
+    // other keys add to the counter.
+    HotKeyConfig config;
+    config.width = 1;
+    config.depth = 1;
+    config.top_k = 1;
+    config.merge_interval = 1;
+    HotKeyTracker tracker(1, config);
+    for (int i = 0; i < 10; i++) tracker.RecordAccess(0, "early");
+    for (int i = 0; i < 5; i++) tracker.RecordAccess(0, "late_" + std::to_string(i));
+
+    auto top = tracker.TopKeys();
+    assert(top.size() == 1 && top[0].key == "early" && top[0].accesses == 15);
+    std::cout << "  PASSED: Newcomers compared against the resident's current estimate" << std::endl;
+}
+
+void test_tracker_sampling_is_weighted() {
+    std::cout << "\n=== Test: Sampled Counts Are Weighted ===" << std::endl;
+
+    HotKeyConfig config;
+    config.sample_period = 4;
+    HotKeyTracker tracker(1, config);
+    for (int i = 0; i < 400; i++) tracker.RecordAccess(0, "k");
+    tracker.Flush(0);
+
+    assert(tracker.EstimateAccesses("k") == 400);
+    std::cout << "  PASSED: 1-in-4 sampling reports the full count" << std::endl;
+}
+
+void test_tracker_multithreaded_merge() {
+    std::cout << "\n=== Test: Per-Thread Sketches Merge ===" << std::endl;
+
+    const int NUM_THREADS = 4;
+    const int PER_THREAD = 5000;
+    HotKeyTracker tracker(NUM_THREADS);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&tracker, t]() {
+            for (int i = 0; i < PER_THREAD; i++) {
+                tracker.RecordAccess(t, "shared");
+                tracker.RecordAccess(t, "own_" + std::to_string(t));
+            }
+            tracker.Flush(t);
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    assert(tracker.EstimateAccesses("shared") >= NUM_THREADS * PER_THREAD);
+    auto top = tracker.TopKeys();
+    assert(top[0].key == "shared");
+    std::cout << "  PASSED: Shared key counted across all threads" << std::endl;
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main() {
+    std::cout << "Starting Hot-Key Tracker Tests" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    try {
+        test_sketch_never_undercounts();
+        test_sketch_merge();
+
+        test_tracker_finds_hot_keys();
+        test_tracker_conflicts();
+        test_tracker_evicts_on_current_estimates();
+        test_tracker_sampling_is_weighted();
+        test_tracker_multithreaded_merge();
+
+        std::cout << "\n==============================" << std::endl;
+        std::cout << "All Hot-Key Tracker Tests Passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "\nTEST FAILED with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include "database/database.h"
+#include "transaction/transaction.h"
+#include "concurrency/hybrid_manager.h"
+#include "concurrency/manager_factory.h"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <filesystem>
+
+using namespace txn;
+
+// Helper: open a fresh database for each test
+static Database& fresh_db(const std::string& path = "test_hybrid_db") {
+    static Database db;
+    if (db.IsOpen()) db.Close();
+    std::filesystem::remove_all(path);
+    assert(db.Open(path));
+    return db;
+}
+
+static size_t structure_size(TransactionManager& mgr, const std::string& name) {
+    for (const auto& [n, size] : mgr.StructureSizes()) {
+        if (n == name) return size;
+    }
+    return 0;
+}
+
+// ============================================================
+// Phase 1: Configuration
+// ============================================================
+
+void test_hybrid_factory_assignments() {
+    std::cout << "\n=== Test: Factory assigns protocols per template ===" << std::endl;
+
+    auto& db = fresh_db();
+    ManagerOptions options;
+    options.template_protocols = {{"payment", "2pl"}, {"new_order", "occ"}};
+    auto mgr = MakeTransactionManager("hybrid", db, options);
+    assert(mgr && mgr->ProtocolName() == "Hybrid");
+    auto* hybrid = dynamic_cast<HybridManager*>(mgr.get());
+    assert(hybrid->Locking("payment"));
+    assert(!hybrid->Locking("new_order"));
+    assert(!hybrid->Locking("delivery"));  // unlisted: OCC
+    std::cout << "  PASSED: payment locks, new_order and unlisted templates validate" << std::endl;
+
+    options.template_protocols = {{"payment", "mvcc"}};
+    assert(!MakeTransactionManager("hybrid", db, options));
+    options.template_protocols = {{"payment", ""}};
+    assert(!MakeTransactionManager("hybrid", db, options));
+    std::cout << "  PASSED: Unknown template protocols rejected" << std::endl;
+
+    db.Close();
+}
+
+// ============================================================
+// Phase 2: Conflicts across classes
+// ============================================================
+
+void test_hybrid_locking_commit_invalidates_occ_read() {
+    std::cout << "\n=== Test: A 2PL commit fails a concurrent OCC reader ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "100");
+    db.Put("B", "0");
+    HybridManager mgr(db, {"locker"});
+
+    auto reader = mgr.Begin("scanner");
+    assert(mgr.Read(reader, "A").value() == "100");
+
+    auto locker = mgr.Begin("locker", {"A"});
+    mgr.Write(locker, "A", "50");
+    assert(mgr.Commit(locker).success);
+
+    mgr.Write(reader, "B", "100");  // derived from the stale A
+    assert(!mgr.Commit(reader).success);
+    assert(db.Get("B").value() == "0");
+    std::cout << "  PASSED: OCC reader of a key a 2PL txn wrote aborts" << std::endl;
+
+    assert(structure_size(mgr, "lock_table") == 0);
+    assert(structure_size(mgr, "active_txns") == 0);
+    db.Close();
+}
+
+void test_hybrid_occ_write_yields_to_held_lock() {
+    std::cout << "\n=== Test: An OCC write to a 2PL-locked key aborts ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "100");
+    HybridManager mgr(db, {"locker"});
+
+    auto locker = mgr.Begin("locker", {"A"});
+    assert(mgr.Read(locker, "A").value() == "100");
+
+    auto writer = mgr.Begin("writer");
+    mgr.Write(writer, "A", "7");
+    assert(!mgr.Commit(writer).success);
+    assert(db.Get("A").value() == "100");
+    std::cout << "  PASSED: OCC commit aborted while the lock is held" << std::endl;
+
+    mgr.Write(locker, "A", "101");
+    assert(mgr.Commit(locker).success);
+    assert(db.Get("A").value() == "101");
+
+    auto retry = mgr.Begin("writer");
+    mgr.Write(retry, "A", "7");
+    assert(mgr.Commit(retry).success);
+    assert(db.Get("A").value() == "7");
+    assert(structure_size(mgr, "lock_table") == 0);
+    std::cout << "  PASSED: 2PL txn commits, the OCC retry succeeds after release" << std::endl;
+
+    db.Close();
+}
+
+void test_hybrid_prepare_pins_occ_keys() {
+    std::cout << "\n=== Test: A prepared OCC txn holds its keys against 2PL ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "1");
+    db.Put("B", "2");
+    HybridManager mgr(db, {"locker"});
+
+    auto occ = mgr.Begin("occ");
+    mgr.Read(occ, "A");
+    mgr.Write(occ, "B", "20");
+    assert(mgr.Prepare(occ));
+    assert(occ.status == TxnStatus::PREPARED);
+
+    assert(!mgr.TryBegin("locker", {"A"}).has_value());  // read key: held shared
+    assert(!mgr.TryBegin("locker", {"B"}).has_value());  // write key: held exclusive
+    std::cout << "  PASSED: 2PL txns cannot lock a prepared txn's keys" << std::endl;
+
+    assert(mgr.Commit(occ).success);
+    assert(db.Get("B").value() == "20");
+    auto locker = mgr.TryBegin("locker", {"A", "B"});
+    assert(locker.has_value());
+    assert(mgr.Commit(*locker).success);
+    assert(structure_size(mgr, "lock_table") == 0);
+    std::cout << "  PASSED: Keys released by the commit" << std::endl;
+
+    db.Close();
+}
+
+// ============================================================
+// Phase 3: Multi-threaded correctness
+// ============================================================
+
+void test_hybrid_mixed_transfers_conserve_balance() {
+    std::cout << "\n=== Test: Mixed 2PL and OCC transfers conserve the total ===" << std::endl;
+
+    auto& db = fresh_db();
+    const int NUM_ACCOUNTS = 10;
+    const int INITIAL_BALANCE = 1000;
+    const int NUM_THREADS = 4;
+    const int TXNS_PER_THREAD = 200;
+
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        db.Put("account_" + std::to_string(i), std::to_string(INITIAL_BALANCE));
+    }
+
+    HybridManager mgr(db, {"transfer_2pl"});
+    std::atomic<int> commits{0};
+    std::atomic<int> aborts{0};
+
+    // Even threads lock, odd threads validate
+    auto worker = [&](int thread_id) {
+        const std::string type_name = thread_id % 2 == 0 ? "transfer_2pl" : "transfer_occ";
+        std::mt19937 rng(thread_id * 31 + 5);
+        std::uniform_int_distribution<int> acct_dist(0, NUM_ACCOUNTS - 1);
+
+        for (int i = 0; i < TXNS_PER_THREAD; i++) {
+            int a = acct_dist(rng);
+            int b;
+            do { b = acct_dist(rng); } while (b == a);
+            std::string key_a = "account_" + std::to_string(a);
+            std::string key_b = "account_" + std::to_string(b);
+
+            while (true) {
+                auto txn = mgr.Begin(type_name, {key_a, key_b});
+                int bal_a = std::stoi(mgr.Read(txn, key_a).value_or("0"));
+                int bal_b = std::stoi(mgr.Read(txn, key_b).value_or("0"));
+                mgr.Write(txn, key_a, std::to_string(bal_a - 10));
+                mgr.Write(txn, key_b, std::to_string(bal_b + 10));
+                if (mgr.Commit(txn).success) break;
+                assert(type_name == "transfer_occ");  // declared keys: 2PL never fails
+                aborts++;
+            }
+            commits++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& t : threads) t.join();
+
+    long long total = 0;
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        total += std::stoi(db.Get("account_" + std::to_string(i)).value());
+    }
+    std::cout << "  Commits: " << commits.load() << ", OCC aborts: " << aborts.load() << std::endl;
+    assert(commits.load() == NUM_THREADS * TXNS_PER_THREAD);
+    assert(total == (long long)NUM_ACCOUNTS * INITIAL_BALANCE);
+    assert(structure_size(mgr, "lock_table") == 0);
+    assert(structure_size(mgr, "active_txns") == 0);
+    std::cout << "  PASSED: Balance conserved across both classes" << std::endl;
+
+    db.Close();
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main() {
+    std::cout << "Starting Hybrid Tests" << std::endl;
+    std::cout << "=====================" << std::endl;
+
+    try {
+        // Phase 1: Configuration
+        test_hybrid_factory_assignments();
+
+        // Phase 2: Conflicts across classes
+        test_hybrid_locking_commit_invalidates_occ_read();
+        test_hybrid_occ_write_yields_to_held_lock();
+        test_hybrid_prepare_pins_occ_keys();
+
+        // Phase 3: Multi-threaded correctness
+        test_hybrid_mixed_transfers_conserve_balance();
+
+        std::cout << "\n=====================" << std::endl;
+        std::cout << "All Hybrid Tests Passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "\nTEST FAILED with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "database/database.h"
 #include "transaction/transaction.h"
 #include "concurrency/occ_manager.h"
+#include "concurrency/timestamp_oracle.h"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <thread>
@@ -206,6 +208,7 @@ void test_occ_conflict_detection() {
     mgr.Write(txnA, "k1", "300");
     auto rA = mgr.Commit(txnA);
     assert(!rA.success);
+    assert(rA.conflict_key == "k1");
     assert(txnA.status == TxnStatus::ABORTED);
     std::cout << "  PASSED: Txn A correctly aborted due to write-read conflict" << std::endl;
 
@@ -293,6 +296,230 @@ void test_occ_timestamp_monotonicity() {
     db.Close();
 }
 
+static size_t structure_size(TransactionManager& mgr, const std::string& name) {
+    for (const auto& [n, size] : mgr.StructureSizes()) {
+        if (n == name) return size;
+    }
+    assert(false && "unknown structure");
+    return 0;
+}
+
+void test_occ_history_pruned() {
+    std::cout << "\n=== Test: Committed History Is Pruned ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("k1", "0");
+
+    OCCManager mgr(db);
+
+    // An old active transaction pins every record committed after it began
+    auto old_txn = mgr.Begin("old");
+    mgr.Read(old_txn, "k1");
+    for (int i = 0; i < 1000; i++) {
+        auto txn = mgr.Begin("w");
+        mgr.Write(txn, "k1", std::to_string(i));
+        assert(mgr.Commit(txn).success);
+    }
+    assert(structure_size(mgr, "committed_history") == 1000);
+    assert(structure_size(mgr, "active_txns") == 1);
+    std::cout << "  PASSED: History kept while an older txn is active" << std::endl;
+
+    // The pinned history is exactly what lets the old txn's conflict be detected
+    mgr.Write(old_txn, "k1", "stale");
+    assert(!mgr.Commit(old_txn).success);
+    assert(structure_size(mgr, "active_txns") == 0);
+    std::cout << "  PASSED: Old txn still aborts on its stale read" << std::endl;
+
+    for (int i = 0; i < 1000; i++) {
+        auto txn = mgr.Begin("w");
+        mgr.Write(txn, "k1", std::to_string(i));
+        assert(mgr.Commit(txn).success);
+    }
+    assert(structure_size(mgr, "committed_history") < 256);
+    std::cout << "  PASSED: History pruned once no txn needs it" << std::endl;
+
+    db.Close();
+}
+
+void test_occ_prepare_pins_keys() {
+    std::cout << "\n=== Test: Prepared Txn Pins Its Keys Until Commit ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("k1", "1");
+    db.Put("k2", "2");
+
+    OCCManager mgr(db);
+
+    auto prepared = mgr.Begin("prepared");
+    mgr.Read(prepared, "k1");
+    mgr.Write(prepared, "k1", "10");
+    assert(mgr.Prepare(prepared));
+    assert(prepared.status == TxnStatus::PREPARED);
+    assert(structure_size(mgr, "prepared_keys") == 1);
+
+    // A writer of the pinned key fails validation; disjoint keys still commit
+    auto writer = mgr.Begin("writer");
+    mgr.Write(writer, "k1", "99");
+    assert(!mgr.Commit(writer).success);
+    auto other = mgr.Begin("other");
+    mgr.Read(other, "k2");
+    mgr.Write(other, "k2", "20");
+    assert(mgr.Commit(other).success);
+    std::cout << "  PASSED: Commits touching a prepared key abort" << std::endl;
+
+    // Commit after Prepare cannot fail and releases the pin
+    assert(mgr.Commit(prepared).success);
+    assert(db.Get("k1").value() == "10");
+    assert(structure_size(mgr, "prepared_keys") == 0);
+
+    // A stale prepare votes no; aborting a prepared txn releases its keys
+    auto stale = mgr.Begin("stale");
+    mgr.Read(stale, "k2");
+    auto bump = mgr.Begin("bump");
+    mgr.Write(bump, "k2", "21");
+    assert(mgr.Commit(bump).success);
+    assert(!mgr.Prepare(stale));
+    auto undone = mgr.Begin("undone");
+    mgr.Write(undone, "k2", "x");
+    assert(mgr.Prepare(undone));
+    mgr.Abort(undone);
+    assert(structure_size(mgr, "prepared_keys") == 0);
+    assert(db.Get("k2").value() == "21");
+    std::cout << "  PASSED: Stale prepares vote no, aborts release the pin" << std::endl;
+
+    db.Close();
+}
+
+void test_occ_batch_begin_and_commit() {
+    std::cout << "\n=== Test: BeginBatch / CommitBatch ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("k1", "1");
+    db.Put("k2", "2");
+
+    OCCManager mgr(db);
+
+    auto txns = mgr.BeginBatch({{"writer", {"k1"}}, {"reader", {"k1"}}, {"other", {"k2"}}});
+    assert(txns.size() == 3);
+    for (const auto& txn : txns) assert(txn.has_value());
+    assert(txns[0]->start_ts == txns[1]->start_ts && txns[1]->start_ts == txns[2]->start_ts);
+    assert(txns[0]->txn_id + 1 == txns[1]->txn_id && txns[1]->txn_id + 1 == txns[2]->txn_id);
+    assert(structure_size(mgr, "active_txns") == 3);
+    std::cout << "  PASSED: One id block and one start timestamp for the batch" << std::endl;
+
+    // The reader saw k1 from before the writer's write in the same batch
+    std::vector<Transaction> batch;
+    for (auto& txn : txns) batch.push_back(std::move(*txn));
+    mgr.Write(batch[0], "k1", "10");
+    mgr.Read(batch[1], "k1");
+    mgr.Write(batch[1], "k1", "11");
+    mgr.Read(batch[2], "k2");
+    mgr.Write(batch[2], "k2", "20");
+    auto results = mgr.CommitBatch(batch);
+    assert(results.size() == 3);
+    assert(results[0].success && !results[1].success && results[2].success);
+    assert(batch[1].status == TxnStatus::ABORTED);
+    assert(db.Get("k1").value() == "10");
+    assert(db.Get("k2").value() == "20");
+    assert(structure_size(mgr, "active_txns") == 0);
+    std::cout << "  PASSED: Stale reader of an earlier member aborts, the rest commit" << std::endl;
+
+    db.Close();
+}
+
+void test_occ_read_only_fast_path() {
+    std::cout << "\n=== Test: Read-only commits skip timestamps and history ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("k1", "1");
+    db.Put("k2", "2");
+
+    OCCManager mgr(db);
+
+    auto single = mgr.Begin("single");
+    mgr.Read(single, "k1");
+    auto bump = mgr.Begin("bump");
+    mgr.Write(bump, "k1", "10");
+    assert(mgr.Commit(bump).success);
+    size_t history = structure_size(mgr, "committed_history");
+
+    // One read is consistent on its own, even though k1 changed since
+    assert(mgr.Commit(single).success);
+    assert(single.validation_ts == 0 && single.finish_ts == 0);
+    assert(structure_size(mgr, "committed_history") == history);
+    assert(structure_size(mgr, "active_txns") == 0);
+    std::cout << "  PASSED: Single-read txn commits without validation" << std::endl;
+
+    // Two reads spanning a commit still fail validation
+    auto pair = mgr.Begin("pair");
+    mgr.Read(pair, "k1");
+    auto bump2 = mgr.Begin("bump");
+    mgr.Write(bump2, "k1", "11");
+    mgr.Write(bump2, "k2", "12");
+    assert(mgr.Commit(bump2).success);
+    mgr.Read(pair, "k2");
+    assert(!mgr.Commit(pair).success);
+    assert(pair.status == TxnStatus::ABORTED);
+    assert(structure_size(mgr, "active_txns") == 0);
+    std::cout << "  PASSED: Multi-read txn is still validated" << std::endl;
+
+    db.Close();
+}
+
+void test_occ_isolation_levels() {
+    std::cout << "\n=== Test: Weaker isolation levels validate less ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("k1", "1");
+    db.Put("k2", "2");
+    db.Put("k3", "3");
+
+    OCCManager mgr(db);
+    mgr.SetIsolation("rc", IsolationLevel::kReadCommitted);
+    mgr.SetIsolation("si", IsolationLevel::kSnapshot);
+    assert(mgr.IsolationOf("other") == IsolationLevel::kSerializable);
+
+    // Read committed: reads spanning a commit are not checked
+    auto rc = mgr.Begin("rc");
+    assert(rc.isolation == IsolationLevel::kReadCommitted);
+    mgr.Read(rc, "k1");
+    auto bump = mgr.Begin("bump");
+    mgr.Write(bump, "k1", "10");
+    mgr.Write(bump, "k2", "20");
+    assert(mgr.Commit(bump).success);
+    assert(mgr.Read(rc, "k2").value() == "20");  // latest committed value
+    mgr.Write(rc, "k3", "30");
+    assert(mgr.Commit(rc).success);
+    std::cout << "  PASSED: Read-committed txn commits over a stale read" << std::endl;
+
+    // Snapshot: reads see Begin's state; only write-write conflicts abort
+    auto reader = mgr.Begin("si");
+    auto writer = mgr.Begin("si");
+    assert(mgr.Read(reader, "k1").value() == "10");
+    mgr.Read(writer, "k1");
+    auto bump2 = mgr.Begin("bump");
+    mgr.Write(bump2, "k1", "11");
+    mgr.Write(bump2, "k2", "21");
+    assert(mgr.Commit(bump2).success);
+    assert(mgr.Read(reader, "k2").value() == "20");  // as of Begin
+    assert(mgr.Commit(reader).success);
+    mgr.Write(writer, "k3", "31");  // read k1 went stale, wrote elsewhere
+    assert(mgr.Commit(writer).success);
+    std::cout << "  PASSED: Snapshot reads are consistent and stale reads are not checked" << std::endl;
+
+    auto loser = mgr.Begin("si");
+    auto winner = mgr.Begin("si");
+    mgr.Write(winner, "k1", "12");
+    mgr.Write(loser, "k1", "13");
+    assert(mgr.Commit(winner).success);
+    assert(!mgr.Commit(loser).success);
+    assert(db.Get("k1").value() == "12");
+    assert(structure_size(mgr, "active_txns") == 0);
+    std::cout << "  PASSED: Snapshot write-write conflict aborts the second committer" << std::endl;
+
+    db.Close();
+}
+
 // ============================================================
 // Phase 3: Multi-threaded correctness
 // ============================================================
@@ -381,6 +608,52 @@ void test_occ_multithread_balance_conservation() {
     db.Close();
 }
 
+void test_occ_read_committed_no_lost_update() {
+    std::cout << "\n=== Test: Read-committed increments lose no update ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("counter", "0");
+    OCCManager mgr(db);
+    mgr.SetIsolation("inc", IsolationLevel::kReadCommitted);
+
+    // Both read 0; the second to commit would overwrite the first's 1
+    auto first = mgr.Begin("inc");
+    auto second = mgr.Begin("inc");
+    mgr.Write(first, "counter", std::to_string(std::stoi(mgr.Read(first, "counter").value()) + 1));
+    mgr.Write(second, "counter", std::to_string(std::stoi(mgr.Read(second, "counter").value()) + 1));
+    assert(mgr.Commit(first).success);
+    assert(!mgr.Commit(second).success);
+    assert(second.conflict_key == "counter");
+    assert(db.Get("counter").value() == "1");
+    std::cout << "  PASSED: The second of two concurrent increments aborts" << std::endl;
+
+    const int NUM_THREADS = 4;
+    const int INCREMENTS_PER_THREAD = 200;
+    std::atomic<int> total_aborts{0};
+    auto worker = [&]() {
+        for (int i = 0; i < INCREMENTS_PER_THREAD; i++) {
+            while (true) {
+                auto txn = mgr.Begin("inc");
+                int value = std::stoi(mgr.Read(txn, "counter").value());
+                mgr.Write(txn, "counter", std::to_string(value + 1));
+                if (mgr.Commit(txn).success) break;
+                total_aborts++;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& t : threads) t.join();
+
+    std::cout << "  Aborts: " << total_aborts.load() << std::endl;
+    assert(std::stoi(db.Get("counter").value()) == 1 + NUM_THREADS * INCREMENTS_PER_THREAD);
+    std::cout << "  PASSED: Every concurrent read-committed increment is counted" << std::endl;
+
+    db.Close();
+}
+
 void test_occ_multithread_all_commit_low_contention() {
     std::cout << "\n=== Test: Low Contention All Commit ===" << std::endl;
 
@@ -501,6 +774,115 @@ void test_occ_contention_increases_aborts() {
     db.Close();
 }
 
+void test_timestamp_oracles() {
+    std::cout << "\n=== Test: Timestamp Oracles Across Threads ===" << std::endl;
+
+    const int NUM_THREADS = 4;
+    const int CALLS_PER_THREAD = 5000;
+
+    for (const std::string name : {"central", "batched", "epoch", "clock"}) {
+        auto oracle = MakeTimestampOracle(name);
+        assert(oracle && oracle->Name() == name);
+        std::vector<std::vector<uint64_t>> issued(NUM_THREADS);
+        // Largest horizon returned so far: any Next started later must exceed it
+        std::atomic<uint64_t> latest_horizon{0};
+
+        auto worker = [&](int thread_id) {
+            uint64_t last = 0;
+            for (int i = 0; i < CALLS_PER_THREAD; i++) {
+                if (i % 16 == thread_id) {
+                    uint64_t h = oracle->Horizon();
+                    uint64_t seen = latest_horizon.load();
+                    while (h > seen && !latest_horizon.compare_exchange_weak(seen, h)) {}
+                }
+                uint64_t seen = latest_horizon.load();
+                uint64_t ts = oracle->Next();
+                assert(ts > seen);
+                assert(ts > last);
+                last = ts;
+                issued[thread_id].push_back(ts);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back(worker, t);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        std::vector<uint64_t> all;
+        for (const auto& ts : issued) all.insert(all.end(), ts.begin(), ts.end());
+        std::sort(all.begin(), all.end());
+        assert(std::adjacent_find(all.begin(), all.end()) == all.end());
+        assert(oracle->Horizon() >= all.front());
+        std::cout << "  PASSED: " << name << ": " << all.size()
+                  << " unique timestamps, increasing per thread and above earlier horizons" << std::endl;
+    }
+    assert(!MakeTimestampOracle("lamport"));
+}
+
+void test_occ_oracles_balance_conservation() {
+    std::cout << "\n=== Test: Balance Conservation With Each Timestamp Oracle ===" << std::endl;
+
+    const int NUM_ACCOUNTS = 20;
+    const int NUM_THREADS = 4;
+    const int TXNS_PER_THREAD = 200;
+
+    for (const std::string name : {"batched", "epoch", "clock"}) {
+        auto& db = fresh_db();
+        for (int i = 0; i < NUM_ACCOUNTS; i++) {
+            db.Put("account_" + std::to_string(i), "1000");
+        }
+
+        OCCManager mgr(db, MakeTimestampOracle(name));
+        assert(mgr.OracleName() == name);
+        std::atomic<int> total_aborts{0};
+
+        auto worker = [&](int thread_id) {
+            std::mt19937 rng(thread_id * 1000 + 7);
+            std::uniform_int_distribution<int> acct_dist(0, NUM_ACCOUNTS - 1);
+            for (int i = 0; i < TXNS_PER_THREAD; i++) {
+                int a = acct_dist(rng);
+                int b;
+                do { b = acct_dist(rng); } while (b == a);
+                std::string key_a = "account_" + std::to_string(a);
+                std::string key_b = "account_" + std::to_string(b);
+
+                while (true) {
+                    auto txn = mgr.Begin("transfer");
+                    int bal_a = std::stoi(mgr.Read(txn, key_a).value_or("0"));
+                    int bal_b = std::stoi(mgr.Read(txn, key_b).value_or("0"));
+                    mgr.Write(txn, key_a, std::to_string(bal_a - 10));
+                    mgr.Write(txn, key_b, std::to_string(bal_b + 10));
+                    if (mgr.Commit(txn).success) break;
+                    total_aborts++;
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back(worker, t);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        long long total = 0;
+        for (int i = 0; i < NUM_ACCOUNTS; i++) {
+            total += std::stoi(db.Get("account_" + std::to_string(i)).value());
+        }
+        assert(total == 1000LL * NUM_ACCOUNTS);
+        std::cout << "  PASSED: " << name << ": balance conserved, "
+                  << total_aborts.load() << " aborts" << std::endl;
+
+        db.Close();
+    }
+}
+
 // ============================================================
 // Main
 // ============================================================
@@ -523,11 +905,19 @@ int main() {
         test_occ_no_conflict_disjoint_keys();
         test_occ_abort_clears_state();
         test_occ_timestamp_monotonicity();
+        test_occ_history_pruned();
+        test_occ_prepare_pins_keys();
+        test_occ_batch_begin_and_commit();
+        test_occ_read_only_fast_path();
+        test_occ_isolation_levels();
 
         // Multi-threaded tests
         test_occ_multithread_all_commit_low_contention();
         test_occ_multithread_balance_conservation();
+        test_occ_read_committed_no_lost_update();
         test_occ_contention_increases_aborts();
+        test_timestamp_oracles();
+        test_occ_oracles_balance_conservation();
 
         std::cout << "\n==================" << std::endl;
         std::cout << "All OCC Tests Passed!" << std::endl;
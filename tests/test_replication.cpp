@@ -0,0 +1,286 @@
+#include "replication/log_shipper.h"
+#include "replication/follower.h"
+#include "replication/replication_stream.h"
+#include "concurrency/manager_factory.h"
+#include "workload/workload_executor.h"
+#include "workload/workload_template.h"
+#include "metrics/metrics.h"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace txn;
+
+static const std::string kSocketPath = "/tmp/test_replication.sock";
+
+static void open_fresh(Database& db, const std::string& path) {
+    std::filesystem::remove_all(path);
+    assert(db.Open(path));
+}
+
+// Records every OnCommit call, in order
+class RecordingObserver : public CommitObserver {
+public:
+    void OnCommit(const std::unordered_map<std::string, std::string>& writes) override {
+        batches.emplace_back(writes.begin(), writes.end());
+    }
+    std::vector<std::map<std::string, std::string>> batches;
+};
+
+// ============================================================
+// Phase 1: Stream encoding
+// ============================================================
+
+void test_replication_frames_round_trip() {
+    std::cout << "\n=== Test: Replication frames encode and decode ===" << std::endl;
+
+    ReplicationRecord batch;
+    batch.kind = ReplicationKind::kBatch;
+    batch.seq = 42;
+    batch.commit_ns = 123456789;
+    batch.writes = {{"A_1", "100"}, {"A_2", std::string(70000, 'x')}};
+    ReplicationRecord end;
+    end.kind = ReplicationKind::kEnd;
+    end.seq = 42;
+
+    std::string out;
+    AppendReplicationFrame(out, batch);
+    AppendReplicationFrame(out, end);
+
+    std::string_view payload;
+    size_t consumed = 0;
+    ReplicationRecord decoded;
+    assert(NextFrame(out.data(), out.size(), payload, consumed) == FrameStatus::kComplete);
+    assert(DecodeReplication(payload, decoded));
+    assert(decoded.kind == ReplicationKind::kBatch && decoded.seq == 42);
+    assert(decoded.commit_ns == 123456789 && decoded.writes == batch.writes);
+    assert(NextFrame(out.data() + consumed, out.size() - consumed, payload, consumed)
+           == FrameStatus::kComplete);
+    assert(DecodeReplication(payload, decoded));
+    assert(decoded.kind == ReplicationKind::kEnd && decoded.writes.empty());
+    std::cout << "  PASSED: Batch and end marker round trip" << std::endl;
+
+    std::string bad;
+    AppendReplicationFrame(bad, batch);
+    bad[sizeof(uint32_t)] = 9;  // unknown kind
+    assert(NextFrame(bad.data(), bad.size(), payload, consumed) == FrameStatus::kComplete);
+    assert(!DecodeReplication(payload, decoded));
+    assert(!DecodeReplication(std::string_view(out).substr(4, 20), decoded));
+    std::cout << "  PASSED: Unknown kinds and truncated payloads rejected" << std::endl;
+}
+
+// ============================================================
+// Phase 2: Commit log
+// ============================================================
+
+void test_commit_observer_sees_committed_batches() {
+    std::cout << "\n=== Test: Commits reach the observer as one batch each ===" << std::endl;
+
+    for (const std::string protocol : {"occ", "2pl"}) {
+        Database db;
+        open_fresh(db, "test_replication_db");
+        assert(db.InitializeWithData({{"A_1", "100"}, {"A_2", "200"}}));
+        auto mgr = MakeTransactionManager(protocol, db);
+
+        RecordingObserver observer;
+        auto contents = db.AttachObserver(&observer);
+        assert(contents.size() == 2 && contents["A_2"] == "200");
+
+        auto txn = mgr->Begin("transfer", {"A_1", "A_2"});
+        mgr->Write(txn, "A_1", "90");
+        mgr->Write(txn, "A_2", "210");
+        assert(mgr->Commit(txn).success);
+        auto reader = mgr->Begin("balance_check", {"A_1"});
+        mgr->Read(reader, "A_1");
+        assert(mgr->Commit(reader).success);
+        assert(observer.batches.size() == 1);
+        assert(observer.batches[0] == (std::map<std::string, std::string>{{"A_1", "90"}, {"A_2", "210"}}));
+        std::cout << "  PASSED: " << protocol << ": write set observed once, read-only commit skipped" << std::endl;
+
+        db.DetachObserver();
+        auto later = mgr->Begin("write", {"A_1"});
+        mgr->Write(later, "A_1", "80");
+        assert(mgr->Commit(later).success);
+        assert(observer.batches.size() == 1 && db.Get("A_1").value() == "80");
+        std::cout << "  PASSED: " << protocol << ": detached observer sees nothing" << std::endl;
+
+        mgr.reset();
+        db.Close();
+    }
+}
+
+// ============================================================
+// Phase 3: Primary to follower
+// ============================================================
+
+void test_follower_replays_concurrent_transfers() {
+    std::cout << "\n=== Test: Follower replays transfers, readers see whole commits ===" << std::endl;
+
+    const int NUM_ACCOUNTS = 8;
+    for (const std::string protocol : {"occ", "2pl"}) {
+        Database primary_db;
+        open_fresh(primary_db, "test_replication_db");
+        std::map<std::string, std::string> data;
+        for (int a = 1; a <= NUM_ACCOUNTS; a++) data["A_" + std::to_string(a)] = "1000";
+        assert(primary_db.InitializeWithData(data));
+        auto mgr = MakeTransactionManager(protocol, primary_db);
+
+        LogShipper shipper(primary_db, kSocketPath);
+        assert(shipper.Listen());
+
+        Database follower_db;
+        open_fresh(follower_db, "test_replication_follower_db");
+        Follower follower(follower_db);
+        std::atomic<bool> replaying{true};
+        std::atomic<int> torn_reads{0};
+        std::atomic<uint64_t> reads{0};
+        bool applied = false;
+        std::thread follower_thread([&]() {
+            assert(follower.Connect(kSocketPath));
+            auto keys = follower.ReceiveSnapshot();
+            assert(keys && keys->size() == data.size() && follower.AppliedSeq() == 0);
+            // Every transfer conserves the total, so any read at one position sums to it
+            std::thread reader([&]() {
+                std::vector<std::string> all(keys->begin(), keys->end());
+                std::vector<std::optional<std::string>> values;
+                uint64_t last = 0;
+                while (replaying) {
+                    uint64_t position = follower.ReadAt(all, values);
+                    long long total = 0;
+                    for (const auto& v : values) total += std::stoi(v.value());
+                    if (total != 1000LL * NUM_ACCOUNTS || position < last) torn_reads++;
+                    last = position;
+                    reads++;
+                }
+            });
+            applied = follower.ApplyStream();
+            replaying = false;
+            reader.join();
+        });
+        assert(shipper.AcceptFollower());
+
+        ExecutorConfig config;
+        config.num_threads = 4;
+        config.txns_per_thread = 100;
+        config.retry_backoff_base_us = 20;
+        WorkloadTemplate transfer = MakeTransferTemplate();
+        transfer.key_builder = [](std::mt19937& rng) {
+            std::uniform_int_distribution<int> dist(1, NUM_ACCOUNTS);
+            int a = dist(rng), b = dist(rng);
+            while (b == a) b = dist(rng);
+            return std::vector<std::string>{"A_" + std::to_string(a), "A_" + std::to_string(b)};
+        };
+        config.templates = {transfer};
+        MetricsCollector metrics;
+        WorkloadExecutor executor(*mgr, metrics, config);
+        executor.Run();
+
+        assert(shipper.Finish());
+        follower_thread.join();
+        assert(applied);
+
+        ShipperStats shipped = shipper.Stats();
+        assert(shipped.batches == 400 && shipped.acked_seq == 400 && !shipped.follower_lost);
+        assert(shipped.snapshot_keys == data.size() && shipped.writes == 800);
+        FollowerStats stats = follower.Stats();
+        assert(stats.applied_seq == 400 && stats.writes == 800);
+        assert(stats.lag_max_us >= stats.lag_p50_us && stats.lag_mean_us > 0.0);
+        assert(follower_db.Dump() == primary_db.Dump());
+        assert(torn_reads == 0 && reads > 0);
+        std::cout << "  PASSED: " << protocol << ": 400 commits in " << stats.apply_groups
+                  << " write batches, " << reads.load() << " consistent reads, states match" << std::endl;
+
+        mgr.reset();
+        primary_db.Close();
+        follower_db.Close();
+    }
+}
+
+void test_follower_rejects_sequence_gap() {
+    std::cout << "\n=== Test: A gap in the commit sequence stops the follower ===" << std::endl;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, kSocketPath.c_str(), sizeof(addr.sun_path) - 1);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(kSocketPath.c_str());
+    assert(bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    assert(listen(listen_fd, 1) == 0);
+
+    Database follower_db;
+    open_fresh(follower_db, "test_replication_follower_db");
+    Follower follower(follower_db);
+    bool applied = true;
+    std::thread follower_thread([&]() {
+        assert(follower.Connect(kSocketPath));
+        assert(follower.ReceiveSnapshot().has_value());
+        applied = follower.ApplyStream();
+    });
+
+    ReplicationStream primary;
+    primary.Adopt(accept(listen_fd, nullptr, nullptr));
+    ReplicationRecord record;
+    record.kind = ReplicationKind::kSnapshot;
+    record.seq = 5;
+    record.writes = {{"A_1", "100"}};
+    assert(primary.Send(record));
+    record.writes.clear();
+    assert(primary.Send(record));  // end of snapshot at commit 5
+    record.kind = ReplicationKind::kBatch;
+    record.seq = 6;
+    record.writes = {{"A_1", "90"}};
+    assert(primary.Send(record));
+    record.seq = 8;  // commit 7 is missing
+    record.writes = {{"A_1", "80"}};
+    assert(primary.Send(record));
+    follower_thread.join();
+
+    assert(!applied);
+    assert(follower.AppliedSeq() == 6);
+    assert(follower_db.Get("A_1").value() == "90");
+    std::cout << "  PASSED: Applied through commit 6, stopped before the gap" << std::endl;
+
+    primary.Close();
+    close(listen_fd);
+    unlink(kSocketPath.c_str());
+    follower_db.Close();
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main() {
+    std::cout << "Starting Replication Tests" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    try {
+        // Phase 1: Stream encoding
+        test_replication_frames_round_trip();
+
+        // Phase 2: Commit log
+        test_commit_observer_sees_committed_batches();
+
+        // Phase 3: Primary to follower
+        test_follower_replays_concurrent_transfers();
+        test_follower_rejects_sequence_gap();
+
+        std::cout << "\n==========================" << std::endl;
+        std::cout << "All Replication Tests Passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "\nTEST FAILED with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,491 @@
+#include "database/database.h"
+#include "concurrency/occ_manager.h"
+#include "concurrency/twopl_manager.h"
+#include "server/wire_protocol.h"
+#include "server/txn_service.h"
+#include "server/socket_server.h"
+#include "server/txn_client.h"
+#include "server/shm_server.h"
+#include "server/shm_client.h"
+#include "workload/workload_template.h"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <set>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+using namespace txn;
+
+static const std::string kSocketPath = "test_server.sock";
+static const std::string kShmName = "/test_server_shm";
+
+// Helper: open a fresh database for each test
+static Database& fresh_db(const std::string& path = "test_server_db") {
+    static Database db;
+    if (db.IsOpen()) db.Close();
+    std::filesystem::remove_all(path);
+    assert(db.Open(path));
+    return db;
+}
+
+// ============================================================
+// Phase 1: Wire protocol
+// ============================================================
+
+void test_protocol_round_trip() {
+    std::cout << "\n=== Test: Request and response frames round-trip ===" << std::endl;
+
+    TxnRequest ops_req;
+    ops_req.id = 42;
+    ops_req.kind = RequestKind::kOps;
+    ops_req.ops = {{OpType::kRead, "a", ""}, {OpType::kWrite, "b", std::string("v\0x", 3)}};
+    TxnRequest tmpl_req;
+    tmpl_req.id = 43;
+    tmpl_req.template_id = 1;
+    tmpl_req.keys = {"k1", "k2"};
+
+    std::string wire;
+    AppendRequestFrame(wire, ops_req);
+    AppendRequestFrame(wire, tmpl_req);
+
+    std::string_view payload;
+    size_t consumed = 0;
+    TxnRequest decoded;
+    assert(NextFrame(wire.data(), wire.size(), payload, consumed) == FrameStatus::kComplete);
+    assert(DecodeRequest(payload, decoded));
+    assert(decoded.id == 42 && decoded.kind == RequestKind::kOps && decoded.ops.size() == 2);
+    assert(decoded.ops[1].type == OpType::kWrite && decoded.ops[1].value == std::string("v\0x", 3));
+
+    size_t first = consumed;
+    assert(NextFrame(wire.data() + first, wire.size() - first, payload, consumed)
+           == FrameStatus::kComplete);
+    assert(DecodeRequest(payload, decoded));
+    assert(decoded.id == 43 && decoded.template_id == 1 && decoded.keys.size() == 2);
+    assert(first + consumed == wire.size());
+
+    TxnResponse resp;
+    resp.id = 7;
+    resp.retries = 3;
+    resp.reads = {std::string("x"), std::nullopt};
+    std::string resp_wire;
+    AppendResponseFrame(resp_wire, resp);
+    TxnResponse resp_decoded;
+    assert(NextFrame(resp_wire.data(), resp_wire.size(), payload, consumed) == FrameStatus::kComplete);
+    assert(DecodeResponse(payload, resp_decoded));
+    assert(resp_decoded.id == 7 && resp_decoded.retries == 3 && resp_decoded.reads.size() == 2);
+    assert(resp_decoded.reads[0] == "x" && !resp_decoded.reads[1].has_value());
+    std::cout << "  PASSED: Requests and responses decode to what was encoded" << std::endl;
+}
+
+void test_protocol_partial_and_malformed() {
+    std::cout << "\n=== Test: Partial frames wait, malformed payloads are rejected ===" << std::endl;
+
+    TxnRequest req;
+    req.keys = {"k"};
+    std::string wire;
+    AppendRequestFrame(wire, req);
+
+    std::string_view payload;
+    size_t consumed = 0;
+    for (size_t len = 0; len < wire.size(); len++) {
+        assert(NextFrame(wire.data(), len, payload, consumed) == FrameStatus::kIncomplete);
+    }
+
+    // Truncated payload and trailing garbage both fail to decode
+    TxnRequest decoded;
+    assert(NextFrame(wire.data(), wire.size(), payload, consumed) == FrameStatus::kComplete);
+    assert(!DecodeRequest(payload.substr(0, payload.size() - 1), decoded));
+    std::string padded(payload);
+    padded += 'x';
+    assert(!DecodeRequest(padded, decoded));
+
+    uint32_t huge = kMaxFrameBytes + 1;
+    std::string oversized(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    assert(NextFrame(oversized.data(), oversized.size(), payload, consumed) == FrameStatus::kInvalid);
+    std::cout << "  PASSED: Incomplete frames wait for more bytes, bad ones are rejected" << std::endl;
+}
+
+// ============================================================
+// Phase 2: Server over a Unix domain socket
+// ============================================================
+
+void test_server_ops_read_write() {
+    std::cout << "\n=== Test: Explicit ops commit and return reads ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("k1", "one");
+
+    OCCManager mgr(db);
+    MetricsCollector metrics;
+    ServiceConfig config;
+    config.num_workers = 2;
+    TxnService service(mgr, metrics, config);
+    SocketServer server(service, kSocketPath);
+    service.Start();
+    assert(server.Start());
+
+    TxnClient client;
+    assert(client.Connect(kSocketPath));
+    TxnResponse resp;
+    assert(client.Execute({{OpType::kRead, "k1", ""}, {OpType::kWrite, "k2", "two"},
+                           {OpType::kRead, "k2", ""}, {OpType::kRead, "missing", ""}}, resp));
+    assert(resp.status == ResponseStatus::kCommitted);
+    assert(resp.reads.size() == 3);
+    assert(resp.reads[0] == "one");
+    assert(resp.reads[1] == "two");  // read-your-writes inside the request
+    assert(!resp.reads[2].has_value());
+    assert(db.Get("k2").value() == "two");
+
+    // Empty op lists are rejected without closing the connection
+    assert(client.Execute({}, resp));
+    assert(resp.status == ResponseStatus::kBadRequest);
+    assert(client.Execute({{OpType::kRead, "k2", ""}}, resp));
+    assert(resp.status == ResponseStatus::kCommitted && resp.reads[0] == "two");
+
+    client.Close();
+    server.Stop();
+    service.Stop();
+    assert(!std::filesystem::exists(kSocketPath));
+    std::cout << "  PASSED: Ops run as one transaction, bad requests keep the connection" << std::endl;
+
+    db.Close();
+}
+
+void test_server_pipelined_transfers() {
+    std::cout << "\n=== Test: Pipelined template requests from several clients ===" << std::endl;
+
+    auto& db = fresh_db();
+    const int NUM_ACCOUNTS = 10;
+    const int NUM_CLIENTS = 3;
+    const int REQUESTS_PER_CLIENT = 200;
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        db.Put("account_" + std::to_string(i), "1000");
+    }
+
+    TwoPLManager mgr(db);
+    MetricsCollector metrics;
+    ServiceConfig config;
+    config.num_workers = 4;
+    config.contention = {NUM_ACCOUNTS, 2, 0.5};
+    config.templates = {MakeTransferTemplate(), MakeBalanceCheckTemplate()};
+    TxnService service(mgr, metrics, config);
+    SocketServer server(service, kSocketPath);
+    service.Start();
+    assert(server.Start());
+
+    std::atomic<int> committed{0};
+    auto client_thread = [&](int c) {
+        TxnClient client;
+        assert(client.Connect(kSocketPath));
+        std::set<uint64_t> pending;
+        // Everything in one batch: requests are in flight before any response
+        for (int i = 0; i < REQUESTS_PER_CLIENT; i++) {
+            pending.insert(i % 2 == 0 ? client.SubmitTemplate()
+                                      : client.SubmitTemplate(0, {"account_" + std::to_string(c),
+                                                                  "account_9"}));
+        }
+        assert(client.InFlight() == REQUESTS_PER_CLIENT);
+        assert(client.Flush());
+        while (!pending.empty()) {
+            TxnResponse resp;
+            assert(client.Receive(resp));
+            assert(pending.erase(resp.id) == 1);
+            assert(resp.status == ResponseStatus::kCommitted);
+            committed++;
+        }
+        assert(client.InFlight() == 0);
+    };
+    std::vector<std::thread> clients;
+    for (int c = 0; c < NUM_CLIENTS; c++) clients.emplace_back(client_thread, c);
+    for (auto& t : clients) t.join();
+
+    server.Stop();
+    service.Stop();
+
+    assert(committed == NUM_CLIENTS * REQUESTS_PER_CLIENT);
+    assert(metrics.TotalCommits() == static_cast<uint64_t>(NUM_CLIENTS * REQUESTS_PER_CLIENT));
+    long long total = 0;
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        total += std::stoi(db.Get("account_" + std::to_string(i)).value());
+    }
+    assert(total == 1000LL * NUM_ACCOUNTS);
+    std::cout << "  PASSED: " << committed << " pipelined requests committed, balance conserved"
+              << std::endl;
+
+    db.Close();
+}
+
+void test_server_unknown_template() {
+    std::cout << "\n=== Test: Unknown template id and short key lists are bad requests ===" << std::endl;
+
+    auto& db = fresh_db();
+    OCCManager mgr(db);
+    MetricsCollector metrics;
+    ServiceConfig config;
+    config.num_workers = 1;
+    config.templates = {MakeTransferTemplate()};
+    TxnService service(mgr, metrics, config);
+    SocketServer server(service, kSocketPath);
+    service.Start();
+    assert(server.Start());
+
+    TxnClient client;
+    assert(client.Connect(kSocketPath));
+    uint64_t unknown = client.SubmitTemplate(5);
+    uint64_t short_keys = client.SubmitTemplate(0, {"only_one"});
+    assert(client.Flush());
+    for (int i = 0; i < 2; i++) {
+        TxnResponse resp;
+        assert(client.Receive(resp));
+        assert(resp.id == unknown || resp.id == short_keys);
+        assert(resp.status == ResponseStatus::kBadRequest);
+        assert(!resp.error.empty());
+    }
+    assert(metrics.TotalCommits() == 0);
+    std::cout << "  PASSED: Invalid template requests get kBadRequest" << std::endl;
+
+    client.Close();
+    server.Stop();
+    service.Stop();
+    db.Close();
+}
+
+void test_server_malformed_template_requests() {
+    std::cout << "\n=== Test: Malformed template requests fail without killing the server ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "100");
+    db.Put("B", "100");
+    TwoPLManager mgr(db);
+    MetricsCollector metrics;
+    ServiceConfig config;
+    config.num_workers = 1;
+    // Like the TPC-C templates: keys come only from the key_builder, and
+    // execute relies on their layout
+    WorkloadTemplate built{
+        "built",
+        0,
+        [](std::mt19937&) { return std::vector<std::string>{"A", "B", "C"}; },
+        [](TransactionManager& mgr, const std::vector<std::string>& keys) -> CommitResult {
+            auto txn = mgr.Begin("built", keys);
+            mgr.Read(txn, keys[2]);
+            return mgr.Commit(txn);
+        }
+    };
+    config.templates = {MakeTransferTemplate(), built};
+    TxnService service(mgr, metrics, config);
+    SocketServer server(service, kSocketPath);
+    service.Start();
+    assert(server.Start());
+
+    TxnClient client;
+    assert(client.Connect(kSocketPath));
+    auto run_template = [&client](uint16_t id, const std::vector<std::string>& keys) {
+        client.SubmitTemplate(id, keys);
+        assert(client.Flush());
+        TxnResponse resp;
+        assert(client.Receive(resp));
+        return resp;
+    };
+
+    // Client keys for it are refused, not indexed
+    TxnResponse resp = run_template(1, {"x"});
+    assert(resp.status == ResponseStatus::kBadRequest);
+    assert(!resp.error.empty());
+    std::cout << "  PASSED: Client keys for a key_builder-only template are refused" << std::endl;
+
+    // A balance overwritten with text makes transfer throw mid-transaction
+    assert(client.Execute({{OpType::kWrite, "A", "not a number"}}, resp));
+    assert(resp.status == ResponseStatus::kCommitted);
+    resp = run_template(0, {"A", "B"});
+    assert(resp.status == ResponseStatus::kBadRequest);
+    assert(resp.error.find("transfer") != std::string::npos);
+    // Its locks were released: the next request on A does not wait forever
+    assert(client.Execute({{OpType::kWrite, "A", "100"}}, resp));
+    assert(resp.status == ResponseStatus::kCommitted);
+    resp = run_template(0, {"A", "B"});
+    assert(resp.status == ResponseStatus::kCommitted);
+    assert(db.Get("A").value() == "90" && db.Get("B").value() == "110");
+    std::cout << "  PASSED: A throwing template gets kBadRequest and its transaction is aborted" << std::endl;
+
+    client.Close();
+    server.Stop();
+    service.Stop();
+    db.Close();
+}
+
+// ============================================================
+// Phase 3: Shared-memory transport
+// ============================================================
+
+void test_shm_ops_and_pipelined_transfers() {
+    std::cout << "\n=== Test: Ops and pipelined transfers over shared memory ===" << std::endl;
+
+    auto& db = fresh_db();
+    const int NUM_ACCOUNTS = 10;
+    const int NUM_CLIENTS = 3;
+    const int REQUESTS_PER_CLIENT = 300;
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        db.Put("account_" + std::to_string(i), "1000");
+    }
+
+    TwoPLManager mgr(db);
+    MetricsCollector metrics;
+    ServiceConfig config;
+    config.num_workers = 4;
+    config.contention = {NUM_ACCOUNTS, 2, 0.5};
+    config.templates = {MakeTransferTemplate(), MakeBalanceCheckTemplate()};
+    TxnService service(mgr, metrics, config);
+    ShmServerConfig shm;
+    shm.num_slots = 4;
+    shm.ring_bytes = 4096;  // small rings: batches wrap and fill them
+    ShmServer server(service, kShmName, shm);
+    service.Start();
+    assert(server.Start());
+
+    {
+        ShmTxnClient client;
+        assert(client.Connect(kShmName));
+        TxnResponse resp;
+        assert(client.Execute({{OpType::kWrite, "shm_key", "v"}, {OpType::kRead, "shm_key", ""},
+                               {OpType::kRead, "account_0", ""}}, resp));
+        assert(resp.status == ResponseStatus::kCommitted);
+        assert(resp.reads.size() == 2);
+        assert(resp.reads[0] == "v" && resp.reads[1] == "1000");
+        assert(client.Execute({}, resp));
+        assert(resp.status == ResponseStatus::kBadRequest);
+    }
+    assert(db.Get("shm_key").value() == "v");
+
+    std::atomic<int> committed{0};
+    auto client_thread = [&](int c) {
+        ShmTxnClient client;
+        client.SetSpinPolls(50);  // exercise the futex sleep path
+        assert(client.Connect(kShmName));
+        std::set<uint64_t> pending;
+        int sent = 0;
+        while (sent < REQUESTS_PER_CLIENT || !pending.empty()) {
+            while (sent < REQUESTS_PER_CLIENT && client.InFlight() < 64) {
+                uint64_t id = sent % 2 == 0
+                    ? client.SubmitTemplate()
+                    : client.SubmitTemplate(0, {"account_" + std::to_string(c), "account_9"});
+                assert(id != 0);
+                pending.insert(id);
+                sent++;
+            }
+            assert(client.Flush());
+            TxnResponse resp;
+            assert(client.Receive(resp));
+            assert(pending.erase(resp.id) == 1);
+            assert(resp.status == ResponseStatus::kCommitted);
+            committed++;
+        }
+        assert(client.InFlight() == 0);
+    };
+    std::vector<std::thread> clients;
+    for (int c = 0; c < NUM_CLIENTS; c++) clients.emplace_back(client_thread, c);
+    for (auto& t : clients) t.join();
+
+    server.Stop();
+    service.Stop();
+
+    assert(committed == NUM_CLIENTS * REQUESTS_PER_CLIENT);
+    long long total = 0;
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        total += std::stoi(db.Get("account_" + std::to_string(i)).value());
+    }
+    assert(total == 1000LL * NUM_ACCOUNTS);
+    std::cout << "  PASSED: " << committed << " requests over shared memory, balance conserved"
+              << std::endl;
+
+    db.Close();
+}
+
+void test_shm_slot_reuse_and_engine_stop() {
+    std::cout << "\n=== Test: Closed slots are reused, clients see the engine stop ===" << std::endl;
+
+    auto& db = fresh_db();
+    OCCManager mgr(db);
+    MetricsCollector metrics;
+    ServiceConfig config;
+    config.num_workers = 2;
+    TxnService service(mgr, metrics, config);
+    ShmServerConfig shm;
+    shm.num_slots = 2;
+    shm.ring_bytes = 4096;
+    ShmServer server(service, kShmName, shm);
+    service.Start();
+    assert(server.Start());
+
+    // More sequential clients than slots: each Close must free its slot
+    for (int i = 0; i < 6; i++) {
+        ShmTxnClient client;
+        bool connected = false;
+        for (int attempt = 0; attempt < 200 && !connected; attempt++) {
+            connected = client.Connect(kShmName);
+            if (!connected) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        assert(connected);
+        TxnResponse resp;
+        assert(client.Execute({{OpType::kWrite, "reuse_" + std::to_string(i), "x"}}, resp));
+        assert(resp.status == ResponseStatus::kCommitted);
+    }
+    assert(server.ClientsAttached() == 6);
+    std::cout << "  PASSED: 6 clients through 2 slots" << std::endl;
+
+    ShmTxnClient waiting;
+    assert(waiting.Connect(kShmName));
+    std::atomic<bool> returned{false};
+    std::thread receiver([&] {
+        TxnResponse resp;
+        assert(!waiting.Receive(resp));  // nothing in flight: only the stop ends this
+        returned = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    server.Stop();
+    receiver.join();
+    assert(returned);
+    assert(waiting.SubmitOps({{OpType::kRead, "reuse_0", ""}}) == 0 || !waiting.Flush());
+    ShmTxnClient late;
+    assert(!late.Connect(kShmName));  // region is unlinked
+    service.Stop();
+    std::cout << "  PASSED: Receive fails once the engine stops, region removed" << std::endl;
+
+    db.Close();
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main() {
+    std::cout << "Starting Server Tests" << std::endl;
+    std::cout << "=====================" << std::endl;
+
+    try {
+        // Phase 1: Wire protocol
+        test_protocol_round_trip();
+        test_protocol_partial_and_malformed();
+
+        // Phase 2: Server over a Unix domain socket
+        test_server_ops_read_write();
+        test_server_pipelined_transfers();
+        test_server_unknown_template();
+        test_server_malformed_template_requests();
+
+        // Phase 3: Shared-memory transport
+        test_shm_ops_and_pipelined_transfers();
+        test_shm_slot_reuse_and_engine_stop();
+
+        std::cout << "\n=====================" << std::endl;
+        std::cout << "All Server Tests Passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "\nTEST FAILED with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
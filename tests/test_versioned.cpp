@@ -0,0 +1,291 @@
+#include "database/database.h"
+#include "transaction/transaction.h"
+#include "concurrency/versioned_occ_manager.h"
+#include "concurrency/manager_factory.h"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <filesystem>
+
+using namespace txn;
+
+// Helper: open a fresh database for each test
+static Database& fresh_db(const std::string& path = "test_versioned_db") {
+    static Database db;
+    if (db.IsOpen()) db.Close();
+    std::filesystem::remove_all(path);
+    assert(db.Open(path));
+    return db;
+}
+
+static uint64_t stored_version(Database& db, const std::string& key) {
+    uint64_t version;
+    db.GetVersioned(key, version);
+    return version;
+}
+
+// ============================================================
+// Phase 1: Stored versions
+// ============================================================
+
+void test_versioned_values_carry_versions() {
+    std::cout << "\n=== Test: Committed values carry their key's version ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "100");
+    assert(stored_version(db, "A") == 0);  // loaded without a version
+    assert(stored_version(db, "missing") == 0);
+
+    auto mgr = MakeTransactionManager("occ-versioned", db);
+    assert(mgr && mgr->ProtocolName() == "OCC-Versioned");
+    for (int i = 1; i <= 3; i++) {
+        auto txn = mgr->Begin("bump");
+        int a = std::stoi(mgr->Read(txn, "A").value());
+        mgr->Write(txn, "A", std::to_string(a + 1));
+        mgr->Write(txn, "B", "x");
+        assert(mgr->Commit(txn).success);
+        assert(stored_version(db, "A") == static_cast<uint64_t>(i));
+    }
+    assert(stored_version(db, "B") == 3);
+    assert(db.Get("A").value() == "103");  // Get returns the bare value
+    assert(db.MultiGet({"A", "B"})[1].value() == "x");
+    std::cout << "  PASSED: Each commit bumps the version; Get and MultiGet strip it" << std::endl;
+
+    // Versions are stored, not kept by the manager: they survive a reopen
+    db.Close();
+    assert(db.Open("test_versioned_db"));
+    assert(stored_version(db, "A") == 3 && db.Get("A").value() == "103");
+    VersionedOCCManager reopened(db);
+    auto txn = reopened.Begin("bump");
+    reopened.Write(txn, "A", "0");
+    assert(reopened.Commit(txn).success);
+    assert(stored_version(db, "A") == 4);
+    assert(reopened.StructureSizes()[0].second == 0);  // prepared_keys: no history to grow
+    std::cout << "  PASSED: Versions survive closing and reopening the database" << std::endl;
+
+    db.Close();
+}
+
+// ============================================================
+// Phase 2: Validation
+// ============================================================
+
+void test_versioned_conflict_detection() {
+    std::cout << "\n=== Test: A stale read version aborts the commit ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "1");
+    db.Put("B", "2");
+    VersionedOCCManager mgr(db);
+
+    auto reader = mgr.Begin("reader");
+    mgr.Read(reader, "A");
+    auto writer = mgr.Begin("writer");
+    mgr.Write(writer, "A", "10");
+    assert(mgr.Commit(writer).success);
+
+    mgr.Write(reader, "B", "20");
+    assert(!mgr.Commit(reader).success);
+    assert(reader.status == TxnStatus::ABORTED);
+    assert(db.Get("B").value() == "2");
+    std::cout << "  PASSED: Reader of an overwritten key aborts, nothing written" << std::endl;
+
+    auto disjoint = mgr.Begin("reader");
+    mgr.Read(disjoint, "B");
+    auto other = mgr.Begin("writer");
+    mgr.Write(other, "A", "11");
+    assert(mgr.Commit(other).success);
+    mgr.Write(disjoint, "B", "21");
+    assert(mgr.Commit(disjoint).success);
+    assert(db.Get("B").value() == "21");
+    std::cout << "  PASSED: Disjoint keys commit" << std::endl;
+
+    // A missing key reads as version 0: inserting it invalidates the read
+    auto absent = mgr.Begin("reader");
+    assert(!mgr.Read(absent, "C").has_value());
+    auto insert = mgr.Begin("writer");
+    mgr.Write(insert, "C", "new");
+    assert(mgr.Commit(insert).success);
+    mgr.Write(absent, "A", "12");
+    assert(!mgr.Commit(absent).success);
+    std::cout << "  PASSED: Insert of a key read as missing is a conflict" << std::endl;
+
+    // Read committed checks no read, but a written key it read must be unchanged
+    mgr.SetIsolation("rc", IsolationLevel::kReadCommitted);
+    auto stale = mgr.Begin("rc");
+    auto fresh = mgr.Begin("rc");
+    mgr.Read(stale, "A");
+    mgr.Read(stale, "B");
+    mgr.Read(fresh, "A");
+    auto bump = mgr.Begin("writer");
+    mgr.Write(bump, "A", "13");
+    mgr.Write(bump, "B", "22");
+    assert(mgr.Commit(bump).success);
+    mgr.Write(fresh, "C", "rc");
+    assert(mgr.Commit(fresh).success);  // stale read of A, A not written
+    mgr.Write(stale, "B", "23");
+    assert(!mgr.Commit(stale).success);  // would lose bump's update of B
+    assert(db.Get("B").value() == "22");
+    std::cout << "  PASSED: Read-committed commits over a stale read, not over a lost update" << std::endl;
+
+    db.Close();
+}
+
+void test_versioned_managers_share_state() {
+    std::cout << "\n=== Test: Separate managers on one database see each other ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "1");
+    VersionedOCCManager first(db);
+    VersionedOCCManager second(db);
+
+    auto txn1 = first.Begin("t");
+    auto txn2 = second.Begin("t");
+    first.Read(txn1, "A");
+    second.Read(txn2, "A");
+    first.Write(txn1, "A", "2");
+    second.Write(txn2, "A", "3");
+    assert(first.Commit(txn1).success);
+    assert(!second.Commit(txn2).success);
+    assert(db.Get("A").value() == "2");
+    std::cout << "  PASSED: The second manager's lost update aborts" << std::endl;
+
+    db.Close();
+}
+
+void test_versioned_prepare_pins_keys() {
+    std::cout << "\n=== Test: Prepare pins keys until commit or abort ===" << std::endl;
+
+    auto& db = fresh_db();
+    db.Put("A", "1");
+    db.Put("B", "2");
+    VersionedOCCManager mgr(db);
+
+    auto prepared = mgr.Begin("t");
+    mgr.Read(prepared, "A");
+    mgr.Write(prepared, "B", "20");
+    assert(mgr.Prepare(prepared));
+
+    auto writer = mgr.Begin("t");
+    mgr.Write(writer, "A", "10");
+    assert(!mgr.Commit(writer).success);
+    assert(mgr.Commit(prepared).success);
+    assert(db.Get("B").value() == "20");
+    assert(mgr.StructureSizes()[0].second == 0);
+    std::cout << "  PASSED: Pinned key blocks a writer; prepared commit applies and unpins" << std::endl;
+
+    auto stale = mgr.Begin("t");
+    mgr.Read(stale, "A");
+    auto bump = mgr.Begin("t");
+    mgr.Write(bump, "A", "11");
+    assert(mgr.Commit(bump).success);
+    mgr.Write(stale, "B", "21");
+    assert(!mgr.Prepare(stale));
+    assert(mgr.StructureSizes()[0].second == 0);
+    std::cout << "  PASSED: Stale prepare votes no and pins nothing" << std::endl;
+
+    db.Close();
+}
+
+// ============================================================
+// Phase 3: Multi-threaded correctness
+// ============================================================
+
+void test_versioned_balance_conservation() {
+    std::cout << "\n=== Test: Transfers through two managers conserve the total ===" << std::endl;
+
+    auto& db = fresh_db();
+    const int NUM_ACCOUNTS = 10;
+    const int INITIAL_BALANCE = 1000;
+    const int NUM_THREADS = 4;
+    const int TXNS_PER_THREAD = 200;
+
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        db.Put("account_" + std::to_string(i), std::to_string(INITIAL_BALANCE));
+    }
+
+    // Two managers, as two front ends over one database would have
+    VersionedOCCManager first(db);
+    VersionedOCCManager second(db);
+    std::atomic<int> commits{0};
+    std::atomic<int> aborts{0};
+
+    auto worker = [&](int thread_id) {
+        VersionedOCCManager& mgr = thread_id % 2 == 0 ? first : second;
+        std::mt19937 rng(thread_id * 17 + 3);
+        std::uniform_int_distribution<int> acct_dist(0, NUM_ACCOUNTS - 1);
+
+        for (int i = 0; i < TXNS_PER_THREAD; i++) {
+            int a = acct_dist(rng);
+            int b;
+            do { b = acct_dist(rng); } while (b == a);
+            std::string key_a = "account_" + std::to_string(a);
+            std::string key_b = "account_" + std::to_string(b);
+
+            while (true) {
+                auto txn = mgr.Begin("transfer");
+                int bal_a = std::stoi(mgr.Read(txn, key_a).value_or("0"));
+                int bal_b = std::stoi(mgr.Read(txn, key_b).value_or("0"));
+                mgr.Write(txn, key_a, std::to_string(bal_a - 10));
+                mgr.Write(txn, key_b, std::to_string(bal_b + 10));
+                if (mgr.Commit(txn).success) break;
+                aborts++;
+            }
+            commits++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& t : threads) t.join();
+
+    long long total = 0;
+    uint64_t versions = 0;
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+        std::string key = "account_" + std::to_string(i);
+        total += std::stoi(db.Get(key).value());
+        versions += stored_version(db, key);
+    }
+    std::cout << "  Commits: " << commits.load() << ", aborts: " << aborts.load() << std::endl;
+    assert(commits.load() == NUM_THREADS * TXNS_PER_THREAD);
+    assert(total == (long long)NUM_ACCOUNTS * INITIAL_BALANCE);
+    assert(versions == 2ull * NUM_THREADS * TXNS_PER_THREAD);  // two keys per commit
+    std::cout << "  PASSED: Balance conserved; every commit bumped two versions" << std::endl;
+
+    db.Close();
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+int main() {
+    std::cout << "Starting Versioned OCC Tests" << std::endl;
+    std::cout << "============================" << std::endl;
+
+    try {
+        // Phase 1: Stored versions
+        test_versioned_values_carry_versions();
+
+        // Phase 2: Validation
+        test_versioned_conflict_detection();
+        test_versioned_managers_share_state();
+        test_versioned_prepare_pins_keys();
+
+        // Phase 3: Multi-threaded correctness
+        test_versioned_balance_conservation();
+
+        std::cout << "\n============================" << std::endl;
+        std::cout << "All Versioned OCC Tests Passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "\nTEST FAILED with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}